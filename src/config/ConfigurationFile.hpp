@@ -10,8 +10,10 @@
 #ifndef SRC_CONFIGURATIONFILE_HPP_
 #define SRC_CONFIGURATIONFILE_HPP_
 
+#include <functional>
 #include <string>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 
  /**
@@ -22,6 +24,11 @@ class ConfigurationFile
 public:
 	typedef std::unordered_map<std::string, std::unordered_map<std::string, std::string>> ConfigurationStructure;
 
+	/**
+	* Receives every key=value read from the configuration. Views are valid only during the call.
+	*/
+	typedef std::function<void(std::string_view section, std::string_view key, std::string_view value)> Visitor;
+
 	/**
 	* Default constructor.
 	*/
@@ -45,6 +52,28 @@ public:
 	* @param[out] settings reference to map where configuration will be stored
 	*/
 	virtual void parse(std::stringstream& config, ConfigurationStructure& settings) = 0;
+
+	/**
+	* Parse configuration held in memory and store key=value results in provided map.
+	* @param[in] config text of the configuration
+	* @param[out] settings reference to map where configuration will be stored
+	*/
+	virtual void parseText(std::string_view config, ConfigurationStructure& settings) = 0;
+
+	/**
+	* Read specified file and pass every key=value to the visitor.
+	* @param[in] path path to the file with configuration
+	* @param[in] visit called for every key=value
+	* @return True if file could be read.
+	*/
+	virtual bool read(const std::string& path, const Visitor& visit) = 0;
+
+	/**
+	* Read configuration held in memory and pass every key=value to the visitor.
+	* @param[in] config text of the configuration
+	* @param[in] visit called for every key=value
+	*/
+	virtual void readText(std::string_view config, const Visitor& visit) = 0;
 };
 
 #endif /* SRC_CONFIGURATIONFILE_HPP_ */
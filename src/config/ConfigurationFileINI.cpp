@@ -8,46 +8,181 @@
  */
 
 #include "ConfigurationFileINI.hpp"
+#include "Global.h"
 
-#include <regex>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+
+#if defined(SWPL_SYSTEM_HAVE_SYS_MMAN_H) && defined(SWPL_SYSTEM_HAVE_FCNTL_H) && defined(SWPL_SYSTEM_HAVE_UNISTD_H)
+#define SWPL_CONFIG_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+* Whitespace trimmed around lines, keys and values - space, \t, \v, \f and \r (new line ends the line).
+*/
+static inline bool is_space(char c) noexcept
+{
+    return c == ' ' || (c >= '\t' && c <= '\r' && c != '\n');
+}
 
 void ConfigurationFileINI::parse(std::string path, ConfigurationStructure& settings)
 {
-    std::ifstream file_reader(path, std::ifstream::in);
-    std::stringstream buffer;
+    read(path, [&settings](std::string_view section, std::string_view key, std::string_view value)
+        {
+            // Repeated key keeps the last value.
+            settings[std::string(section)][std::string(key)].assign(value);
+        });
+}
+
+void ConfigurationFileINI::parse(std::stringstream& config, ConfigurationStructure& settings)
+{
+    parseText(config.view(), settings);
+}
 
-    if (file_reader.good())
+void ConfigurationFileINI::parseText(std::string_view config, ConfigurationStructure& settings)
+{
+    const char* last_section = nullptr;
+    std::unordered_map<std::string, std::string>* values = nullptr;    // Map of the section, created with its first key
+    std::string name;                                                   // Reused for lookups, allocates only when it grows
+
+    readText(config, [&](std::string_view section, std::string_view key, std::string_view value)
+        {
+            // Keys of one section share the view of its header.
+            if (values == nullptr || section.data() != last_section)
+            {
+                name.assign(section);
+                values = &settings[name];
+                last_section = section.data();
+            }
+
+            name.assign(key);
+            (*values)[name].assign(value);
+        });
+}
+
+bool ConfigurationFileINI::read(const std::string& path, const Visitor& visit)
+{
+#if defined(SWPL_CONFIG_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+
+    if (fd < 0 || ::fstat(fd, &info) != 0)
     {
-        buffer << file_reader.rdbuf();
-        parse(buffer, settings);
+        if (fd >= 0)
+            ::close(fd);
+        errors_.clear();
+        error(0, "cannot open " + path);
+        return false;
     }
-    file_reader.close();
-}
 
+    // Empty file can not be mapped.
+    const auto size = static_cast<size_t>(info.st_size);
+    void* mapped = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    ::close(fd);
 
-void ConfigurationFileINI::parse(std::stringstream& config, ConfigurationStructure& settings)
+    if (mapped != MAP_FAILED)
+    {
+        if (mapped != nullptr)
+            ::madvise(mapped, size, MADV_SEQUENTIAL);
+        readText(std::string_view(static_cast<const char*>(mapped), mapped != nullptr ? size : 0), visit);
+        if (mapped != nullptr)
+            ::munmap(mapped, size);
+        return true;
+    }
+#endif
+
+    std::ifstream file_reader(path, std::ifstream::in | std::ifstream::binary);
+    if (!file_reader.good())
+    {
+        errors_.clear();
+        error(0, "cannot open " + path);
+        return false;
+    }
+
+    std::string content{ std::istreambuf_iterator<char>(file_reader), std::istreambuf_iterator<char>() };
+    readText(content, visit);
+    return true;
+}
+
+void ConfigurationFileINI::readText(std::string_view config, const Visitor& visit)
 {
-    static const std::regex comment_regex{ R"~(\s*[;#])~" };
-    static const std::regex section_regex{ R"~(\s*\[([^\]]+)\])~" };
-    static const std::regex value_regex{ R"~(\s*(\S[^ \t=]*)\s*=\s*((\s?\S+)+)\s*$)~" };
+    const char* pos = config.data();
+    const char* const end = pos + config.size();
+    std::string_view section;
+    unsigned int number = 0;
 
-    std::string section;
-    std::smatch elems;
+    errors_.clear();
 
-    for (std::string line; std::getline(config, line);)
+    while (pos < end)
     {
-        if (line.empty() || std::regex_match(line, elems, comment_regex)) continue;
+        auto newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        const char* first = pos;
+        const char* last = newline != nullptr ? newline : end;
+        pos = last + 1;
+        ++number;
+
+        while (first < last && is_space(*first))
+            ++first;
+        while (last > first && is_space(last[-1]))
+            --last;
+
+        if (first == last || *first == ';' || *first == '#')
+            continue;
+
+        if (*first == '[')
+        {
+            auto close = static_cast<const char*>(std::memchr(first, ']', static_cast<size_t>(last - first)));
+            if (close == nullptr || close == first + 1 || close + 1 != last)
+            {
+                error(number, "invalid section header");
+                continue;
+            }
+
+            section = std::string_view(first + 1, static_cast<size_t>(close - first - 1));
+            continue;
+        }
+
+        auto equal = static_cast<const char*>(std::memchr(first, '=', static_cast<size_t>(last - first)));
+        if (equal == nullptr)
+        {
+            error(number, "missing '='");
+            continue;
+        }
+
+        const char* key_end = equal;
+        while (key_end > first && is_space(key_end[-1]))
+            --key_end;
+        const char* value = equal + 1;
+        while (value < last && is_space(*value))
+            ++value;
+
+        const char* inner = first;
+        while (inner < key_end && !is_space(*inner))
+            ++inner;
 
-        if (std::regex_match(line, elems, section_regex))
+        std::string_view key(first, static_cast<size_t>(key_end - first));
+        if (key.empty() || inner != key_end)
         {
-            if (elems.size() == 2)
-                section = elems[1].str();
+            error(number, "invalid key");
+            continue;
         }
-        else if (std::regex_match(line, elems, value_regex))
+        if (value == last)
         {
-            if (elems.size() == 4)
-                settings[section][elems[1].str()] = elems[2].str();
+            error(number, "missing value of " + std::string(key));
+            continue;
         }
+
+        visit(section, key, std::string_view(value, static_cast<size_t>(last - value)));
     }
-}
\ No newline at end of file
+}
+
+void ConfigurationFileINI::error(unsigned int line, std::string message)
+{
+    LOG_WARNING("configuration line {}: {}", line, message);
+    errors_.push_back(Error{ line, std::move(message) });
+}
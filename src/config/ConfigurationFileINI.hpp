@@ -13,14 +13,28 @@
 #include "ConfigurationFile.hpp"
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
  /**
  * Configuration stored in INI file.
+ * File is read in a single pass straight from the memory (file is mapped, not copied) - lines are
+ * cut into views passed to the visitor, nothing is allocated by the parser itself. Lines that can
+ * not be parsed are skipped and reported with their numbers.
  */
 class ConfigurationFileINI : public ConfigurationFile
 {
 public:
+	/**
+	* Line of the configuration that could not be parsed.
+	*/
+	struct Error
+	{
+		unsigned int line;							/*!< Line number, counted from 1 (0 - whole file) */
+		std::string message;
+	};
+
 	/**
 	* Default constructor.
 	*/
@@ -44,6 +58,44 @@ public:
 	* @param[out] settings reference to map where configuration will be stored
 	*/
 	void parse(std::stringstream& config, ConfigurationStructure& settings) override;
+
+	/**
+	* Parse configuration held in memory and store key=value results in provided map.
+	* @param[in] config text of the configuration
+	* @param[out] settings reference to map where configuration will be stored
+	*/
+	void parseText(std::string_view config, ConfigurationStructure& settings) override;
+
+	/**
+	* Read specified file and pass every key=value to the visitor.
+	* @param[in] path path to the file with configuration
+	* @param[in] visit called for every key=value
+	* @return True if file could be read.
+	*/
+	bool read(const std::string& path, const Visitor& visit) override;
+
+	/**
+	* Read configuration held in memory and pass every key=value to the visitor.
+	* @param[in] config text of the configuration
+	* @param[in] visit called for every key=value
+	*/
+	void readText(std::string_view config, const Visitor& visit) override;
+
+	/**
+	* Get errors found by the last parse.
+	*/
+	const std::vector<Error>& getErrors() const
+	{
+		return errors_;
+	}
+
+private:
+	/**
+	* Record and report the error.
+	*/
+	void error(unsigned int line, std::string message);
+
+	std::vector<Error> errors_;
 };
 
 #endif /* SRC_CONFIGURATIONFILE_HPP_ */
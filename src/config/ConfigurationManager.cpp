@@ -10,14 +10,18 @@
 
 #include "ConfigurationManager.hpp"
 #include "ConfigurationFileINI.hpp"
+#include "Global.h"
 
-#include <fstream>
-#include <regex>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <utility>
 
-#include <cfloat>
-#include <climits>
+#include <cstdlib>
+#include <cstring>
 
  /**
   * Convert std::string to long long.
@@ -35,6 +39,79 @@ long long convertToLongLong(const std::string& value);
  */
 double convertToDouble(const std::string& value);
 
+/**
+* Cut whitespace around the number.
+*/
+static std::string_view trim(std::string_view value) noexcept
+{
+	constexpr std::string_view whitespace{ " \t\n\v\f\r" };
+
+	auto first = value.find_first_not_of(whitespace);
+	if (first == std::string_view::npos)
+		return {};
+
+	return value.substr(first, value.find_last_not_of(whitespace) - first + 1);
+}
+
+/**
+* Drop the plus sign, which from_chars() does not accept.
+* @return False if the sign is followed by another one.
+*/
+static bool unsign(std::string_view& text) noexcept
+{
+	if (text.empty() || text[0] != '+')
+		return true;
+
+	text.remove_prefix(1);
+	return text.empty() || (text[0] != '+' && text[0] != '-');
+}
+
+/**
+* Parse decimal integer with optional sign and whitespace around it.
+*/
+static bool parse_integer(std::string_view text, long long& value) noexcept
+{
+	text = trim(text);
+	if (!unsign(text) || text.empty())
+		return false;
+
+	auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return error == std::errc() && end == text.data() + text.size();
+}
+
+/**
+* Parse decimal floating point number (no inf, nan or hex) with optional sign and whitespace around it.
+*/
+static bool parse_real(std::string_view text, double& value) noexcept
+{
+	text = trim(text);
+	if (!unsign(text))
+		return false;
+
+	size_t digit = !text.empty() && text[0] == '-' ? 1 : 0;
+	if (digit >= text.size() || !(std::isdigit(static_cast<unsigned char>(text[digit])) || text[digit] == '.'))
+		return false;
+
+	auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return error == std::errc() && end == text.data() + text.size();
+}
+
+/**
+* Compare ignoring case of ASCII letters.
+*/
+static bool equal_nocase(std::string_view text, std::string_view lower) noexcept
+{
+	if (text.size() != lower.size())
+		return false;
+
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		if (std::tolower(static_cast<unsigned char>(text[i])) != lower[i])
+			return false;
+	}
+	return true;
+}
+
 
 void ConfigurationManager::parseConfiguration(int argc, char** argv) noexcept
 {
@@ -46,6 +123,7 @@ void ConfigurationManager::parseConfiguration(int argc, char** argv) noexcept
 	appConfig_.help = false;
 	appConfig_.valid = false;
 	appConfig_.verbose = false;
+	appConfig_.bench = 0;
 
 	for (auto i = 1; i < argc; i++)
 	{
@@ -68,6 +146,16 @@ void ConfigurationManager::parseConfiguration(int argc, char** argv) noexcept
 				case 'd':
 					appConfig_.daemonize = false;
 					break;
+				case 'b':
+					if (i + 1 < argc)
+						appConfig_.bench = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+					break;
+				case '-':
+					if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc)
+						appConfig_.bench = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+					else
+						appConfig_.valid = false;
+					break;
 				default:
 					appConfig_.valid = false;
 			}
@@ -75,19 +163,58 @@ void ConfigurationManager::parseConfiguration(int argc, char** argv) noexcept
 	}
 
 	if (appConfig_.valid == true && appConfig_.config != nullptr)
-	{
-		configurationFile_ = std::make_unique<ConfigurationFileINI>();
-		configurationFile_->parse(appConfig_.config, configuration_);
-	}
+		load(appConfig_.config, configuration_);
 }
 
-void ConfigurationManager::parseFromMemory(std::string& configuration) noexcept
+/**
+* Store the integer in the narrower type.
+* @return False if it does not fit.
+*/
+template<typename T>
+static bool narrow(long long integer, T& value) noexcept
 {
-	std::stringstream ss;
-	ss.str(configuration);
+	if (!std::in_range<T>(integer))
+		return false;
 
+	value = static_cast<T>(integer);
+	return true;
+}
+
+void ConfigurationManager::parseFromMemory(std::string& configuration) noexcept
+{
 	configurationFile_ = std::make_unique<ConfigurationFileINI>();
-	configurationFile_->parse(ss, configuration_);
+	configurationFile_->readText(configuration, [this](std::string_view section, std::string_view key, std::string_view text)
+		{
+			configuration_.add(section, key, text);
+		});
+	configuration_.commit();
+}
+
+bool ConfigurationManager::reload() noexcept
+{
+	if (appConfig_.config == nullptr)
+		return false;
+
+	// Lines with errors are skipped by the parser, so such configuration would silently miss them.
+	Snapshot fresh;
+	if (!load(appConfig_.config, fresh))
+		return false;
+
+	std::swap(configuration_, fresh);
+	previous_ = std::move(fresh);
+	revertible_ = true;
+	return true;
+}
+
+bool ConfigurationManager::revert() noexcept
+{
+	if (!revertible_)
+		return false;
+
+	std::swap(configuration_, previous_);
+	previous_ = Snapshot();
+	revertible_ = false;
+	return true;
 }
 
 
@@ -100,18 +227,179 @@ bool ConfigurationManager::get(const std::string& section, const std::string& ke
 
 bool ConfigurationManager::settingExists(const std::string& section, const std::string& key) noexcept
 {
-	bool exists = true;
+	return find(section, key) != nullptr;
+}
+
+bool ConfigurationManager::getSection(const std::string& section, SectionStructure& values) noexcept
+{
+	const auto* stored = configuration_.values(section);
+
+	if (stored == nullptr)
+		return false;
+
+	values.clear();
+	for (const auto& value : *stored)
+		values.emplace(configuration_.key(value), configuration_.text(value));
+	return true;
+}
+
+bool ConfigurationManager::validate(const std::string& section, const Setting& setting) noexcept
+{
+	const Value* value = find(section, setting.setting_name);
+	if (value == nullptr)
+		return true;
+
+	const char* expected = nullptr;
+	switch (setting.setting_type)
+	{
+		case SettingType::INTEGER:
+			expected = value->is_integer ? nullptr : "an integer"; break;
+		case SettingType::UNSIGNED:
+			expected = value->is_integer && value->integer >= 0 ? nullptr : "a non-negative integer"; break;
+		case SettingType::DOUBLE:
+			expected = value->is_real ? nullptr : "a number"; break;
+		case SettingType::BOOL:
+			expected = value->is_flag ? nullptr : "true or false"; break;
+		default:
+			break;
+	}
+
+	if (expected == nullptr)
+		return true;
+
+	LOG_ERROR("section {}: {} = {} is not {}", section, setting.setting_name, configuration_.text(*value), expected);
+	return false;
+}
+
+bool ConfigurationManager::load(const char* path, Snapshot& snapshot)
+{
+	auto file = std::make_unique<ConfigurationFileINI>();
+	bool read = file->read(path, [&snapshot](std::string_view section, std::string_view key, std::string_view text)
+		{
+			snapshot.add(section, key, text);
+		});
+	snapshot.commit();
+
+	bool valid = read && file->getErrors().empty();
+	configurationFile_ = std::move(file);
+	return valid;
+}
+
+void ConfigurationManager::Snapshot::add(std::string_view section, std::string_view key, std::string_view text)
+{
+	// Parser passes the same view for all keys of the section.
+	if (current_ == nullptr || section.data() != current_name_)
+	{
+		auto it = sections_.find(section);
+		if (it == sections_.end())
+			it = sections_.emplace(std::string(section), std::vector<Value>()).first;
+		current_ = &it->second;
+		current_name_ = section.data();
+		changed_.push_back(current_);
+
+		// Values loaded before are sorted, keys present there are replaced in place.
+		current_sorted_ = std::is_sorted(current_->begin(), current_->end(), strictly_by_key) ? current_->size() : 0;
+	}
+
+	auto name = keys_.find(key);
+	if (name == keys_.end())
+	{
+		name = keys_.emplace(std::string(key), static_cast<uint32_t>(names_.size())).first;
+		names_.push_back(&name->first);
+	}
 
-	try 
+	Value value;
+	value.key = name->second;
+	value.offset = text_.size();
+	value.size = static_cast<uint32_t>(text.size());
+
+	// Parser trims the value, only the first character tells if it may be a number.
+	const char first = text.empty() ? '\0' : text[0];
+	if ((first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.')
+	{
+		value.is_integer = parse_integer(text, value.integer);
+		value.is_real = parse_real(text, value.real);
+	}
+	value.flag = equal_nocase(text, "true") || text == "1";
+	value.is_flag = value.flag || equal_nocase(text, "false") || text == "0";
+
+	text_.append(text);
+	live_ += text.size();
+
+	auto sorted_end = current_->begin() + static_cast<std::ptrdiff_t>(current_sorted_);
+	auto replaced = std::lower_bound(current_->begin(), sorted_end, value.key, [](const Value& value, uint32_t key) { return value.key < key; });
+	if (replaced != sorted_end && replaced->key == value.key)
 	{
-		auto& test = configuration_.at(section).at(key);
+		live_ -= replaced->size;
+		*replaced = value;
 	}
-	catch (std::out_of_range&) 
+	else
+		current_->push_back(value);
+}
+
+void ConfigurationManager::Snapshot::commit()
+{
+	// Text of the value added later is stored later, so it orders values of the same key.
+	auto by_key = [](const Value& left, const Value& right) { return left.key < right.key || (left.key == right.key && left.offset < right.offset); };
+	for (auto* values : changed_)
 	{
-		exists = false;
+		if (std::is_sorted(values->begin(), values->end(), strictly_by_key))
+			continue;
+
+		// Only the last value of the key is kept.
+		std::sort(values->begin(), values->end(), by_key);
+		size_t kept = 0;
+		for (size_t i = 0; i < values->size(); ++i)
+		{
+			if (i + 1 < values->size() && (*values)[i + 1].key == (*values)[i].key)
+			{
+				live_ -= (*values)[i].size;
+				continue;
+			}
+			(*values)[kept++] = (*values)[i];
+		}
+		values->resize(kept);
 	}
 
-	return exists;
+	changed_.clear();
+	current_ = nullptr;
+	current_name_ = nullptr;
+
+	// Texts of the replaced values are dropped once they take most of the buffer.
+	if (text_.size() <= 2 * live_ + 65536)
+		return;
+
+	std::string compacted;
+	compacted.reserve(live_);
+	for (auto& [name, values] : sections_)
+	{
+		for (auto& value : values)
+		{
+			compacted.append(text_, value.offset, value.size);
+			value.offset = compacted.size() - value.size;
+		}
+	}
+	text_.swap(compacted);
+}
+
+const ConfigurationManager::Value* ConfigurationManager::Snapshot::find(std::string_view section, std::string_view key) const noexcept
+{
+	const auto* stored = values(section);
+	if (stored == nullptr)
+		return nullptr;
+
+	auto name = keys_.find(key);
+	if (name == keys_.end())
+		return nullptr;
+
+	auto value = std::lower_bound(stored->begin(), stored->end(), name->second, [](const Value& value, uint32_t key) { return value.key < key; });
+	return value == stored->end() || value->key != name->second ? nullptr : &*value;
+}
+
+const std::vector<ConfigurationManager::Value>* ConfigurationManager::Snapshot::values(std::string_view section) const noexcept
+{
+	auto it = sections_.find(section);
+	return it == sections_.end() ? nullptr : &it->second;
 }
 
 
@@ -125,20 +413,12 @@ bool ConfigurationManager::settingExists(const std::string& section, const std::
 template<>
 bool ConfigurationManager::get(const std::string& section, const std::string& key, bool& value) noexcept
 {
-	bool result = false;
-
-	if (settingExists(section, key))
-	{
-		std::string testVal = configuration_[section][key];
-
-		std::transform(testVal.begin(), testVal.end(), testVal.begin(),
-			[](unsigned char c) { return std::tolower(c); });
+	const Value* found = find(section, key);
+	if (found == nullptr)
+		return false;
 
-		value = (testVal == "true" || testVal == "1");
-		result = true;
-	}
-
-	return result;
+	value = found->flag;
+	return true;
 }
 
 /**
@@ -151,19 +431,16 @@ bool ConfigurationManager::get(const std::string& section, const std::string& ke
 template<>
 bool ConfigurationManager::get(const std::string& section, const std::string& key, int& value) noexcept
 {
-	bool result = false;
+	const Value* found = find(section, key);
+	if (found == nullptr || !found->is_integer)
+		return false;
 
-	try
+	if (!narrow(found->integer, value))
 	{
-		if (settingExists(section, key))
-		{
-			value = static_cast<int>(convertToLongLong(configuration_[section][key]));
-			result = true;
-		}
+		LOG_ERROR("section {}: {} = {} is out of range", section, key, found->integer);
+		return false;
 	}
-	catch (std::runtime_error&) {}
-
-	return result;
+	return true;
 }
 
 /**
@@ -176,24 +453,21 @@ bool ConfigurationManager::get(const std::string& section, const std::string& ke
 template<>
 bool ConfigurationManager::get(const std::string& section, const std::string& key, long& value) noexcept
 {
-	bool result = false;
+	const Value* found = find(section, key);
+	if (found == nullptr || !found->is_integer)
+		return false;
 
-	try
+	if (!narrow(found->integer, value))
 	{
-		if (settingExists(section, key))
-		{
-			value = static_cast<long>(convertToLongLong(configuration_[section][key]));
-			result = true;
-		}
+		LOG_ERROR("section {}: {} = {} is out of range", section, key, found->integer);
+		return false;
 	}
-	catch (std::runtime_error&) { }
-
-	return result;
+	return true;
 }
 
 
 /**
-* Get the value from specified key and section - long version.
+* Get the value from specified key and section - size_t version.
 * @param[in] section section to get key from
 * @param[in] key key to find
 * @param[out] value place to store the value
@@ -202,19 +476,16 @@ bool ConfigurationManager::get(const std::string& section, const std::string& ke
 template<>
 bool ConfigurationManager::get(const std::string& section, const std::string& key, size_t& value) noexcept
 {
-	bool result = false;
+	const Value* found = find(section, key);
+	if (found == nullptr || !found->is_integer)
+		return false;
 
-	try
+	if (!narrow(found->integer, value))
 	{
-		if (settingExists(section, key))
-		{
-			value = static_cast<long>(convertToLongLong(configuration_[section][key]));
-			result = true;
-		}
+		LOG_ERROR("section {}: {} = {} is out of range", section, key, found->integer);
+		return false;
 	}
-	catch (std::runtime_error&) {}
-
-	return result;
+	return true;
 }
 
 /**
@@ -227,19 +498,12 @@ bool ConfigurationManager::get(const std::string& section, const std::string& ke
 template<>
 bool ConfigurationManager::get(const std::string& section, const std::string& key, double& value) noexcept
 {
-	bool result = false;
+	const Value* found = find(section, key);
+	if (found == nullptr || !found->is_real)
+		return false;
 
-	try
-	{
-		if (settingExists(section, key))
-		{
-			value = convertToDouble(configuration_[section][key]);
-			result = true;
-		}
-	}
-	catch (std::runtime_error&) {}
-
-	return result;
+	value = found->real;
+	return true;
 }
 
 /**
@@ -252,37 +516,30 @@ bool ConfigurationManager::get(const std::string& section, const std::string& ke
 template<>
 bool ConfigurationManager::get(const std::string& section, const std::string& key, std::string& value) noexcept
 {
-	bool result = false;
+	const Value* found = find(section, key);
+	if (found == nullptr)
+		return false;
 
-	if (settingExists(section, key))
-	{
-		value = configuration_[section][key];
-		result = true;
-	}
-
-	return result;
+	value = configuration_.text(*found);
+	return true;
 }
 
 
 long long convertToLongLong(const std::string& value)
 {
-	std::smatch matcher;
-	std::regex  numberRegex(R"~(^\s*([+-]?\d+)\s*$)~");
+	long long result;
 
-	if (std::regex_match(value, matcher, numberRegex))
-		return std::strtoll(matcher[1].str().c_str(), nullptr, 10);
-	else
+	if (!parse_integer(value, result))
 		throw std::runtime_error("bad conversion");
+	return result;
 }
 
 
 double convertToDouble(const std::string& value)
 {
-	std::smatch matcher;
-	std::regex  numberRegex(R"~(^\s*([+-]?(\d+([.]\d*)?([eE][+-]?\d+)?|[.]\d+([eE][+-]?\d+)?))\s*$)~");;
+	double result;
 
-	if (std::regex_match(value, matcher, numberRegex))
-		return static_cast<double>(std::strtold(matcher[1].str().c_str(), nullptr));
-	else
+	if (!parse_real(value, result))
 		throw std::runtime_error("bad conversion");
+	return result;
 }
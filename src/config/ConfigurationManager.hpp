@@ -11,10 +11,15 @@
 #define SRC_CONFIGURATIONMANAGER_HPP_
 
 #include "ConfigurationFile.hpp"
+#include "core/Configurable.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 typedef struct {
 	bool verbose;
@@ -22,20 +27,28 @@ typedef struct {
 	bool help;
 	bool valid;
 	const char* config;
+	unsigned int bench;			/*!< Benchmark duration in seconds (0 - normal run) */
 } AppConfig;
 
 /**
 * Configuration manager class that is responsible for handling application settings. Parses
 * command line arguments and if needed manages parsing file with configuration.
+* Every value is converted to all supported types once, when the configuration is loaded - get()
+* is a single lookup that does not parse anything. Integers that do not fit the requested type
+* are rejected, not truncated. parseFromMemory() merges the new values into the loaded
+* configuration, reload() replaces it as a whole.
+* Values are read straight from the parser views - names of the keys are interned and texts of
+* the values are copied into one buffer, so loading does not allocate per value.
 * Implements singleton pattern as there is always only one, global configuration. 
 * This implementation follow the exception described in:
 * https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#Ri-singleton
 */
 class ConfigurationManager
 {
-	typedef std::unordered_map<std::string, std::unordered_map<std::string, std::string>> ConfigurationStructure;
-
 public:
+	typedef std::unordered_map<std::string, std::string> SectionStructure;
+	typedef std::unordered_map<std::string, SectionStructure> ConfigurationStructure;
+
 	ConfigurationManager(ConfigurationManager const&) = delete;
 	void operator=(ConfigurationManager const&) = delete;
 	~ConfigurationManager() { }
@@ -59,12 +72,26 @@ public:
 
 
 	/**
-	* Parse configuration passed as string.
-	* @param[in] argc argument count
-	* @param[in] argv pointer to c-like strings containing arguments
+	* Parse configuration passed as string and merge it into the current one - values of the
+	* keys present in both are replaced.
+	* @param[in] configuration configuration text in the INI format
 	*/
 	void parseFromMemory(std::string& configuration) noexcept;
 
+	/**
+	* Parse configuration file given in the command line once again. Current configuration
+	* is replaced only if the file could be read and had no errors.
+	* @return True if configuration has been reloaded, otherwise false.
+	*/
+	bool reload() noexcept;
+
+	/**
+	* Bring back the configuration replaced by the last successful reload(), eg. when it could
+	* not be applied.
+	* @return True if configuration has been reverted, false if there was nothing to revert.
+	*/
+	bool revert() noexcept;
+
 	/**
 	* Get the value from specified key and section - generic version.
 	* @param[in] section section to get key from
@@ -82,6 +109,41 @@ public:
 	*/
 	bool settingExists(const std::string& section, const std::string& key) noexcept;
 
+	/**
+	* Get all key=value pairs stored under given section.
+	* @param[in] section section to get
+	* @param[out] values place to store the section content
+	* @return True if section exists, otherwise false.
+	*/
+	bool getSection(const std::string& section, SectionStructure& values) noexcept;
+
+	/**
+	* Check that values present in the section have types declared by the module reading it.
+	* Every value that does not match its type is reported.
+	* @param[in] section section to check
+	* @param[in] schema settings of the module
+	* @return True if all values are valid, otherwise false.
+	*/
+	template<typename Label>
+	bool validate(const std::string& section, const std::unordered_map<Label, Setting>& schema) noexcept
+	{
+		bool valid = true;
+		for (const auto& [label, setting] : schema)
+		{
+			if (!validate(section, setting))
+				valid = false;
+		}
+		return valid;
+	}
+
+	/**
+	* Check that value of the setting (if present in the section) has the declared type.
+	* @param[in] section section to check
+	* @param[in] setting name and type of the setting
+	* @return True if value is valid or not present, otherwise false.
+	*/
+	bool validate(const std::string& section, const Setting& setting) noexcept;
+
 	/**
 	* Get application configuration.
 	*/
@@ -91,10 +153,120 @@ public:
 	}
 
 private:
+	/**
+	* Value of the setting with its conversions done at load. Text of the value is kept by the snapshot.
+	*/
+	struct Value
+	{
+		uint32_t key{ 0 };						/*!< Interned name of the key */
+		uint32_t size{ 0 };						/*!< Size of the text */
+		size_t offset{ 0 };						/*!< Offset of the text in the snapshot */
+		long long integer{ 0 };
+		double real{ 0.0 };
+		bool flag{ false };						/*!< Value read as bool - true only for "true" and "1" */
+		bool is_integer{ false };
+		bool is_real{ false };
+		bool is_flag{ false };					/*!< Value is one of true/false/1/0 */
+	};
+
+	/**
+	* Hash of the names that lets them be looked up by a view, without making a string.
+	*/
+	struct NameHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view name) const noexcept
+		{
+			return std::hash<std::string_view>{}(name);
+		}
+	};
+
+	template<typename T>
+	using NameMap = std::unordered_map<std::string, T, NameHash, std::equal_to<>>;
+
+	/**
+	* Loaded configuration. Names of the keys are interned, values of every section are kept sorted
+	* by the key and their texts are stored one after another in a single buffer.
+	*/
+	class Snapshot
+	{
+	public:
+		/**
+		* Convert the value and add it to the section, replacing the value of the same key.
+		*/
+		void add(std::string_view section, std::string_view key, std::string_view text);
+
+		/**
+		* Finish adding - sort changed sections, drop replaced values and compact the text buffer.
+		*/
+		void commit();
+
+		/**
+		* Find the value.
+		* @return Pointer to the value or nullptr if not present.
+		*/
+		const Value* find(std::string_view section, std::string_view key) const noexcept;
+
+		/**
+		* Find values of the section.
+		* @return Pointer to the values or nullptr if section is not present.
+		*/
+		const std::vector<Value>* values(std::string_view section) const noexcept;
+
+		std::string_view text(const Value& value) const noexcept
+		{
+			return std::string_view(text_).substr(value.offset, value.size);
+		}
+
+		const std::string& key(const Value& value) const noexcept
+		{
+			return *names_[value.key];
+		}
+
+	private:
+		/**
+		* Order of the values without repeated keys (for std::is_sorted()).
+		*/
+		static bool strictly_by_key(const Value& left, const Value& right) noexcept
+		{
+			return left.key <= right.key;
+		}
+
+		NameMap<uint32_t> keys_;								/*!< Interned names of the keys */
+		std::vector<const std::string*> names_;					/*!< Names of the interned keys */
+		NameMap<std::vector<Value>> sections_;
+		std::string text_;										/*!< Texts of all values */
+		size_t live_{ 0 };										/*!< Size of the texts of not replaced values */
+
+		std::vector<Value>* current_{ nullptr };				/*!< Section of the last add() */
+		const char* current_name_{ nullptr };					/*!< Name of that section as passed to add() */
+		size_t current_sorted_{ 0 };							/*!< Values of that section sorted before add() */
+		std::vector<std::vector<Value>*> changed_;				/*!< Sections changed since the last commit() */
+	};
+
 	ConfigurationManager() { }
+
+	/**
+	* Read the configuration file into the snapshot.
+	* @return True if file was read and had no errors.
+	*/
+	bool load(const char* path, Snapshot& snapshot);
+
+	/**
+	* Find the value.
+	* @return Pointer to the value or nullptr if not present.
+	*/
+	const Value* find(const std::string& section, const std::string& key) const noexcept
+	{
+		return configuration_.find(section, key);
+	}
+
 	std::unique_ptr<ConfigurationFile> configurationFile_;
-	ConfigurationStructure configuration_;
-	AppConfig appConfig_ {false, true, true, false, nullptr};
+	Snapshot configuration_;
+	Snapshot previous_;											/*!< Configuration replaced by the last reload() */
+	bool revertible_{ false };
+	AppConfig appConfig_ {false, true, true, false, nullptr, 0};
 };
 
 
@@ -77,6 +77,14 @@ public:
 		return size_.load(std::memory_order::seq_cst);
 	}
 
+	/**
+	* Get the highest size the queue ever had.
+	* @return Queue high-water mark.
+	*/
+	size_t high_water() const noexcept {
+		return max_size_.load(std::memory_order::relaxed);
+	}
+
 	/**
 	* Return front queue element. 
 	* @return Pointer to front queue element.
@@ -122,7 +130,7 @@ public:
 		else
 			head_.store(new_node, std::memory_order::seq_cst);
 		tail_.store(new_node, std::memory_order::seq_cst);
-		size_.fetch_add(1);
+		update_high_water(size_.fetch_add(1) + 1);
 		
 		//while (!tail_.compare_exchange_weak(new_node->next, new_node, std::memory_order_release, std::memory_order_relaxed)) {
 		//	std::this_thread::yield();
@@ -142,7 +150,7 @@ public:
 		else
 			head_.store(new_node, std::memory_order::seq_cst);
 		tail_.store(new_node, std::memory_order::seq_cst);
-		size_.fetch_add(1);
+		update_high_water(size_.fetch_add(1) + 1);
 	}
 
 	/**
@@ -187,9 +195,19 @@ public:
 	}
 
 private:
+	/**
+	* Update high-water mark with the current size.
+	* @param[in] size size after push
+	*/
+	void update_high_water(size_t size) noexcept {
+		auto current = max_size_.load(std::memory_order::relaxed);
+		while (size > current && !max_size_.compare_exchange_weak(current, size, std::memory_order::relaxed)) { }
+	}
+
 	std::atomic<QueueNode<T>*> head_;					/*!< Queue head */
 	std::atomic<QueueNode<T>*> tail_;					/*!< Queue tail */
 	std::atomic<size_t> size_;							/*!< Queue size */
+	std::atomic<size_t> max_size_{ 0 };					/*!< Highest size ever reached */
 
 	std::mutex to_remove_mutex_;						/*!< Mutex to be removed when queue will be fully lock-free */
 };
\ No newline at end of file
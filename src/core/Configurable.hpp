@@ -19,6 +19,7 @@ enum class SettingType
 	UNKNOWN,
 	STRING,
 	INTEGER,
+	UNSIGNED,				/*!< Integer that can not be negative (sizes, intervals) */
 	DOUBLE,
 	BOOL
 };
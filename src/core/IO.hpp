@@ -19,7 +19,10 @@
 #include "Global.h"
 #include "IOconfiguration.hpp"
 #include "Configurable.hpp"
+#include "Metrics.hpp"
 
+#include <cerrno>
+#include <cstdint>
 #include <cstdlib>
 #include <string>
 #include <functional>
@@ -99,6 +102,26 @@ public:
 	*/
 	virtual ssize_t write(const std::vector<char>& buffer, size_t writeMax = 0) = 0;
 
+	/**
+	* Wake up read() waiting for more data, it returns 0 as at the end of the stream. Used to stop
+	* reading streams that wait for data instead of ending. Default implementation does nothing.
+	*/
+	virtual void cancel() { }
+
+	/**
+	* Make data written so far durable. Default implementation has nothing to flush.
+	* @return 0 if successful, otherwise negative info with error code.
+	*/
+	virtual int sync() { return 0; }
+
+	/**
+	* Continue at the given position of the stream after restart - input skips data read before,
+	* output drops everything written after it. Must be called before open().
+	* @param[in] position offset from the beginning of the stream
+	* @return 0 if successful, -ENOTSUP if stream has no positions, otherwise negative error code.
+	*/
+	virtual int resume(uint64_t) { return -ENOTSUP; }
+
 	/**
 	* Async read method. Takes reference to buffer and two optional parameters - max read chars 
 	* (readMax <= buffer.max_size()) and rxCallback. If no callback is given then it is used default one
@@ -156,6 +179,18 @@ public:
 		return configuration_;
 	}
 
+	/**
+	* Get metrics of the IO operations.
+	* @return Reference to IO metrics.
+	*/
+	const IOMetrics& getMetrics() const
+	{
+		return metrics_;
+	}
+
+protected:
+	IOMetrics metrics_;							/*!< Counts and durations of the IO operations */
+
 private:
 	/**
 	* Helper method to async reading.
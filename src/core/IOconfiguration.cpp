@@ -35,16 +35,16 @@ static const std::unordered_map<SettingLabel, Setting> SETTINGS(
 
 	{SettingLabel::DIRECTION, {"direction", SettingType::STRING}},
 	{SettingLabel::BINARY, {"binary", SettingType::BOOL}},
-	{SettingLabel::READ_CHUNK_MIN, {"read_chunk_min", SettingType::INTEGER}},
-	{SettingLabel::READ_CHUNK_MAX, {"read_chunk_max", SettingType::INTEGER}},
-	{SettingLabel::WRITE_CHUNK_MIN, {"write_chunk_min", SettingType::INTEGER}},
-	{SettingLabel::WRITE_CHUNK_MAX, {"write_chunk_max", SettingType::INTEGER}},
+	{SettingLabel::READ_CHUNK_MIN, {"read_chunk_min", SettingType::UNSIGNED}},
+	{SettingLabel::READ_CHUNK_MAX, {"read_chunk_max", SettingType::UNSIGNED}},
+	{SettingLabel::WRITE_CHUNK_MIN, {"write_chunk_min", SettingType::UNSIGNED}},
+	{SettingLabel::WRITE_CHUNK_MAX, {"write_chunk_max", SettingType::UNSIGNED}},
 	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
 });
 
 bool IOconfiguration::configure(ConfigurationManager& config, const std::string& section)
 {
-	bool configurationCorrect = true;
+	bool configurationCorrect = config.validate(section, SETTINGS);
 	std::string direction{};
 
 	config.get(section, SETTINGS.at(SettingLabel::NAME).setting_name, name_);
@@ -0,0 +1,334 @@
+/**
+ *  @file   Journal.cpp
+ *  @brief  Durable journal of the pipeline positions.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Journal.hpp"
+#include "transform/Crc.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if defined(SWPL_SYSTEM_HAVE_UNISTD_H) && defined(SWPL_SYSTEM_HAVE_FCNTL_H)
+#define SWPL_JOURNAL_FILE
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+* Record: payload size (4 bytes LE), CRC32C of the payload (4 bytes LE), payload - position value
+* (8 bytes LE) followed by its name.
+*/
+static constexpr size_t VALUE_SIZE = 8;
+
+static const Crc CRC{ Crc::Algorithm::CRC32C };
+
+static void write_le(uint8_t* at, uint64_t value, size_t size) noexcept
+{
+	for (size_t i = 0; i < size; ++i)
+		at[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static uint64_t read_le(const uint8_t* at, size_t size) noexcept
+{
+	uint64_t value = 0;
+	for (size_t i = size; i > 0; --i)
+		value = (value << 8) | at[i - 1];
+	return value;
+}
+
+#if defined(SWPL_JOURNAL_FILE)
+static bool write_all(int fd, const uint8_t* data, size_t size)
+{
+	while (size > 0)
+	{
+		auto written = ::write(fd, data, size);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += written;
+		size -= static_cast<size_t>(written);
+	}
+	return true;
+}
+
+static int data_sync(int fd)
+{
+#if defined(__APPLE__)
+	return ::fsync(fd);
+#else
+	return ::fdatasync(fd);
+#endif
+}
+#endif
+
+Journal::~Journal()
+{
+	close();
+}
+
+bool Journal::open()
+{
+	close();
+
+#if defined(SWPL_JOURNAL_FILE)
+	fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (fd_ < 0)
+	{
+		LOG_ERROR("cannot open journal {}: {}", path_, errno);
+		return false;
+	}
+
+	std::vector<uint8_t> content;
+	std::vector<uint8_t> chunk(1 << 16);
+	for (;;)
+	{
+		auto got = ::read(fd_, chunk.data(), chunk.size());
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got < 0)
+		{
+			LOG_ERROR("cannot read journal {}: {}", path_, errno);
+			close();
+			return false;
+		}
+		if (got == 0)
+			break;
+		content.insert(content.end(), chunk.begin(), chunk.begin() + got);
+	}
+
+	std::scoped_lock lock{ mutex_ };
+	positions_.clear();
+	pending_.clear();
+	tickets_ = durable_ = commits_ = 0;
+	committing_ = broken_ = false;
+
+	file_size_ = replay(content);
+	if (file_size_ < content.size())
+	{
+		// Crash during the write leaves torn record at the end - records appended after it would never be read.
+		LOG_WARNING("journal {}: {} bytes of broken records cut off", path_, content.size() - file_size_);
+		if (::ftruncate(fd_, static_cast<off_t>(file_size_)) != 0 || data_sync(fd_) != 0)
+		{
+			LOG_ERROR("cannot truncate journal {}: {}", path_, errno);
+			::close(fd_);
+			fd_ = -1;
+			return false;
+		}
+	}
+
+	return true;
+#else
+	LOG_ERROR("journal {} is not supported on this platform", path_);
+	return false;
+#endif
+}
+
+void Journal::close()
+{
+#if defined(SWPL_JOURNAL_FILE)
+	if (fd_ >= 0)
+		::close(fd_);
+#endif
+	fd_ = -1;
+}
+
+bool Journal::get(const std::string& key, uint64_t& value) const
+{
+	std::scoped_lock lock{ mutex_ };
+
+	auto it = positions_.find(key);
+	if (it == positions_.end())
+		return false;
+
+	value = it->second;
+	return true;
+}
+
+uint64_t Journal::set(const std::string& key, uint64_t value)
+{
+	std::scoped_lock lock{ mutex_ };
+
+	positions_[key] = value;
+	encode(pending_, key, value);
+	return ++tickets_;
+}
+
+bool Journal::sync(uint64_t ticket)
+{
+	std::unique_lock lock{ mutex_ };
+	std::vector<uint8_t> batch;
+
+	while (durable_ < ticket && !broken_)
+	{
+		if (committing_)
+		{
+			synced_.wait(lock);
+			continue;
+		}
+
+		// This caller writes the batch for everybody who is waiting, others wait for it.
+		committing_ = true;
+		batch.clear();
+		batch.swap(pending_);
+		const auto last = tickets_;
+
+		uint64_t live = 0;
+		for (const auto& [key, value] : positions_)
+			live += HEADER_SIZE + VALUE_SIZE + key.size();
+
+		// Values in memory already include the batch, so compacted file replaces it too.
+		const bool compacting = file_size_ + batch.size() > COMPACT_SIZE && file_size_ + batch.size() > 4 * live;
+		if (compacting)
+		{
+			batch.clear();
+			for (const auto& [key, value] : positions_)
+				encode(batch, key, value);
+		}
+
+		lock.unlock();
+		bool written = compacting ? compact(batch) : commit(batch);
+		lock.lock();
+
+		committing_ = false;
+		if (written)
+		{
+			file_size_ = compacting ? batch.size() : file_size_ + batch.size();
+			durable_ = last;
+			++commits_;
+		}
+		else
+		{
+			broken_ = true;
+		}
+		synced_.notify_all();
+	}
+
+	return durable_ >= ticket;
+}
+
+bool Journal::sync()
+{
+	uint64_t ticket;
+	{
+		std::scoped_lock lock{ mutex_ };
+		ticket = tickets_;
+	}
+	return sync(ticket);
+}
+
+uint64_t Journal::getCommits() const
+{
+	std::scoped_lock lock{ mutex_ };
+	return commits_;
+}
+
+uint64_t Journal::getFileSize() const
+{
+	std::scoped_lock lock{ mutex_ };
+	return file_size_;
+}
+
+bool Journal::sync_file(const std::string& path)
+{
+#if defined(SWPL_JOURNAL_FILE)
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	bool synced = data_sync(fd) == 0;
+	::close(fd);
+	return synced;
+#else
+	return false;
+#endif
+}
+
+void Journal::encode(std::vector<uint8_t>& buffer, const std::string& key, uint64_t value)
+{
+	const size_t at = buffer.size();
+	const size_t size = VALUE_SIZE + key.size();
+
+	buffer.resize(at + HEADER_SIZE + size);
+	uint8_t* record = buffer.data() + at;
+
+	write_le(record, size, 4);
+	write_le(record + HEADER_SIZE, value, VALUE_SIZE);
+	std::memcpy(record + HEADER_SIZE + VALUE_SIZE, key.data(), key.size());
+	write_le(record + 4, CRC.compute(record + HEADER_SIZE, size), 4);
+}
+
+uint64_t Journal::replay(const std::vector<uint8_t>& content)
+{
+	size_t pos = 0;
+
+	while (content.size() - pos >= HEADER_SIZE)
+	{
+		const uint8_t* record = content.data() + pos;
+		auto size = read_le(record, 4);
+
+		if (size < VALUE_SIZE || content.size() - pos - HEADER_SIZE < size)
+			break;
+		if (CRC.compute(record + HEADER_SIZE, size) != read_le(record + 4, 4))
+			break;
+
+		auto key = reinterpret_cast<const char*>(record + HEADER_SIZE + VALUE_SIZE);
+		positions_[std::string(key, size - VALUE_SIZE)] = read_le(record + HEADER_SIZE, VALUE_SIZE);
+		pos += HEADER_SIZE + size;
+	}
+
+	return pos;
+}
+
+bool Journal::commit(const std::vector<uint8_t>& buffer)
+{
+#if defined(SWPL_JOURNAL_FILE)
+	if (fd_ >= 0 && write_all(fd_, buffer.data(), buffer.size()) && data_sync(fd_) == 0)
+		return true;
+
+	LOG_ERROR("cannot write journal {}: {}", path_, errno);
+#endif
+	return false;
+}
+
+bool Journal::compact(const std::vector<uint8_t>& buffer)
+{
+#if defined(SWPL_JOURNAL_FILE)
+	const std::string temporary = path_ + ".tmp";
+
+	int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	if (fd >= 0 && write_all(fd, buffer.data(), buffer.size()) && data_sync(fd) == 0
+		&& ::rename(temporary.c_str(), path_.c_str()) == 0)
+	{
+		// Renamed file survives the crash only after its directory is synced.
+		auto directory = std::filesystem::path(path_).parent_path();
+		int dir = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+		if (dir >= 0)
+		{
+			::fsync(dir);
+			::close(dir);
+		}
+
+		::close(fd_);
+		fd_ = fd;
+		return true;
+	}
+
+	LOG_ERROR("cannot compact journal {}: {}", path_, errno);
+	if (fd >= 0)
+	{
+		::close(fd);
+		std::remove(temporary.c_str());
+	}
+#endif
+	return false;
+}
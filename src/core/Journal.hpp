@@ -0,0 +1,141 @@
+/**
+ *  @file   Journal.hpp
+ *  @brief  Durable journal of the pipeline positions.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Journal keeps named 64-bit positions (input offsets, output sizes) in an append-only file. Every
+ *  change is a small record with its own checksum - on open the file is replayed and a torn record
+ *  left by a crash is cut off, so the last durable value of every position is recovered.
+ *
+ *  Changes become durable in batches - set() only queues the record and sync() makes the caller
+ *  wait until it is on the disk. The first waiter writes everything queued so far and calls
+ *  fdatasync() once for the whole batch, others wait for it (group commit). When the file grows
+ *  much larger than the live positions, it is rewritten with the current values only.
+ */
+
+#ifndef SRC_CORE_JOURNAL_HPP_
+#define SRC_CORE_JOURNAL_HPP_
+
+#include "Global.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Journal
+{
+public:
+	/**
+	* Create journal stored in the given file. File is not touched until open().
+	* @param[in] path path of the journal file
+	*/
+	explicit Journal(std::string path) : path_{ std::move(path) } { }
+	~Journal();
+
+	Journal(const Journal&) = delete;
+	Journal& operator=(const Journal&) = delete;
+
+	/**
+	* Open (or create) the journal file and recover positions stored there.
+	* @return True if journal can be used.
+	*/
+	bool open();
+
+	/**
+	* Close the journal file. Changes not synced are lost.
+	*/
+	void close();
+
+	/**
+	* Get recovered or last set value of the position.
+	* @param[in] key name of the position
+	* @param[out] value value of the position
+	* @return True if position is known.
+	*/
+	bool get(const std::string& key, uint64_t& value) const;
+
+	/**
+	* Change the position. Change is durable after sync() with the returned ticket.
+	* @param[in] key name of the position
+	* @param[in] value new value
+	* @return Ticket of the change.
+	*/
+	uint64_t set(const std::string& key, uint64_t value);
+
+	/**
+	* Wait until the change with the given ticket (and all before it) is on the disk.
+	* @param[in] ticket value returned by set()
+	* @return False if journal could not be written.
+	*/
+	bool sync(uint64_t ticket);
+
+	/**
+	* Wait until all changes set so far are on the disk.
+	* @return False if journal could not be written.
+	*/
+	bool sync();
+
+	/**
+	* Get number of batches written (each one costs single fdatasync).
+	*/
+	uint64_t getCommits() const;
+
+	/**
+	* Get size of the journal file in bytes.
+	*/
+	uint64_t getFileSize() const;
+
+	/**
+	* Flush data of the file to the disk.
+	* @param[in] path path of the file
+	* @return True if data is durable.
+	*/
+	static bool sync_file(const std::string& path);
+
+private:
+	static constexpr size_t HEADER_SIZE = 8;			/*!< Record size and checksum */
+	static constexpr uint64_t COMPACT_SIZE = 1 << 20;	/*!< File is not compacted below that size */
+
+	/**
+	* Append record of the change to the buffer.
+	*/
+	static void encode(std::vector<uint8_t>& buffer, const std::string& key, uint64_t value);
+
+	/**
+	* Read records from the beginning of the file.
+	* @return Size of the valid part of the file.
+	*/
+	uint64_t replay(const std::vector<uint8_t>& content);
+
+	/**
+	* Write buffer at the end of the file and make it durable.
+	*/
+	bool commit(const std::vector<uint8_t>& buffer);
+
+	/**
+	* Replace the file with the one holding only the records of the current values.
+	*/
+	bool compact(const std::vector<uint8_t>& buffer);
+
+	std::string path_;
+	int fd_{ -1 };
+	uint64_t file_size_{ 0 };
+
+	mutable std::mutex mutex_;
+	std::condition_variable synced_;
+	std::unordered_map<std::string, uint64_t> positions_;
+	std::vector<uint8_t> pending_;						/*!< Records waiting for the next batch */
+	uint64_t tickets_{ 0 };								/*!< Last ticket given */
+	uint64_t durable_{ 0 };								/*!< Last ticket on the disk */
+	uint64_t commits_{ 0 };
+	bool committing_{ false };							/*!< Batch is being written by some caller */
+	bool broken_{ false };
+};
+
+#endif /* SRC_CORE_JOURNAL_HPP_ */
@@ -0,0 +1,69 @@
+/**
+ *  @file   Metrics.cpp
+ *  @brief  Low-overhead instrumentation primitives.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Metrics.hpp"
+
+#include <bit>
+
+unsigned int LatencyHistogram::bucket_index(uint64_t value) noexcept
+{
+	if (value < SUB_BUCKETS)
+		return static_cast<unsigned int>(value);
+
+	unsigned int shift = static_cast<unsigned int>(63 - std::countl_zero(value)) - SUB_BUCKET_BITS;
+	return ((shift + 1) << SUB_BUCKET_BITS) + static_cast<unsigned int>((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t LatencyHistogram::bucket_lower(unsigned int bucket) noexcept
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	unsigned int shift = (bucket >> SUB_BUCKET_BITS) - 1;
+	return static_cast<uint64_t>(SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper(unsigned int bucket) noexcept
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	unsigned int shift = (bucket >> SUB_BUCKET_BITS) - 1;
+	return bucket_lower(bucket) + ((uint64_t{ 1 } << shift) - 1);
+}
+
+uint64_t LatencyHistogram::quantile(double quantile) const noexcept
+{
+	uint64_t total = 0;
+
+	for (unsigned int i = 0; i < BUCKETS; ++i)
+		total += count(i);
+
+	if (total == 0)
+		return 0;
+
+	if (quantile < 0.0)
+		quantile = 0.0;
+	if (quantile > 1.0)
+		quantile = 1.0;
+
+	auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total));
+	if (rank == 0)
+		rank = 1;
+
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < BUCKETS; ++i)
+	{
+		seen += count(i);
+		if (seen >= rank)
+			return bucket_upper(i);
+	}
+
+	return bucket_upper(BUCKETS - 1);
+}
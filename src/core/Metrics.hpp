@@ -0,0 +1,392 @@
+/**
+ *  @file   Metrics.hpp
+ *  @brief  Low-overhead instrumentation primitives.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Counters have cache-line sized slots owned by the calling thread, so hot paths executed
+ *  concurrently neither bounce the same cache line nor need locked instructions. Value is
+ *  aggregated only when it is read. Histograms are log-bucketed (HDR-style): every power of two range is split into a fixed
+ *  number of linear sub-buckets which gives constant relative precision over the whole range.
+ *
+ *  Whole instrumentation can be compiled out with SWPL_ENABLE_METRICS switched off - all recording
+ *  methods become empty then.
+ */
+
+#ifndef SRC_CORE_METRICS_HPP_
+#define SRC_CORE_METRICS_HPP_
+
+#include "Global.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+/**
+* Get timestamp used for measuring durations.
+* @return Monotonic time in nanoseconds or 0 if metrics are disabled.
+*/
+inline uint64_t metrics_clock() noexcept
+{
+#if defined(SWPL_ENABLE_METRICS)
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+	return 0;
+#endif
+}
+
+/**
+* Latency of every LATENCY_SAMPLE_RATE-th message (per thread) is measured. Reading the clock
+* costs more than the rest of the queue instrumentation, sampling keeps the overhead negligible
+* while histograms still get plenty of values.
+*/
+static constexpr unsigned int LATENCY_SAMPLE_RATE = 64;
+
+/**
+* Get timestamp for the sampled latency measurement.
+* @return metrics_clock() for every LATENCY_SAMPLE_RATE-th call in the thread, otherwise 0.
+*/
+inline uint64_t metrics_sample_clock() noexcept
+{
+#if defined(SWPL_ENABLE_METRICS)
+	thread_local unsigned int calls = 0;
+	if ((++calls & (LATENCY_SAMPLE_RATE - 1)) != 0)
+		return 0;
+#endif
+	return metrics_clock();
+}
+
+/**
+* Small, dense index of the current thread. Indexes of finished threads are reused, so
+* long running application that creates and destroys threads keeps indexes low.
+*/
+class ThreadIndex
+{
+public:
+	/**
+	* Get index of the calling thread.
+	* @return Thread index.
+	*/
+	static unsigned int current() noexcept {
+		thread_local unsigned int index = UNASSIGNED;			// Trivial thread_local - no init guard on the hot path.
+		if (index == UNASSIGNED)
+			index = assign();
+		return index;
+	}
+
+private:
+	static constexpr unsigned int UNASSIGNED = ~0u;
+
+	static unsigned int assign() {
+		thread_local Holder holder;
+		return holder.index;
+	}
+
+	struct Holder
+	{
+		Holder() {
+			std::scoped_lock lock{ mutex() };
+			if (free().empty()) {
+				index = next()++;
+			}
+			else {
+				index = free().back();
+				free().pop_back();
+			}
+		}
+
+		~Holder() {
+			std::scoped_lock lock{ mutex() };
+			free().push_back(index);
+		}
+
+		unsigned int index{ 0 };
+	};
+
+	static std::mutex& mutex() { static std::mutex m; return m; }
+	static std::vector<unsigned int>& free() { static std::vector<unsigned int> f; return f; }
+	static unsigned int& next() { static unsigned int n = 0; return n; }
+};
+
+/**
+* Monotonic counter with per-thread slots. First SLOTS threads own their slot exclusively
+* and update it without any read-modify-write instruction, remaining threads share atomic
+* overflow slot. Value is aggregated only when read.
+*/
+class Counter
+{
+public:
+	static constexpr unsigned int SLOTS = 16;
+
+	/**
+	* Add value to the counter.
+	* @param[in] value value to add
+	*/
+	void add(uint64_t value = 1) noexcept {
+#if defined(SWPL_ENABLE_METRICS)
+		auto index = ThreadIndex::current();
+		if (index < SLOTS) {
+			auto& slot = slots_[index].value;
+			slot.store(slot.load(std::memory_order::relaxed) + value, std::memory_order::relaxed);
+		}
+		else {
+			overflow_.value.fetch_add(value, std::memory_order::relaxed);
+		}
+#endif
+	}
+
+	/**
+	* Get counter value aggregated from all the slots.
+	* @return Counter value.
+	*/
+	uint64_t value() const noexcept {
+		uint64_t sum = overflow_.value.load(std::memory_order::relaxed);
+		for (const auto& slot : slots_)
+			sum += slot.value.load(std::memory_order::relaxed);
+		return sum;
+	}
+
+private:
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> value{ 0 };
+	};
+
+	Slot slots_[SLOTS];
+	Slot overflow_;
+};
+
+/**
+* Pair of counters - messages and bytes - kept in the same per-thread slot, so both are
+* updated with a single slot lookup.
+*/
+class TrafficCounter
+{
+public:
+	/**
+	* Account single message.
+	* @param[in] bytes size of the message
+	*/
+	void add(uint64_t bytes) noexcept {
+#if defined(SWPL_ENABLE_METRICS)
+		auto index = ThreadIndex::current();
+		if (index < Counter::SLOTS) {
+			auto& slot = slots_[index];
+			slot.messages.store(slot.messages.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+			slot.bytes.store(slot.bytes.load(std::memory_order::relaxed) + bytes, std::memory_order::relaxed);
+		}
+		else {
+			overflow_.messages.fetch_add(1, std::memory_order::relaxed);
+			overflow_.bytes.fetch_add(bytes, std::memory_order::relaxed);
+		}
+#endif
+	}
+
+	/**
+	* Get number of messages.
+	*/
+	uint64_t messages() const noexcept {
+		uint64_t sum = overflow_.messages.load(std::memory_order::relaxed);
+		for (const auto& slot : slots_)
+			sum += slot.messages.load(std::memory_order::relaxed);
+		return sum;
+	}
+
+	/**
+	* Get number of bytes.
+	*/
+	uint64_t bytes() const noexcept {
+		uint64_t sum = overflow_.bytes.load(std::memory_order::relaxed);
+		for (const auto& slot : slots_)
+			sum += slot.bytes.load(std::memory_order::relaxed);
+		return sum;
+	}
+
+private:
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> messages{ 0 };
+		std::atomic<uint64_t> bytes{ 0 };
+	};
+
+	Slot slots_[Counter::SLOTS];
+	Slot overflow_;
+};
+
+/**
+* Maximum value ever observed.
+*/
+class HighWaterMark
+{
+public:
+	/**
+	* Observe the value.
+	* @param[in] value current value
+	*/
+	void observe(uint64_t value) noexcept {
+#if defined(SWPL_ENABLE_METRICS)
+		auto current = max_.load(std::memory_order::relaxed);
+		while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order::relaxed)) { }
+#endif
+	}
+
+	/**
+	* Get the highest value observed.
+	* @return Highest value.
+	*/
+	uint64_t value() const noexcept {
+		return max_.load(std::memory_order::relaxed);
+	}
+
+private:
+	std::atomic<uint64_t> max_{ 0 };
+};
+
+/**
+* Log-bucketed histogram of 64-bit values (durations in nanoseconds). Values below SUB_BUCKETS
+* have their own buckets, every following power of two range is split into SUB_BUCKETS buckets,
+* which gives 12.5% worst-case relative error.
+* Recording is not sharded - histogram is expected to be fed mostly from one thread (eg. stage
+* consumer), atomics are used only to make concurrent reads safe.
+*/
+class LatencyHistogram
+{
+public:
+	static constexpr unsigned int SUB_BUCKET_BITS = 3;
+	static constexpr unsigned int SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+	static constexpr unsigned int BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	/**
+	* Record single value.
+	* @param[in] value value to record
+	*/
+	void record(uint64_t value) noexcept {
+#if defined(SWPL_ENABLE_METRICS)
+		counts_[bucket_index(value)].fetch_add(1, std::memory_order::relaxed);
+		count_.fetch_add(1, std::memory_order::relaxed);
+		sum_.fetch_add(value, std::memory_order::relaxed);
+		max_.observe(value);
+#endif
+	}
+
+	/**
+	* Get number of recorded values.
+	*/
+	uint64_t count() const noexcept {
+		return count_.load(std::memory_order::relaxed);
+	}
+
+	/**
+	* Get sum of recorded values.
+	*/
+	uint64_t sum() const noexcept {
+		return sum_.load(std::memory_order::relaxed);
+	}
+
+	/**
+	* Get maximum recorded value.
+	*/
+	uint64_t max() const noexcept {
+		return max_.value();
+	}
+
+	/**
+	* Get number of values recorded in the bucket.
+	* @param[in] bucket bucket index
+	*/
+	uint64_t count(unsigned int bucket) const noexcept {
+		return counts_[bucket].load(std::memory_order::relaxed);
+	}
+
+	/**
+	* Get value below which given fraction of recorded values is.
+	* @param[in] quantile quantile (0.0 - 1.0)
+	* @return Upper bound of the bucket containing the quantile or 0 if histogram is empty.
+	*/
+	uint64_t quantile(double quantile) const noexcept;
+
+	/**
+	* Calculate bucket for the value.
+	* @param[in] value value to find bucket for
+	* @return Bucket index.
+	*/
+	static unsigned int bucket_index(uint64_t value) noexcept;
+
+	/**
+	* Get the lowest value that goes to the bucket.
+	*/
+	static uint64_t bucket_lower(unsigned int bucket) noexcept;
+
+	/**
+	* Get the highest value that goes to the bucket.
+	*/
+	static uint64_t bucket_upper(unsigned int bucket) noexcept;
+
+private:
+	std::atomic<uint64_t> counts_[BUCKETS]{};
+	std::atomic<uint64_t> count_{ 0 };
+	std::atomic<uint64_t> sum_{ 0 };
+	HighWaterMark max_;
+};
+
+/**
+* Metrics of the single stage.
+*/
+struct StageMetrics
+{
+	TrafficCounter in;							/*!< Messages and bytes put into stage queues */
+	TrafficCounter out;							/*!< Messages and bytes delivered to cooperatives */
+	LatencyHistogram queue_latency;				/*!< Time between enqueue and dequeue [ns] */
+};
+
+/**
+* Metrics of the IO - counts and durations of the system calls done by the IO.
+*/
+struct IOMetrics
+{
+	Counter read_calls;
+	Counter read_errors;
+	Counter read_bytes;
+	LatencyHistogram read_duration;				/*!< Read call duration [ns] */
+
+	Counter write_calls;
+	Counter write_errors;
+	Counter write_bytes;
+	LatencyHistogram write_duration;			/*!< Write call duration [ns] */
+
+	/**
+	* Record read operation.
+	* @param[in] result value returned by read (bytes or negative error)
+	* @param[in] start metrics_clock() taken before the call
+	*/
+	void record_read(ssize_t result, uint64_t start) noexcept {
+		read_calls.add();
+		if (result < 0)
+			read_errors.add();
+		else
+			read_bytes.add(static_cast<uint64_t>(result));
+		read_duration.record(metrics_clock() - start);
+	}
+
+	/**
+	* Record write operation.
+	* @param[in] result value returned by write (bytes or negative error)
+	* @param[in] start metrics_clock() taken before the call
+	*/
+	void record_write(ssize_t result, uint64_t start) noexcept {
+		write_calls.add();
+		if (result < 0)
+			write_errors.add();
+		else
+			write_bytes.add(static_cast<uint64_t>(result));
+		write_duration.record(metrics_clock() - start);
+	}
+};
+
+#endif /* SRC_CORE_METRICS_HPP_ */
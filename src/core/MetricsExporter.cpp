@@ -0,0 +1,487 @@
+/**
+ *  @file   MetricsExporter.cpp
+ *  @brief  Exporter of the pipeline metrics in Prometheus text format.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "MetricsExporter.hpp"
+#include "Stage.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(SWPL_SYSTEM_HAVE_UNISTD_H) && defined(SWPL_SYSTEM_HAVE_POLL_H) && defined(SWPL_SYSTEM_HAVE_SYS_UN_H)
+#define SWPL_METRICS_SOCKET
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+enum class SettingLabel
+{
+	SOCKET,
+	FILE,
+	INTERVAL,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::SOCKET, {"socket", SettingType::STRING}},
+	{SettingLabel::FILE, {"file", SettingType::STRING}},
+	{SettingLabel::INTERVAL, {"interval", SettingType::INTEGER}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Upper bounds [ns] of the exported histogram buckets. Internal histograms are much finer, they are
+* folded into these on export - value is counted in the first bound not lower than the upper bound of
+* its internal bucket.
+*/
+static constexpr std::array<uint64_t, 7> EXPORT_BOUNDS{ 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+/**
+* Time client has to send the HTTP request before plain exposition is sent.
+*/
+static constexpr int CLIENT_REQUEST_TIMEOUT_MS = 50;
+
+/**
+* Time the whole exchange with the client may take - client that does not read can not hold the
+* exporter thread (and stop()) longer.
+*/
+static constexpr std::chrono::milliseconds CLIENT_TIMEOUT{ 1000 };
+
+namespace {
+
+struct HistogramSnapshot
+{
+	std::array<uint64_t, EXPORT_BOUNDS.size() + 1> cumulative{};	/*!< Last one is +Inf */
+	uint64_t sum{ 0 };
+
+	HistogramSnapshot() = default;
+
+	explicit HistogramSnapshot(const LatencyHistogram& histogram) {
+		for (unsigned int i = 0; i < LatencyHistogram::BUCKETS; ++i)
+		{
+			auto count = histogram.count(i);
+			if (count == 0)
+				continue;
+
+			size_t bound = 0;
+			while (bound < EXPORT_BOUNDS.size() && LatencyHistogram::bucket_upper(i) > EXPORT_BOUNDS[bound])
+				++bound;
+			for (; bound < cumulative.size(); ++bound)
+				cumulative[bound] += count;
+		}
+		sum = histogram.sum();
+	}
+};
+
+struct StageSnapshot
+{
+	std::string labels;
+	uint64_t in_messages{ 0 }, in_bytes{ 0 }, out_messages{ 0 }, out_bytes{ 0 };
+	uint64_t queue_depth{ 0 }, queue_depth_max{ 0 };
+	HistogramSnapshot queue_latency;
+
+	bool io{ false };
+	uint64_t read_calls{ 0 }, read_errors{ 0 }, read_bytes{ 0 };
+	uint64_t write_calls{ 0 }, write_errors{ 0 }, write_bytes{ 0 }, write_lost{ 0 };
+	HistogramSnapshot read_duration;
+	HistogramSnapshot write_duration;
+};
+
+/**
+* Escape label value according to the exposition format.
+*/
+std::string escape(const std::string& value)
+{
+	std::string result;
+
+	result.reserve(value.size());
+	for (auto c : value)
+	{
+		switch (c)
+		{
+		case '\\': result += "\\\\"; break;
+		case '"': result += "\\\""; break;
+		case '\n': result += "\\n"; break;
+		default: result += c; break;
+		}
+	}
+
+	return result;
+}
+
+void header(std::ostringstream& out, const char* name, const char* type, const char* help)
+{
+	out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+}
+
+void family(std::ostringstream& out, const std::vector<StageSnapshot>& stages, const char* name, const char* type,
+	const char* help, bool io_only, const std::function<uint64_t(const StageSnapshot&)>& value)
+{
+	header(out, name, type, help);
+	for (const auto& stage : stages)
+	{
+		if (!io_only || stage.io)
+			out << name << '{' << stage.labels << "} " << value(stage) << '\n';
+	}
+}
+
+void histogram_family(std::ostringstream& out, const std::vector<StageSnapshot>& stages, const char* name,
+	const char* help, bool io_only, const std::function<const HistogramSnapshot&(const StageSnapshot&)>& value)
+{
+	header(out, name, "histogram", help);
+	for (const auto& stage : stages)
+	{
+		if (io_only && !stage.io)
+			continue;
+
+		const auto& histogram = value(stage);
+		for (size_t i = 0; i < EXPORT_BOUNDS.size(); ++i)
+		{
+			out << name << "_bucket{" << stage.labels << ",le=\"" << static_cast<double>(EXPORT_BOUNDS[i]) / 1e9
+				<< "\"} " << histogram.cumulative[i] << '\n';
+		}
+		out << name << "_bucket{" << stage.labels << ",le=\"+Inf\"} " << histogram.cumulative.back() << '\n';
+		out << name << "_sum{" << stage.labels << "} " << static_cast<double>(histogram.sum) / 1e9 << '\n';
+		out << name << "_count{" << stage.labels << "} " << histogram.cumulative.back() << '\n';
+	}
+}
+
+}
+
+MetricsExporter::~MetricsExporter()
+{
+	stop();
+}
+
+bool MetricsExporter::configure(ConfigurationManager& config, const std::string& section)
+{
+	long interval = 0;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	socket_path_.clear();
+	file_path_.clear();
+
+	config.get(section, SETTINGS.at(SettingLabel::SOCKET).setting_name, socket_path_);
+	config.get(section, SETTINGS.at(SettingLabel::FILE).setting_name, file_path_);
+
+	if (config.get(section, SETTINGS.at(SettingLabel::INTERVAL).setting_name, interval))
+	{
+		if (interval <= 0)
+			return false;
+		interval_ = std::chrono::milliseconds(interval);
+	}
+
+#if !defined(SWPL_METRICS_SOCKET)
+	if (!socket_path_.empty())
+		return false;
+#endif
+
+	return !socket_path_.empty() || !file_path_.empty();
+}
+
+std::string MetricsExporter::render() const
+{
+	std::vector<StageSnapshot> stages;
+	std::ostringstream out;
+	const auto pipeline = escape(pipeline_.getName());
+
+	// Only copy the values while stages are locked, formatting is done afterwards.
+	pipeline_.for_each_stage([&](const std::string& name, const Stage& stage) {
+		const auto& metrics = stage.getMetrics();
+		std::ostringstream labels;
+
+		labels << "pipeline=\"" << pipeline << "\",stage=\"" << escape(name) << "\",id=\"" << stage.getID() << '"';
+
+		auto io_stage = dynamic_cast<const IOStage*>(&stage);
+		if (io_stage)
+			labels << ",io=\"" << escape(io_stage->getIO().getConfiguration().getName()) << '"';
+
+		StageSnapshot snapshot;
+		snapshot.labels = labels.str();
+		snapshot.in_messages = metrics.in.messages();
+		snapshot.in_bytes = metrics.in.bytes();
+		snapshot.out_messages = metrics.out.messages();
+		snapshot.out_bytes = metrics.out.bytes();
+		snapshot.queue_depth = stage.pending();
+		snapshot.queue_depth_max = stage.pending_high_water();
+		snapshot.queue_latency = HistogramSnapshot{ metrics.queue_latency };
+
+		if (io_stage)
+		{
+			const auto& io = io_stage->getIO().getMetrics();
+			snapshot.io = true;
+			snapshot.read_calls = io.read_calls.value();
+			snapshot.read_errors = io.read_errors.value();
+			snapshot.read_bytes = io.read_bytes.value();
+			snapshot.read_duration = HistogramSnapshot{ io.read_duration };
+			snapshot.write_calls = io.write_calls.value();
+			snapshot.write_errors = io.write_errors.value();
+			snapshot.write_bytes = io.write_bytes.value();
+			snapshot.write_lost = io_stage->getLost();
+			snapshot.write_duration = HistogramSnapshot{ io.write_duration };
+		}
+
+		stages.push_back(std::move(snapshot));
+	});
+
+	family(out, stages, "swpl_stage_messages_in_total", "counter", "Messages put into the stage queues.", false,
+		[](const auto& s) { return s.in_messages; });
+	family(out, stages, "swpl_stage_bytes_in_total", "counter", "Bytes put into the stage queues.", false,
+		[](const auto& s) { return s.in_bytes; });
+	family(out, stages, "swpl_stage_messages_out_total", "counter", "Messages delivered by the stage.", false,
+		[](const auto& s) { return s.out_messages; });
+	family(out, stages, "swpl_stage_bytes_out_total", "counter", "Bytes delivered by the stage.", false,
+		[](const auto& s) { return s.out_bytes; });
+	family(out, stages, "swpl_stage_queue_depth", "gauge", "Messages waiting in the stage queues.", false,
+		[](const auto& s) { return s.queue_depth; });
+	family(out, stages, "swpl_stage_queue_depth_max", "gauge", "Highest number of messages waiting in a stage queue.", false,
+		[](const auto& s) { return s.queue_depth_max; });
+	histogram_family(out, stages, "swpl_stage_queue_latency_seconds", "Time messages spend in the stage queues (sampled).", false,
+		[](const auto& s) -> const HistogramSnapshot& { return s.queue_latency; });
+
+	family(out, stages, "swpl_io_read_calls_total", "counter", "Read calls done by the IO.", true,
+		[](const auto& s) { return s.read_calls; });
+	family(out, stages, "swpl_io_read_errors_total", "counter", "Failed read calls.", true,
+		[](const auto& s) { return s.read_errors; });
+	family(out, stages, "swpl_io_read_bytes_total", "counter", "Bytes read by the IO.", true,
+		[](const auto& s) { return s.read_bytes; });
+	histogram_family(out, stages, "swpl_io_read_duration_seconds", "Duration of the read calls.", true,
+		[](const auto& s) -> const HistogramSnapshot& { return s.read_duration; });
+	family(out, stages, "swpl_io_write_calls_total", "counter", "Write calls done by the IO.", true,
+		[](const auto& s) { return s.write_calls; });
+	family(out, stages, "swpl_io_write_errors_total", "counter", "Failed write calls.", true,
+		[](const auto& s) { return s.write_errors; });
+	family(out, stages, "swpl_io_write_bytes_total", "counter", "Bytes written by the IO.", true,
+		[](const auto& s) { return s.write_bytes; });
+	family(out, stages, "swpl_io_write_lost_bytes_total", "counter", "Bytes that could not be written.", true,
+		[](const auto& s) { return s.write_lost; });
+	histogram_family(out, stages, "swpl_io_write_duration_seconds", "Duration of the write calls.", true,
+		[](const auto& s) -> const HistogramSnapshot& { return s.write_duration; });
+
+	return out.str();
+}
+
+bool MetricsExporter::write_snapshot() const
+{
+	// Collectors must never see partially written file, so it is replaced atomically.
+	const auto temporary = file_path_ + ".tmp";
+
+	{
+		std::ofstream file(temporary, std::ios::out | std::ios::trunc);
+		if (!file)
+			return false;
+		file << render();
+		if (!file.flush())
+			return false;
+	}
+
+	return std::rename(temporary.c_str(), file_path_.c_str()) == 0;
+}
+
+#if defined(SWPL_METRICS_SOCKET)
+
+bool MetricsExporter::start()
+{
+	if (running_ || ::pipe(wake_pipe_) != 0)
+		return false;
+
+	if (!socket_path_.empty())
+	{
+		sockaddr_un address{};
+		if (socket_path_.size() >= sizeof(address.sun_path))
+		{
+			stop();
+			return false;
+		}
+
+		address.sun_family = AF_UNIX;
+		socket_path_.copy(address.sun_path, sizeof(address.sun_path) - 1);
+		::unlink(socket_path_.c_str());						// Leftover from the previous run.
+
+		listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (listen_fd_ < 0 || ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+			|| ::listen(listen_fd_, 8) != 0)
+		{
+			stop();
+			return false;
+		}
+	}
+
+	running_ = true;
+	worker_ = std::thread(&MetricsExporter::worker, this);
+
+	return true;
+}
+
+void MetricsExporter::stop()
+{
+	if (running_.exchange(false))
+	{
+		char wake = 0;
+		[[maybe_unused]] auto written = ::write(wake_pipe_[1], &wake, 1);
+	}
+
+	if (worker_.joinable())
+		worker_.join();
+
+	if (listen_fd_ >= 0)
+	{
+		::close(listen_fd_);
+		::unlink(socket_path_.c_str());
+		listen_fd_ = -1;
+	}
+
+	for (auto& fd : wake_pipe_)
+	{
+		if (fd >= 0)
+			::close(fd);
+		fd = -1;
+	}
+}
+
+void MetricsExporter::worker()
+{
+	auto next_snapshot = std::chrono::steady_clock::now();
+
+	while (running_)
+	{
+		int timeout = -1;
+
+		if (!file_path_.empty())
+		{
+			auto now = std::chrono::steady_clock::now();
+			if (now >= next_snapshot)
+			{
+				write_snapshot();
+				next_snapshot = now + interval_;
+			}
+			timeout = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(next_snapshot - now).count()) + 1;
+		}
+
+		pollfd fds[2] = { { wake_pipe_[0], POLLIN, 0 }, { listen_fd_, POLLIN, 0 } };
+		auto ready = ::poll(fds, listen_fd_ >= 0 ? 2 : 1, timeout);
+		if (ready < 0 && errno != EINTR)
+			break;
+
+		if (ready > 0 && (fds[1].revents & POLLIN))
+		{
+			int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+			if (client >= 0)
+			{
+				serve_client(client);
+				::close(client);
+			}
+		}
+	}
+
+	// Final snapshot, so the file reflects the state at shutdown.
+	if (!file_path_.empty())
+		write_snapshot();
+}
+
+void MetricsExporter::serve_client(int fd) const
+{
+	std::string response;
+	char request[1024];
+	size_t received = 0;
+	const auto deadline = std::chrono::steady_clock::now() + CLIENT_TIMEOUT;
+
+	// Blocking send() to the client that does not read returns after the timeout.
+	const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(CLIENT_TIMEOUT).count();
+	timeval timeout{ static_cast<time_t>(usec / 1000000), static_cast<suseconds_t>(usec % 1000000) };
+	if (::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0 ||
+		::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0)
+		return;
+
+	// Plain clients (eg. socat) just read, HTTP clients send the request first.
+	pollfd client{ fd, POLLIN, 0 };
+	while (received < sizeof(request) && std::chrono::steady_clock::now() < deadline && ::poll(&client, 1, CLIENT_REQUEST_TIMEOUT_MS) > 0)
+	{
+		auto ret = ::recv(fd, request + received, sizeof(request) - received, 0);
+		if (ret <= 0)
+			break;
+		received += static_cast<size_t>(ret);
+		if (std::string_view(request, received).find("\r\n\r\n") != std::string_view::npos)
+			break;
+	}
+
+	auto body = render();
+	if (received >= 4 && std::string_view(request, 4) == "GET ")
+	{
+		response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+			+ std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+	}
+	response += body;
+
+	size_t sent = 0;
+	while (sent < response.size() && std::chrono::steady_clock::now() < deadline)
+	{
+		auto ret = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			break;
+		sent += static_cast<size_t>(ret);
+	}
+}
+
+#else
+
+bool MetricsExporter::start()
+{
+	if (running_ || !socket_path_.empty())
+		return false;
+
+	running_ = true;
+	worker_ = std::thread(&MetricsExporter::worker, this);
+
+	return true;
+}
+
+void MetricsExporter::stop()
+{
+	running_ = false;
+	if (worker_.joinable())
+		worker_.join();
+}
+
+void MetricsExporter::worker()
+{
+	while (running_)
+	{
+		write_snapshot();
+
+		auto deadline = std::chrono::steady_clock::now() + interval_;
+		while (running_ && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	write_snapshot();
+}
+
+void MetricsExporter::serve_client(int) const
+{
+}
+
+#endif
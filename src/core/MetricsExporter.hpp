@@ -0,0 +1,81 @@
+/**
+ *  @file   MetricsExporter.hpp
+ *  @brief  Exporter of the pipeline metrics in Prometheus text format.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Metrics are serialized by the exporter's own thread - stages only update their counters, so
+ *  scraping never slows the data path down. Exposition can be served over the unix domain socket
+ *  (plain text or minimal HTTP response when client sends a request, eg. curl --unix-socket) and/or
+ *  written periodically to a file that is suitable for the node exporter textfile collector.
+ */
+
+#ifndef SRC_CORE_METRICSEXPORTER_HPP_
+#define SRC_CORE_METRICSEXPORTER_HPP_
+
+#include "Configurable.hpp"
+#include "Pipeline.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+class MetricsExporter : public Configurable
+{
+public:
+	/**
+	* Constructor.
+	* @param[in] pipeline pipeline which metrics are exported, must outlive the exporter
+	*/
+	explicit MetricsExporter(const Pipeline& pipeline) : pipeline_(pipeline) {}
+
+	/**
+	* Destructor. Stops exporting.
+	*/
+	virtual ~MetricsExporter();
+
+	/**
+	* Read exporter configuration. At least one of socket or file must be set.
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section section with exporter settings
+	* @return True if configuration is valid, otherwise false.
+	*/
+	bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Bind the socket (if configured) and start exporting thread.
+	* @return True if exporter was started, otherwise false.
+	*/
+	bool start();
+
+	/**
+	* Stop exporting thread and remove the socket.
+	*/
+	void stop();
+
+	/**
+	* Serialize current metrics of the pipeline.
+	* @return Metrics in Prometheus text exposition format.
+	*/
+	std::string render() const;
+
+private:
+	void worker();
+	void serve_client(int fd) const;
+	bool write_snapshot() const;
+
+	const Pipeline& pipeline_;						/*!< Pipeline which metrics are exported */
+	std::string socket_path_;						/*!< Path of the unix socket (empty if not served) */
+	std::string file_path_;							/*!< Path of the snapshot file (empty if not written) */
+	std::chrono::milliseconds interval_{ 10000 };	/*!< Period of writing the snapshot file */
+
+	int listen_fd_{ -1 };							/*!< Listening socket */
+	int wake_pipe_[2]{ -1, -1 };					/*!< Pipe used to wake the exporting thread up */
+	std::atomic<bool> running_{ false };			/*!< Exporting thread should run */
+	std::thread worker_;							/*!< Exporting thread */
+};
+
+#endif /* SRC_CORE_METRICSEXPORTER_HPP_ */
@@ -8,4 +8,654 @@
  */
 
 #include "Pipeline.hpp"
+#include "StageFactory.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	STAGE,
+	DRAIN_TIMEOUT,
+	TYPE,
+	PASS,
+	DEFAULT,
+	SPILL_THRESHOLD,
+	SPILL_DIRECTORY,
+	SPILL_SEGMENT,
+	JOURNAL,
+	JOURNAL_INTERVAL,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::STAGE, {"stage", SettingType::STRING}},
+	{SettingLabel::DRAIN_TIMEOUT, {"drain_timeout", SettingType::UNSIGNED}},
+	{SettingLabel::TYPE, {"type", SettingType::STRING}},
+	{SettingLabel::PASS, {"pass", SettingType::STRING}},
+	{SettingLabel::DEFAULT, {"default", SettingType::STRING}},
+	{SettingLabel::SPILL_THRESHOLD, {"spill_threshold", SettingType::UNSIGNED}},
+	{SettingLabel::SPILL_DIRECTORY, {"spill_directory", SettingType::STRING}},
+	{SettingLabel::SPILL_SEGMENT, {"spill_segment", SettingType::UNSIGNED}},
+	{SettingLabel::JOURNAL, {"journal", SettingType::STRING}},
+	{SettingLabel::JOURNAL_INTERVAL, {"journal_interval", SettingType::UNSIGNED}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Journal keys of the IO stage positions are the stage names with these suffixes.
+*/
+static const std::string READ_SUFFIX{ ".read" };
+static const std::string WRITTEN_SUFFIX{ ".written" };
+
+/**
+* Longest wait for a single stage before checking if the checkpoint should be given up.
+*/
+static constexpr std::chrono::milliseconds BARRIER_WAIT{ 10 };
+
+/**
+* Make link with names ordered, so the same connection is always represented the same way.
+*/
+static std::pair<std::string, std::string> make_link(const std::string& first, const std::string& second)
+{
+	return first < second ? std::make_pair(first, second) : std::make_pair(second, first);
+}
+
+Pipeline::~Pipeline()
+{
+	stop();
+}
+
+bool Pipeline::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::map<std::string, Settings> stages;
+	std::set<Link> links;
+
+	if (running_)
+		return false;
+
+	std::scoped_lock lock{ stages_mutex_ };
+
+	section_ = section;
+	stages_.clear();
+	links_.clear();
+
+	if (!read_graph(config, stages, links))
+		return false;
+
+	for (const auto& [name, settings] : stages)
+	{
+		auto stage = create_stage(config, name, settings);
+		if (!stage)
+		{
+			stages_.clear();
+			return false;
+		}
+		stages_[name] = StageEntry{ std::move(stage), settings, {} };
+	}
+
+	for (const auto& link : links)
+		connect(*stages_[link.first].stage, *stages_[link.second].stage);
+	links_ = std::move(links);
+
+	if (!open_journal(config))
+	{
+		stages_.clear();
+		links_.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool Pipeline::reconfigure(ConfigurationManager& config)
+{
+	std::map<std::string, Settings> new_stages;
+	std::set<Link> new_links;
+
+	// Checkpoint would wait for stages that are being replaced.
+	std::scoped_lock checkpoint_lock{ checkpoint_mutex_ };
+
+	if (!read_graph(config, new_stages, new_links))
+		return false;
+
+	// Create stages that were added or changed first - if any of them fails,
+	// running graph is left untouched.
+	std::map<std::string, StageEntry> fresh;
+	for (const auto& [name, settings] : new_stages)
+	{
+		auto it = stages_.find(name);
+		if (it != stages_.end() && it->second.settings == settings)
+			continue;
+
+		auto stage = create_stage(config, name, settings);
+		if (!stage)
+			return false;
+		fresh[name] = StageEntry{ std::move(stage), settings, {} };
+	}
+
+	// Retiring stages are the ones removed from the configuration or replaced by fresh instances.
+	auto retiring = [&](const std::string& name) {
+		return !new_stages.contains(name) || fresh.contains(name);
+	};
+	auto resolve = [&](const std::string& name) {
+		auto it = fresh.find(name);
+		return it != fresh.end() ? it->second.stage.get() : stages_[name].stage.get();
+	};
+
+	// Wire the new graph. Surviving stages linked to the old instance of a replaced stage switch
+	// to the new one atomically, so they never send data to nowhere.
+	for (const auto& link : new_links)
+	{
+		Stage* first = resolve(link.first);
+		Stage* second = resolve(link.second);
+		bool first_fresh = fresh.contains(link.first);
+		bool second_fresh = fresh.contains(link.second);
+
+		if (!first_fresh && !second_fresh)
+		{
+			if (!links_.contains(link))
+				connect(*first, *second);
+			continue;
+		}
+
+		if (first_fresh)
+			first->register_coop(second->getID(), second);
+		if (second_fresh)
+			second->register_coop(first->getID(), first);
+
+		auto switch_survivor = [&](Stage& survivor, Stage& replacement, const std::string& replaced) {
+			auto old = stages_.find(replaced);
+			if (old != stages_.end() && links_.contains(link))
+				survivor.replace_coop(old->second.stage->getID(), replacement.getID(), &replacement);
+			else
+				survivor.register_coop(replacement.getID(), &replacement);
+		};
+
+		if (!first_fresh)
+			switch_survivor(*first, *second, link.second);
+		if (!second_fresh)
+			switch_survivor(*second, *first, link.first);
+	}
+
+	// Surviving stages stop sending over links that are going away.
+	for (const auto& link : links_)
+	{
+		bool kept = new_links.contains(link) && !retiring(link.first) && !retiring(link.second);
+		if (kept)
+			continue;
+
+		Stage& first = *stages_[link.first].stage;
+		Stage& second = *stages_[link.second].stage;
+		if (!retiring(link.first))
+			first.detach_coop(second.getID());
+		if (!retiring(link.second))
+			second.detach_coop(first.getID());
+	}
+
+	// Retiring stages are still running and deliver whatever they have queued.
+	std::vector<Stage*> draining;
+	for (auto& [name, entry] : stages_)
+	{
+		if (retiring(name))
+			draining.push_back(entry.stage.get());
+	}
+	if (running_ && !drain(draining))
+		LOG_WARNING("pipeline {}: removed stages not drained in {} ms, moving leftovers", section_, drain_timeout_.count());
+
+	// Whatever did not make it in time goes to the replacement stage (if there is one).
+	for (auto& [name, entry] : stages_)
+	{
+		if (!retiring(name))
+			continue;
+
+		stop_stage(entry);
+
+		auto replacement = fresh.find(name);
+		if (replacement == fresh.end())
+			continue;
+
+		for (const auto& link : links_)
+		{
+			if (link.first != name && link.second != name)
+				continue;
+
+			const auto& neighbour = (link.first == name) ? link.second : link.first;
+			if (!new_links.contains(link) || !new_stages.contains(neighbour))
+				continue;
+
+			entry.stage->migrate_coop(stages_[neighbour].stage->getID(), *replacement->second.stage, resolve(neighbour)->getID());
+		}
+	}
+
+	// Surviving stages consume data that came over removed links and forget them.
+	for (const auto& link : links_)
+	{
+		bool kept = new_links.contains(link) && !retiring(link.first) && !retiring(link.second);
+		if (kept)
+			continue;
+
+		Stage& first = *stages_[link.first].stage;
+		Stage& second = *stages_[link.second].stage;
+		if (!retiring(link.first))
+		{
+			if (running_ && !drain(first, second.getID()))
+				LOG_WARNING("pipeline {}: {} messages from {} to {} lost", section_, first.pending(second.getID()), link.second, link.first);
+			first.unregister_coop(second.getID());
+		}
+		if (!retiring(link.second))
+		{
+			if (running_ && !drain(second, first.getID()))
+				LOG_WARNING("pipeline {}: {} messages from {} to {} lost", section_, second.pending(first.getID()), link.first, link.second);
+			second.unregister_coop(first.getID());
+		}
+	}
+
+	std::scoped_lock lock{ stages_mutex_ };
+
+	std::erase_if(stages_, [&](const auto& item) { return retiring(item.first); });
+
+	for (auto& [name, entry] : fresh)
+	{
+		auto& placed = stages_[name];
+		placed = std::move(entry);
+		if (running_)
+			start_stage(placed);
+	}
+	links_ = std::move(new_links);
+
+	LOG_INFO("pipeline {} reconfigured: {} stages replaced or added", section_, fresh.size());
+
+	return true;
+}
+
+bool Pipeline::start()
+{
+	if (running_ || stages_.empty())
+		return false;
+
+	for (auto& [name, entry] : stages_)
+		start_stage(entry);
+	running_ = true;
+
+	if (journal_)
+	{
+		checkpointing_ = true;
+		if (journal_interval_.count() > 0)
+			checkpointer_ = std::thread(&Pipeline::checkpoint_worker, this);
+	}
+
+	return true;
+}
+
+bool Pipeline::stop()
+{
+	if (!running_)
+		return false;
+
+	// Flag is cleared first, so checkpoint waiting for data is interrupted and releases the lock.
+	checkpointing_ = false;
+	{
+		std::scoped_lock lock{ checkpoint_mutex_ };
+	}
+	checkpoint_cv_.notify_all();
+	if (checkpointer_.joinable())
+		checkpointer_.join();
+
+	for (auto& [name, entry] : stages_)
+		stop_stage(entry);
+	running_ = false;
+
+	// Stopped pipeline with nothing left in the queues is checkpointed exactly, restart repeats nothing.
+	if (journal_)
+		checkpoint();
+
+	return true;
+}
+
+bool Pipeline::pause()
+{
+	return stop();
+}
+
+bool Pipeline::resume()
+{
+	return start();
+}
+
+Stage* Pipeline::getStage(const std::string& name) const
+{
+	auto it = stages_.find(name);
+	return it != stages_.end() ? it->second.stage.get() : nullptr;
+}
+
+void Pipeline::for_each_stage(const std::function<void(const std::string&, const Stage&)>& visitor) const
+{
+	std::scoped_lock lock{ stages_mutex_ };
+
+	for (const auto& [name, entry] : stages_)
+		visitor(name, *entry.stage);
+}
+
+bool Pipeline::stage_setting(const std::string& key)
+{
+	for (auto label : { SettingLabel::TYPE, SettingLabel::DEFAULT, SettingLabel::SPILL_THRESHOLD, SettingLabel::SPILL_DIRECTORY,
+		SettingLabel::SPILL_SEGMENT })
+	{
+		if (key == SETTINGS.at(label).setting_name)
+			return true;
+	}
+
+	const auto& pass = SETTINGS.at(SettingLabel::PASS).setting_name;
+	return key.size() > pass.size() && key.starts_with(pass) &&
+		std::all_of(key.begin() + static_cast<std::ptrdiff_t>(pass.size()), key.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+
+bool Pipeline::checkpoint()
+{
+	std::scoped_lock lock{ checkpoint_mutex_ };
+	std::vector<std::pair<std::string, uint64_t>> reads;
+
+	if (!journal_)
+		return false;
+
+	for (const auto& [name, entry] : stages_)
+	{
+		auto io = dynamic_cast<const IOStage*>(entry.stage.get());
+		if (io && io->getIO().getConfiguration().getDirection() == StreamDirection::INPUT)
+			reads.emplace_back(name, io->getReadPosition());
+	}
+
+	if (running_)
+	{
+		if (!wait_for_barrier())
+			return false;
+	}
+	else
+	{
+		for (const auto& [name, entry] : stages_)
+		{
+			if (entry.stage->pending() != 0)
+				return false;
+		}
+	}
+
+	// Data held inside a stage (eg. incomplete record) was read before the position but not delivered,
+	// so the position of the input is moved back by it - such data is read again after a crash.
+	for (auto& [name, position] : reads)
+		position -= std::min(position, held_behind(name));
+
+	return commit_positions(reads);
+}
+
+uint64_t Pipeline::held_behind(const std::string& name) const
+{
+	std::set<std::string> reached{ name };
+	std::vector<std::string> pending{ name };
+	uint64_t held = 0;
+
+	while (!pending.empty())
+	{
+		auto current = std::move(pending.back());
+		pending.pop_back();
+
+		auto it = stages_.find(current);
+		if (it != stages_.end())
+			held += it->second.stage->held();
+
+		for (const auto& [first, second] : links_)
+		{
+			const auto* neighbour = (first == current) ? &second : (second == current) ? &first : nullptr;
+			if (neighbour != nullptr && reached.insert(*neighbour).second)
+				pending.push_back(*neighbour);
+		}
+	}
+
+	return held;
+}
+
+bool Pipeline::read_graph(ConfigurationManager& config, std::map<std::string, Settings>& stages, std::set<Link>& links)
+{
+	std::vector<std::string> names;
+	long timeout = 0;
+
+	if (!config.validate(section_, SETTINGS))
+		return false;
+
+	if (config.get(section_, SETTINGS.at(SettingLabel::DRAIN_TIMEOUT).setting_name, timeout) && timeout >= 0)
+		drain_timeout_ = std::chrono::milliseconds(timeout);
+
+	for (unsigned int i = 1; ; ++i)
+	{
+		std::string name;
+		if (!config.get(section_, SETTINGS.at(SettingLabel::STAGE).setting_name + std::to_string(i), name))
+			break;
+		names.push_back(name);
+	}
+
+	if (names.empty())
+		return false;
+
+	for (size_t i = 0; i + 1 < names.size(); ++i)
+	{
+		if (names[i] != names[i + 1])
+			links.insert(make_link(names[i], names[i + 1]));
+	}
+
+	// Stages named as branches of other stages are part of the pipeline too, so the list grows here.
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		const std::string name = names[i];
+		Settings settings;
+
+		if (stages.contains(name))
+			continue;
+		if (!config.getSection(name, settings) || !settings.contains(SETTINGS.at(SettingLabel::TYPE).setting_name))
+			return false;
+
+		std::vector<std::string> branches;
+		for (unsigned int j = 1; settings.contains(SETTINGS.at(SettingLabel::PASS).setting_name + std::to_string(j)); ++j)
+			branches.push_back(settings.at(SETTINGS.at(SettingLabel::PASS).setting_name + std::to_string(j)));
+		if (settings.contains(SETTINGS.at(SettingLabel::DEFAULT).setting_name))
+			branches.push_back(settings.at(SETTINGS.at(SettingLabel::DEFAULT).setting_name));
+
+		for (const auto& branch : branches)
+		{
+			if (branch == name)
+				continue;
+			links.insert(make_link(name, branch));
+			names.push_back(branch);
+		}
+
+		stages[name] = std::move(settings);
+	}
+
+	return true;
+}
+
+std::unique_ptr<Stage> Pipeline::create_stage(ConfigurationManager& config, const std::string& name, const Settings& settings)
+{
+	auto stage = StageFactory::create(settings.at(SETTINGS.at(SettingLabel::TYPE).setting_name));
+	SpillSettings spill;
+
+	if (!config.validate(name, SETTINGS))
+		return nullptr;
+
+	config.get(name, SETTINGS.at(SettingLabel::SPILL_THRESHOLD).setting_name, spill.threshold);
+	config.get(name, SETTINGS.at(SettingLabel::SPILL_DIRECTORY).setting_name, spill.directory);
+	config.get(name, SETTINGS.at(SettingLabel::SPILL_SEGMENT).setting_name, spill.segment_size);
+
+	if (stage)
+	{
+		stage->setName(name);
+		stage->setSpill(spill);
+	}
+	if (stage && !stage->configure(config, name))
+		stage.reset();
+
+	return stage;
+}
+
+bool Pipeline::drain(const std::vector<Stage*>& stages)
+{
+	auto deadline = std::chrono::steady_clock::now() + drain_timeout_;
+	unsigned int quiet = 0;
+
+	// Data can be in flight between two draining stages (taken from one queue, not yet put
+	// into the next one), so queues must be seen empty twice in a row.
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		size_t pending = 0;
+		for (const auto stage : stages)
+			pending += stage->pending();
+
+		quiet = (pending == 0) ? quiet + 1 : 0;
+		if (quiet >= 2)
+			return true;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return false;
+}
+
+bool Pipeline::drain(const Stage& stage, unsigned int id)
+{
+	auto deadline = std::chrono::steady_clock::now() + drain_timeout_;
+
+	while (stage.pending(id) != 0)
+	{
+		if (std::chrono::steady_clock::now() >= deadline)
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return true;
+}
+
+bool Pipeline::open_journal(ConfigurationManager& config)
+{
+	std::string path;
+	long interval = 100;
+
+	journal_.reset();
+	if (!config.get(section_, SETTINGS.at(SettingLabel::JOURNAL).setting_name, path) || path.empty())
+		return true;
+
+	config.get(section_, SETTINGS.at(SettingLabel::JOURNAL_INTERVAL).setting_name, interval);
+	if (interval < 0)
+		return false;
+	journal_interval_ = std::chrono::milliseconds(interval);
+
+	journal_ = std::make_unique<Journal>(path);
+	if (!journal_->open())
+	{
+		journal_.reset();
+		return false;
+	}
+
+	for (auto& [name, entry] : stages_)
+	{
+		auto io = dynamic_cast<IOStage*>(entry.stage.get());
+		if (io == nullptr)
+			continue;
+
+		std::optional<uint64_t> read, written;
+		uint64_t position = 0;
+		if (journal_->get(name + READ_SUFFIX, position))
+			read = position;
+		if (journal_->get(name + WRITTEN_SUFFIX, position))
+			written = position;
+		io->setResume(read, written);
+	}
+
+	return true;
+}
+
+bool Pipeline::wait_for_barrier()
+{
+	std::vector<Stage::Barrier> barriers(stages_.size());
+	// Reconfiguration waits for the checkpoint, so data stuck in a stage can not hold it forever.
+	auto deadline = std::chrono::steady_clock::now() + drain_timeout_;
+
+	// Every round data moves at least one stage further, so after as many rounds as there are stages
+	// everything read before the checkpoint reached the outputs.
+	for (size_t round = 0; round < stages_.size(); ++round)
+	{
+		size_t index = 0;
+		for (const auto& [name, entry] : stages_)
+			entry.stage->set_barrier(barriers[index++]);
+
+		// Stage past the barrier stays past it, so stages can be waited for one by one.
+		index = 0;
+		for (const auto& [name, entry] : stages_)
+		{
+			auto& barrier = barriers[index++];
+			while (!entry.stage->wait_passed(barrier, std::min(deadline, std::chrono::steady_clock::now() + BARRIER_WAIT)))
+			{
+				if (!checkpointing_ || std::chrono::steady_clock::now() >= deadline)
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool Pipeline::commit_positions(const std::vector<std::pair<std::string, uint64_t>>& reads)
+{
+	for (auto& [name, entry] : stages_)
+	{
+		auto io = dynamic_cast<IOStage*>(entry.stage.get());
+		if (io == nullptr || io->getIO().getConfiguration().getDirection() != StreamDirection::OUTPUT)
+			continue;
+
+		// Size is taken before the sync, so all of it is on the disk when the sync succeeds.
+		auto written = io->getWritten();
+		if (io->sync() < 0)
+		{
+			LOG_WARNING("pipeline {}: cannot sync output {}, checkpoint skipped", section_, name);
+			return false;
+		}
+		journal_->set(name + WRITTEN_SUFFIX, written);
+	}
+
+	for (const auto& [name, position] : reads)
+		journal_->set(name + READ_SUFFIX, position);
+
+	return journal_->sync();
+}
+
+void Pipeline::checkpoint_worker()
+{
+	std::unique_lock lock{ checkpoint_mutex_ };
+
+	while (!checkpoint_cv_.wait_for(lock, journal_interval_, [this]() { return !checkpointing_.load(); }))
+	{
+		lock.unlock();
+		checkpoint();
+		lock.lock();
+	}
+}
+
+void Pipeline::start_stage(StageEntry& entry)
+{
+	entry.stage->set_work_flag(true);
+	entry.worker = std::thread(&Stage::run, entry.stage.get());
+}
+
+void Pipeline::stop_stage(StageEntry& entry)
+{
+	entry.stage->set_work_flag(false);
+	if (entry.worker.joinable())
+		entry.worker.join();
+	entry.stage->update_held();
+}
+
+void Pipeline::connect(Stage& first, Stage& second)
+{
+	first.register_coop(second.getID(), &second);
+	second.register_coop(first.getID(), &first);
+}
@@ -5,6 +5,40 @@
  *  @author Piotr "asmie" Olszewski
  *
  *  @date   2022.06.15
+ *
+ *  Pipeline is built from the configuration section listing its stages:
+ *  [pipeline]
+ *  stage1 = io1
+ *  stage2 = transform1
+ *  stage3 = io2
+ *
+ *  Every stageN value is the name of the section describing that stage. Consecutive stages
+ *  are connected with each other in both directions.
+ *
+ *  Stage can also branch - passN and default keys in its own section name the sections of further
+ *  stages. Those are added to the pipeline (even if not listed as stageN) and connected with the
+ *  branching stage.
+ *
+ *  Every stage section can also enable spilling of the stage incoming queues - messages over the
+ *  threshold go to the disk instead of memory (see SpillQueue):
+ *  spill_threshold = 0				# bytes kept in memory per incoming queue, 0 - no spilling
+ *  spill_directory = ""				# directory of the spill files, def: system temporary directory
+ *  spill_segment = 67108864			# size of the spill file segment, def: 64 MiB
+ *
+ *  Pipeline section can name a journal file. Positions of the IO stages (offset of the input after
+ *  the data already read, size of the output) are checkpointed there periodically - a checkpoint
+ *  is taken only when all data read before it went through every stage and outputs are synced.
+ *  After restart inputs continue from the last checkpoint and outputs are cut back to it, so
+ *  every message is delivered at least once. Data held back inside the stages (eg. incomplete
+ *  records, ratelimit, compress blocks, sample reservoirs) was read but not delivered yet, so the
+ *  inputs connected with those stages commit positions moved back by the held bytes. This is exact
+ *  for stages holding the input bytes as they came (framer, compress right after the input); a
+ *  sample reservoir is simply drawn again after a crash. Checkpoint is skipped when the data does
+ *  not get through within drain_timeout.
+ *
+ *  Running pipeline can be reconfigured. New configuration is compared with the running graph
+ *  and only stages which were added, removed or whose settings changed are touched. Stages that
+ *  are going away are drained first, so no data buffered in their queues is lost.
  */
 
 #ifndef SRC_PIPELINE_HPP_
@@ -13,19 +47,59 @@
 #include "Global.h"
 
 #include "Stage.hpp"
+#include "Configurable.hpp"
+#include "Journal.hpp"
+#include "config/ConfigurationManager.hpp"
 
-#include <deque>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
-class Pipeline
+class Pipeline : public Configurable
 {
 public:
-	Pipeline();
+	Pipeline() = default;
 	~Pipeline();
 
-	bool add_stage(Stage& stage);
-	bool remove_stage(Stage& stage);
+	Pipeline(const Pipeline&) = delete;
+	Pipeline& operator=(const Pipeline&) = delete;
 
+	/**
+	* Build pipeline from the configuration. Pipeline must not be running.
+	* Supported configuration:
+	* [section_name]
+	* stage1 = "section of the first stage"
+	* stageN = "section of the Nth stage"
+	*
+	* Optional configuration:
+	* drain_timeout = 1000				# ms to wait for removed stages to drain their queues and for checkpointed data
+	* journal = "path"					# journal file of the IO positions, def: none
+	* journal_interval = 100			# ms between checkpoints, def: 100
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where pipeline configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
 
+	/**
+	* Apply new configuration to the (possibly running) pipeline using the same section
+	* as in configure(). If new configuration is not valid, running pipeline is not touched.
+	* @param[in] config reference to the configuration manager facility
+	* @return True if pipeline has been reconfigured, otherwise false.
+	*/
+	bool reconfigure(ConfigurationManager& config);
+
+	/**
+	* Start all stages of the pipeline.
+	*/
 	bool start();
 
 	/**
@@ -43,9 +117,141 @@ public:
 	*/
 	bool resume();
 
+	/**
+	* Check if pipeline is running.
+	* @return True if running.
+	*/
+	bool is_running() const {
+		return running_;
+	}
+
+	/**
+	* Get stage created from the specified section.
+	* @param[in] name name of the stage section
+	* @return Pointer to the stage or nullptr if there is no such stage.
+	*/
+	Stage* getStage(const std::string& name) const;
+
+	/**
+	* Get name of the pipeline (its configuration section).
+	* @return Name of the pipeline.
+	*/
+	const std::string& getName() const {
+		return section_;
+	}
+
+	/**
+	* Call visitor for every stage of the pipeline. Stages are not added or removed while
+	* visitor is running, so it is safe to call from other threads (eg. metrics exporter).
+	* @param[in] visitor function taking stage section name and the stage
+	*/
+	void for_each_stage(const std::function<void(const std::string&, const Stage&)>& visitor) const;
+
+	/**
+	* Check if the key of a stage section is read by the pipeline itself, not by the stage (type,
+	* passN, default and the spill settings). Stages passing their settings on (eg. to a plugin)
+	* skip those.
+	* @param[in] key setting name
+	* @return True if the key belongs to the pipeline.
+	*/
+	static bool stage_setting(const std::string& key);
+
+	/**
+	* Checkpoint positions of the IO stages now. Returns after all data read so far went through
+	* the pipeline and positions are durable.
+	* @return False if there is no journal, pipeline stopped meanwhile or journal failed.
+	*/
+	bool checkpoint();
+
+	/**
+	* Get journal of the pipeline.
+	* @return Pointer to the journal or nullptr if pipeline has none.
+	*/
+	const Journal* getJournal() const {
+		return journal_.get();
+	}
+
 private:
-	std::deque<Stage> stages_;
+	typedef ConfigurationManager::SectionStructure Settings;
+	typedef std::pair<std::string, std::string> Link;
+
+	struct StageEntry
+	{
+		std::unique_ptr<Stage> stage;
+		Settings settings;
+		std::thread worker;
+	};
+
+	/**
+	* Read stages and links described in the pipeline section.
+	* @return True if graph is valid.
+	*/
+	bool read_graph(ConfigurationManager& config, std::map<std::string, Settings>& stages, std::set<Link>& links);
+
+	/**
+	* Create and configure the stage described in the given section.
+	* @return Configured stage or nullptr.
+	*/
+	std::unique_ptr<Stage> create_stage(ConfigurationManager& config, const std::string& name, const Settings& settings);
+
+	/**
+	* Wait until all given stages have nothing in their incoming queues.
+	* @return True if drained before the timeout.
+	*/
+	bool drain(const std::vector<Stage*>& stages);
+
+	/**
+	* Wait until data that came from the specified cooperative is consumed.
+	* @return True if drained before the timeout.
+	*/
+	bool drain(const Stage& stage, unsigned int id);
+
+	/**
+	* Open the journal named in the pipeline section and set IO stages to continue from it.
+	* @return False if journal is configured but can not be used.
+	*/
+	bool open_journal(ConfigurationManager& config);
+
+	/**
+	* Wait until all data queued in the stages now went through the whole pipeline.
+	* @return False if checkpointing was stopped meanwhile or data did not get through within drain timeout.
+	*/
+	bool wait_for_barrier();
+
+	/**
+	* Write positions of the IO stages to the journal.
+	* @param[in] reads input positions taken before the data was waited for
+	*/
+	bool commit_positions(const std::vector<std::pair<std::string, uint64_t>>& reads);
+
+	/**
+	* Bytes held back by all stages connected (directly or not) with the given one.
+	*/
+	uint64_t held_behind(const std::string& name) const;
+
+	/**
+	* Take checkpoints periodically until checkpointing is stopped.
+	*/
+	void checkpoint_worker();
+
+	void start_stage(StageEntry& entry);
+	void stop_stage(StageEntry& entry);
+
+	static void connect(Stage& first, Stage& second);
+
+	std::string section_;										/*!< Configuration section of the pipeline */
+	std::map<std::string, StageEntry> stages_;					/*!< Stages indexed by their section names */
+	std::set<Link> links_;										/*!< Connections between stages (ordered pairs of names) */
+	std::chrono::milliseconds drain_timeout_{ 1000 };			/*!< Max time to wait for queues to drain */
+	mutable std::mutex stages_mutex_;							/*!< Guards adding/removing stages against visitors */
+	bool running_{ false };
 
+	std::unique_ptr<Journal> journal_;							/*!< Journal of the IO positions (nullptr - none) */
+	std::chrono::milliseconds journal_interval_{ 100 };			/*!< Time between checkpoints */
+	std::thread checkpointer_;
+	std::atomic<bool> checkpointing_{ false };
+	std::mutex checkpoint_mutex_;								/*!< Checkpoint and reconfiguration do not overlap */
+	std::condition_variable checkpoint_cv_;
 };
 
 
@@ -0,0 +1,167 @@
+/**
+ *  @file   RoutingTable.hpp
+ *  @brief  Dense routing table with RCU-style publication.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Routing table is a flat array with one slot per cooperating stage. Readers (the per-message path)
+ *  never take any lock - they enter a read-side section, load the currently published table and find
+ *  the slot of the cooperative in it. Writers (registering and unregistering cooperatives) are
+ *  serialized, build a modified copy of the table, publish it with a single atomic pointer swap and wait
+ *  for the grace period (all readers that could still see the old table leave their sections) before
+ *  the old copy is released.
+ *
+ *  Grace period detection uses two reader counters selected by the epoch parity. Every writer flips the
+ *  epoch after publishing new table and waits until counter of the previous parity drops to zero.
+ */
+
+#ifndef SRC_CORE_ROUTINGTABLE_HPP_
+#define SRC_CORE_ROUTINGTABLE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* Flat routing table with lock-free readers. Entry type must be copyable as writers
+* always work on the copy of the current table and must have the id member (0 - free slot).
+*/
+template<class Entry>
+class RoutingTable
+{
+public:
+	typedef std::vector<Entry> Table;
+
+	/**
+	* Read-side critical section. As long as the guard exists, the table it has loaded
+	* (and everything that table owns) stays valid even if writers publish newer versions.
+	* Guard must not be held while calling update() on the same table - it would never
+	* see the end of the grace period.
+	*/
+	class ReadGuard
+	{
+	public:
+		explicit ReadGuard(const RoutingTable& routing) : counter_(routing.enter()),
+			version_(routing.version_.load(std::memory_order::acquire)),
+			table_(routing.current_.load(std::memory_order::seq_cst)) { }
+
+		~ReadGuard() {
+			counter_.fetch_sub(1, std::memory_order::release);
+		}
+
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+
+		/**
+		* Find entry with the specified ID. Tables hold few entries, so they are just scanned.
+		* @param[in] id id of the entry
+		* @return Pointer to the entry or nullptr if there is no entry with that ID.
+		*/
+		const Entry* find(unsigned int id) const noexcept {
+			if (id == 0)
+				return nullptr;
+			for (const auto& entry : *table_)
+			{
+				if (entry.id == id)
+					return &entry;
+			}
+			return nullptr;
+		}
+
+		/**
+		* Get the whole table seen by this guard.
+		* @return Reference to the table.
+		*/
+		const Table& table() const noexcept {
+			return *table_;
+		}
+
+		/**
+		* Get version of the table. Version is read before the table, so the table seen by the guard
+		* is at least that new. Readers caching something derived from the table can compare versions
+		* to find out that it has to be refreshed.
+		* @return Number of updates published before the guard was created.
+		*/
+		uint64_t version() const noexcept {
+			return version_;
+		}
+
+	private:
+		std::atomic<unsigned int>& counter_;			/*!< Reader counter entered by this guard */
+		uint64_t version_;								/*!< Table version seen when entering */
+		const Table* table_;							/*!< Table visible in this section */
+	};
+
+	RoutingTable() : current_(new Table()) { }
+
+	~RoutingTable() {
+		delete current_.load();
+	}
+
+	RoutingTable(const RoutingTable&) = delete;
+	RoutingTable& operator=(const RoutingTable&) = delete;
+
+	/**
+	* Modify the table. Modifier gets the copy of the current table, after it returns the copy
+	* is published and old version is released once no reader can access it.
+	* @param[in] modify callable taking Table& to be modified
+	*/
+	template<class Modifier>
+	void update(Modifier&& modify) {
+		std::scoped_lock lock{ writer_mutex_ };
+
+		const Table* old_table = current_.load(std::memory_order::relaxed);
+		auto new_table = std::make_unique<Table>(*old_table);
+		modify(*new_table);
+
+		current_.store(new_table.release(), std::memory_order::seq_cst);
+		version_.fetch_add(1, std::memory_order::release);
+		synchronize();
+		delete old_table;
+	}
+
+private:
+	/**
+	* Enter read-side section. Re-checking the epoch after incrementing the counter guarantees
+	* that the writer which publishes the next table will wait for this reader.
+	* @return Counter that has been incremented.
+	*/
+	std::atomic<unsigned int>& enter() const noexcept {
+		for (;;) {
+			auto epoch = epoch_.load(std::memory_order::seq_cst);
+			auto& counter = readers_[epoch & 1].count;
+			counter.fetch_add(1, std::memory_order::seq_cst);
+			if (epoch_.load(std::memory_order::seq_cst) == epoch)
+				return counter;
+			counter.fetch_sub(1, std::memory_order::release);
+		}
+	}
+
+	/**
+	* Wait until all readers that could have seen the previous table leave their sections.
+	*/
+	void synchronize() {
+		auto old_epoch = epoch_.fetch_add(1, std::memory_order::seq_cst);
+		auto& counter = readers_[old_epoch & 1].count;
+		while (counter.load(std::memory_order::acquire) != 0)
+			std::this_thread::yield();
+	}
+
+	struct alignas(64) ReaderCounter
+	{
+		std::atomic<unsigned int> count{ 0 };
+	};
+
+	std::atomic<const Table*> current_;				/*!< Currently published table */
+	std::atomic<unsigned int> epoch_{ 0 };				/*!< Grace period epoch */
+	std::atomic<uint64_t> version_{ 0 };				/*!< Number of published updates */
+	mutable ReaderCounter readers_[2];					/*!< Readers in sections, indexed by epoch parity */
+	std::mutex writer_mutex_;							/*!< Serializes writers */
+};
+
+#endif /* SRC_CORE_ROUTINGTABLE_HPP_ */
@@ -0,0 +1,233 @@
+/**
+ *  @file   SpillQueue.cpp
+ *  @brief  Disk overflow of the stage incoming queues.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "SpillQueue.hpp"
+#include "Global.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+static constexpr size_t HEADER_SIZE = 4;
+
+SpillFile::SpillFile(std::string path, size_t segment_size) : path_{ std::move(path) }, segment_size_{ segment_size }
+{
+}
+
+SpillFile::~SpillFile()
+{
+	clear();
+}
+
+bool SpillFile::append(const std::vector<uint8_t>& data)
+{
+	if (data.size() > 0xffffffffu)
+		return false;
+
+	if (!writer_.is_open())
+	{
+		write_buffer_.resize(BUFFER_SIZE);
+		writer_.rdbuf()->pubsetbuf(write_buffer_.data(), static_cast<std::streamsize>(write_buffer_.size()));
+		writer_.open(segment_path(write_segment_), std::ios::binary | std::ios::trunc);
+		write_offset_ = 0;
+	}
+
+	const auto size = static_cast<uint32_t>(data.size());
+	const char header[HEADER_SIZE] = { static_cast<char>(size), static_cast<char>(size >> 8), static_cast<char>(size >> 16), static_cast<char>(size >> 24) };
+	writer_.write(header, HEADER_SIZE);
+	writer_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	if (!writer_.good())
+		return false;
+
+	++records_;
+	unflushed_ = true;
+	write_offset_ += HEADER_SIZE + data.size();
+
+	if (write_offset_ >= segment_size_)
+	{
+		// Closed segment is complete - reader that gets to its end moves on to the next one.
+		writer_.close();
+		unflushed_ = false;
+		++write_segment_;
+	}
+
+	return true;
+}
+
+bool SpillFile::next(std::vector<uint8_t>& data)
+{
+	if (records_ == 0)
+		return false;
+
+	for (;;)
+	{
+		if (!reader_.is_open())
+		{
+			read_buffer_.resize(BUFFER_SIZE);
+			reader_.rdbuf()->pubsetbuf(read_buffer_.data(), static_cast<std::streamsize>(read_buffer_.size()));
+			reader_.open(segment_path(read_segment_), std::ios::binary);
+			if (!reader_.is_open())
+				return false;
+		}
+
+		if (read_segment_ == write_segment_ && unflushed_)
+		{
+			writer_.flush();
+			unflushed_ = false;
+		}
+
+		unsigned char header[HEADER_SIZE];
+		reader_.read(reinterpret_cast<char*>(header), HEADER_SIZE);
+		if (reader_.gcount() == 0 && reader_.eof() && read_segment_ < write_segment_)
+		{
+			// End of the closed segment, it is not needed any more.
+			reader_.close();
+			reader_.clear();
+			std::remove(segment_path(read_segment_).c_str());
+			++read_segment_;
+			continue;
+		}
+		if (reader_.gcount() != HEADER_SIZE)
+			return false;
+
+		size_t size = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<size_t>(header[3]) << 24);
+		data.resize(size);
+		reader_.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
+		if (static_cast<size_t>(reader_.gcount()) != size)
+			return false;
+
+		--records_;
+		return true;
+	}
+}
+
+void SpillFile::clear()
+{
+	if (writer_.is_open())
+		writer_.close();
+	if (reader_.is_open())
+		reader_.close();
+	writer_.clear();
+	reader_.clear();
+
+	if (records_ != 0 || write_offset_ != 0 || write_segment_ != 0)
+	{
+		for (auto segment = read_segment_; segment <= write_segment_; ++segment)
+			std::remove(segment_path(segment).c_str());
+	}
+
+	write_segment_ = 0;
+	write_offset_ = 0;
+	read_segment_ = 0;
+	records_ = 0;
+	unflushed_ = false;
+}
+
+std::string SpillFile::segment_path(uint64_t segment) const
+{
+	return path_ + "." + std::to_string(segment);
+}
+
+/**
+* Spill file path unique for the queue and the process.
+*/
+static std::string spill_path(const SpillSettings& settings, const std::string& name)
+{
+	std::error_code error;
+	std::filesystem::path directory = settings.directory;
+	if (directory.empty())
+		directory = std::filesystem::temp_directory_path(error);
+
+	std::random_device random;
+	auto token = (static_cast<uint64_t>(random()) << 32) | random();
+	char hex[17];
+	std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(token));
+
+	return (directory / ("swpl-spill-" + name + "-" + hex)).string();
+}
+
+SpillQueue::SpillQueue(const SpillSettings& settings, const std::string& name) :
+	threshold_{ settings.threshold }, file_{ spill_path(settings, name), std::max<size_t>(settings.segment_size, 1) }
+{
+}
+
+bool SpillQueue::push(std::vector<uint8_t>& data)
+{
+	const size_t size = data.size();
+
+	// Fast path - nothing spilled and the message fits in memory.
+	if (!spilling_.load() && memory_.load(std::memory_order::relaxed) + size <= threshold_)
+	{
+		memory_.fetch_add(size);
+		return false;
+	}
+
+	std::scoped_lock lock{ mutex_ };
+
+	if (!spilling_.load() && memory_.load() + size <= threshold_)
+	{
+		memory_.fetch_add(size);
+		return false;
+	}
+
+	if (!broken_ && !file_.append(data))
+	{
+		LOG_WARNING("spill file {} can not be written, queue is kept in memory", file_.segment_path(0));
+		broken_ = true;
+	}
+	if (broken_)
+		held_.push_back(std::move(data));
+
+	spilling_.store(true);
+	size_.fetch_add(1);
+	spilled_.fetch_add(1, std::memory_order::relaxed);
+	return true;
+}
+
+bool SpillQueue::pop(std::vector<uint8_t>& data)
+{
+	if (!spilling_.load())
+		return false;
+
+	std::scoped_lock lock{ mutex_ };
+	bool found = false;
+
+	if (file_.size() != 0)
+	{
+		found = file_.next(data);
+		if (!found)
+		{
+			LOG_WARNING("spill file {} can not be read, {} messages lost", file_.segment_path(0), file_.size());
+			lost_.fetch_add(file_.size(), std::memory_order::relaxed);
+			size_.fetch_sub(file_.size());
+			file_.clear();
+		}
+	}
+
+	if (!found && !held_.empty())
+	{
+		data = std::move(held_.front());
+		held_.pop_front();
+		found = true;
+	}
+
+	if (found)
+		size_.fetch_sub(1);
+
+	if (file_.size() == 0 && held_.empty())
+	{
+		// Drained - new messages can go to memory again, file starts over.
+		file_.clear();
+		broken_ = false;
+		spilling_.store(false);
+	}
+
+	return found;
+}
@@ -0,0 +1,176 @@
+/**
+ *  @file   SpillQueue.hpp
+ *  @brief  Disk overflow of the stage incoming queues.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Queue of the stage that can not keep up (eg. output device or peer stalled) grows without limit.
+ *  With spilling enabled, messages over the memory threshold are appended to the file instead and
+ *  read back when the memory part of the queue is empty. Once spilling starts, all messages go to
+ *  the file until it is read to the end, so the order is kept. File is split into segments - every
+ *  segment is removed as soon as it is read and the whole file when it is drained. File is only
+ *  written at the end and read from the beginning, through large stream buffers.
+ */
+
+#ifndef SRC_CORE_SPILLQUEUE_HPP_
+#define SRC_CORE_SPILLQUEUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+* Spilling settings of the stage incoming queues.
+*/
+struct SpillSettings
+{
+	size_t threshold{ 0 };								/*!< Bytes held in memory per queue before spilling, 0 - no spilling */
+	std::string directory;								/*!< Directory of the spill files (empty - system temporary directory) */
+	size_t segment_size{ 64 << 20 };					/*!< Size the file segment is closed at */
+};
+
+/**
+* Append-only file of messages split into segments. Not thread safe.
+*/
+class SpillFile
+{
+public:
+	/**
+	* Create spill file, nothing is written until the first message is appended.
+	* @param[in] path path of the file, segments get their numbers appended
+	* @param[in] segment_size size the segment is closed at
+	*/
+	SpillFile(std::string path, size_t segment_size);
+	~SpillFile();
+
+	SpillFile(const SpillFile&) = delete;
+	SpillFile& operator=(const SpillFile&) = delete;
+
+	/**
+	* Append message to the end of the file.
+	* @return False if message could not be written.
+	*/
+	bool append(const std::vector<uint8_t>& data);
+
+	/**
+	* Read the oldest message.
+	* @param[out] data message
+	* @return False if there is no message or it could not be read.
+	*/
+	bool next(std::vector<uint8_t>& data);
+
+	/**
+	* Remove all messages and segments.
+	*/
+	void clear();
+
+	/**
+	* Get number of messages in the file.
+	*/
+	size_t size() const noexcept {
+		return records_;
+	}
+
+	/**
+	* Get path of the segment.
+	*/
+	std::string segment_path(uint64_t segment) const;
+
+private:
+	static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+	std::string path_;
+	size_t segment_size_;
+
+	std::ofstream writer_;
+	uint64_t write_segment_{ 0 };
+	size_t write_offset_{ 0 };								/*!< Bytes in the segment being written */
+	bool unflushed_{ false };								/*!< Writer buffer holds data the reader may need */
+
+	std::ifstream reader_;
+	uint64_t read_segment_{ 0 };
+
+	size_t records_{ 0 };
+	std::vector<char> write_buffer_;
+	std::vector<char> read_buffer_;
+};
+
+/**
+* Overflow of the single incoming queue. Producers call push() before putting message into the
+* memory queue, consumer calls taken() for every message it took from there and pop() when the
+* memory queue is empty.
+*/
+class SpillQueue
+{
+public:
+	/**
+	* Create overflow of the queue.
+	* @param[in] settings spilling settings
+	* @param[in] name name making the spill file unique (eg. stage and cooperative IDs)
+	*/
+	SpillQueue(const SpillSettings& settings, const std::string& name);
+
+	/**
+	* Spill the message if it does not fit in memory (or spilled messages are waiting).
+	* @param[in,out] data message
+	* @return True if message was taken, false if it should go to the memory queue.
+	*/
+	bool push(std::vector<uint8_t>& data);
+
+	/**
+	* Account message taken from the memory queue.
+	* @param[in] size size of the message
+	*/
+	void taken(size_t size) noexcept {
+		memory_.fetch_sub(size);
+	}
+
+	/**
+	* Take the oldest spilled message.
+	* @param[out] data message
+	* @return False if there are no spilled messages.
+	*/
+	bool pop(std::vector<uint8_t>& data);
+
+	/**
+	* Get number of spilled messages waiting.
+	*/
+	size_t size() const noexcept {
+		return size_.load();
+	}
+
+	/**
+	* Get number of messages spilled so far.
+	*/
+	uint64_t getSpilled() const noexcept {
+		return spilled_.load(std::memory_order::relaxed);
+	}
+
+	/**
+	* Get number of spilled messages that could not be read back.
+	*/
+	uint64_t getLost() const noexcept {
+		return lost_.load(std::memory_order::relaxed);
+	}
+
+private:
+	const size_t threshold_;
+	std::atomic<size_t> memory_{ 0 };						/*!< Bytes in the memory queue */
+	std::atomic<bool> spilling_{ false };					/*!< New messages must go after the spilled ones */
+	std::atomic<size_t> size_{ 0 };
+	std::atomic<uint64_t> spilled_{ 0 };
+	std::atomic<uint64_t> lost_{ 0 };
+
+	std::mutex mutex_;										/*!< Guards file and held messages */
+	SpillFile file_;
+	bool broken_{ false };									/*!< File can not be written, messages are held in memory */
+	std::deque<std::vector<uint8_t>> held_;					/*!< Messages after the file when it is broken */
+};
+
+#endif /* SRC_CORE_SPILLQUEUE_HPP_ */
@@ -0,0 +1,142 @@
+/**
+ *  @file   Stage.cpp
+ *  @brief  IO stage implementation.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Stage.hpp"
+
+#include <cstring>
+#include <thread>
+
+/**
+* Default read chunk used when IO configuration does not specify one.
+*/
+static constexpr size_t DEFAULT_READ_CHUNK = 4096;
+
+bool IOStage::configure(ConfigurationManager& config, const std::string& section)
+{
+	return io_->configure(config, section);
+}
+
+void IOStage::run()
+{
+	const auto direction = io_->getConfiguration().getDirection();
+
+	read_ = direction == StreamDirection::INPUT ? resume(resume_read_) : 0;
+	written_ = direction == StreamDirection::OUTPUT ? resume(resume_written_) : 0;
+	resume_read_.reset();
+	resume_written_.reset();
+
+	if (io_->open() < 0)
+	{
+		LOG_ERROR("stage {}: cannot open IO {}", getID(), io_->getConfiguration().getName());
+		return;
+	}
+
+	std::thread reader;
+
+	if (direction != StreamDirection::OUTPUT)
+		reader = std::thread(&IOStage::read_worker, this);
+
+	std::vector<char> buffer;
+	std::vector<uint8_t> data;
+	bool failing = false;
+
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		// Routing table is read only to take the data - stalled write must not hold back its updates.
+		for (unsigned int slot = 0; direction != StreamDirection::INPUT; ++slot)
+		{
+			{
+				RoutingTable<Route>::ReadGuard routes{ routes_ };
+				const auto& table = routes.table();
+
+				if (slot >= table.size())
+					break;
+				if (!take(table[slot], data))
+					continue;
+			}
+
+			idle = false;
+			if (data.empty())
+				continue;
+
+			buffer.assign(data.begin(), data.end());
+			auto ret = io_->write(buffer, buffer.size());
+			if (ret > 0)
+				written_ += static_cast<uint64_t>(ret);
+
+			// IO counts failed calls, bytes lost are counted here. Only the first failure in a row is reported.
+			if (ret < static_cast<ssize_t>(buffer.size()))
+			{
+				lost_ += buffer.size() - static_cast<size_t>(std::max<ssize_t>(ret, 0));
+				if (!failing)
+					LOG_WARNING("stage {}: write to {} failed ({}), data lost", getID(), io_->getConfiguration().getName(),
+						ret < 0 ? std::strerror(-static_cast<int>(ret)) : "partial write");
+				failing = true;
+			}
+			else
+				failing = false;
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+
+	if (reader.joinable())
+	{
+		io_->cancel();
+		reader.join();
+	}
+
+	io_->close();
+}
+
+void IOStage::read_worker()
+{
+	size_t chunk = io_->getConfiguration().getReadChunkMax();
+	std::vector<char> buffer;
+
+	if (chunk == 0)
+		chunk = DEFAULT_READ_CHUNK;
+	buffer.resize(chunk);
+
+	while (get_work_flag())
+	{
+		auto ret = io_->read(buffer, chunk);
+		if (ret <= 0)
+		{
+			LOG_VERBOSE("stage {}: input {} finished ({})", getID(), io_->getConfiguration().getName(), ret);
+			break;														// End of stream or error.
+		}
+
+		std::vector<uint8_t> data(buffer.begin(), buffer.begin() + ret);
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		send_to_all(std::move(data), routes);
+		read_ += static_cast<uint64_t>(ret);
+	}
+}
+
+uint64_t IOStage::resume(std::optional<uint64_t> position)
+{
+	if (!position)
+		return 0;
+
+	auto ret = io_->resume(*position);
+	if (ret == 0)
+	{
+		LOG_INFO("stage {}: {} resumed at {}", getID(), io_->getConfiguration().getName(), *position);
+		return *position;
+	}
+
+	if (ret != -ENOTSUP)
+		LOG_WARNING("stage {}: {} cannot be resumed at {} ({}), starting from the beginning", getID(), io_->getConfiguration().getName(), *position, ret);
+	return 0;
+}
@@ -11,77 +11,369 @@
 #define SRC_CORE_STAGE_HPP_
 
 #include "IO.hpp"
+#include "Configurable.hpp"
 #include "ConcurrentQueue.hpp"
+#include "RoutingTable.hpp"
+#include "Metrics.hpp"
+#include "SpillQueue.hpp"
 
+#include <algorithm>
 #include <atomic>
-#include <queue>
-#include <map>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* Data waiting in the stage queue along with the time it was put there.
+*/
+struct QueuedData
+{
+	std::vector<uint8_t> data;
+	uint64_t enqueued{ 0 };								/*!< metrics_clock() at enqueue (0 if not sampled) */
+};
 
 struct DataQueue
 {
-	ConcurrentQueue<std::vector<uint8_t>> queue;
-	std::unique_ptr<std::mutex> mutex;
-	std::unique_ptr<std::condition_variable> cv;
+	ConcurrentQueue<QueuedData> queue;
+	std::unique_ptr<SpillQueue> spill;					/*!< Messages over the memory threshold (nullptr - no spilling) */
+	std::atomic<uint64_t> pushed{ 0 };					/*!< Messages ever put to the queue */
+	std::atomic<uint64_t> popped{ 0 };					/*!< Messages ever taken from the queue */
+
+	/**
+	* Get number of messages waiting in memory and spilled.
+	*/
+	size_t size() const {
+		return queue.size() + (spill ? spill->size() : 0);
+	}
+};
+
+class Stage;
+
+/**
+* Single slot of the stage routing table. Slots are assigned to cooperatives when they are registered
+* and reused after they are unregistered, so the table is as long as the number of cooperatives.
+* Slot 0 is never assigned - 0 stands for no slot.
+*/
+struct Route
+{
+	unsigned int id{ 0 };								/*!< ID of the cooperative in the slot (0 - free slot) */
+	unsigned int slot{ 0 };								/*!< Index of the slot in the table */
+	std::shared_ptr<DataQueue> incoming;				/*!< Queue with data received from the cooperative */
+	Stage* outgoing{ nullptr };							/*!< Cooperative to put outgoing data to */
 };
 
 /**
 * Base class for all stages that can be derived in the system.
-* Provides basic mechanisms for registering senders as well as 
+* Provides basic mechanisms for registering senders as well as
 * interface for adding new messages.
 */
-class Stage
+class Stage : public Configurable
 {
 public:
-	Stage() = default;
+	Stage() : id_(++last_id_) { }
 	virtual ~Stage() = default;
-	
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Default implementation accepts any configuration as there is nothing to set up.
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager&, const std::string&) override {
+		return true;
+	}
+
+	/**
+	* Runs the current stage. Method returns after work flag is cleared.
+	*/
+	virtual void run() = 0;
+
 	/**
 	* Add message to the incoming queue of the stage with the specified sender ID or
 	* leave that ID alone for those stages that have only one sender or does not care
 	* who the sender is (0 then is default queue that stage which does not matter should
 	* create during construction).
+	* Lookup scans the currently published routing table (one slot per cooperative) and does
+	* not take any lock, so it can run concurrently with register_coop()/unregister_coop().
 	* @param[in] data data to be added to the queue
 	* @param[in] id optional id of the sender
 	* @return True if added was successful, otherwise false (queue is full).
 	*/
 	virtual bool add_to_queue(std::vector<uint8_t> data, unsigned int id = 0) {
-		bool added = false;
-		
-		if (incoming_data_.contains(id))
 		{
-			added = true;
-			incoming_data_[id].queue.push(std::move(data));
-			incoming_data_[id].cv->notify_one();										// Notify the thread that there is new data in the queue.
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const Route* route = routes.find(id);
+
+			if (route == nullptr || !route->incoming)
+				return false;
+
+			metrics_.in.add(data.size());
+			auto& incoming = *route->incoming;
+			if (!incoming.spill || !incoming.spill->push(data))
+				incoming.queue.push(QueuedData{ std::move(data), metrics_sample_clock() });
+			incoming.pushed.fetch_add(1, std::memory_order::release);
 		}
-		return added;
+		notify();																	// Wake up the stage thread as there is new data.
+		return true;
 	}
 
 	/**
-	* Register new data cooperative stage with the specified ID.
+	* Register new data cooperative stage with the specified ID. If the cooperative was
+	* already registered its incoming queue (and data waiting there) is preserved.
 	* @param[in] id id of the new sender
 	* @param[in] sender pointer to the sender.
 	*/
 	virtual void register_coop(unsigned int id, Stage *sender) {
-		std::scoped_lock lock{ configuration_mutex_ };
-
-		incoming_data_.insert_or_assign(id, std::move(DataQueue{}));
-		incoming_data_[id].mutex = std::make_unique<std::mutex>();
-		incoming_data_[id].cv = std::make_unique<std::condition_variable>();
-		outgoing_data_.insert_or_assign(id, sender);
+		routes_.update([this, id, sender](RoutingTable<Route>::Table& table) {
+			auto& route = table[assign_slot(table, id)];
+			if (!route.incoming)
+				route.incoming = make_queue(id);
+			route.outgoing = sender;
+		});
 	}
 
+	/**
+	* Unregister data cooperative stage. Returns after no other thread can access
+	* the removed queue.
+	* @param[in] id id of the sender
+	*/
 	virtual void unregister_coop(unsigned int id) {
-		std::scoped_lock lock{ configuration_mutex_ };
+		routes_.update([id](RoutingTable<Route>::Table& table) {
+			auto slot = find_slot(table, id);
+			if (slot == 0)
+				return;
+
+			table[slot] = Route{};
+			while (table.size() > 1 && table.back().id == 0)
+				table.pop_back();
+		});
+		notify();																	// Stage thread releases what it holds for the cooperative.
+	}
+
+	/**
+	* Stop sending data to the cooperative but keep accepting data from it. Used when
+	* cooperative is going to be removed and its in-flight data has to be drained first.
+	* @param[in] id id of the cooperative
+	*/
+	virtual void detach_coop(unsigned int id) {
+		routes_.update([id](RoutingTable<Route>::Table& table) {
+			if (auto slot = find_slot(table, id); slot != 0)
+				table[slot].outgoing = nullptr;
+		});
+	}
+
+	/**
+	* Atomically switch outgoing data from one cooperative to another one. Data already
+	* received from the old cooperative stays in its queue until it is unregistered.
+	* @param[in] old_id id of the cooperative being replaced
+	* @param[in] new_id id of the new cooperative
+	* @param[in] sender pointer to the new cooperative
+	*/
+	virtual void replace_coop(unsigned int old_id, unsigned int new_id, Stage* sender) {
+		routes_.update([this, old_id, new_id, sender](RoutingTable<Route>::Table& table) {
+			if (auto slot = find_slot(table, old_id); slot != 0)
+				table[slot].outgoing = nullptr;
+
+			auto& route = table[assign_slot(table, new_id)];
+			if (!route.incoming)
+				route.incoming = make_queue(new_id);
+			route.outgoing = sender;
+		});
+	}
+
+	/**
+	* Move all data waiting in the queue of the specified cooperative to another stage.
+	* Should be used only when stage is not running.
+	* @param[in] id id of the cooperative
+	* @param[in] target stage to move data to
+	* @param[in] target_id sender ID to put data under in the target stage
+	* @return Number of messages that could not be moved.
+	*/
+	size_t migrate_coop(unsigned int id, Stage& target, unsigned int target_id) {
+		size_t lost = 0;
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		const Route* route = routes.find(id);
+
+		if (route == nullptr || !route->incoming)
+			return 0;
 
-		if (incoming_data_.contains(id))
+		std::vector<uint8_t> data;
+		while (take(*route, data))
 		{
-			std::scoped_lock rlock{ *incoming_data_[id].mutex.get() };		// Make sure that nothing is doing any operation
-			incoming_data_.erase(id);
+			if (!target.add_to_queue(std::move(data), target_id))
+				lost++;
 		}
+		return lost;
+	}
+
+	/**
+	* Get number of messages waiting in the queue of the specified cooperative.
+	* @param[in] id id of the cooperative
+	* @return Number of messages.
+	*/
+	size_t pending(unsigned int id) const {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		const Route* route = routes.find(id);
+		return (route != nullptr && route->incoming) ? route->incoming->size() : 0;
+	}
 
-		if (outgoing_data_.contains(id))
-			outgoing_data_.erase(id);
+	/**
+	* Get number of messages waiting in all incoming queues.
+	* @return Number of messages.
+	*/
+	size_t pending() const {
+		size_t count = 0;
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		for (const auto& route : routes.table())
+			count += route.incoming ? route.incoming->size() : 0;
+		return count;
+	}
+
+	/**
+	* Get the highest number of messages that was waiting in any of the current incoming queues.
+	* @return Queue depth high-water mark.
+	*/
+	size_t pending_high_water() const {
+		size_t depth = 0;
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		for (const auto& route : routes.table())
+			depth = std::max(depth, route.incoming ? route.incoming->queue.high_water() : 0);
+		return depth;
+	}
+
+	/**
+	* Get metrics of the stage.
+	* @return Reference to stage metrics.
+	*/
+	const StageMetrics& getMetrics() const {
+		return metrics_;
+	}
+
+	/**
+	* Get stage ID. This is the ID stage uses as a sender when putting data into cooperatives.
+	* @return ID of the stage.
+	*/
+	unsigned int getID() const {
+		return id_;
+	}
+
+	/**
+	* Get name of the stage. Pipeline names stages after their configuration sections.
+	* @return Name of the stage (empty if not set).
+	*/
+	const std::string& getName() const {
+		return name_;
+	}
+
+	/**
+	* Set name of the stage. Must be done before the stage is started.
+	* @param[in] name new name
+	*/
+	void setName(const std::string& name) {
+		name_ = name;
+	}
+
+	/**
+	* Enable spilling of the incoming queues to disk. Applies to the queues of cooperatives
+	* registered afterwards, so it must be done before the stage is connected.
+	* @param[in] spill spilling settings (threshold 0 disables spilling)
+	*/
+	void setSpill(const SpillSettings& spill) {
+		spill_ = spill;
+	}
+
+	/**
+	* Data queued to the stage at some moment, used to find out when all of it went through.
+	*/
+	struct Barrier
+	{
+		std::vector<uint64_t> pushed;					/*!< Messages put to every incoming queue when the barrier was set */
+		std::vector<unsigned int> ids;					/*!< Cooperatives in the slots when the barrier was set */
+		uint64_t passes{ 0 };							/*!< Passes of the stage when all of them were taken */
+		bool taken{ false };
+	};
+
+	/**
+	* Set barrier behind the data waiting in the incoming queues now.
+	* @param[out] barrier barrier to set
+	*/
+	void set_barrier(Barrier& barrier) const {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		const auto& table = routes.table();
+
+		barrier = Barrier{};
+		barrier.pushed.resize(table.size());
+		barrier.ids.resize(table.size());
+		for (size_t slot = 0; slot < table.size(); ++slot)
+		{
+			barrier.pushed[slot] = table[slot].incoming ? table[slot].incoming->pushed.load(std::memory_order::acquire) : 0;
+			barrier.ids[slot] = table[slot].id;
+		}
+	}
+
+	/**
+	* Check if all data queued before the barrier was taken and processed - everything stage sent
+	* because of it is already in the queues of its cooperatives. Stage finishes processing the data
+	* when it starts the next pass or waits for more.
+	* @param[in,out] barrier barrier set with set_barrier()
+	* @return True if stage is past the barrier.
+	*/
+	bool passed(Barrier& barrier) const {
+		if (!barrier.taken)
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+
+			// Slot taken by another cooperative in the meantime has none of the data.
+			for (size_t slot = 0; slot < barrier.pushed.size() && slot < table.size(); ++slot)
+			{
+				if (table[slot].incoming && table[slot].id == barrier.ids[slot] &&
+					table[slot].incoming->popped.load(std::memory_order::acquire) < barrier.pushed[slot])
+					return false;
+			}
+			barrier.taken = true;
+			barrier.passes = passes_.load();
+		}
+
+		return waiting_.load() || passes_.load() != barrier.passes;
+	}
+
+	/**
+	* Wait until stage is past the barrier. Stage thread wakes the waiter up whenever it starts
+	* the next pass or waits for data, so there is no polling.
+	* @param[in,out] barrier barrier set with set_barrier()
+	* @param[in] deadline time to stop waiting at
+	* @return True if stage is past the barrier.
+	*/
+	bool wait_passed(Barrier& barrier, std::chrono::steady_clock::time_point deadline) const {
+		pass_waiters_.fetch_add(1);
+		std::unique_lock lock{ wait_mutex_ };
+		bool result = wait_cv_.wait_until(lock, deadline, [this, &barrier]() { return passed(barrier); });
+		lock.unlock();
+		pass_waiters_.fetch_sub(1);
+		return result;
+	}
+
+	/**
+	* Get amount of data taken from the incoming queues and not passed on yet (eg. incomplete
+	* records), as it was when the stage started its last pass.
+	* @return Number of bytes held in the stage.
+	*/
+	size_t held() const {
+		return held_.load(std::memory_order::acquire);
+	}
+
+	/**
+	* Refresh held() after the stage thread finished. Must not be called while it is running.
+	*/
+	void update_held() {
+		held_.store(held_data(), std::memory_order::release);
 	}
 
 	bool get_work_flag() const {
@@ -90,33 +382,350 @@ public:
 
 	void set_work_flag(bool work_flag) {
 		work_flag_.store(work_flag);
+		notify();
 	}
 
 protected:
-	// Queues are protected for performance reason to give direct access.
-	std::map<unsigned int, DataQueue> incoming_data_;					/*!< vector of the queues containing incoming data */
-	std::map<unsigned int, Stage*> outgoing_data_;					/*!< vector of pointer to put outgoing data */
-
-private:	
-	unsigned int id{0};
-	std::atomic<bool> work_flag_;
-	std::mutex configuration_mutex_;
+	/**
+	* Get current data sequence. Sequence should be taken before checking the queues
+	* and passed to wait_for_data() to not miss any wake up.
+	* @return Current data sequence.
+	*/
+	unsigned int data_sequence() const {
+		held_.store(held_data(), std::memory_order::release);
+		passes_.fetch_add(1);												// Stage starts the next pass, previous data is processed.
+		wake_pass_waiters();
+		return data_seq_.load(std::memory_order::acquire);
+	}
+
+	/**
+	* Block until new data arrives or work flag changes.
+	* @param[in] sequence value returned by data_sequence() before queues were checked
+	*/
+	void wait_for_data(unsigned int sequence) const {
+		waiting_.store(true);
+		wake_pass_waiters();
+		data_seq_.wait(sequence, std::memory_order::acquire);
+		waiting_.store(false);
+	}
+
+	/**
+	* Block until new data arrives, work flag changes or the deadline passes.
+	* @param[in] sequence value returned by data_sequence() before queues were checked
+	* @param[in] deadline time to stop waiting at
+	* @return True if woken up before the deadline.
+	*/
+	bool wait_for_data_until(unsigned int sequence, std::chrono::steady_clock::time_point deadline) const {
+		// Atomic wait has no timeout, so timed waiter announces itself and waits on the condition variable.
+		timed_waiter_.store(true);
+		waiting_.store(true);
+		wake_pass_waiters();
+		std::unique_lock lock{ wait_mutex_ };
+		bool woken = wait_cv_.wait_until(lock, deadline, [this, sequence]() { return data_seq_.load() != sequence; });
+		waiting_.store(false);
+		timed_waiter_.store(false);
+		return woken;
+	}
+
+	/**
+	* Wake up stage thread waiting in wait_for_data() or wait_for_data_until().
+	*/
+	void notify() {
+		data_seq_.fetch_add(1);
+		data_seq_.notify_all();
+		if (timed_waiter_.load())
+		{
+			std::scoped_lock lock{ wait_mutex_ };
+			wait_cv_.notify_all();
+		}
+	}
+
+	/**
+	* Take the oldest data from the route incoming queue. Must be called only by the
+	* stage consumer thread (queues have single consumer).
+	* @param[in] route route to take data from
+	* @param[out] data place to store the data
+	* @return True if data was taken, false if queue is empty.
+	*/
+	bool take(const Route& route, std::vector<uint8_t>& data) {
+		if (!route.incoming)
+			return false;
+
+		if (route.slot >= sources_.size())
+			sources_.resize(route.slot + 1, 0);
+		if (sources_[route.slot] != route.id)
+		{
+			if (sources_[route.slot] != 0)
+				source_changed(route.slot);
+			sources_[route.slot] = route.id;
+		}
+
+		auto& incoming = *route.incoming;
+		if (incoming.queue.empty())
+		{
+			if (!incoming.spill || !incoming.spill->pop(data))			// Spilled messages come after all in memory
+				return false;
+			incoming.popped.fetch_add(1, std::memory_order::release);
+			return true;
+		}
+
+		auto& queued = *incoming.queue.front();
+		data = std::move(queued.data);
+		if (queued.enqueued != 0)
+			metrics_.queue_latency.record(metrics_clock() - queued.enqueued);
+		incoming.queue.pop();
+		incoming.popped.fetch_add(1, std::memory_order::release);
+		if (incoming.spill)
+			incoming.spill->taken(data.size());
+		return true;
+	}
+
+	/**
+	* Find slots whose cooperatives were unregistered since the last check and call source_changed()
+	* for them, even if no other cooperative took the slot. Must be called only by the stage thread.
+	* Stages holding data per slot call it every pass, so the data is not held forever.
+	* @param[in] routes read guard with the routing table
+	*/
+	void check_sources(const RoutingTable<Route>::ReadGuard& routes) {
+		if (routes.version() == sources_version_)
+			return;
+
+		const auto& table = routes.table();
+		sources_version_ = routes.version();
+		for (unsigned int slot = 0; slot < sources_.size(); ++slot)
+		{
+			if (sources_[slot] != 0 && (slot >= table.size() || table[slot].id != sources_[slot]))
+			{
+				source_changed(slot);
+				sources_[slot] = 0;
+			}
+		}
+	}
+
+	/**
+	* Called by the stage thread when the cooperative of the slot is gone - from check_sources() or
+	* before it takes the first data from the cooperative that got the slot of an unregistered one.
+	* Stages keeping state per slot flush or reset it here, so nothing left by the old cooperative
+	* is mixed with the data of the new one. Default implementation has no such state.
+	*/
+	virtual void source_changed(unsigned int) { }
+
+	/**
+	* Get amount of data the stage holds back between passes, called by the stage thread at the start
+	* of every pass. Stages keeping data of the past messages (eg. incomplete records) override it,
+	* so the pipeline does not checkpoint input positions of data that is not delivered yet.
+	* @return Number of bytes held.
+	*/
+	virtual size_t held_data() const {
+		return 0;
+	}
+
+	/**
+	* Put data to single cooperative and account it in the outgoing metrics.
+	* @param[in] data data to be sent
+	* @param[in] target cooperative to send data to
+	* @return True if cooperative accepted the data.
+	*/
+	bool send(std::vector<uint8_t>&& data, Stage& target) {
+		auto size = data.size();
+		if (!target.add_to_queue(std::move(data), id_))
+			return false;
+		metrics_.out.add(size);
+		return true;
+	}
+
+	/**
+	* Put data to every outgoing cooperative except the one with excluded ID.
+	* @param[in] data data to be sent
+	* @param[in] routes read guard with the routing table
+	* @param[in] excluded slot of the cooperative that should not get the data (0 for none)
+	*/
+	void send_to_all(std::vector<uint8_t>&& data, const RoutingTable<Route>::ReadGuard& routes, unsigned int excluded = 0) {
+		Stage* last = nullptr;
+		const auto& table = routes.table();
+
+		for (unsigned int dst = 0; dst < table.size(); ++dst)
+		{
+			if (dst == excluded || table[dst].outgoing == nullptr)
+				continue;
+			if (last != nullptr)
+				send(std::vector<uint8_t>(data), *last);
+			last = table[dst].outgoing;
+		}
+
+		if (last != nullptr)
+			send(std::move(data), *last);						// Last receiver does not need a copy.
+	}
+
+	// Routing table is protected for performance reason to give direct access.
+	RoutingTable<Route> routes_;										/*!< Incoming queues and outgoing cooperatives, one slot per cooperative */
+	StageMetrics metrics_;												/*!< Stage instrumentation */
+
+private:
+	/**
+	* Wake up threads waiting in wait_passed().
+	*/
+	void wake_pass_waiters() const {
+		if (pass_waiters_.load() != 0)
+		{
+			std::scoped_lock lock{ wait_mutex_ };
+			wait_cv_.notify_all();
+		}
+	}
+
+	/**
+	* Find slot of the cooperative.
+	* @return Slot index or 0 if cooperative is not registered.
+	*/
+	static unsigned int find_slot(const RoutingTable<Route>::Table& table, unsigned int id) {
+		for (unsigned int slot = 1; slot < table.size(); ++slot)
+		{
+			if (table[slot].id == id)
+				return slot;
+		}
+		return 0;
+	}
+
+	/**
+	* Find slot of the cooperative or assign it the first free one.
+	* @return Slot index.
+	*/
+	static unsigned int assign_slot(RoutingTable<Route>::Table& table, unsigned int id) {
+		if (auto slot = find_slot(table, id); slot != 0)
+			return slot;
+
+		unsigned int slot = 1;
+		while (slot < table.size() && table[slot].id != 0)
+			++slot;
+		if (slot >= table.size())
+			table.resize(slot + 1);
+		table[slot].id = id;
+		table[slot].slot = slot;
+		return slot;
+	}
+
+	/**
+	* Create incoming queue for the cooperative.
+	*/
+	std::shared_ptr<DataQueue> make_queue(unsigned int id) const {
+		auto queue = std::make_shared<DataQueue>();
+		if (spill_.threshold != 0)
+			queue->spill = std::make_unique<SpillQueue>(spill_, std::to_string(id_) + "-" + std::to_string(id));
+		return queue;
+	}
+
+	inline static std::atomic<unsigned int> last_id_{ 0 };
+
+	unsigned int id_{ 0 };												/*!< Stage identification number (unique, starts from 1) */
+	std::string name_;													/*!< Stage name (configuration section) */
+	SpillSettings spill_;												/*!< Spilling of the incoming queues */
+	std::atomic<bool> work_flag_{ false };
+	mutable std::atomic<unsigned int> data_seq_{ 0 };					/*!< Bumped on every new data and work flag change */
+	mutable std::atomic<bool> timed_waiter_{ false };					/*!< Stage thread is in wait_for_data_until() */
+	mutable std::atomic<uint64_t> passes_{ 0 };						/*!< Passes of the stage loop started */
+	mutable std::atomic<bool> waiting_{ false };						/*!< Stage thread waits for data */
+	mutable std::atomic<unsigned int> pass_waiters_{ 0 };				/*!< Threads in wait_passed() */
+	mutable std::atomic<size_t> held_{ 0 };							/*!< Data held when the last pass started */
+	mutable std::mutex wait_mutex_;
+	mutable std::condition_variable wait_cv_;
+	std::vector<unsigned int> sources_;								/*!< Cooperative the stage thread last took data of, per slot */
+	uint64_t sources_version_{ 0 };									/*!< Routing table version sources_ were last checked against */
 };
 
 /**
 * Derived class for stage that is intended to be IO stage.
-* IO stage can have single IO and single queues for input and 
+* IO stage can have single IO and single queues for input and
 * output data. This determines that IO stages can be only
 * leaves in pipelines (terminates the pipeline).
 */
 class IOStage : public Stage
 {
 public:
-	IOStage() { }
+	/**
+	* Create IO stage with given IO.
+	* @param[in] io IO object to be handled by the stage
+	*/
+	explicit IOStage(std::unique_ptr<IO> io) : io_(std::move(io)) { }
+
+	/**
+	* Configures underlying IO.
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where IO configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Opens the IO, reads it (in a separate thread) and sends data to all cooperatives,
+	* and writes everything that comes from cooperatives. Closes IO after work flag is cleared.
+	*/
+	virtual void run() override;
+
+	/**
+	* Get IO handled by the stage.
+	* @return Reference to the IO.
+	*/
+	const IO& getIO() const {
+		return *io_;
+	}
+
+	/**
+	* Set positions the IO continues from when the stage starts (eg. recovered from the journal).
+	* @param[in] read offset of the input to read from
+	* @param[in] written size of the output to keep and write after
+	*/
+	void setResume(std::optional<uint64_t> read, std::optional<uint64_t> written) {
+		resume_read_ = read;
+		resume_written_ = written;
+	}
+
+	/**
+	* Get offset of the input after the data already sent to the cooperatives.
+	*/
+	uint64_t getReadPosition() const {
+		return read_.load();
+	}
+
+	/**
+	* Get offset of the output after the data already written.
+	*/
+	uint64_t getWritten() const {
+		return written_.load();
+	}
+
+	/**
+	* Get number of bytes that could not be written to the output.
+	*/
+	uint64_t getLost() const {
+		return lost_.load();
+	}
+
+	/**
+	* Make written data durable.
+	* @return 0 if successful, otherwise negative info with error code.
+	*/
+	int sync() {
+		return io_->sync();
+	}
 
-	
 protected:
-	std::unique_ptr<IO> io;												/*!< Base IO used for input / output or both */ 
+	/**
+	* Reads the IO until work flag is cleared, end of stream or error.
+	*/
+	void read_worker();
+
+	/**
+	* Ask IO to continue at the position.
+	* @return Position IO continues at.
+	*/
+	uint64_t resume(std::optional<uint64_t> position);
+
+	std::unique_ptr<IO> io_;											/*!< Base IO used for input / output or both */
+	std::optional<uint64_t> resume_read_;
+	std::optional<uint64_t> resume_written_;
+	std::atomic<uint64_t> read_{ 0 };
+	std::atomic<uint64_t> written_{ 0 };
+	std::atomic<uint64_t> lost_{ 0 };
 };
 
 /**
@@ -0,0 +1,65 @@
+/**
+ *  @file   StageFactory.cpp
+ *  @brief  Creates stages based on the type name from configuration.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "StageFactory.hpp"
+#include "io/FileIO.hpp"
+#include "io/DeviceIO.hpp"
+#include "io/GeneratorIO.hpp"
+#include "io/SinkIO.hpp"
+#include "transform/Aggregate.hpp"
+#include "transform/Api.hpp"
+#include "transform/Call.hpp"
+#include "transform/Checksum.hpp"
+#include "transform/Compress.hpp"
+#include "transform/Dedup.hpp"
+#include "transform/Fields.hpp"
+#include "transform/Framer.hpp"
+#include "transform/Match.hpp"
+#include "transform/Mirror.hpp"
+#include "transform/Patch.hpp"
+#include "transform/RateLimit.hpp"
+#include "transform/Sample.hpp"
+
+#include <functional>
+#include <unordered_map>
+
+typedef std::function<std::unique_ptr<Stage>()> StageCreator;
+
+static const std::unordered_map<std::string, StageCreator> CREATORS(
+{
+	{"file", []() { return std::make_unique<IOStage>(std::make_unique<FileIO>()); }},
+	{"device", []() { return std::make_unique<IOStage>(std::make_unique<DeviceIO>()); }},
+	{"generator", []() { return std::make_unique<IOStage>(std::make_unique<GeneratorIO>()); }},
+	{"sink", []() { return std::make_unique<IOStage>(std::make_unique<SinkIO>()); }},
+
+	{"mirror", []() { return std::make_unique<MirrorTransformation>(); }},
+	{"match", []() { return std::make_unique<MatchTransformation>(); }},
+	{"patch", []() { return std::make_unique<PatchTransformation>(); }},
+	{"framer", []() { return std::make_unique<FramerTransformation>(); }},
+	{"call", []() { return std::make_unique<CallTransformation>(); }},
+	{"api", []() { return std::make_unique<ApiTransformation>(); }},
+	{"checksum", []() { return std::make_unique<ChecksumTransformation>(); }},
+	{"compress", []() { return std::make_unique<CompressTransformation>(); }},
+	{"decompress", []() { return std::make_unique<DecompressTransformation>(); }},
+	{"ratelimit", []() { return std::make_unique<RateLimitTransformation>(); }},
+	{"dedup", []() { return std::make_unique<DedupTransformation>(); }},
+	{"fields", []() { return std::make_unique<FieldsTransformation>(); }},
+	{"sample", []() { return std::make_unique<SampleTransformation>(); }},
+	{"aggregate", []() { return std::make_unique<AggregateTransformation>(); }}
+});
+
+std::unique_ptr<Stage> StageFactory::create(const std::string& type)
+{
+	auto it = CREATORS.find(type);
+
+	if (it == CREATORS.end())
+		return nullptr;
+
+	return it->second();
+}
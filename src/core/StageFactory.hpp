@@ -0,0 +1,33 @@
+/**
+ *  @file   StageFactory.hpp
+ *  @brief  Creates stages based on the type name from configuration.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#ifndef SRC_CORE_STAGEFACTORY_HPP_
+#define SRC_CORE_STAGEFACTORY_HPP_
+
+#include "Stage.hpp"
+
+#include <memory>
+#include <string>
+
+/**
+* Factory of the stages. Knows every IO and transformation type that can be put
+* into the pipeline.
+*/
+class StageFactory
+{
+public:
+	/**
+	* Create not configured stage of the specified type.
+	* @param[in] type type name as used in configuration file (eg. "file", "mirror")
+	* @return New stage or nullptr if type is unknown.
+	*/
+	static std::unique_ptr<Stage> create(const std::string& type);
+};
+
+#endif /* SRC_CORE_STAGEFACTORY_HPP_ */
@@ -0,0 +1,224 @@
+/**
+ *  @file   TimerWheel.hpp
+ *  @brief  Hierarchical timer wheel.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Items are scheduled at a tick (time divided by the tick length). Wheel has LEVELS levels of 64
+ *  slots - level 0 slot holds items of a single tick, level 1 slot items of 64 ticks and so on, items
+ *  further than the last level reach wait on the overflow list. When the time reaches the range of
+ *  a higher level slot, its items are moved down (cascaded), so scheduling and expiring cost O(1)
+ *  whatever the number of items is. Every level keeps a bitmap of non-empty slots, which lets the
+ *  wheel jump straight to the next scheduled tick instead of stepping through the empty ones.
+ *
+ *  Items of the same tick expire in the order they were scheduled.
+ */
+
+#ifndef SRC_CORE_TIMERWHEEL_HPP_
+#define SRC_CORE_TIMERWHEEL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+template<typename Item>
+class TimerWheel
+{
+public:
+	static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+	/**
+	* Create the wheel.
+	* @param[in] tick length of the tick (in the time units used by the caller, eg. ns)
+	* @param[in] now current time
+	*/
+	explicit TimerWheel(uint64_t tick = 1000, uint64_t now = 0) : tick_{ std::max<uint64_t>(tick, 1) }, now_{ now / tick_ } { }
+
+	/**
+	* Schedule item. Item scheduled in the past expires on the next expire() call.
+	* @param[in] time when the item expires
+	* @param[in] item item
+	*/
+	void schedule(uint64_t time, Item&& item) {
+		insert(Entry{ std::max(time / tick_, now_), std::move(item) });
+		++size_;
+	}
+
+	/**
+	* Get number of scheduled items.
+	*/
+	size_t size() const noexcept {
+		return size_;
+	}
+
+	bool empty() const noexcept {
+		return size_ == 0;
+	}
+
+	/**
+	* Get time no later than the earliest scheduled item expires at (exact for the items closer than
+	* 64 ticks).
+	* @return Time or NEVER if the wheel is empty.
+	*/
+	uint64_t next_time() const noexcept {
+		auto tick = next_tick();
+		return tick == NEVER ? NEVER : tick * tick_;
+	}
+
+	/**
+	* Expire all items scheduled up to the given time.
+	* @param[in] now current time
+	* @param[in] on_expire callable void(Item&&), it may schedule new items
+	* @return Number of expired items.
+	*/
+	template<typename Callback>
+	size_t expire(uint64_t now, Callback&& on_expire) {
+		const uint64_t target = now / tick_;
+		size_t expired = 0;
+
+		if (target < now_)
+			return 0;
+
+		for (auto tick = next_tick(); tick <= target; tick = next_tick())
+		{
+			move_to(tick);
+
+			auto& slot = levels_[0].slots[now_ & MASK];
+			levels_[0].bitmap &= ~(uint64_t{ 1 } << (now_ & MASK));
+			std::swap(slot, expiring_);
+			for (auto& entry : expiring_)
+			{
+				--size_;
+				++expired;
+				on_expire(std::move(entry.item));
+			}
+			expiring_.clear();
+		}
+
+		move_to(target);
+		return expired;
+	}
+
+private:
+	static constexpr unsigned int LEVELS = 4;
+	static constexpr unsigned int BITS = 6;
+	static constexpr uint64_t MASK = (uint64_t{ 1 } << BITS) - 1;
+
+	struct Entry
+	{
+		uint64_t tick;
+		Item item;
+	};
+
+	struct Level
+	{
+		uint64_t bitmap{ 0 };								/*!< Non-empty slots */
+		std::array<std::vector<Entry>, MASK + 1> slots;
+	};
+
+	/**
+	* Index of the slot the tick belongs to at the level.
+	*/
+	static size_t index(uint64_t tick, unsigned int level) noexcept {
+		return static_cast<size_t>((tick >> (BITS * level)) & MASK);
+	}
+
+	/**
+	* Check if ticks are in the same range of the level slot.
+	*/
+	static bool same(uint64_t a, uint64_t b, unsigned int level) noexcept {
+		return level * BITS >= 64 || (a >> (BITS * level)) == (b >> (BITS * level));
+	}
+
+	void insert(Entry&& entry) {
+		unsigned int level = 0;
+		while (level < LEVELS && !same(entry.tick, now_, level + 1))
+			++level;
+
+		if (level == LEVELS)
+		{
+			overflow_min_ = std::min(overflow_min_, entry.tick);
+			overflow_.push_back(std::move(entry));
+			return;
+		}
+
+		auto slot = index(entry.tick, level);
+		levels_[level].bitmap |= uint64_t{ 1 } << slot;
+		levels_[level].slots[slot].push_back(std::move(entry));
+	}
+
+	/**
+	* First tick of the earliest non-empty slot. Slots of the lowest non-empty level come before
+	* all slots of the higher ones.
+	*/
+	uint64_t next_tick() const noexcept {
+		for (unsigned int level = 0; level < LEVELS; ++level)
+		{
+			auto bitmap = levels_[level].bitmap;
+			if (bitmap == 0)
+				continue;
+
+			auto slot = static_cast<uint64_t>(__builtin_ctzll(bitmap));
+			auto shift = BITS * (level + 1);
+			auto base = shift >= 64 ? 0 : (now_ >> shift) << shift;
+			return std::max(now_, base | (slot << (BITS * level)));
+		}
+
+		return overflow_.empty() ? NEVER : overflow_min_;
+	}
+
+	/**
+	* Advance to the tick (no items are scheduled before it), cascading slots the tick enters.
+	*/
+	void move_to(uint64_t tick) {
+		const uint64_t previous = now_;
+		if (tick <= previous)
+			return;
+		now_ = tick;
+
+		if (!same(tick, previous, LEVELS) && !overflow_.empty())
+		{
+			std::vector<Entry> waiting;
+			waiting.swap(overflow_);
+			overflow_min_ = NEVER;
+			for (auto& entry : waiting)
+				insert(std::move(entry));
+		}
+
+		// Higher levels first, items they release can land in the lower level slots entered now.
+		for (unsigned int level = LEVELS - 1; level > 0; --level)
+		{
+			if (same(tick, previous, level))
+				continue;
+
+			auto slot = index(tick, level);
+			if ((levels_[level].bitmap & (uint64_t{ 1 } << slot)) == 0)
+				continue;
+
+			levels_[level].bitmap &= ~(uint64_t{ 1 } << slot);
+			std::vector<Entry> moved;
+			moved.swap(levels_[level].slots[slot]);
+			for (auto& entry : moved)
+				insert(std::move(entry));
+			// Nothing can land in the slot being entered, keep its storage for the next items.
+			moved.clear();
+			levels_[level].slots[slot].swap(moved);
+		}
+	}
+
+	uint64_t tick_;
+	uint64_t now_;											/*!< Current tick, all earlier ones are expired */
+	size_t size_{ 0 };
+	std::array<Level, LEVELS> levels_;
+	std::vector<Entry> overflow_;							/*!< Items beyond the range of the last level */
+	uint64_t overflow_min_{ NEVER };
+	std::vector<Entry> expiring_;
+};
+
+#endif /* SRC_CORE_TIMERWHEEL_HPP_ */
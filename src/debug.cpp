@@ -0,0 +1,272 @@
+/**
+ *  @file    debug.cpp
+ *  @brief  Debugging facility - background part of the logger.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Global.h"
+
+#include <condition_variable>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* How often the logger thread looks for new records.
+*/
+static constexpr std::chrono::milliseconds LOGGER_PERIOD{ 10 };
+
+namespace {
+
+/**
+* State shared by all the rings. Neither mutex is taken on the logging path. Registering thread takes only
+* attach_mutex, which the consumer holds just to pick up new rings - never while writing the output.
+*/
+struct LoggerState
+{
+	std::mutex mutex;											/*!< Guards rings and output */
+	std::condition_variable wake;
+	std::vector<std::shared_ptr<LogRing>> rings;
+	std::FILE* output{ stderr };
+
+	std::mutex attach_mutex;									/*!< Guards attached, worker and destroyed */
+	std::vector<std::shared_ptr<LogRing>> attached;				/*!< Rings registered since the last drain */
+	std::thread worker;
+	std::atomic<bool> running{ false };
+	bool destroyed{ false };
+
+	~LoggerState() {
+		{
+			std::scoped_lock lock{ mutex };
+			running = false;
+		}
+		wake.notify_all();
+		if (worker.joinable())
+			worker.join();
+
+		std::scoped_lock lock{ mutex, attach_mutex };
+		destroyed = true;
+		rings.insert(rings.end(), attached.begin(), attached.end());
+		attached.clear();
+		write_pending();
+	}
+
+	void run() {
+		std::unique_lock lock{ mutex };
+
+		while (running)
+		{
+			drain();
+			wake.wait_for(lock, LOGGER_PERIOD);
+		}
+	}
+
+	/**
+	* Format and write all the pending records. Must be called with mutex held.
+	*/
+	void drain() {
+		{
+			std::scoped_lock lock{ attach_mutex };
+			rings.insert(rings.end(), attached.begin(), attached.end());
+			attached.clear();
+		}
+		write_pending();
+	}
+
+	void write_pending() {
+		std::string line;
+
+		for (auto& ring : rings)
+		{
+			auto head = ring->head.load(std::memory_order::relaxed);
+			auto tail = ring->tail.load(std::memory_order::acquire);
+
+			for (; head != tail; ++head)
+			{
+				format(ring->records[head % LogRing::SLOTS], line);
+				std::fwrite(line.data(), 1, line.size(), output);
+				ring->head.store(head + 1, std::memory_order::release);
+			}
+
+			if (auto dropped = ring->dropped.exchange(0, std::memory_order::relaxed); dropped != 0)
+				std::fprintf(output, "[WARNING] %llu log records dropped\n", static_cast<unsigned long long>(dropped));
+		}
+
+		std::erase_if(rings, [](const auto& ring) {
+			return ring->finished.load(std::memory_order::acquire)
+				&& ring->head.load(std::memory_order::relaxed) == ring->tail.load(std::memory_order::acquire);
+		});
+
+		std::fflush(output);
+	}
+
+	static void format(const LogRecord& record, std::string& line) {
+		static const char* const LEVELS[] = { "NONE", "ERROR", "WARNING", "INFO", "VERBOSE" };
+		char buffer[64];
+
+		auto seconds = static_cast<std::time_t>(record.timestamp / 1000000000ull);
+		std::tm time{};
+#if defined(_MSC_VER)
+		localtime_s(&time, &seconds);
+#else
+		localtime_r(&seconds, &time);
+#endif
+		std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &time);
+
+		line = buffer;
+		std::snprintf(buffer, sizeof(buffer), ".%06u [%s] ", static_cast<unsigned int>(record.timestamp % 1000000000ull / 1000),
+			LEVELS[static_cast<unsigned int>(record.level) % std::size(LEVELS)]);
+		line += buffer;
+
+		unsigned int arg = 0;
+		for (const char* c = record.format; *c != '\0'; ++c)
+		{
+			if (c[0] != '{' || c[1] != '}' || arg >= record.argc)
+			{
+				line += *c;
+				continue;
+			}
+
+			const auto& value = record.values[arg];
+			switch (record.types[arg])
+			{
+			case LogRecord::ArgType::SIGNED:
+				line += std::to_string(value.i); break;
+			case LogRecord::ArgType::UNSIGNED:
+				line += std::to_string(value.u); break;
+			case LogRecord::ArgType::BOOL:
+				line += value.u ? "true" : "false"; break;
+			case LogRecord::ArgType::DOUBLE:
+				std::snprintf(buffer, sizeof(buffer), "%g", value.d);
+				line += buffer;
+				break;
+			case LogRecord::ArgType::POINTER:
+				std::snprintf(buffer, sizeof(buffer), "%p", value.p);
+				line += buffer;
+				break;
+			case LogRecord::ArgType::STRING:
+				line.append(record.text + value.s.offset, value.s.length); break;
+			}
+			++arg;
+			++c;
+		}
+		line += '\n';
+	}
+};
+
+LoggerState& state()
+{
+	static LoggerState logger;
+	return logger;
+}
+
+/**
+* Set when the thread can not get a ring anymore - its ring holder or the logger is destroyed.
+* Trivial, so it stays readable until the thread ends.
+*/
+thread_local bool no_ring = false;
+
+/**
+* Marks the ring as finished when the owning thread exits, logger thread releases it once it is drained.
+* Cached pointer is reset at the same time, later records of the thread are written directly.
+*/
+struct RingHolder
+{
+	std::shared_ptr<LogRing> ring;
+	LogRing** cached{ nullptr };
+
+	~RingHolder() {
+		no_ring = true;
+		if (cached != nullptr)
+			*cached = nullptr;
+		if (ring)
+			ring->finished.store(true, std::memory_order::release);
+	}
+};
+
+}
+
+void Logger::attach(LogRing*& cached) noexcept
+{
+	if (no_ring)
+		return;
+
+	thread_local RingHolder holder;
+
+	try
+	{
+		if (!holder.ring)
+		{
+			auto& logger = state();
+			std::scoped_lock lock{ logger.attach_mutex };
+
+			if (logger.destroyed)
+			{
+				no_ring = true;										// Later records of the thread are written directly.
+				return;
+			}
+
+			auto ring = std::make_shared<LogRing>();
+			if (!logger.worker.joinable())
+			{
+				logger.running = true;
+				logger.worker = std::thread(&LoggerState::run, &logger);
+			}
+
+			logger.attached.push_back(ring);
+			holder.ring = std::move(ring);
+		}
+	}
+	catch (...)
+	{
+		return;													// Logging must never break the caller.
+	}
+
+	holder.cached = &cached;
+	cached = holder.ring.get();
+}
+
+void Logger::write(const LogRecord& record) noexcept
+{
+	try
+	{
+		auto& logger = state();
+		std::string line;
+		LoggerState::format(record, line);
+
+		// Records already in the rings go first.
+		std::scoped_lock lock{ logger.mutex };
+		if (logger.destroyed)
+			return;
+		logger.drain();
+		std::fwrite(line.data(), 1, line.size(), logger.output);
+		std::fflush(logger.output);
+	}
+	catch (...)
+	{
+	}
+}
+
+void Logger::set_output(std::FILE* output) noexcept
+{
+	auto& logger = state();
+	std::scoped_lock lock{ logger.mutex };
+
+	logger.drain();
+	logger.output = output;
+}
+
+void Logger::flush() noexcept
+{
+	auto& logger = state();
+	std::scoped_lock lock{ logger.mutex };
+
+	logger.drain();
+}
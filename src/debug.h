@@ -1,18 +1,287 @@
- /**
+/**
  *  @file    debug.h
  *  @brief  Debugging facility.
  *
  *  @author Piotr "asmie" Olszewski
  *
  *  @date   2019.04.12
+ *
+ *  Logging is asynchronous - calling thread only stores binary record (pointer to the format literal,
+ *  timestamp and raw argument values) into its own single-producer ring buffer. No locks, no allocations
+ *  and no system calls are done on the logging path, so it can be used from the data path. Records are
+ *  formatted and written by the background thread. If the ring is full, record is dropped and counted -
+ *  logging never blocks the caller.
+ *
+ *  Levels above SWPL_LOG_LEVEL are compiled out completely (arguments are not even evaluated). Remaining
+ *  levels can be limited at runtime with Logger::set_level().
+ *
+ *  Format uses {} as the argument placeholder, eg. LOG_ERROR("read from {} failed: {}", path, ret).
  */
 
 #ifndef SWPL_SRC_DEBUG_H_
 #define SWPL_SRC_DEBUG_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#define SWPL_LOG_LEVEL_NONE		0
+#define SWPL_LOG_LEVEL_ERROR	1
+#define SWPL_LOG_LEVEL_WARNING	2
+#define SWPL_LOG_LEVEL_INFO		3
+#define SWPL_LOG_LEVEL_VERBOSE	4
+
 #if defined(DEBUG) && DEBUG > 0
 
+#undef SWPL_LOG_LEVEL
+#define SWPL_LOG_LEVEL SWPL_LOG_LEVEL_VERBOSE
 
 #endif /* defined(DEBUG) && DEBUG > 0 */
 
+#if !defined(SWPL_LOG_LEVEL)
+#define SWPL_LOG_LEVEL SWPL_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t
+{
+	ERROR = SWPL_LOG_LEVEL_ERROR,
+	WARNING = SWPL_LOG_LEVEL_WARNING,
+	INFO = SWPL_LOG_LEVEL_INFO,
+	VERBOSE = SWPL_LOG_LEVEL_VERBOSE
+};
+
+/**
+* Single log record as stored in the ring. Strings are copied into the record (truncated if needed),
+* format must be a literal as only the pointer is kept.
+*/
+struct LogRecord
+{
+	static constexpr unsigned int MAX_ARGS = 6;
+
+	enum class ArgType : uint8_t
+	{
+		SIGNED,
+		UNSIGNED,
+		BOOL,
+		DOUBLE,
+		POINTER,
+		STRING
+	};
+
+	union Value
+	{
+		int64_t i;
+		uint64_t u;
+		double d;
+		const void* p;
+		struct { uint16_t offset; uint16_t length; } s;
+	};
+
+	const char* format;
+	uint64_t timestamp;										/*!< Wall clock [ns since epoch] */
+	LogLevel level;
+	uint8_t argc;
+	ArgType types[MAX_ARGS];
+	uint16_t text_used;
+	Value values[MAX_ARGS];
+	char text[176];											/*!< Storage for the string arguments */
+};
+
+static_assert(sizeof(LogRecord) == 256, "Log record should have fixed size");
+
+/**
+* Per-thread ring of log records. Producer is the owning thread, consumer is the logger thread.
+*/
+struct LogRing
+{
+	static constexpr uint32_t SLOTS = 256;
+
+	alignas(64) std::atomic<uint32_t> head{ 0 };			/*!< Next record to consume */
+	alignas(64) std::atomic<uint32_t> tail{ 0 };			/*!< Next record to produce */
+	std::atomic<uint64_t> dropped{ 0 };						/*!< Records lost because ring was full */
+	std::atomic<bool> finished{ false };					/*!< Owning thread exited */
+	LogRecord records[SLOTS];
+};
+
+/**
+* Asynchronous logger. Use the LOG_* macros rather than calling it directly.
+*/
+class Logger
+{
+public:
+	/**
+	* Set the highest level that is logged (levels compiled out stay disabled).
+	* @param[in] level maximum level
+	*/
+	static void set_level(LogLevel level) noexcept {
+		level_.store(static_cast<uint8_t>(level), std::memory_order::relaxed);
+	}
+
+	/**
+	* Check if the level is enabled at runtime.
+	*/
+	static bool enabled(LogLevel level) noexcept {
+		return static_cast<uint8_t>(level) <= level_.load(std::memory_order::relaxed);
+	}
+
+	/**
+	* Set the stream records are written to (stderr by default). Stream must stay open.
+	* @param[in] output stream to write to
+	*/
+	static void set_output(std::FILE* output) noexcept;
+
+	/**
+	* Format and write all records logged so far. Blocks until done.
+	*/
+	static void flush() noexcept;
+
+	/**
+	* Store the log record.
+	* @param[in] level level of the record
+	* @param[in] format format literal with {} placeholders
+	* @param[in] args arguments
+	*/
+	template<size_t N, typename... Args>
+	static void log(LogLevel level, const char (&format)[N], const Args&... args) noexcept {
+		static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+
+		if (!enabled(level))
+			return;
+
+		LogRing* ring = current_ring();
+		if (ring == nullptr)
+		{
+			// Thread has no ring (eg. it is exiting), record is written right away.
+			LogRecord record;
+			fill(record, level, format, args...);
+			write(record);
+			return;
+		}
+
+		auto tail = ring->tail.load(std::memory_order::relaxed);
+		if (tail - ring->head.load(std::memory_order::acquire) >= LogRing::SLOTS)
+		{
+			ring->dropped.fetch_add(1, std::memory_order::relaxed);
+			return;
+		}
+
+		fill(ring->records[tail % LogRing::SLOTS], level, format, args...);
+		ring->tail.store(tail + 1, std::memory_order::release);
+	}
+
+private:
+	static LogRing* current_ring() noexcept {
+		thread_local LogRing* ring = nullptr;					// Trivial thread_local - no init guard on the hot path.
+		if (ring == nullptr)
+			attach(ring);
+		return ring;
+	}
+
+	/**
+	* Give the calling thread its ring. Holder of the ring resets the cached pointer when the thread
+	* exits, so logging from later thread_local destructors does not use the released ring.
+	* @param[out] cached thread_local pointer to the ring (stays nullptr if thread can not have one)
+	*/
+	static void attach(LogRing*& cached) noexcept;
+
+	/**
+	* Format and write the record at once, bypassing the rings.
+	*/
+	static void write(const LogRecord& record) noexcept;
+
+	template<typename... Args>
+	static void fill(LogRecord& record, LogLevel level, const char* format, const Args&... args) noexcept {
+		record.format = format;
+		record.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+		record.level = level;
+		record.argc = 0;
+		record.text_used = 0;
+		(encode(record, args), ...);
+	}
+
+	static void encode_string(LogRecord& record, std::string_view value) noexcept {
+		auto length = std::min(value.size(), sizeof(record.text) - record.text_used);
+		std::memcpy(record.text + record.text_used, value.data(), length);
+		record.types[record.argc] = LogRecord::ArgType::STRING;
+		record.values[record.argc].s = { record.text_used, static_cast<uint16_t>(length) };
+		record.text_used = static_cast<uint16_t>(record.text_used + length);
+	}
+
+	template<typename T>
+	static void encode(LogRecord& record, const T& value) noexcept {
+		using Type = std::decay_t<T>;
+
+		if constexpr (std::is_same_v<Type, bool>) {
+			record.types[record.argc] = LogRecord::ArgType::BOOL;
+			record.values[record.argc].u = value ? 1 : 0;
+		}
+		else if constexpr (std::is_enum_v<Type>) {
+			record.types[record.argc] = LogRecord::ArgType::SIGNED;
+			record.values[record.argc].i = static_cast<int64_t>(value);
+		}
+		else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+			record.types[record.argc] = LogRecord::ArgType::SIGNED;
+			record.values[record.argc].i = value;
+		}
+		else if constexpr (std::is_integral_v<Type>) {
+			record.types[record.argc] = LogRecord::ArgType::UNSIGNED;
+			record.values[record.argc].u = value;
+		}
+		else if constexpr (std::is_floating_point_v<Type>) {
+			record.types[record.argc] = LogRecord::ArgType::DOUBLE;
+			record.values[record.argc].d = value;
+		}
+		else if constexpr (std::is_array_v<T>) {
+			encode_string(record, std::string_view(value));
+		}
+		else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+			encode_string(record, value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+		}
+		else if constexpr (std::is_convertible_v<const Type&, std::string_view>) {
+			encode_string(record, std::string_view(value));
+		}
+		else if constexpr (std::is_pointer_v<Type>) {
+			record.types[record.argc] = LogRecord::ArgType::POINTER;
+			record.values[record.argc].p = value;
+		}
+		else {
+			static_assert(!sizeof(Type), "Unsupported log argument type");
+		}
+		record.argc++;
+	}
+
+	inline static std::atomic<uint8_t> level_{ static_cast<uint8_t>(LogLevel::INFO) };
+};
+
+#if SWPL_LOG_LEVEL >= SWPL_LOG_LEVEL_ERROR
+#define LOG_ERROR(...)		Logger::log(LogLevel::ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...)		do { } while (0)
+#endif
+
+#if SWPL_LOG_LEVEL >= SWPL_LOG_LEVEL_WARNING
+#define LOG_WARNING(...)	Logger::log(LogLevel::WARNING, __VA_ARGS__)
+#else
+#define LOG_WARNING(...)	do { } while (0)
+#endif
+
+#if SWPL_LOG_LEVEL >= SWPL_LOG_LEVEL_INFO
+#define LOG_INFO(...)		Logger::log(LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...)		do { } while (0)
+#endif
+
+#if SWPL_LOG_LEVEL >= SWPL_LOG_LEVEL_VERBOSE
+#define LOG_VERBOSE(...)	Logger::log(LogLevel::VERBOSE, __VA_ARGS__)
+#else
+#define LOG_VERBOSE(...)	do { } while (0)
+#endif
+
 #endif /* SWPL_SRC_DEBUG_H_ */
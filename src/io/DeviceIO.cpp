@@ -22,6 +22,7 @@
 #include "Global.h"
 
 #include <cerrno>
+#include <cstring>
 #include <mutex>
 
 #include <sys/stat.h>
@@ -39,16 +40,25 @@
 #include <io.h>
 #endif
 
+#if defined(SWPL_SYSTEM_HAVE_POLL_H) && defined(SWPL_SYSTEM_HAVE_FCNTL_H) && defined(SWPL_SYSTEM_HAVE_UNISTD_H)
+#define SWPL_DEVICE_POLL
+#include <poll.h>
+#endif
+
 
 DeviceIO::~DeviceIO()
 {
-
+	if (devFd_ >= 0)
+		close();
 }
 
 bool DeviceIO::configure(ConfigurationManager& config, const std::string& section)
 {
 	bool configurationCorrect = IOconfig<FileIOconfiguration>::configuration_.configure(config, section);
 
+	if (configurationCorrect)
+		devicePath_ = IOconfig<FileIOconfiguration>::configuration_.getFile();
+
 	return configurationCorrect;
 }
 
@@ -81,21 +91,46 @@ int DeviceIO::open()
 #else
 #error "Can't use DeviceIO module because no open call is available"
 #endif
+
+		if (result < 0)
+			LOG_ERROR("cannot open device {}: {}", devicePath_, std::strerror(-result));
 	}
 
+	cancelled_ = false;
+#if defined(SWPL_DEVICE_POLL)
+	// Reader waits in poll() on the device and this pipe, so cancel() does not need any data.
+	if (result == 0 && wake_pipe_[0] < 0 && ::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0)
+		wake_pipe_[0] = wake_pipe_[1] = -1;
+#endif
+
 	return result;
 }
 
 int DeviceIO::close()
 {
+	// Reader blocked on the device would hold the lock.
+	cancel();
+
 	std::lock_guard<std::mutex> r_guard(readLock_);
 	std::lock_guard<std::mutex> w_guard(writeLock_);
 
+#if defined(SWPL_DEVICE_POLL)
+	for (auto& fd : wake_pipe_)
+	{
+		if (fd >= 0)
+			::close(fd);
+		fd = -1;
+	}
+#endif
+
+	int fd = devFd_;
+	devFd_ = -1;
+
 #if defined(SWPL_SYSTEM_HAVE_IO_H)
-	if (_close(devFd_) == -1)
+	if (_close(fd) == -1)
 		return -errno;
 #elif defined(SWPL_SYSTEM_HAVE_UNISTD_H)
-	if (::close(devFd_) == -1)
+	if (::close(fd) == -1)
 		return -errno;
 #else
 #error "Can't use DeviceIO module because no close call is available"
@@ -120,6 +155,34 @@ ssize_t DeviceIO::read(std::vector<char>& buffer, size_t readMax)
 	if (readMax != 0 && readMax < toRead)
 		toRead = readMax;
 
+#if defined(SWPL_DEVICE_POLL)
+	if (wake_pipe_[0] >= 0)
+	{
+		pollfd fds[2] = { { devFd_, POLLIN, 0 }, { wake_pipe_[0], POLLIN, 0 } };
+
+		while (!cancelled_)
+		{
+			if (::poll(fds, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return -errno;
+			}
+			if (fds[0].revents != 0)
+				break;
+
+			// Wake up left by cancel() before the last open().
+			char wake[16];
+			while (::read(wake_pipe_[0], wake, sizeof(wake)) > 0) { }
+		}
+	}
+#endif
+
+	if (cancelled_)
+		return 0;
+
+	auto start = metrics_clock();
+
 #if defined(SWPL_SYSTEM_HAVE_IO_H)
 	retVal = _read(devFd_, buffer.data(), toRead);
 #elif defined(SWPL_SYSTEM_HAVE_UNISTD_H)
@@ -129,7 +192,11 @@ ssize_t DeviceIO::read(std::vector<char>& buffer, size_t readMax)
 #endif
 
 	if (retVal < 0)
+	{
 		retVal = -errno;
+		LOG_ERROR("read from {} failed: {}", devicePath_, std::strerror(-static_cast<int>(retVal)));
+	}
+	metrics_.record_read(retVal, start);
 
 	return retVal;
 }
@@ -151,6 +218,8 @@ ssize_t DeviceIO::write(const std::vector<char>& buffer, size_t writeMax)
 	if (writeMax != 0 && writeMax < toWrite)
 		toWrite = writeMax;
 
+	auto start = metrics_clock();
+
 #if defined(SWPL_SYSTEM_HAVE_IO_H)
 	retVal = _write(devFd_, buffer.data(), toWrite);
 #elif defined(SWPL_SYSTEM_HAVE_UNISTD_H)
@@ -160,7 +229,23 @@ ssize_t DeviceIO::write(const std::vector<char>& buffer, size_t writeMax)
 #endif
 	
 	if (retVal < 0)
+	{
 		retVal = -errno;
+		LOG_ERROR("write to {} failed: {}", devicePath_, std::strerror(-static_cast<int>(retVal)));
+	}
+	metrics_.record_write(retVal, start);
 
 	return retVal;
-}
\ No newline at end of file
+}
+
+void DeviceIO::cancel()
+{
+	cancelled_ = true;
+#if defined(SWPL_DEVICE_POLL)
+	if (wake_pipe_[1] >= 0)
+	{
+		char wake = 0;
+		[[maybe_unused]] auto written = ::write(wake_pipe_[1], &wake, 1);
+	}
+#endif
+}
@@ -15,6 +15,7 @@
 #include "core/IO.hpp"
 #include "FileIOconfiguration.hpp"
 
+#include <atomic>
 #include <cstdlib>
 #include <mutex>
 
@@ -91,9 +92,25 @@ public:
 	*/
 	virtual ssize_t write(const std::vector<char>& buffer, size_t writeMax = 0) override;
 
+	/**
+	* Wake up read() waiting for data from the device, it returns 0 as at the end of the stream.
+	*/
+	virtual void cancel() override;
+
+	/**
+	* Get configuration of the IO.
+	* @return Reference to the IO configuration.
+	*/
+	virtual const IOconfiguration& getConfiguration() const override
+	{
+		return IOconfig<FileIOconfiguration>::configuration_;
+	}
+
 private:
 	std::string devicePath_;			/*!< Device path */
-	int devFd_;							/*!< Internal representation of file descriptor */
+	int devFd_{ -1 };					/*!< Internal representation of file descriptor */
+	int wake_pipe_[2]{ -1, -1 };		/*!< Pipe used to cancel waiting read */
+	std::atomic<bool> cancelled_{ false };
 
 	std::mutex readLock_;				/*!< Mutex preventing concurrent locking during reading */
 	std::mutex writeLock_;				/*!< Mutex preventing concurrent locking during writing */
@@ -7,21 +7,35 @@
  *  @date   2022.04.22
  *
  *  This file contains the class for manipulating files.
+ *
+ *  Followed input waits for the file changes with inotify. Watch on the file wakes the reader when
+ *  data is appended, truncated or the file is moved away, watch on its directory when new file
+ *  with the same name appears. Reader blocks in poll() meanwhile, so idle file costs no CPU.
  */
 
 #include "FileIO.hpp"
 #include "config/ConfigurationManager.hpp"
+#include "core/Journal.hpp"
 
 #include <fstream>
 #include <cerrno>
+#include <filesystem>
 #include <mutex>
 #include <string_view>
 
+#if defined(SWPL_SYSTEM_HAVE_SYS_INOTIFY_H) && defined(SWPL_SYSTEM_HAVE_POLL_H) && defined(SWPL_SYSTEM_HAVE_UNISTD_H)
+#define SWPL_FILE_FOLLOW
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 
 FileIO::~FileIO() 
 {
-
+	stop_follow();
 }
 
 bool FileIO::configure(ConfigurationManager& config, const std::string& section)
@@ -32,6 +46,29 @@ bool FileIO::configure(ConfigurationManager& config, const std::string& section)
 int FileIO::open() 
 {
 	int result = 0;
+	const auto& configuration = IOconfig<FileIOconfiguration>::configuration_;
+
+	if (configuration.getRotate())
+	{
+		if (rotating_)
+			return 0;
+
+		RotatingFile::Settings settings;
+		settings.path = configuration.getFile();
+		settings.size = configuration.getRotateSize();
+		settings.interval = configuration.getRotateInterval();
+		settings.preallocate = configuration.getPreallocate();
+		settings.compress = configuration.getRotateCompress();
+
+		rotating_ = std::make_unique<RotatingFile>(settings);
+		if (rotating_->open())
+			return 0;
+
+		rotating_.reset();
+		LOG_ERROR("cannot open file {}: {}", configuration.getFile(), -EBADF);
+		return -EBADF;
+	}
+
 	if (!fileStream_.is_open())
 	{
 		std::fstream::openmode mode = static_cast<std::fstream::openmode>(0);
@@ -47,14 +84,34 @@ int FileIO::open()
 
 		try 
 		{
-			fileStream_.open(IOconfig<FileIOconfiguration>::configuration_.getFile(), mode);
+			const auto& file = IOconfig<FileIOconfiguration>::configuration_.getFile();
+			if (resume_ && mode == std::fstream::out)
+			{
+				// Resumed output keeps what was written up to the position.
+				std::filesystem::resize_file(file, *resume_);
+				mode = std::fstream::in | std::fstream::out;
+			}
+
+			fileStream_.open(file, mode);
+			if (resume_ && fileStream_.is_open())
+			{
+				fileStream_.seekg(static_cast<std::streamoff>(*resume_));
+				fileStream_.seekp(static_cast<std::streamoff>(*resume_));
+			}
+			resume_.reset();
+
 			if (!fileStream_.is_open() || !fileStream_.good())
 				result = -EBADF;
+			else if (IOconfig<FileIOconfiguration>::configuration_.getFollow() && !start_follow())
+				result = -EMFILE;
 		}
-		catch (std::fstream::failure& e)
+		catch (std::exception& e)
 		{
 			result = -ENFILE;
 		}
+
+		if (result < 0)
+			LOG_ERROR("cannot open file {}: {}", IOconfig<FileIOconfiguration>::configuration_.getFile(), result);
 	}
 	return result;
 }
@@ -65,6 +122,8 @@ int FileIO::close()
 	std::lock_guard<std::mutex> r_guard(readLock_);
 	std::lock_guard<std::mutex> w_guard(writeLock_);
 	fileStream_.close();
+	rotating_.reset();
+	stop_follow();
 	return 0;
 }
 
@@ -77,7 +136,11 @@ ssize_t FileIO::read(std::vector<char>& buffer, size_t readMax)
 		return -EINVAL;
 
 	std::lock_guard<std::mutex> guard(readLock_);
+	const bool follow = IOconfig<FileIOconfiguration>::configuration_.getFollow();
 
+	// End of the followed file is not the end of the stream, I/O error is.
+	if (follow)
+		fileStream_.clear(fileStream_.rdstate() & std::ios::badbit);
 	if (!fileStream_.is_open() || !fileStream_.good())
 		return -ENFILE;
 	size_t toRead = buffer.capacity();
@@ -85,17 +148,36 @@ ssize_t FileIO::read(std::vector<char>& buffer, size_t readMax)
 	if (readMax != 0 && readMax < toRead)
 		toRead = readMax;
 
-	try
-	{
-		fileStream_.read(buffer.data(), toRead);
-		retVal = fileStream_.gcount();
-	}
-	catch (std::fstream::failure& e)
+	for (;;)
 	{
-		retVal = -EBADF;
-	}
+		auto start = metrics_clock();
+		try
+		{
+			fileStream_.read(buffer.data(), toRead);
+			retVal = fileStream_.gcount();
+		}
+		catch (std::fstream::failure& e)
+		{
+			retVal = -EBADF;
+			LOG_ERROR("read from {} failed: {}", getConfiguration().getName(), e.what());
+		}
 
-	return retVal;
+		if (retVal == 0 && fileStream_.bad())
+		{
+			retVal = -EIO;
+			LOG_ERROR("read from {} failed", getConfiguration().getName());
+		}
+
+		if (retVal != 0 || !follow)
+		{
+			metrics_.record_read(retVal, start);
+			return retVal;
+		}
+
+		fileStream_.clear(fileStream_.rdstate() & std::ios::badbit);
+		if (!follow_rotation() && !wait_for_change())
+			return 0;
+	}
 }
 
 ssize_t FileIO::write(const std::vector<char>& buffer, size_t writeMax) 
@@ -107,7 +189,7 @@ ssize_t FileIO::write(const std::vector<char>& buffer, size_t writeMax)
 
 	std::lock_guard<std::mutex> guard(writeLock_);
 
-	if (!fileStream_.is_open() || !fileStream_.good())
+	if (!rotating_ && (!fileStream_.is_open() || !fileStream_.good()))
 		return -ENFILE;
 
 	size_t toWrite = buffer.capacity();
@@ -115,15 +197,197 @@ ssize_t FileIO::write(const std::vector<char>& buffer, size_t writeMax)
 	if (writeMax != 0 && writeMax < toWrite)
 		toWrite = writeMax;
 
+	auto start = metrics_clock();
 	try
 	{
-		fileStream_.write(buffer.data(), toWrite);
-		retVal = fileStream_.gcount();
+		bool written;
+		if (rotating_)
+			written = rotating_->write(buffer.data(), toWrite);
+		else
+			written = fileStream_.write(buffer.data(), toWrite).good();
+		retVal = written ? static_cast<ssize_t>(toWrite) : -EIO;
+		if (retVal < 0)
+			LOG_ERROR("write of {} bytes to {} failed", toWrite, getConfiguration().getName());
 	}
 	catch (std::fstream::failure& e)
 	{
 		retVal = -EBADF;
+		LOG_ERROR("write to {} failed: {}", getConfiguration().getName(), e.what());
 	}
+	metrics_.record_write(retVal, start);
 
 	return retVal;
-}
\ No newline at end of file
+}
+
+void FileIO::cancel()
+{
+	cancelled_ = true;
+#if defined(SWPL_FILE_FOLLOW)
+	if (wake_pipe_[1] >= 0)
+	{
+		char wake = 0;
+		[[maybe_unused]] auto written = ::write(wake_pipe_[1], &wake, 1);
+	}
+#endif
+}
+
+int FileIO::sync()
+{
+	if (getConfiguration().getDirection() == StreamDirection::INPUT)
+		return 0;
+
+	std::lock_guard<std::mutex> guard(writeLock_);
+
+	if (rotating_)
+		return rotating_->sync() ? 0 : -EIO;
+	if (fileStream_.is_open() && !fileStream_.flush())
+		return -EIO;
+
+	return Journal::sync_file(IOconfig<FileIOconfiguration>::configuration_.getFile()) ? 0 : -EIO;
+}
+
+int FileIO::resume(uint64_t position)
+{
+	const auto direction = getConfiguration().getDirection();
+	std::error_code error;
+
+	if (direction == StreamDirection::BIDIRECTIONAL || IOconfig<FileIOconfiguration>::configuration_.getRotate())
+		return -ENOTSUP;
+	if (fileStream_.is_open() || rotating_)
+		return -EBUSY;
+
+	// File replaced or truncated in the meantime is processed from the start.
+	auto size = std::filesystem::file_size(IOconfig<FileIOconfiguration>::configuration_.getFile(), error);
+	if (error || size < position)
+		return -ESPIPE;
+
+	resume_ = position;
+	return 0;
+}
+
+bool FileIO::start_follow()
+{
+	cancelled_ = false;
+#if defined(SWPL_FILE_FOLLOW)
+	const std::filesystem::path path{ IOconfig<FileIOconfiguration>::configuration_.getFile() };
+	auto directory = path.parent_path();
+
+	stop_follow();
+	name_ = path.filename().string();
+	notify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notify_fd_ < 0 || ::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0)
+	{
+		stop_follow();
+		return false;
+	}
+
+	if (::inotify_add_watch(notify_fd_, directory.empty() ? "." : directory.c_str(), IN_CREATE | IN_MOVED_TO) < 0 || !watch_file())
+	{
+		stop_follow();
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void FileIO::stop_follow()
+{
+#if defined(SWPL_FILE_FOLLOW)
+	for (auto fd : { notify_fd_, wake_pipe_[0], wake_pipe_[1] })
+	{
+		if (fd >= 0)
+			::close(fd);
+	}
+#endif
+	notify_fd_ = wake_pipe_[0] = wake_pipe_[1] = file_watch_ = -1;
+}
+
+bool FileIO::watch_file()
+{
+#if defined(SWPL_FILE_FOLLOW)
+	const auto& file = IOconfig<FileIOconfiguration>::configuration_.getFile();
+	struct stat info;
+
+	if (file_watch_ >= 0)
+		::inotify_rm_watch(notify_fd_, file_watch_);
+
+	// File is watched before it is read from the new position, so no change is missed.
+	file_watch_ = ::inotify_add_watch(notify_fd_, file.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+	if (file_watch_ < 0 || ::stat(file.c_str(), &info) != 0)
+		return false;
+
+	inode_ = static_cast<uint64_t>(info.st_ino);
+	device_ = static_cast<uint64_t>(info.st_dev);
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool FileIO::follow_rotation()
+{
+#if defined(SWPL_FILE_FOLLOW)
+	const auto& file = IOconfig<FileIOconfiguration>::configuration_.getFile();
+	struct stat info;
+
+	// Rotated file not created yet - old one is still read when it gets more data.
+	if (::stat(file.c_str(), &info) != 0)
+		return false;
+
+	if (static_cast<uint64_t>(info.st_ino) != inode_ || static_cast<uint64_t>(info.st_dev) != device_)
+	{
+		// Data appended to the old file after the last read is read out before switching to the new one.
+		if (fileStream_.peek() != std::char_traits<char>::eof())
+			return true;
+
+		fileStream_.clear(fileStream_.rdstate() & std::ios::badbit);
+		LOG_VERBOSE("file {} rotated, reopening", file);
+		fileStream_.close();
+		fileStream_.open(file, std::fstream::in);
+		return watch_file() && fileStream_.is_open();
+	}
+
+	auto position = fileStream_.tellg();
+	if (position > 0 && static_cast<uint64_t>(info.st_size) < static_cast<uint64_t>(position))
+	{
+		LOG_VERBOSE("file {} truncated, reading from the beginning", file);
+		fileStream_.seekg(0);
+		return true;
+	}
+#endif
+	return false;
+}
+
+bool FileIO::wait_for_change()
+{
+#if defined(SWPL_FILE_FOLLOW)
+	pollfd fds[2] = { { notify_fd_, POLLIN, 0 }, { wake_pipe_[0], POLLIN, 0 } };
+	alignas(inotify_event) char events[4096];
+
+	while (!cancelled_)
+	{
+		if (::poll(fds, 2, -1) < 0 && errno != EINTR)
+			return false;
+
+		// Directory events of other files are only drained.
+		bool changed = false;
+		ssize_t got;
+		while ((got = ::read(notify_fd_, events, sizeof(events))) > 0)
+		{
+			for (char* at = events; at < events + got; )
+			{
+				auto event = reinterpret_cast<const inotify_event*>(at);
+				if (event->wd == file_watch_ || (event->len > 0 && name_ == event->name))
+					changed = true;
+				at += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		if (changed)
+			return !cancelled_;
+	}
+#endif
+	return false;
+}
@@ -14,9 +14,13 @@
 
 #include "core/IO.hpp"
 #include "FileIOconfiguration.hpp"
+#include "RotatingFile.hpp"
 
+#include <atomic>
 #include <fstream>
+#include <memory>
 #include <mutex>
+#include <optional>
 
 /**
 * Class for reading files using IO interface.
@@ -58,6 +62,11 @@ public:
 	* read_chunk_max = 128							# read chunks - only for bi/input
 	* write_chunk_min = 0							# write chunks - onlu for bi/output
 	* write_chunk_max = 128							# write chunks - onlu for bi/output
+	* follow = true/false							# def: false - only for input, wait for appended data and rotation
+	* rotate_size = 0								# def: 0 - only for output, split file into segments of that size
+	* rotate_interval = 0							# def: 0 - only for output, start new segment after that time in ms
+	* preallocate = true/false						# def: true - reserve space of rotate_size for every segment
+	* rotate_compress = true/false					# def: false - compress closed segments
 	* @param[in] config reference to the configuration manager facility
 	* @param[in] section place where module configuration is stored
 	* @return True if configuration is valid, otherwise false.
@@ -92,8 +101,75 @@ public:
 	*/
 	virtual ssize_t write(const std::vector<char>& buffer, size_t writeMax = 0) override;
 
+	/**
+	* Wake up read() waiting for the followed file to change.
+	*/
+	virtual void cancel() override;
+
+	/**
+	* Flush written data and make it durable.
+	* @return 0 if successful, otherwise negative info with error code.
+	*/
+	virtual int sync() override;
+
+	/**
+	* Input file is read from the given offset, output file is cut at the given size and written
+	* from there (instead of being truncated). Applied by the next open(), bidirectional and rotated
+	* files can not be resumed.
+	* @param[in] position offset in the file
+	* @return 0 if successful, otherwise negative info with error code.
+	*/
+	virtual int resume(uint64_t position) override;
+
+	/**
+	* Get configuration of the IO.
+	* @return Reference to the IO configuration.
+	*/
+	virtual const IOconfiguration& getConfiguration() const override
+	{
+		return IOconfig<FileIOconfiguration>::configuration_;
+	}
+
 private:
+	/**
+	* Start watching the followed file.
+	* @return True if file can be followed.
+	*/
+	bool start_follow();
+
+	/**
+	* Stop watching the followed file.
+	*/
+	void stop_follow();
+
+	/**
+	* Watch the file currently present under the path.
+	*/
+	bool watch_file();
+
+	/**
+	* Reopen the followed file if it was replaced or rewind it if it was truncated.
+	* @return True if there can be new data to read.
+	*/
+	bool follow_rotation();
+
+	/**
+	* Wait until the followed file changes.
+	* @return False if read was cancelled.
+	*/
+	bool wait_for_change();
+
 	std::fstream fileStream_;					/*!< Internal file stream representation */
+	std::optional<uint64_t> resume_;			/*!< Position to open the file at */
+	std::unique_ptr<RotatingFile> rotating_;	/*!< Segments of the rotated output */
+
+	std::string name_;							/*!< Followed file name (without directory) */
+	int notify_fd_{ -1 };						/*!< Inotify instance watching the followed file */
+	int file_watch_{ -1 };
+	int wake_pipe_[2]{ -1, -1 };				/*!< Pipe used to cancel waiting read */
+	uint64_t inode_{ 0 };						/*!< Identity of the file being read */
+	uint64_t device_{ 0 };
+	std::atomic<bool> cancelled_{ false };
 
 	std::mutex readLock_;						/*!< Mutex preventing concurrent locking during reading */
 	std::mutex writeLock_;						/*!< Mutex preventing concurrent locking during writing */
@@ -16,12 +16,22 @@
 enum class SettingLabel
 {
 	FILE,
+	FOLLOW,
+	ROTATE_SIZE,
+	ROTATE_INTERVAL,
+	PREALLOCATE,
+	ROTATE_COMPRESS,
 	EMPTY
 };
 
 static const std::unordered_map<SettingLabel, Setting> SETTINGS(
 	{
 		{SettingLabel::FILE, {"file", SettingType::STRING}},
+		{SettingLabel::FOLLOW, {"follow", SettingType::BOOL}},
+		{SettingLabel::ROTATE_SIZE, {"rotate_size", SettingType::UNSIGNED}},
+		{SettingLabel::ROTATE_INTERVAL, {"rotate_interval", SettingType::UNSIGNED}},
+		{SettingLabel::PREALLOCATE, {"preallocate", SettingType::BOOL}},
+		{SettingLabel::ROTATE_COMPRESS, {"rotate_compress", SettingType::BOOL}},
 		{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
 	});
 
@@ -29,10 +39,40 @@ bool FileIOconfiguration::configure(ConfigurationManager& config, const std::str
 {
 	bool configurationCorrect = IOconfiguration::configure(config, section);
 
+	if (!config.validate(section, SETTINGS))
+		configurationCorrect = false;
+
 	config.get(section, SETTINGS.at(SettingLabel::FILE).setting_name, file_);
+	follow_ = false;
+	config.get(section, SETTINGS.at(SettingLabel::FOLLOW).setting_name, follow_);
+
+	size_t interval = 0;
+	rotate_size_ = 0;
+	preallocate_ = true;
+	rotate_compress_ = false;
+	config.get(section, SETTINGS.at(SettingLabel::ROTATE_SIZE).setting_name, rotate_size_);
+	config.get(section, SETTINGS.at(SettingLabel::ROTATE_INTERVAL).setting_name, interval);
+	config.get(section, SETTINGS.at(SettingLabel::PREALLOCATE).setting_name, preallocate_);
+	config.get(section, SETTINGS.at(SettingLabel::ROTATE_COMPRESS).setting_name, rotate_compress_);
+	rotate_interval_ = std::chrono::milliseconds(interval);
 
 	if (file_.empty())
 		configurationCorrect = false;
 
+	// Only input can be followed and only where file changes can be watched.
+#if defined(SWPL_SYSTEM_HAVE_SYS_INOTIFY_H) && defined(SWPL_SYSTEM_HAVE_POLL_H) && defined(SWPL_SYSTEM_HAVE_UNISTD_H)
+	if (follow_ && getDirection() != StreamDirection::INPUT)
+		configurationCorrect = false;
+#else
+	if (follow_)
+		configurationCorrect = false;
+#endif
+
+	// Segments are written only, appending or reading them makes no sense.
+	if (getRotate() && getDirection() != StreamDirection::OUTPUT)
+		configurationCorrect = false;
+	if (rotate_compress_ && !getRotate())
+		configurationCorrect = false;
+
 	return configurationCorrect;
 }
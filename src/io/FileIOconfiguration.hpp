@@ -14,6 +14,7 @@
 #include "Global.h"
 #include "core/IOconfiguration.hpp"
 
+#include <chrono>
 #include <cstdlib>
 #include <string>
 #include <string_view>
@@ -41,6 +42,13 @@ public:
 	* Supported configuration:
 	* [section_name]
 	* file = "file path"
+	*
+	* Optional configuration:
+	* follow = false						# input: wait for data appended to the file and follow its rotation, def: false
+	* rotate_size = 0						# output: start new segment at that size in bytes, def: 0 - no limit
+	* rotate_interval = 0					# output: start new segment after that time in ms, def: 0 - no limit
+	* preallocate = true					# output: reserve space of rotate_size for every segment, def: true
+	* rotate_compress = false				# output: compress closed segments, def: false
 	* @param[in] config reference to the configuration manager facility
 	* @param[in] section place where module configuration is stored
 	* @return True if configuration is valid, otherwise false.
@@ -56,8 +64,63 @@ public:
 		return file_;
 	}
 
+	/**
+	* Check if input follows the file as it grows and rotates.
+	* @return True if file is followed.
+	*/
+	bool getFollow() const
+	{
+		return follow_;
+	}
+
+	/**
+	* Check if output is split into rotated segments.
+	* @return True if output is rotated.
+	*/
+	bool getRotate() const
+	{
+		return rotate_size_ != 0 || rotate_interval_.count() != 0;
+	}
+
+	/**
+	* Get segment size limit in bytes, 0 if not limited.
+	*/
+	uint64_t getRotateSize() const
+	{
+		return rotate_size_;
+	}
+
+	/**
+	* Get segment time limit, 0 if not limited.
+	*/
+	std::chrono::milliseconds getRotateInterval() const
+	{
+		return rotate_interval_;
+	}
+
+	/**
+	* Check if space of the segments is reserved up front.
+	*/
+	bool getPreallocate() const
+	{
+		return preallocate_;
+	}
+
+	/**
+	* Check if closed segments are compressed.
+	*/
+	bool getRotateCompress() const
+	{
+		return rotate_compress_;
+	}
+
 private:
 	std::string file_{ "" };										/*!< Path to the file */
+	bool follow_{ false };											/*!< Wait for appended data instead of ending at EOF */
+	size_t rotate_size_{ 0 };										/*!< Segment size limit */
+	std::chrono::milliseconds rotate_interval_{ 0 };				/*!< Segment time limit */
+	bool preallocate_{ true };										/*!< Reserve space of the segments */
+	bool rotate_compress_{ false };									/*!< Compress closed segments */
 };
 
 #endif /* SRC_FILEIOCONFIGURATION_HPP_ */
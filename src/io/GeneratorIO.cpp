@@ -0,0 +1,177 @@
+/**
+ *  @file   GeneratorIO.cpp
+ *  @brief  Synthetic traffic generator.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "GeneratorIO.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	RATE,
+	SIZE,
+	MAX_SIZE,
+	DISTRIBUTION,
+	BURST,
+	COUNT,
+	SEED,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::RATE, {"rate", SettingType::INTEGER}},
+	{SettingLabel::SIZE, {"size", SettingType::INTEGER}},
+	{SettingLabel::MAX_SIZE, {"size_max", SettingType::INTEGER}},
+	{SettingLabel::DISTRIBUTION, {"distribution", SettingType::STRING}},
+	{SettingLabel::BURST, {"burst", SettingType::INTEGER}},
+	{SettingLabel::COUNT, {"count", SettingType::INTEGER}},
+	{SettingLabel::SEED, {"seed", SettingType::INTEGER}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Generator that fell behind by more than this does not try to catch up with a huge burst.
+*/
+static constexpr std::chrono::seconds MAX_LAG{ 1 };
+
+bool GeneratorIO::configure(ConfigurationManager& config, const std::string& section)
+{
+	long rate = 0, size = 64, size_max = -1, burst = 1, count = 0, seed = 1;
+	std::string distribution;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	if (!IO::configure(config, section) || getConfiguration().getDirection() == StreamDirection::OUTPUT)
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::RATE).setting_name, rate);
+	config.get(section, SETTINGS.at(SettingLabel::SIZE).setting_name, size);
+	config.get(section, SETTINGS.at(SettingLabel::MAX_SIZE).setting_name, size_max);
+	config.get(section, SETTINGS.at(SettingLabel::DISTRIBUTION).setting_name, distribution);
+	config.get(section, SETTINGS.at(SettingLabel::BURST).setting_name, burst);
+	config.get(section, SETTINGS.at(SettingLabel::COUNT).setting_name, count);
+	config.get(section, SETTINGS.at(SettingLabel::SEED).setting_name, seed);
+
+	if (size_max < 0)
+		size_max = size;
+
+	if (rate < 0 || size < 0 || size_max < size || burst <= 0 || count < 0)
+		return false;
+
+	if (distribution.empty())
+		distribution_ = (size_max > size) ? SizeDistribution::UNIFORM : SizeDistribution::FIXED;
+	else if (distribution == "fixed")
+		distribution_ = SizeDistribution::FIXED;
+	else if (distribution == "uniform")
+		distribution_ = SizeDistribution::UNIFORM;
+	else if (distribution == "exponential")
+		distribution_ = SizeDistribution::EXPONENTIAL;
+	else
+		return false;
+
+	rate_ = static_cast<uint64_t>(rate);
+	size_ = std::max(static_cast<size_t>(size), GeneratorHeader::SIZE);
+	size_max_ = std::max(static_cast<size_t>(size_max), size_);
+	burst_ = static_cast<uint64_t>(burst);
+	count_ = static_cast<uint64_t>(count);
+	random_.seed(static_cast<uint64_t>(seed));
+
+	return true;
+}
+
+int GeneratorIO::open()
+{
+	next_burst_ = std::chrono::steady_clock::now();
+	std::scoped_lock lock{ cancel_mutex_ };
+	cancelled_ = false;
+	return 0;
+}
+
+int GeneratorIO::close()
+{
+	return 0;
+}
+
+ssize_t GeneratorIO::read(std::vector<char>& buffer, size_t readMax)
+{
+	auto sequence = sequence_.load(std::memory_order::relaxed);
+
+	if (count_ != 0 && sequence >= count_)
+		return 0;
+
+	size_t limit = buffer.size();
+	if (readMax != 0 && readMax < limit)
+		limit = readMax;
+	if (limit < GeneratorHeader::SIZE)
+		return -EINVAL;
+
+	// Bursts are spread evenly, so the average rate is kept whatever the burst size is.
+	if (rate_ != 0 && sequence % burst_ == 0)
+	{
+		auto now = std::chrono::steady_clock::now();
+		if (now - next_burst_ > MAX_LAG)
+			next_burst_ = now;
+		std::unique_lock lock{ cancel_mutex_ };
+		if (cancel_cv_.wait_until(lock, next_burst_, [this]() { return cancelled_; }))
+			return 0;
+		next_burst_ += std::chrono::nanoseconds(burst_ * 1000000000ull / rate_);
+	}
+
+	auto start = metrics_clock();
+	auto size = std::min(next_size(), limit);
+	GeneratorHeader header{ getConfiguration().getID(), sequence, GeneratorHeader::now() };
+
+	header.encode(buffer.data());
+	std::memset(buffer.data() + GeneratorHeader::SIZE, static_cast<int>(sequence & 0xff), size - GeneratorHeader::SIZE);
+	sequence_.store(sequence + 1, std::memory_order::relaxed);
+
+	auto result = static_cast<ssize_t>(size);
+	metrics_.record_read(result, start);
+
+	return result;
+}
+
+ssize_t GeneratorIO::write(const std::vector<char>&, size_t)
+{
+	return -EINVAL;
+}
+
+void GeneratorIO::cancel()
+{
+	{
+		std::scoped_lock lock{ cancel_mutex_ };
+		cancelled_ = true;
+	}
+	cancel_cv_.notify_all();
+}
+
+size_t GeneratorIO::next_size()
+{
+	switch (distribution_)
+	{
+	case SizeDistribution::UNIFORM:
+		return std::uniform_int_distribution<size_t>(size_, size_max_)(random_);
+	case SizeDistribution::EXPONENTIAL:
+	{
+		// Mostly small messages with a long tail up to size_max.
+		double mean = static_cast<double>(size_max_ - size_) / 4.0;
+		if (mean <= 0.0)
+			return size_;
+		auto extra = std::exponential_distribution<double>(1.0 / mean)(random_);
+		return std::min(size_ + static_cast<size_t>(extra), size_max_);
+	}
+	case SizeDistribution::FIXED:
+	default:
+		return size_;
+	}
+}
@@ -0,0 +1,169 @@
+/**
+ *  @file   GeneratorIO.hpp
+ *  @brief  Synthetic traffic generator.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Generator is an input IO producing messages at the configured rate, size distribution and burst
+ *  pattern. Every message starts with GeneratorHeader carrying sequence number and timestamp, so
+ *  SinkIO at the end of the pipeline can measure end-to-end latency and losses.
+ */
+
+#ifndef SRC_IO_GENERATORIO_HPP_
+#define SRC_IO_GENERATORIO_HPP_
+
+#include "core/IO.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <random>
+
+/**
+* Header put at the beginning of every generated message.
+*/
+struct GeneratorHeader
+{
+	static constexpr uint32_t MAGIC = 0x47505753;			/*!< "SWPG" */
+	static constexpr size_t SIZE = 24;
+
+	uint32_t source{ 0 };									/*!< ID of the generator */
+	uint64_t sequence{ 0 };									/*!< Message number within the source */
+	uint64_t timestamp{ 0 };								/*!< Steady clock at generation time [ns] */
+
+	/**
+	* Store header in the buffer (at least SIZE bytes).
+	*/
+	void encode(char* buffer) const noexcept {
+		std::memcpy(buffer, &MAGIC, 4);
+		std::memcpy(buffer + 4, &source, 4);
+		std::memcpy(buffer + 8, &sequence, 8);
+		std::memcpy(buffer + 16, &timestamp, 8);
+	}
+
+	/**
+	* Read header from the buffer.
+	* @return True if buffer starts with valid header.
+	*/
+	bool decode(const char* buffer, size_t size) noexcept {
+		uint32_t magic = 0;
+		if (size < SIZE)
+			return false;
+		std::memcpy(&magic, buffer, 4);
+		if (magic != MAGIC)
+			return false;
+		std::memcpy(&source, buffer + 4, 4);
+		std::memcpy(&sequence, buffer + 8, 8);
+		std::memcpy(&timestamp, buffer + 16, 8);
+		return true;
+	}
+
+	/**
+	* Get timestamp in the header format.
+	*/
+	static uint64_t now() noexcept {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+};
+
+/**
+* Distribution of the generated message sizes.
+*/
+enum class SizeDistribution
+{
+	FIXED,
+	UNIFORM,
+	EXPONENTIAL
+};
+
+class GeneratorIO : public IO
+{
+public:
+	GeneratorIO() = default;
+
+	virtual ~GeneratorIO() override = default;
+
+	/**
+	* Method allowing module to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "generator"
+	*
+	* Optional configuration:
+	* rate = 1000							# messages per second, def: 0 - as fast as possible
+	* size = 64								# (minimal) message size, def: 64
+	* size_max = 1500						# maximal message size, def: size
+	* distribution = fixed/uniform/exponential	# def: uniform if size_max > size, otherwise fixed
+	* burst = 1								# messages sent back-to-back, def: 1
+	* count = 0								# messages to generate, def: 0 - unlimited
+	* seed = 1								# random seed, def: 1
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where module configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Start generating - pacing starts from now.
+	* @return Always 0.
+	*/
+	virtual int open() override;
+
+	/**
+	* Stop generating.
+	* @return Always 0.
+	*/
+	virtual int close() override;
+
+	/**
+	* Generate single message. Blocks until the message is due.
+	* @param[out] buffer array to store message
+	* @param[in] readMax max message size (must be less than buffer.max_size()).
+	* @return Size of the message, 0 when all messages were generated or negative if error occured.
+	*/
+	virtual ssize_t read(std::vector<char>& buffer, size_t readMax = 0) override;
+
+	/**
+	* Generator does not accept data.
+	* @return -EINVAL
+	*/
+	virtual ssize_t write(const std::vector<char>& buffer, size_t writeMax = 0) override;
+
+	/**
+	* Wake up read() waiting for the next burst, it returns 0 as at the end of the messages.
+	*/
+	virtual void cancel() override;
+
+	/**
+	* Get number of messages generated so far.
+	*/
+	uint64_t getGenerated() const noexcept {
+		return sequence_;
+	}
+
+private:
+	size_t next_size();
+
+	uint64_t rate_{ 0 };									/*!< Messages per second (0 - unlimited) */
+	size_t size_{ 64 };										/*!< Minimal message size */
+	size_t size_max_{ 64 };									/*!< Maximal message size */
+	SizeDistribution distribution_{ SizeDistribution::FIXED };
+	uint64_t burst_{ 1 };									/*!< Messages per burst */
+	uint64_t count_{ 0 };									/*!< Messages to generate (0 - unlimited) */
+
+	std::mt19937_64 random_;
+	std::chrono::steady_clock::time_point next_burst_;		/*!< When the next burst is due */
+	std::atomic<uint64_t> sequence_{ 0 };					/*!< Messages generated */
+
+	std::mutex cancel_mutex_;
+	std::condition_variable cancel_cv_;						/*!< Wakes read() waiting for the burst */
+	bool cancelled_{ false };
+};
+
+#endif /* SRC_IO_GENERATORIO_HPP_ */
@@ -0,0 +1,294 @@
+/**
+ *  @file   RotatingFile.cpp
+ *  @brief  Output file split into rotated segments.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "RotatingFile.hpp"
+#include "core/Journal.hpp"
+#include "transform/Compress.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#if defined(__linux__) && defined(SWPL_SYSTEM_HAVE_FCNTL_H) && defined(SWPL_SYSTEM_HAVE_UNISTD_H)
+#define SWPL_FILE_PREALLOCATE
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+* Closed segment is compressed in blocks of that size.
+*/
+static constexpr size_t COMPRESS_BLOCK = 1 << 20;
+
+static constexpr const char* COMPRESSED_SUFFIX = ".swz";
+
+RotatingFile::~RotatingFile()
+{
+	close();
+}
+
+bool RotatingFile::open()
+{
+	close();
+
+	index_ = first_free_index();
+	current_path_ = segment_path(index_);
+	current_size_ = 0;
+	opened_ = std::chrono::steady_clock::now();
+	if (!prepare(current_path_, current_))
+	{
+		LOG_ERROR("cannot create segment {}", current_path_);
+		return false;
+	}
+
+	stopping_ = false;
+	next_ready_ = false;
+	worker_ = std::thread(&RotatingFile::worker, this);
+	return true;
+}
+
+void RotatingFile::close()
+{
+	if (!worker_.joinable())
+		return;
+
+	{
+		// Segment started by the last rotation may have no data at all.
+		std::scoped_lock lock{ mutex_ };
+		if (current_size_ != 0 || rotations_ == 0)
+			closed_.push_back(Closed{ std::move(current_), current_path_, current_size_ });
+		else
+		{
+			current_.close();
+			std::remove(current_path_.c_str());
+		}
+		stopping_ = true;
+	}
+	work_.notify_all();
+	worker_.join();
+
+	// Segment prepared for the next rotation was never used.
+	if (next_ready_ && next_.is_open())
+	{
+		next_.close();
+		std::remove(next_path_.c_str());
+	}
+	next_ready_ = false;
+}
+
+bool RotatingFile::write(const char* data, size_t size)
+{
+	if (!current_.is_open())
+		return false;
+
+	current_.write(data, static_cast<std::streamsize>(size));
+	current_size_ += size;
+
+	bool due = settings_.size != 0 && current_size_ >= settings_.size;
+	if (!due && settings_.interval.count() != 0)
+		due = std::chrono::steady_clock::now() - opened_ >= settings_.interval;
+	if (due)
+		rotate();
+
+	return current_.good();
+}
+
+bool RotatingFile::sync()
+{
+	if (current_.is_open() && !current_.flush())
+		return false;
+	if (!Journal::sync_file(current_path_))
+		return false;
+
+	std::unique_lock lock{ mutex_ };
+	done_.wait(lock, [this]() { return closed_.empty() && finalizing_ == 0; });
+	return true;
+}
+
+std::string RotatingFile::segment_path(uint64_t index) const
+{
+	char number[24];
+	std::snprintf(number, sizeof(number), ".%06llu", static_cast<unsigned long long>(index));
+	return settings_.path + number;
+}
+
+uint64_t RotatingFile::first_free_index() const
+{
+	const std::filesystem::path path{ settings_.path };
+	const auto prefix = path.filename().string() + ".";
+	auto directory = path.parent_path();
+	uint64_t index = 0;
+	std::error_code error;
+
+	for (const auto& entry : std::filesystem::directory_iterator(directory.empty() ? "." : directory, error))
+	{
+		auto name = entry.path().filename().string();
+		if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+			continue;
+
+		auto number = name.substr(prefix.size());
+		if (number.size() > 4 && number.compare(number.size() - 4, 4, COMPRESSED_SUFFIX) == 0)
+			number.resize(number.size() - 4);
+		if (number.empty() || number.size() > 19 || !std::all_of(number.begin(), number.end(), [](char c) { return c >= '0' && c <= '9'; }))
+			continue;
+
+		index = std::max<uint64_t>(index, std::stoull(number) + 1);
+	}
+
+	return index;
+}
+
+bool RotatingFile::prepare(const std::string& path, std::fstream& stream) const
+{
+	stream.open(path, std::fstream::out | std::fstream::trunc);
+	if (!stream.is_open())
+		return false;
+
+#if defined(SWPL_FILE_PREALLOCATE)
+	// Space is reserved without changing the file size, so readers see only the data written.
+	if (settings_.preallocate && settings_.size != 0)
+	{
+		int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+		if (fd >= 0)
+		{
+			::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(settings_.size));
+			::close(fd);
+		}
+	}
+#endif
+
+	return true;
+}
+
+void RotatingFile::rotate()
+{
+	std::unique_lock lock{ mutex_ };
+
+	if (!next_ready_)
+	{
+		++stalls_;
+		done_.wait(lock, [this]() { return next_ready_; });
+	}
+
+	next_ready_ = false;
+	if (!next_.is_open())
+	{
+		// Next segment could not be created - current one keeps growing until the next try.
+		LOG_WARNING("cannot create segment {}, {} is not rotated", next_path_, current_path_);
+		work_.notify_all();
+		return;
+	}
+
+	closed_.push_back(Closed{ std::move(current_), std::move(current_path_), current_size_ });
+	current_ = std::move(next_);
+	current_path_ = next_path_;
+	current_size_ = 0;
+	opened_ = std::chrono::steady_clock::now();
+	++index_;
+	++rotations_;
+
+	lock.unlock();
+	work_.notify_all();
+}
+
+void RotatingFile::worker()
+{
+	std::unique_lock lock{ mutex_ };
+
+	for (;;)
+	{
+		work_.wait(lock, [this]() { return stopping_ || !closed_.empty() || !next_ready_; });
+
+		// Next segment comes first, writer may be waiting for it.
+		if (!next_ready_ && !stopping_)
+		{
+			auto path = segment_path(index_ + 1);
+			lock.unlock();
+			std::fstream stream;
+			prepare(path, stream);
+			lock.lock();
+
+			next_ = std::move(stream);
+			next_path_ = std::move(path);
+			next_ready_ = true;
+			done_.notify_all();
+			continue;
+		}
+
+		if (!closed_.empty())
+		{
+			auto closed = std::move(closed_.front());
+			closed_.pop_front();
+			++finalizing_;
+			lock.unlock();
+			finalize(std::move(closed));
+			lock.lock();
+			--finalizing_;
+			done_.notify_all();
+			continue;
+		}
+
+		if (stopping_)
+			break;
+	}
+}
+
+void RotatingFile::finalize(Closed&& closed) const
+{
+	closed.stream.close();
+
+#if defined(SWPL_FILE_PREALLOCATE)
+	int fd = ::open(closed.path.c_str(), O_WRONLY | O_CLOEXEC);
+	if (fd >= 0)
+	{
+		// Preallocated space after the data is given back.
+		if (settings_.preallocate && closed.size < settings_.size)
+			::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(closed.size), static_cast<off_t>(settings_.size - closed.size));
+		if (::fdatasync(fd) != 0)
+			LOG_WARNING("cannot sync segment {}", closed.path);
+		::close(fd);
+	}
+#else
+	if (!Journal::sync_file(closed.path))
+		LOG_WARNING("cannot sync segment {}", closed.path);
+#endif
+
+	if (settings_.compress && !compress(closed.path))
+		LOG_WARNING("cannot compress segment {}", closed.path);
+}
+
+bool RotatingFile::compress(const std::string& path) const
+{
+	const auto compressed = path + COMPRESSED_SUFFIX;
+	FrameEncoder encoder;
+	std::vector<char> block(COMPRESS_BLOCK);
+	std::vector<uint8_t> frame;
+
+	{
+		std::ifstream input(path, std::ios::binary);
+		std::ofstream output(compressed, std::ios::binary | std::ios::trunc);
+		if (!input.is_open() || !output.is_open())
+			return false;
+
+		while (input.read(block.data(), static_cast<std::streamsize>(block.size())) || input.gcount() > 0)
+		{
+			encoder.encode(reinterpret_cast<const uint8_t*>(block.data()), static_cast<size_t>(input.gcount()), frame);
+			output.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.size()));
+		}
+
+		if (!output.flush())
+			return false;
+	}
+
+	// Original is removed only when the compressed copy is durable.
+	if (!Journal::sync_file(compressed))
+		return false;
+	return std::remove(path.c_str()) == 0;
+}
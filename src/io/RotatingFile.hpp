@@ -0,0 +1,167 @@
+/**
+ *  @file   RotatingFile.hpp
+ *  @brief  Output file split into rotated segments.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Data is written to segments named after the file with a sequence number (file.000000,
+ *  file.000001, ...), numbering continues after the segments already present. Segment is closed
+ *  when it reaches the size or is open longer than the interval (checked when data is written, a
+ *  write is never split between segments).
+ *
+ *  Rotation does not touch the disk on the data path. Background thread keeps the next segment
+ *  already created (and preallocated with fallocate() where available), so writer only swaps the
+ *  streams. Closed segments are handed back to the thread, which flushes them, releases the
+ *  preallocated space beyond the data, syncs them and optionally compresses them into file.N.swz
+ *  (frames of the compress stage, readable with a decompress stage).
+ */
+
+#ifndef SRC_IO_ROTATINGFILE_HPP_
+#define SRC_IO_ROTATINGFILE_HPP_
+
+#include "Global.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class RotatingFile
+{
+public:
+	struct Settings
+	{
+		std::string path;									/*!< Base path of the segments */
+		uint64_t size{ 0 };									/*!< Rotate at that size, 0 - no size limit */
+		std::chrono::milliseconds interval{ 0 };			/*!< Rotate after that time, 0 - no time limit */
+		bool preallocate{ true };							/*!< Preallocate segments of the size limit */
+		bool compress{ false };								/*!< Compress closed segments */
+	};
+
+	explicit RotatingFile(const Settings& settings) : settings_{ settings } { }
+	~RotatingFile();
+
+	RotatingFile(const RotatingFile&) = delete;
+	RotatingFile& operator=(const RotatingFile&) = delete;
+
+	/**
+	* Open the first segment and start the background thread.
+	* @return True if successful.
+	*/
+	bool open();
+
+	/**
+	* Close the current segment and wait until all closed segments are finalized.
+	*/
+	void close();
+
+	/**
+	* Write data to the current segment, rotating it when it is due. Calls of write() and sync()
+	* must not overlap.
+	* @param[in] data data
+	* @param[in] size size of the data
+	* @return True if data was written.
+	*/
+	bool write(const char* data, size_t size);
+
+	/**
+	* Make all data written so far durable - flush and sync the current segment and wait for the
+	* closed ones to be finalized.
+	* @return True if successful.
+	*/
+	bool sync();
+
+	/**
+	* Get path of the segment with the given number.
+	*/
+	std::string segment_path(uint64_t index) const;
+
+	/**
+	* Get path of the segment written now.
+	*/
+	const std::string& getCurrentPath() const {
+		return current_path_;
+	}
+
+	/**
+	* Get number of rotations.
+	*/
+	uint64_t getRotations() const {
+		return rotations_;
+	}
+
+	/**
+	* Get number of rotations that had to wait for the next segment to be created.
+	*/
+	uint64_t getStalls() const {
+		return stalls_;
+	}
+
+private:
+	struct Closed
+	{
+		std::fstream stream;
+		std::string path;
+		uint64_t size{ 0 };
+	};
+
+	/**
+	* Find the first segment number not used yet.
+	*/
+	uint64_t first_free_index() const;
+
+	/**
+	* Create the segment and preallocate its space.
+	*/
+	bool prepare(const std::string& path, std::fstream& stream) const;
+
+	/**
+	* Switch to the next segment.
+	*/
+	void rotate();
+
+	/**
+	* Flush, trim, sync and (optionally) compress the closed segment.
+	*/
+	void finalize(Closed&& closed) const;
+
+	/**
+	* Compress the segment into the .swz file and remove it.
+	*/
+	bool compress(const std::string& path) const;
+
+	/**
+	* Prepare next segments and finalize closed ones until stopped.
+	*/
+	void worker();
+
+	Settings settings_;
+
+	std::fstream current_;
+	std::string current_path_;
+	uint64_t current_size_{ 0 };
+	std::chrono::steady_clock::time_point opened_;
+	uint64_t index_{ 0 };									/*!< Number of the current segment */
+
+	std::mutex mutex_;
+	std::condition_variable work_;							/*!< Wakes up the background thread */
+	std::condition_variable done_;							/*!< Next segment prepared or closed ones finalized */
+	std::fstream next_;										/*!< Segment prepared for the rotation */
+	std::string next_path_;
+	bool next_ready_{ false };
+	std::deque<Closed> closed_;								/*!< Segments waiting for finalization */
+	unsigned int finalizing_{ 0 };
+	bool stopping_{ false };
+	std::thread worker_;
+
+	uint64_t rotations_{ 0 };
+	uint64_t stalls_{ 0 };
+};
+
+#endif /* SRC_IO_ROTATINGFILE_HPP_ */
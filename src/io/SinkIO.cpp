@@ -0,0 +1,123 @@
+/**
+ *  @file   SinkIO.cpp
+ *  @brief  Measuring sink for the generated traffic.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "SinkIO.hpp"
+#include "GeneratorIO.hpp"
+
+#include <algorithm>
+
+uint64_t SinkReport::latency_quantile(double quantile) const noexcept
+{
+	uint64_t total = 0;
+
+	for (auto count : latency)
+		total += count;
+	if (total == 0)
+		return 0;
+
+	quantile = std::clamp(quantile, 0.0, 1.0);
+	auto rank = std::max<uint64_t>(static_cast<uint64_t>(quantile * static_cast<double>(total)), 1);
+
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < latency.size(); ++i)
+	{
+		seen += latency[i];
+		if (seen >= rank)
+			return std::min(LatencyHistogram::bucket_upper(i), latency_max);
+	}
+
+	return latency_max;
+}
+
+bool SinkIO::configure(ConfigurationManager& config, const std::string& section)
+{
+	return IO::configure(config, section) && getConfiguration().getDirection() != StreamDirection::INPUT;
+}
+
+int SinkIO::open()
+{
+	std::scoped_lock lock{ lock_ };
+
+	report_ = SinkReport{};
+	report_.latency.assign(LatencyHistogram::BUCKETS, 0);
+	first_ = last_ = 0;
+	expected_.clear();
+
+	return 0;
+}
+
+int SinkIO::close()
+{
+	return 0;
+}
+
+ssize_t SinkIO::read(std::vector<char>&, size_t)
+{
+	return 0;
+}
+
+ssize_t SinkIO::write(const std::vector<char>& buffer, size_t writeMax)
+{
+	size_t size = buffer.size();
+	if (writeMax != 0 && writeMax < size)
+		size = writeMax;
+
+	auto start = metrics_clock();
+	auto now = GeneratorHeader::now();
+	GeneratorHeader header;
+	bool tagged = header.decode(buffer.data(), size);
+
+	{
+		std::scoped_lock lock{ lock_ };
+
+		if (report_.latency.empty())
+			report_.latency.assign(LatencyHistogram::BUCKETS, 0);
+		if (report_.messages == 0)
+			first_ = now;
+		last_ = now;
+		report_.messages++;
+		report_.bytes += size;
+
+		if (tagged)
+		{
+			auto latency = now > header.timestamp ? now - header.timestamp : 0;
+			report_.tagged++;
+			report_.latency[LatencyHistogram::bucket_index(latency)]++;
+			report_.latency_max = std::max(report_.latency_max, latency);
+
+			auto& expected = expected_[header.source];
+			if (header.sequence < expected)
+			{
+				report_.reordered++;
+				if (report_.lost > 0)
+					report_.lost--;									// Counted as lost when the gap was seen.
+			}
+			else
+			{
+				report_.lost += header.sequence - expected;
+				expected = header.sequence + 1;
+			}
+		}
+	}
+
+	auto result = static_cast<ssize_t>(size);
+	metrics_.record_write(result, start);
+
+	return result;
+}
+
+SinkReport SinkIO::getReport() const
+{
+	std::scoped_lock lock{ lock_ };
+	SinkReport report = report_;
+
+	report.seconds = static_cast<double>(last_ - first_) / 1e9;
+
+	return report;
+}
@@ -0,0 +1,103 @@
+/**
+ *  @file   SinkIO.hpp
+ *  @brief  Measuring sink for the generated traffic.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Sink is an output IO that discards the data but accounts every message: throughput, end-to-end
+ *  latency (from the GeneratorHeader timestamp) and messages lost or reordered on the way.
+ */
+
+#ifndef SRC_IO_SINKIO_HPP_
+#define SRC_IO_SINKIO_HPP_
+
+#include "core/IO.hpp"
+#include "core/Metrics.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+* Snapshot of what the sink has seen.
+*/
+struct SinkReport
+{
+	uint64_t messages{ 0 };								/*!< All messages written to the sink */
+	uint64_t bytes{ 0 };
+	uint64_t tagged{ 0 };								/*!< Messages with generator header */
+	uint64_t lost{ 0 };									/*!< Gaps in the sequence numbers */
+	uint64_t reordered{ 0 };							/*!< Messages older than already seen ones */
+	double seconds{ 0.0 };								/*!< Time between the first and the last message */
+	uint64_t latency_max{ 0 };							/*!< Highest end-to-end latency [ns] */
+	std::vector<uint64_t> latency;						/*!< Latency histogram (LatencyHistogram buckets) */
+
+	/**
+	* Get end-to-end latency quantile.
+	* @param[in] quantile quantile (0.0 - 1.0)
+	* @return Upper bound of the bucket containing the quantile [ns] or 0 if nothing was measured.
+	*/
+	uint64_t latency_quantile(double quantile) const noexcept;
+};
+
+class SinkIO : public IO
+{
+public:
+	SinkIO() = default;
+
+	virtual ~SinkIO() override = default;
+
+	/**
+	* Method allowing module to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "sink"
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where module configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Reset the statistics.
+	* @return Always 0.
+	*/
+	virtual int open() override;
+
+	/**
+	* Nothing to close.
+	* @return Always 0.
+	*/
+	virtual int close() override;
+
+	/**
+	* Sink produces no data.
+	* @return Always 0 (end of stream).
+	*/
+	virtual ssize_t read(std::vector<char>& buffer, size_t readMax = 0) override;
+
+	/**
+	* Account single message and discard it.
+	* @param[in] buffer message
+	* @param[in] writeMax message size (0 - whole buffer)
+	* @return Size of the message.
+	*/
+	virtual ssize_t write(const std::vector<char>& buffer, size_t writeMax = 0) override;
+
+	/**
+	* Get statistics collected since open().
+	*/
+	SinkReport getReport() const;
+
+private:
+	mutable std::mutex lock_;							/*!< Guards statistics against report readers */
+	SinkReport report_;
+	uint64_t first_{ 0 };								/*!< Time of the first message [ns] */
+	uint64_t last_{ 0 };								/*!< Time of the last message [ns] */
+	std::unordered_map<uint32_t, uint64_t> expected_;	/*!< Next expected sequence per generator */
+};
+
+#endif /* SRC_IO_SINKIO_HPP_ */
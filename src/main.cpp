@@ -8,6 +8,77 @@
  */
 
 #include "config/ConfigurationManager.hpp"
+#include "core/MetricsExporter.hpp"
+#include "core/Pipeline.hpp"
+#include "io/GeneratorIO.hpp"
+#include "io/SinkIO.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+static std::atomic<bool> terminate_requested{ false };
+static std::atomic<bool> reload_requested{ false };
+
+extern "C" void handle_terminate(int)
+{
+	terminate_requested.store(true);
+}
+
+extern "C" void handle_reload(int)
+{
+	reload_requested.store(true);
+}
+
+static void print_usage()
+{
+	std::cout << "swpl -c <config_file> [-h] [-v] [-d] [--bench <seconds>]" << std::endl << std::endl
+		<< "-c <config_file>        path to the configuration file" << std::endl
+		<< "--bench <seconds>       run the pipeline for given time and print report of generators and sinks" << std::endl
+		<< "-h                      display this help" << std::endl
+		<< "-v                      be more verbose" << std::endl
+		<< "-d                      don't deamonize application" << std::endl;
+}
+
+/**
+* Print what generators produced and what sinks received during the benchmark.
+*/
+static void print_bench_report(const Pipeline& pipeline, double seconds)
+{
+	std::cout << std::fixed << std::setprecision(1);
+
+	pipeline.for_each_stage([seconds](const std::string& name, const Stage& stage) {
+		auto ioStage = dynamic_cast<const IOStage*>(&stage);
+		if (ioStage == nullptr)
+			return;
+
+		if (auto generator = dynamic_cast<const GeneratorIO*>(&ioStage->getIO()))
+		{
+			const auto& metrics = generator->getMetrics();
+			std::cout << "generator " << name << ": " << generator->getGenerated() << " messages, "
+				<< metrics.read_bytes.value() << " bytes, "
+				<< static_cast<double>(generator->getGenerated()) / seconds << " msg/s" << std::endl;
+		}
+		else if (auto sink = dynamic_cast<const SinkIO*>(&ioStage->getIO()))
+		{
+			auto report = sink->getReport();
+			auto duration = report.seconds > 0.0 ? report.seconds : seconds;
+			std::cout << "sink " << name << ": " << report.messages << " messages, " << report.bytes << " bytes, "
+				<< static_cast<double>(report.messages) / duration << " msg/s, "
+				<< static_cast<double>(report.bytes) / duration / 1e6 << " MB/s, "
+				<< report.lost << " lost, " << report.reordered << " reordered" << std::endl
+				<< "  latency [us]: p50 " << static_cast<double>(report.latency_quantile(0.5)) / 1e3
+				<< " p90 " << static_cast<double>(report.latency_quantile(0.9)) / 1e3
+				<< " p99 " << static_cast<double>(report.latency_quantile(0.99)) / 1e3
+				<< " p99.9 " << static_cast<double>(report.latency_quantile(0.999)) / 1e3
+				<< " max " << static_cast<double>(report.latency_max) / 1e3 << std::endl;
+		}
+	});
+}
 
 int main(int argc, char *argv[])
 {
@@ -15,6 +86,83 @@ int main(int argc, char *argv[])
 
 	configurationManager.parseConfiguration(argc, argv);
 
-	return 0;
-}
+	auto appConfig = configurationManager.getAppConfig();
+	if (!appConfig.valid || appConfig.help || appConfig.config == nullptr)
+	{
+		print_usage();
+		return appConfig.help ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	Logger::set_level(appConfig.verbose ? LogLevel::VERBOSE : LogLevel::WARNING);
+
+	Pipeline pipeline;
+	if (!pipeline.configure(configurationManager, "pipeline"))
+	{
+		std::cerr << "Invalid pipeline configuration in " << appConfig.config << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Metrics are exported only if the configuration asks for it. Metrics section is read only here, reload does not touch it.
+	MetricsExporter exporter(pipeline);
+	ConfigurationManager::SectionStructure metricsSection;
+	bool exportMetrics = configurationManager.getSection("metrics", metricsSection);
+	if (exportMetrics && !exporter.configure(configurationManager, "metrics"))
+	{
+		std::cerr << "Invalid metrics configuration in " << appConfig.config << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::signal(SIGINT, handle_terminate);
+	std::signal(SIGTERM, handle_terminate);
+#ifdef SIGHUP
+	std::signal(SIGHUP, handle_reload);		// Reload configuration and apply changes to the running pipeline.
+#endif
+
+	if (!pipeline.start())
+	{
+		std::cerr << "Cannot start pipeline " << appConfig.config << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (exportMetrics && !exporter.start())
+		std::cerr << "Cannot start metrics exporter" << std::endl;
+
+	if (appConfig.bench != 0)
+	{
+		auto start = std::chrono::steady_clock::now();
+		auto end = start + std::chrono::seconds(appConfig.bench);
 
+		while (!terminate_requested.load() && std::chrono::steady_clock::now() < end)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		pipeline.stop();
+		exporter.stop();
+		print_bench_report(pipeline, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		Logger::flush();
+
+		return EXIT_SUCCESS;
+	}
+
+	while (!terminate_requested.load())
+	{
+		if (reload_requested.exchange(false))
+		{
+			// Configuration kept by the manager must be the one the pipeline runs, next reload is compared with it.
+			if (!configurationManager.reload())
+				std::cerr << "Configuration reload failed, running pipeline left unchanged" << std::endl;
+			else if (!pipeline.reconfigure(configurationManager))
+			{
+				configurationManager.revert();
+				std::cerr << "Reloaded configuration cannot be applied, previous configuration restored" << std::endl;
+			}
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	exporter.stop();
+	pipeline.stop();
+	Logger::flush();
+
+	return EXIT_SUCCESS;
+}
@@ -51,6 +51,12 @@ public:
 	 */
 	static void* getFuncAddr(void* libraryHandle, const char *functionName);
 
+	/**
+	 * Unloads library. Addresses of its functions must not be used afterwards.
+	 * @param[in] libraryHandle handle to the library returned by loadLibrary function
+	 */
+	static void freeLibrary(void* libraryHandle);
+
 };
 
 #endif /* SRC_OSDEP_DL_H_ */
@@ -32,3 +32,9 @@ void* DL::getFuncAddr(void* libraryHandle, const char* functionName)
 
 	return (addr);
 }
+
+void DL::freeLibrary(void* libraryHandle)
+{
+	if (libraryHandle != nullptr)
+		dlclose(libraryHandle);
+}
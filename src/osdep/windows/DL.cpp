@@ -28,3 +28,9 @@ void* DL::getFuncAddr(void* libraryHandle, const char* functionName)
 
 	return (addr);
 }
+
+void DL::freeLibrary(void* libraryHandle)
+{
+	if (libraryHandle != nullptr)
+		FreeLibrary((HMODULE)libraryHandle);
+}
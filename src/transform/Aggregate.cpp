@@ -0,0 +1,260 @@
+/**
+ *  @file   Aggregate.cpp
+ *  @brief  Replaces messages with their statistics in time windows.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Aggregate.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	WINDOW,
+	SLIDE,
+	VALUE,
+	COLUMN,
+	DELIMITER,
+	OFFSET,
+	SIZE,
+	VALUE_BIG_ENDIAN,
+	EMIT_EMPTY,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::WINDOW, {"window", SettingType::UNSIGNED}},
+	{SettingLabel::SLIDE, {"slide", SettingType::UNSIGNED}},
+	{SettingLabel::VALUE, {"value", SettingType::STRING}},
+	{SettingLabel::COLUMN, {"column", SettingType::UNSIGNED}},
+	{SettingLabel::DELIMITER, {"delimiter", SettingType::STRING}},
+	{SettingLabel::OFFSET, {"offset", SettingType::UNSIGNED}},
+	{SettingLabel::SIZE, {"size", SettingType::UNSIGNED}},
+	{SettingLabel::VALUE_BIG_ENDIAN, {"big_endian", SettingType::BOOL}},
+	{SettingLabel::EMIT_EMPTY, {"emit_empty", SettingType::BOOL}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Upper limit of the number of buckets in the ring (window divided by slide).
+*/
+static constexpr size_t MAX_RING = 4096;
+
+bool AggregateTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string value{ "none" }, text, literal;
+	uint64_t window = 1000, slide = 0;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	column_ = 1;
+	delimiter_ = ',';
+	offset_ = 0;
+	size_ = 4;
+	big_endian_ = true;
+	emit_empty_ = true;
+	invalid_ = 0;
+	series_.clear();
+
+	config.get(section, SETTINGS.at(SettingLabel::WINDOW).setting_name, window);
+	config.get(section, SETTINGS.at(SettingLabel::SLIDE).setting_name, slide);
+	if (slide == 0)
+		slide = window;
+	if (window == 0 || window % slide != 0 || window / slide > MAX_RING)
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::VALUE).setting_name, value);
+	if (value == "none")
+		value_ = Value::NONE;
+	else if (value == "column")
+		value_ = Value::COLUMN;
+	else if (value == "binary")
+		value_ = Value::BINARY;
+	else
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::COLUMN).setting_name, column_);
+	if (config.get(section, SETTINGS.at(SettingLabel::DELIMITER).setting_name, text))
+	{
+		if (!unescape_literal(text, literal) || literal.size() != 1)
+			return false;
+		delimiter_ = static_cast<uint8_t>(literal[0]);
+	}
+	config.get(section, SETTINGS.at(SettingLabel::OFFSET).setting_name, offset_);
+	config.get(section, SETTINGS.at(SettingLabel::SIZE).setting_name, size_);
+	config.get(section, SETTINGS.at(SettingLabel::VALUE_BIG_ENDIAN).setting_name, big_endian_);
+	config.get(section, SETTINGS.at(SettingLabel::EMIT_EMPTY).setting_name, emit_empty_);
+
+	if (column_ == 0 || (size_ != 1 && size_ != 2 && size_ != 4 && size_ != 8))
+		return false;
+
+	slide_ = std::chrono::milliseconds(slide);
+	ring_size_ = window / slide;
+	current_ = 0;
+	slide_end_ = std::chrono::steady_clock::now() + slide_;
+
+	return true;
+}
+
+void AggregateTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				add(data, src);
+			}
+
+			close(std::chrono::steady_clock::now(), [&routes, this](std::vector<uint8_t>&& report, unsigned int src) {
+				send_to_all(std::move(report), routes, src);
+			});
+		}
+
+		if (idle)
+			wait_for_data_until(sequence, slide_end_);
+	}
+}
+
+void AggregateTransformation::source_changed(unsigned int slot)
+{
+	// Statistics of the unregistered cooperative are not reported as those of the new one.
+	if (slot < series_.size())
+		series_[slot] = Series{};
+}
+
+void AggregateTransformation::add(const std::vector<uint8_t>& data, unsigned int src)
+{
+	if (series_.size() <= src)
+		series_.resize(src + 1);
+
+	auto& ring = series_[src].ring;
+	if (ring.empty())
+		ring.resize(ring_size_);
+
+	auto& bucket = ring[current_];
+	++bucket.count;
+	bucket.bytes += data.size();
+
+	double number;
+	if (value_ == Value::NONE)
+		return;
+	if (!value(data, number))
+	{
+		++invalid_;
+		return;
+	}
+
+	++bucket.values;
+	bucket.min = std::min(bucket.min, number);
+	bucket.max = std::max(bucket.max, number);
+}
+
+bool AggregateTransformation::value(const std::vector<uint8_t>& data, double& number) const noexcept
+{
+	if (value_ == Value::BINARY)
+	{
+		if (data.size() < offset_ + size_)
+			return false;
+
+		uint64_t integer = 0;
+		for (size_t i = 0; i < size_; ++i)
+		{
+			auto byte = big_endian_ ? data[offset_ + i] : data[offset_ + size_ - 1 - i];
+			integer = (integer << 8) | byte;
+		}
+		number = static_cast<double>(integer);
+		return true;
+	}
+
+	const char* begin = reinterpret_cast<const char*>(data.data());
+	const char* end = begin + data.size();
+
+	for (size_t column = 1; column < column_; ++column)
+	{
+		auto next = static_cast<const char*>(std::memchr(begin, delimiter_, static_cast<size_t>(end - begin)));
+		if (next == nullptr)
+			return false;
+		begin = next + 1;
+	}
+
+	while (begin != end && *begin == ' ')
+		++begin;
+	auto result = std::from_chars(begin, end, number);
+	return result.ec == std::errc{};
+}
+
+bool AggregateTransformation::report(const Series& series, std::vector<uint8_t>& line) const
+{
+	Bucket total;
+
+	if (series.ring.empty())
+		return false;
+
+	for (const auto& bucket : series.ring)
+	{
+		total.count += bucket.count;
+		total.bytes += bucket.bytes;
+		total.values += bucket.values;
+		total.min = std::min(total.min, bucket.min);
+		total.max = std::max(total.max, bucket.max);
+	}
+
+	if (total.count == 0 && !emit_empty_)
+		return false;
+
+	char buffer[192];
+	char* at = buffer;
+	char* end = buffer + sizeof(buffer);
+	auto put = [&at, end](const char* label, auto number) {
+		at = std::copy(label, label + std::strlen(label), at);
+		at = std::to_chars(at, end, number).ptr;
+	};
+
+	auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	put("time=", static_cast<int64_t>(time));
+	put(" count=", total.count);
+	put(" bytes=", total.bytes);
+	if (total.values != 0)
+	{
+		put(" min=", total.min);
+		put(" max=", total.max);
+	}
+	*at++ = '\n';
+
+	line.assign(buffer, at);
+	return true;
+}
+
+void AggregateTransformation::advance()
+{
+	current_ = (current_ + 1) % ring_size_;
+	slide_end_ += slide_;
+
+	for (auto& series : series_)
+	{
+		if (!series.ring.empty())
+			series.ring[current_] = Bucket{};
+	}
+}
@@ -0,0 +1,176 @@
+/**
+ *  @file   Aggregate.hpp
+ *  @brief  Replaces messages with their statistics in time windows.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Messages of every cooperative are counted in a fixed ring of buckets, each covering one slide of
+ *  time. When the slide ends, report of the whole window (all buckets of the ring) is passed on and
+ *  the oldest bucket is reused for the next slide. Slide equal to the window gives tumbling windows
+ *  (ring of a single bucket), shorter slide - sliding ones. Report is a single text line:
+ *
+ *      time=1760868000000 count=120 bytes=48213 min=0.5 max=97\n
+ *
+ *  with time (ms since the epoch) of the window end, min and max of the numeric field are present
+ *  only when some message in the window had it. Numeric field is a column of the delimited text
+ *  record or unsigned binary integer at the offset.
+ */
+
+#ifndef SRC_TRANSFORM_AGGREGATE_HPP_
+#define SRC_TRANSFORM_AGGREGATE_HPP_
+
+#include "../core/Stage.hpp"
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+
+class AggregateTransformation : public TransformStage
+{
+public:
+	enum class Value
+	{
+		NONE,												/*!< Messages are only counted */
+		COLUMN,												/*!< Number in the column of the text record */
+		BINARY												/*!< Unsigned integer at the offset */
+	};
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "aggregate"
+	*
+	* Optional configuration:
+	* window = 1000							# length of the window [ms], def: 1000
+	* slide = 1000							# time between reports [ms], window must be its multiple, def: window
+	* value = "none"						# numeric field: none, column or binary, def: none
+	* column = 1							# column mode: column holding the number (counted from 1), def: 1
+	* delimiter = ","						# column mode: single byte separating columns, def: ","
+	* offset = 0							# binary mode: offset of the number, def: 0
+	* size = 4								# binary mode: size of the number (1, 2, 4 or 8), def: 4
+	* big_endian = true						# binary mode: byte order of the number, def: true
+	* emit_empty = true						# report windows without messages, def: true
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Count incoming messages and pass reports on to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Count the message in the current slide.
+	* @param[in] data message
+	* @param[in] src cooperative the message came from
+	*/
+	void add(const std::vector<uint8_t>& data, unsigned int src);
+
+	/**
+	* End all slides finished before the time, reporting their windows. Windows of cooperatives
+	* that have not sent anything yet are not reported.
+	* @param[in] now current time
+	* @param[in] on_report callable void(std::vector<uint8_t>&& report, unsigned int src)
+	* @return Number of reports.
+	*/
+	template<typename Callback>
+	size_t close(std::chrono::steady_clock::time_point now, Callback&& on_report) {
+		size_t reports = 0, steps = 0;
+
+		while (slide_end_ <= now)
+		{
+			for (unsigned int src = 0; src < series_.size(); ++src)
+			{
+				std::vector<uint8_t> line;
+				if (report(series_[src], line))
+				{
+					on_report(std::move(line), src);
+					++reports;
+				}
+			}
+			advance();
+
+			// Once the whole ring is empty, windows up to the current one are known to be empty too.
+			if (++steps >= ring_size_ && slide_end_ + slide_ <= now)
+				slide_end_ += ((now - slide_end_) / slide_) * slide_;
+		}
+
+		return reports;
+	}
+
+	/**
+	* Get time the current slide ends at.
+	*/
+	std::chrono::steady_clock::time_point getSlideEnd() const {
+		return slide_end_;
+	}
+
+	/**
+	* Get number of messages the numeric field could not be read from.
+	*/
+	uint64_t getInvalid() const {
+		return invalid_;
+	}
+
+protected:
+	/**
+	* Forget the statistics left in the slot by the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+private:
+	struct Bucket
+	{
+		uint64_t count{ 0 };
+		uint64_t bytes{ 0 };
+		uint64_t values{ 0 };								/*!< Messages with the numeric field */
+		double min{ std::numeric_limits<double>::infinity() };
+		double max{ -std::numeric_limits<double>::infinity() };
+	};
+
+	struct Series
+	{
+		std::vector<Bucket> ring;							/*!< Empty until the cooperative sends something */
+	};
+
+	/**
+	* Read numeric field of the message.
+	* @return False if message does not have it.
+	*/
+	bool value(const std::vector<uint8_t>& data, double& number) const noexcept;
+
+	/**
+	* Build report of the window.
+	* @return False if there is nothing to report.
+	*/
+	bool report(const Series& series, std::vector<uint8_t>& line) const;
+
+	/**
+	* Move to the next slide - its bucket (the oldest one) is emptied.
+	*/
+	void advance();
+
+	std::chrono::steady_clock::duration slide_{ std::chrono::seconds(1) };
+	size_t ring_size_{ 1 };
+	Value value_{ Value::NONE };
+	size_t column_{ 0 };
+	uint8_t delimiter_{ ',' };
+	size_t offset_{ 0 };
+	size_t size_{ 4 };
+	bool big_endian_{ true };
+	bool emit_empty_{ true };
+
+	std::vector<Series> series_;							/*!< Indexed by cooperative slot */
+	size_t current_{ 0 };									/*!< Bucket of the current slide */
+	std::chrono::steady_clock::time_point slide_end_;
+
+	uint64_t invalid_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_AGGREGATE_HPP_ */
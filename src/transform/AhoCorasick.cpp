@@ -0,0 +1,261 @@
+/**
+ *  @file   AhoCorasick.cpp
+ *  @brief  Multi-pattern literal matcher.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "AhoCorasick.hpp"
+
+#include <cstring>
+#include <deque>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <tmmintrin.h>
+#define SWPL_HAVE_SSSE3_TARGET
+#endif
+
+/**
+* Above this number of distinct first bytes the prefilter would stop too often to pay off.
+*/
+static constexpr size_t PREFILTER_MAX_FIRST = 192;
+
+int AhoCorasick::add(std::string_view pattern)
+{
+	if (pattern.empty())
+		return -1;
+
+	patterns_.emplace_back(pattern);
+	return static_cast<int>(patterns_.size() - 1);
+}
+
+void AhoCorasick::compile()
+{
+	constexpr State NO_STATE = std::numeric_limits<State>::max();
+
+	std::vector<std::vector<uint32_t>> outputs(1);
+	std::vector<State> fail(1, START);
+	std::vector<uint32_t> depths(1, 0);
+	std::vector<State> full(256, NO_STATE);						// Built with 256 transitions per state
+
+	first_.fill(false);
+
+	// Trie first - missing transitions are filled in while failure links are computed.
+	for (size_t index = 0; index < patterns_.size(); ++index)
+	{
+		State current = START;
+		for (auto c : patterns_[index])
+		{
+			auto slot = (static_cast<size_t>(current) << 8) | static_cast<uint8_t>(c);
+			if (full[slot] == NO_STATE)
+			{
+				full[slot] = static_cast<State>(outputs.size());
+				outputs.emplace_back();
+				fail.push_back(START);
+				depths.push_back(depths[current] + 1);
+				full.resize(full.size() + 256, NO_STATE);
+			}
+			current = full[slot];
+		}
+		outputs[current].push_back(static_cast<uint32_t>(index));
+		first_[static_cast<uint8_t>(patterns_[index][0])] = true;
+	}
+
+	// Breadth first, so failure target of every state is complete before the state itself.
+	std::deque<State> queue;
+	for (unsigned int c = 0; c < 256; ++c)
+	{
+		auto& next = full[c];
+		if (next == NO_STATE)
+			next = START;
+		else
+			queue.push_back(next);
+	}
+
+	while (!queue.empty())
+	{
+		State current = queue.front();
+		queue.pop_front();
+
+		for (unsigned int c = 0; c < 256; ++c)
+		{
+			auto& next = full[(static_cast<size_t>(current) << 8) | c];
+			auto fallback = full[(static_cast<size_t>(fail[current]) << 8) | c];
+
+			if (next == NO_STATE)
+			{
+				next = fallback;
+				continue;
+			}
+
+			fail[next] = fallback;
+			outputs[next].insert(outputs[next].end(), outputs[fallback].begin(), outputs[fallback].end());
+			queue.push_back(next);
+		}
+	}
+
+	// Bytes that appear in no pattern behave the same way (class 0), every other byte gets its own class.
+	// Narrow rows keep the whole table in the cache.
+	std::array<bool, 256> used{};
+	for (const auto& pattern : patterns_)
+	{
+		for (auto c : pattern)
+			used[static_cast<uint8_t>(c)] = true;
+	}
+
+	stride_ = 1;
+	for (unsigned int c = 0; c < 256; ++c)
+		classes_[c] = used[c] ? static_cast<uint8_t>(stride_++ & 0xff) : 0;
+	if (stride_ > 256)
+	{
+		// Every byte value is used - classes are not needed, but index must fit into uint8_t.
+		stride_ = 256;
+		for (unsigned int c = 0; c < 256; ++c)
+			classes_[c] = static_cast<uint8_t>(c);
+	}
+
+	// States are stored premultiplied by the stride, states with output are flagged.
+	auto encode = [&](State state) {
+		return static_cast<State>(state * stride_) | (outputs[state].empty() ? 0 : MATCH);
+	};
+
+	delta_.assign(outputs.size() * stride_, START);
+	for (size_t state = 0; state < outputs.size(); ++state)
+	{
+		for (unsigned int c = 0; c < 256; ++c)
+			delta_[state * stride_ + classes_[c]] = encode(full[(state << 8) | c]);
+	}
+
+	depths_ = std::move(depths);
+	outputs_begin_.assign(1, 0);
+	outputs_.clear();
+	for (const auto& out : outputs)
+	{
+		outputs_.insert(outputs_.end(), out.begin(), out.end());
+		outputs_begin_.push_back(static_cast<uint32_t>(outputs_.size()));
+	}
+
+	// Prefilter
+	first_count_ = 0;
+	low_nibbles_.fill(0);
+	high_nibbles_.fill(0);
+	for (unsigned int c = 0; c < 256; ++c)
+	{
+		if (!first_[c])
+			continue;
+		if (first_count_ < MAX_BYTES)
+			first_bytes_[first_count_] = static_cast<uint8_t>(c);
+		first_count_++;
+
+		// Bucket is the high nibble modulo 8, so only bytes differing in the top bit can be confused.
+		low_nibbles_[c & 0x0f] |= static_cast<uint8_t>(1u << ((c >> 4) & 7));
+		high_nibbles_[c >> 4] |= static_cast<uint8_t>(1u << ((c >> 4) & 7));
+	}
+
+	if (first_count_ == 0 || first_count_ > PREFILTER_MAX_FIRST)
+		prefilter_ = Prefilter::NONE;
+	else if (first_count_ <= MAX_BYTES)
+		prefilter_ = Prefilter::BYTES;
+	else
+		prefilter_ = Prefilter::NIBBLES;
+}
+
+#if defined(SWPL_HAVE_SSSE3_TARGET)
+/**
+* Nibble lookup: byte is a candidate if its low and high nibble share a bucket.
+*/
+__attribute__((target("ssse3")))
+static size_t find_nibbles(const uint8_t* data, size_t pos, size_t size, const uint8_t* low, const uint8_t* high) noexcept
+{
+	const __m128i low_table = _mm_load_si128(reinterpret_cast<const __m128i*>(low));
+	const __m128i high_table = _mm_load_si128(reinterpret_cast<const __m128i*>(high));
+	const __m128i mask = _mm_set1_epi8(0x0f);
+
+	for (; pos + 16 <= size; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		__m128i lows = _mm_shuffle_epi8(low_table, _mm_and_si128(block, mask));
+		__m128i highs = _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(block, 4), mask));
+		__m128i empty = _mm_cmpeq_epi8(_mm_and_si128(lows, highs), _mm_setzero_si128());
+		unsigned int found = static_cast<unsigned int>(_mm_movemask_epi8(empty)) ^ 0xffffu;
+
+		if (found != 0)
+			return pos + static_cast<size_t>(__builtin_ctz(found));
+	}
+
+	return pos;
+}
+
+/**
+* Check CPU support. Can run before libgcc initializes its CPU model, so it initializes it itself.
+*/
+static bool have_ssse3() noexcept
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+}
+
+static const bool HAVE_SSSE3 = have_ssse3();
+#endif
+
+size_t AhoCorasick::next_candidate(const uint8_t* data, size_t pos, size_t size) const noexcept
+{
+	switch (prefilter_)
+	{
+	case Prefilter::BYTES:
+		if (first_count_ == 1)
+		{
+			auto found = std::memchr(data + pos, first_bytes_[0], size - pos);
+			return found != nullptr ? static_cast<size_t>(static_cast<const uint8_t*>(found) - data) : size;
+		}
+#if defined(__SSE2__)
+		{
+			const __m128i first = _mm_set1_epi8(static_cast<char>(first_bytes_[0]));
+			const __m128i second = _mm_set1_epi8(static_cast<char>(first_bytes_[1]));
+			const __m128i third = _mm_set1_epi8(static_cast<char>(first_bytes_[first_count_ > 2 ? 2 : 1]));
+
+			for (; pos + 16 <= size; pos += 16)
+			{
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+				__m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)),
+					_mm_cmpeq_epi8(block, third));
+				unsigned int found = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+
+				if (found != 0)
+					return pos + static_cast<size_t>(__builtin_ctz(found));
+			}
+		}
+#endif
+		break;
+	case Prefilter::NIBBLES:
+#if defined(SWPL_HAVE_SSSE3_TARGET)
+		while (HAVE_SSSE3 && pos + 16 <= size)
+		{
+			pos = find_nibbles(data, pos, size, low_nibbles_.data(), high_nibbles_.data());
+			if (pos + 16 > size)
+				break;
+			// Nibble buckets can give false positives, skip them here.
+			if (first_[data[pos]])
+				return pos;
+			++pos;
+		}
+#endif
+		break;
+	case Prefilter::NONE:
+	default:
+		return pos;
+	}
+
+	// Tail shorter than a vector (or no SIMD at all).
+	while (pos < size && !first_[data[pos]])
+		++pos;
+
+	return pos;
+}
@@ -0,0 +1,157 @@
+/**
+ *  @file   AhoCorasick.hpp
+ *  @brief  Multi-pattern literal matcher.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  All patterns are compiled into one Aho-Corasick automaton stored as a full DFA (every state has
+ *  a transition for every byte class), so scanning costs a single table lookup per byte whatever the
+ *  number of patterns is. While the automaton is in the root state nothing is partially matched and only the
+ *  first bytes of patterns can move it, so the scanner skips such stretches with a SIMD prefilter
+ *  looking for those first bytes 16 at a time.
+ *
+ *  Scanning state can be carried between calls, which makes it possible to find patterns split
+ *  between consecutive chunks of the stream.
+ */
+
+#ifndef SRC_TRANSFORM_AHOCORASICK_HPP_
+#define SRC_TRANSFORM_AHOCORASICK_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class AhoCorasick
+{
+public:
+	typedef uint32_t State;
+
+	static constexpr State START = 0;						/*!< Initial state (nothing matched) */
+
+	/**
+	* Add pattern to the automaton. Automaton must be compiled again before scanning.
+	* @param[in] pattern non-empty literal
+	* @return Index of the pattern or -1 if pattern is empty.
+	*/
+	int add(std::string_view pattern);
+
+	/**
+	* Build the DFA and the prefilter from all added patterns.
+	*/
+	void compile();
+
+	/**
+	* Get number of patterns.
+	*/
+	size_t size() const noexcept {
+		return patterns_.size();
+	}
+
+	/**
+	* Get pattern with the specified index.
+	*/
+	const std::string& pattern(size_t index) const noexcept {
+		return patterns_[index];
+	}
+
+	/**
+	* Get number of the last bytes scanned in the state that may still become a part of some
+	* occurrence (length of the longest pattern prefix they form).
+	*/
+	size_t depth(State state) const noexcept {
+		return depths_.empty() ? 0 : depths_[(state & ~MATCH) / stride_];
+	}
+
+	/**
+	* Scan the data. For every occurrence of every pattern callback is called with the pattern index
+	* and the offset just past the last byte of the occurrence (occurrence can start in the previous
+	* chunk if the state was carried over). Callback returns false to stop scanning.
+	* @param[in] data data to scan
+	* @param[in] size size of the data
+	* @param[in,out] state scanning state (START for independent messages)
+	* @param[in] on_match callable bool(size_t pattern, size_t end)
+	* @return False if scanning was stopped by the callback, otherwise true.
+	*/
+	template<typename Callback>
+	bool scan(const uint8_t* data, size_t size, State& state, Callback&& on_match) const {
+		State current = state;
+		size_t pos = 0;
+
+		if (delta_.empty())
+			return true;
+
+		size_t resume = 0;										// Prefilter is not used before this offset
+
+		while (pos < size)
+		{
+			// Offset is tested first - it is predictable, while the state in dense data is not.
+			if (pos >= resume && current == START)
+			{
+				auto candidate = next_candidate(data, pos, size);
+				if (candidate >= size)
+					break;
+				// Prefilter stopping every few bytes costs more than it saves, so give it a rest.
+				if (candidate - pos < PREFILTER_REST)
+					resume = candidate + PREFILTER_REST;
+				pos = candidate;
+			}
+
+			current = delta_[(current & ~MATCH) + classes_[data[pos++]]];
+			if ((current & MATCH) == 0)
+				continue;
+
+			auto id = (current & ~MATCH) / stride_;
+			for (auto out = outputs_begin_[id]; out != outputs_begin_[id + 1]; ++out)
+			{
+				if (!on_match(static_cast<size_t>(outputs_[out]), pos))
+				{
+					state = current;
+					return false;
+				}
+			}
+		}
+
+		state = current;
+		return true;
+	}
+
+private:
+	enum class Prefilter
+	{
+		NONE,												/*!< Every byte can start a match */
+		BYTES,												/*!< Compare with up to MAX_BYTES first bytes */
+		NIBBLES												/*!< Nibble lookup for any set of first bytes */
+	};
+
+	static constexpr State MATCH = 0x80000000u;				/*!< Flag of states where some pattern ends */
+	static constexpr size_t MAX_BYTES = 3;
+	static constexpr size_t PREFILTER_REST = 32;			/*!< Bytes scanned without prefilter after a short skip */
+
+	/**
+	* Find the next byte which can start a pattern.
+	* @return Its offset or size if there is none.
+	*/
+	size_t next_candidate(const uint8_t* data, size_t pos, size_t size) const noexcept;
+
+	std::vector<std::string> patterns_;
+	std::array<uint8_t, 256> classes_{};					/*!< Byte classes (bytes not used by any pattern share class 0) */
+	size_t stride_{ 1 };									/*!< Number of classes - transitions per state */
+	std::vector<State> delta_;								/*!< Transitions, stride_ per state, premultiplied by stride_ */
+	std::vector<uint32_t> outputs_begin_;					/*!< Per state offset into outputs_ (states + 1 entries) */
+	std::vector<uint32_t> outputs_;							/*!< Patterns ending in the state (with the suffix ones) */
+	std::vector<uint32_t> depths_;							/*!< Per state length of the matched prefix */
+
+	Prefilter prefilter_{ Prefilter::NONE };
+	std::array<bool, 256> first_{};							/*!< Bytes starting any pattern */
+	std::array<uint8_t, MAX_BYTES> first_bytes_{};			/*!< First bytes for BYTES prefilter */
+	size_t first_count_{ 0 };
+	alignas(16) std::array<uint8_t, 16> low_nibbles_{};	/*!< NIBBLES: buckets having the low nibble */
+	alignas(16) std::array<uint8_t, 16> high_nibbles_{};	/*!< NIBBLES: buckets having the high nibble */
+};
+
+#endif /* SRC_TRANSFORM_AHOCORASICK_HPP_ */
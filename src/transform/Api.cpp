@@ -0,0 +1,251 @@
+/**
+ *  @file   Api.cpp
+ *  @brief  Passes data through the plugin loaded from a shared library.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Api.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "core/Pipeline.hpp"
+#include "osdep/DL.hpp"
+
+#include <new>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	TYPE,
+	LIBRARY,
+	BATCH,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::TYPE, {"type", SettingType::STRING}},
+	{SettingLabel::LIBRARY, {"library", SettingType::STRING}},
+	{SettingLabel::BATCH, {"batch", SettingType::UNSIGNED}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+ApiTransformation::~ApiTransformation()
+{
+	unload();
+}
+
+bool ApiTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	ConfigurationManager::SectionStructure values;
+	std::string library;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	unload();
+
+	if (!config.get(section, SETTINGS.at(SettingLabel::LIBRARY).setting_name, library) || !config.getSection(section, values))
+		return false;
+	config.get(section, SETTINGS.at(SettingLabel::BATCH).setting_name, batch_size_);
+	if (batch_size_ == 0)
+		return false;
+
+	library_ = DL::loadLibrary(unquote(library).c_str());
+	if (library_ == nullptr)
+	{
+		LOG_ERROR("stage {}: cannot load plugin {}", getID(), library);
+		return false;
+	}
+
+	auto entry = reinterpret_cast<swpl_plugin_entry_fn>(DL::getFuncAddr(library_, SWPL_PLUGIN_ENTRY));
+	const swpl_plugin* plugin = entry != nullptr ? entry() : nullptr;
+	if (plugin == nullptr || plugin->abi_version != SWPL_PLUGIN_ABI_VERSION || plugin->process == nullptr)
+	{
+		LOG_ERROR("stage {}: {} is not a plugin for this swpl version", getID(), library);
+		unload();
+		return false;
+	}
+
+	init_ = plugin->init;
+	configure_ = plugin->configure;
+	process_ = plugin->process;
+	destroy_ = plugin->destroy;
+
+	host_ = swpl_host{ this, &ApiTransformation::host_alloc, &ApiTransformation::host_emit, &ApiTransformation::host_log };
+	context_ = init_ != nullptr ? init_(&host_) : nullptr;
+
+	for (const auto& [key, value] : values)
+	{
+		if (Pipeline::stage_setting(key) || key == SETTINGS.at(SettingLabel::LIBRARY).setting_name ||
+			key == SETTINGS.at(SettingLabel::BATCH).setting_name)
+			continue;
+
+		if (configure_ == nullptr || configure_(context_, key.c_str(), unquote(value).c_str()) != 0)
+		{
+			LOG_ERROR("stage {}: plugin rejected {} = {}", getID(), key, value);
+			unload();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ApiTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				messages_.resize(batch_size_);
+
+				size_t count = 0;
+				while (count < batch_size_ && take(table[src], messages_[count]))
+					count++;
+				if (count == 0)
+					continue;
+
+				idle = false;
+				messages_.resize(count);
+				emitted_.clear();
+
+				auto result = process(messages_, emitted_);
+				if (result != 0)
+					LOG_WARNING("stage {}: plugin failed with {}", getID(), result);
+
+				for (auto& message : emitted_)
+					send_to_all(std::move(message), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+}
+
+int ApiTransformation::process(std::vector<std::vector<uint8_t>>& batch, std::vector<std::vector<uint8_t>>& output)
+{
+	if (process_ == nullptr)
+		return -1;
+
+	views_.clear();
+	for (const auto& message : batch)
+		views_.push_back(swpl_view{ message.data(), message.size() });
+
+	batch_ = &batch;
+	output_ = &output;
+	auto result = process_(context_, views_.data(), views_.size(), &host_);
+	batch_ = nullptr;
+	output_ = nullptr;
+
+	// Buffers plugin did not emit are used for the next batches.
+	for (auto& buffer : allocated_)
+	{
+		if (buffer.capacity() != 0 && pool_.size() < batch_size_)
+			pool_.push_back(std::move(buffer));
+	}
+	allocated_.clear();
+
+	return result;
+}
+
+uint8_t* ApiTransformation::host_alloc(void* handle, size_t size)
+{
+	auto* self = static_cast<ApiTransformation*>(handle);
+
+	if (self->output_ == nullptr || size == 0)
+		return nullptr;
+
+	std::vector<uint8_t> buffer;
+	if (!self->pool_.empty())
+	{
+		buffer = std::move(self->pool_.back());
+		self->pool_.pop_back();
+	}
+
+	try
+	{
+		buffer.resize(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+
+	self->allocated_.push_back(std::move(buffer));
+	return self->allocated_.back().data();
+}
+
+int ApiTransformation::host_emit(void* handle, const uint8_t* data, size_t size)
+{
+	auto* self = static_cast<ApiTransformation*>(handle);
+
+	if (self->output_ == nullptr || (data == nullptr && size != 0))
+		return -1;
+	if (size == 0)
+		return 0;
+
+	// Whole input message - pass its buffer on.
+	for (auto& message : *self->batch_)
+	{
+		if (message.data() == data && message.size() == size)
+		{
+			self->output_->push_back(std::move(message));
+			message.clear();
+			return 0;
+		}
+	}
+
+	// Buffer from host_alloc() (possibly shortened) - pass it on.
+	for (auto& buffer : self->allocated_)
+	{
+		if (buffer.data() == data && size <= buffer.size())
+		{
+			buffer.resize(size);
+			self->output_->push_back(std::move(buffer));
+			buffer.clear();
+			return 0;
+		}
+	}
+
+	self->output_->emplace_back(data, data + size);
+	return 0;
+}
+
+void ApiTransformation::host_log(void* handle, int level, const char* message)
+{
+	[[maybe_unused]] auto* self = static_cast<ApiTransformation*>(handle);
+
+	switch (level)
+	{
+	case SWPL_PLUGIN_LOG_ERROR: LOG_ERROR("stage {} plugin: {}", self->getID(), message); break;
+	case SWPL_PLUGIN_LOG_WARNING: LOG_WARNING("stage {} plugin: {}", self->getID(), message); break;
+	case SWPL_PLUGIN_LOG_INFO: LOG_INFO("stage {} plugin: {}", self->getID(), message); break;
+	default: LOG_VERBOSE("stage {} plugin: {}", self->getID(), message); break;
+	}
+}
+
+void ApiTransformation::unload()
+{
+	if (destroy_ != nullptr)
+		destroy_(context_);
+	context_ = nullptr;
+	init_ = nullptr;
+	configure_ = nullptr;
+	process_ = nullptr;
+	destroy_ = nullptr;
+
+	if (library_ != nullptr)
+		DL::freeLibrary(library_);
+	library_ = nullptr;
+}
@@ -0,0 +1,97 @@
+/**
+ *  @file   Api.hpp
+ *  @brief  Passes data through the plugin loaded from a shared library.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Plugin implements the C interface from swpl_plugin.h. Library is loaded and plugin functions
+ *  are resolved once, when the stage is configured. Messages are handed to the plugin in batches
+ *  (all coming from one cooperative) as views of the pipeline buffers - messages plugin passes
+ *  on unchanged and buffers it filled in are moved on without copying.
+ */
+
+#ifndef SRC_TRANSFORM_API_HPP_
+#define SRC_TRANSFORM_API_HPP_
+
+#include "swpl_plugin.h"
+#include "../core/Stage.hpp"
+
+#include <string>
+#include <vector>
+
+class ApiTransformation : public TransformStage
+{
+public:
+	ApiTransformation() = default;
+	ApiTransformation(const ApiTransformation&) = delete;
+	ApiTransformation& operator=(const ApiTransformation&) = delete;
+
+	/**
+	* Destructor. Destroys plugin instance and unloads the library.
+	*/
+	virtual ~ApiTransformation();
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "api"
+	* library = "/path/to/plugin.so"
+	*
+	* Optional configuration:
+	* batch = 64								# max number of messages given to the plugin at once, def: 64
+	* key = value								# all other keys are passed to the plugin configure()
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if library is a valid plugin and it accepted the configuration, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Pass messages through the plugin and its output to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Pass the batch of messages through the plugin.
+	* @param[in,out] batch messages (those passed on without copying are moved out)
+	* @param[out] output messages emitted by the plugin (appended)
+	* @return Value returned by the plugin (0 - success).
+	*/
+	int process(std::vector<std::vector<uint8_t>>& batch, std::vector<std::vector<uint8_t>>& output);
+
+private:
+	static uint8_t* host_alloc(void* handle, size_t size);
+	static int host_emit(void* handle, const uint8_t* data, size_t size);
+	static void host_log(void* handle, int level, const char* message);
+
+	/**
+	* Destroy plugin instance and unload the library.
+	*/
+	void unload();
+
+	void* library_{ nullptr };
+	void* context_{ nullptr };									/*!< Plugin instance */
+	swpl_host host_{};
+	size_t batch_size_{ 64 };
+
+	// Plugin functions resolved at load time.
+	void* (*init_)(const swpl_host*) { nullptr };
+	int (*configure_)(void*, const char*, const char*) { nullptr };
+	int (*process_)(void*, const swpl_view*, size_t, const swpl_host*) { nullptr };
+	void (*destroy_)(void*) { nullptr };
+
+	// State of the process() call in progress.
+	std::vector<std::vector<uint8_t>>* batch_{ nullptr };
+	std::vector<std::vector<uint8_t>>* output_{ nullptr };
+	std::vector<swpl_view> views_;
+	std::vector<std::vector<uint8_t>> allocated_;				/*!< Buffers given to the plugin in this call */
+	std::vector<std::vector<uint8_t>> pool_;					/*!< Buffers to give to the plugin again */
+
+	std::vector<std::vector<uint8_t>> messages_;
+	std::vector<std::vector<uint8_t>> emitted_;
+};
+
+#endif /* SRC_TRANSFORM_API_HPP_ */
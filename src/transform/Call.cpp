@@ -0,0 +1,436 @@
+/**
+ *  @file   Call.cpp
+ *  @brief  Passes data through external applications.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Call.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <unordered_map>
+
+#if defined(SWPL_SYSTEM_HAVE_SPAWN_H) && defined(SWPL_SYSTEM_HAVE_POLL_H) && defined(SWPL_SYSTEM_HAVE_UNISTD_H)
+#define SWPL_CALL_SPAWN
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <spawn.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+/**
+* Max time stage thread sleeps in poll() - work flag is checked that often.
+*/
+static constexpr int MAX_POLL_MS = 100;
+
+/**
+* Answers above this size are treated as broken framing.
+*/
+static constexpr size_t MAX_ANSWER = 64 * 1024 * 1024;
+
+enum class SettingLabel
+{
+	COMMAND,
+	ARG,
+	WORKERS,
+	TIMEOUT,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::COMMAND, {"command", SettingType::STRING}},
+	{SettingLabel::ARG, {"arg", SettingType::STRING}},
+	{SettingLabel::WORKERS, {"workers", SettingType::UNSIGNED}},
+	{SettingLabel::TIMEOUT, {"timeout", SettingType::INTEGER}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+CallTransformation::~CallTransformation()
+{
+#if defined(SWPL_CALL_SPAWN)
+	for (auto& fd : wake_pipe_)
+	{
+		if (fd >= 0)
+			::close(fd);
+		fd = -1;
+	}
+#endif
+}
+
+bool CallTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string value;
+	long timeout = 1000;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	arguments_.clear();
+	worker_count_ = 1;
+
+	if (!config.get(section, SETTINGS.at(SettingLabel::COMMAND).setting_name, value) || unquote(value).empty())
+		return false;
+	command_ = unquote(value);
+	arguments_.push_back(command_);
+
+	for (unsigned int i = 1; config.get(section, SETTINGS.at(SettingLabel::ARG).setting_name + std::to_string(i), value); ++i)
+		arguments_.push_back(unquote(value));
+
+	config.get(section, SETTINGS.at(SettingLabel::WORKERS).setting_name, worker_count_);
+	config.get(section, SETTINGS.at(SettingLabel::TIMEOUT).setting_name, timeout);
+	if (worker_count_ == 0 || timeout < 0)
+		return false;
+	timeout_ = std::chrono::milliseconds(timeout);
+
+#if defined(SWPL_CALL_SPAWN)
+	if (wake_pipe_[0] < 0 && ::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0)
+		return false;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool CallTransformation::add_to_queue(std::vector<uint8_t> data, unsigned int id)
+{
+	if (!Stage::add_to_queue(std::move(data), id))
+		return false;
+
+#if defined(SWPL_CALL_SPAWN)
+	// Pipe full means the thread has not woken up yet, so the byte is not needed.
+	char wake = 0;
+	[[maybe_unused]] auto written = ::write(wake_pipe_[1], &wake, 1);
+#endif
+	return true;
+}
+
+size_t CallTransformation::held_data() const
+{
+	size_t held = abandoned_;
+	for (const auto& worker : workers_)
+	{
+		if (worker.busy)
+			held += worker.request_header.size() + worker.request.size();
+	}
+	return held;
+}
+
+#if defined(SWPL_CALL_SPAWN)
+
+void CallTransformation::run()
+{
+	// Writing to the pipe of the crashed worker must end with EPIPE, not with the signal.
+	sigset_t pipe_signal;
+	sigemptyset(&pipe_signal);
+	sigaddset(&pipe_signal, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipe_signal, nullptr);
+
+	workers_.assign(worker_count_, Worker{});
+	abandoned_ = 0;
+	for (auto& worker : workers_)
+	{
+		if (!spawn(worker))
+		{
+			LOG_ERROR("stage {}: cannot start {}", getID(), command_);
+			for (auto& started : workers_)
+				stop(started);
+			return;
+		}
+	}
+
+	std::vector<pollfd> fds;
+	std::vector<Worker*> polled;
+
+	while (get_work_flag())
+	{
+		bool idle_worker = false;
+		data_sequence();											// Answers of the previous pass are sent.
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			for (auto& worker : workers_)
+			{
+				if (!worker.busy && !start_call(worker, routes))
+					idle_worker = true;
+			}
+		}
+
+		// Wake up on new data only if there is a worker to take it.
+		fds.clear();
+		polled.clear();
+		fds.push_back(pollfd{ idle_worker ? wake_pipe_[0] : -1, POLLIN, 0 });
+
+		auto now = Clock::now();
+		int timeout = MAX_POLL_MS;
+
+		for (auto& worker : workers_)
+		{
+			if (!worker.busy)
+				continue;
+
+			if (worker.written < worker.request_header.size() + worker.request.size())
+				fds.push_back(pollfd{ worker.input, POLLOUT, 0 });
+			fds.push_back(pollfd{ worker.output, POLLIN, 0 });
+			polled.push_back(&worker);
+
+			if (timeout_.count() > 0)
+			{
+				auto left = std::chrono::duration_cast<std::chrono::milliseconds>(worker.deadline - now).count() + 1;
+				timeout = static_cast<int>(std::clamp<long long>(left, 0, timeout));
+			}
+		}
+
+		if (::poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR)
+			break;
+
+		if (fds[0].revents & POLLIN)
+		{
+			char drain[64];
+			while (::read(wake_pipe_[0], drain, sizeof(drain)) > 0) { }
+		}
+
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		now = Clock::now();
+
+		for (auto* worker : polled)
+		{
+			// Pipes are non-blocking, so both directions are just tried - poll results only ended the wait.
+			if (!write_request(*worker))
+			{
+				restart(*worker, "write failed");
+				continue;
+			}
+
+			auto result = read_answer(*worker);
+			if (result < 0)
+				restart(*worker, "answer broken");
+			else if (result > 0)
+			{
+				worker->busy = false;
+				if (!worker->answer.empty())
+					send_to_all(std::move(worker->answer), routes, worker->src);
+				worker->answer.clear();
+			}
+			else if (timeout_.count() > 0 && now >= worker->deadline)
+			{
+				timeouts_.fetch_add(1, std::memory_order::relaxed);
+				restart(*worker, "call timed out");
+			}
+		}
+	}
+
+	// Calls in progress are lost with their workers.
+	for (auto& worker : workers_)
+	{
+		if (worker.busy)
+			abandoned_ += worker.request_header.size() + worker.request.size();
+		stop(worker);
+	}
+}
+
+bool CallTransformation::spawn(Worker& worker)
+{
+	int input[2], output[2];
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attributes;
+	sigset_t mask, defaults;
+
+	if (::pipe2(input, O_CLOEXEC) != 0)
+		return false;
+	if (::pipe2(output, O_CLOEXEC) != 0)
+	{
+		::close(input[0]);
+		::close(input[1]);
+		return false;
+	}
+
+	// dup2() clears close-on-exec, so the application gets only its standard streams.
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, input[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, output[1], STDOUT_FILENO);
+
+	// Application must not inherit blocked SIGPIPE of this thread.
+	sigemptyset(&mask);
+	sigemptyset(&defaults);
+	sigaddset(&defaults, SIGPIPE);
+	posix_spawnattr_init(&attributes);
+	posix_spawnattr_setsigmask(&attributes, &mask);
+	posix_spawnattr_setsigdefault(&attributes, &defaults);
+	posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+	std::vector<char*> argv;
+	for (auto& argument : arguments_)
+		argv.push_back(argument.data());
+	argv.push_back(nullptr);
+
+	pid_t pid = -1;
+	auto result = ::posix_spawnp(&pid, command_.c_str(), &actions, &attributes, argv.data(), environ);
+
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attributes);
+	::close(input[0]);
+	::close(output[1]);
+
+	if (result != 0)
+	{
+		::close(input[1]);
+		::close(output[0]);
+		return false;
+	}
+
+	::fcntl(input[1], F_SETFL, O_NONBLOCK);
+	::fcntl(output[0], F_SETFL, O_NONBLOCK);
+
+	worker.pid = pid;
+	worker.input = input[1];
+	worker.output = output[0];
+	worker.busy = false;
+	return true;
+}
+
+void CallTransformation::stop(Worker& worker)
+{
+	if (worker.input >= 0)
+		::close(worker.input);
+	if (worker.output >= 0)
+		::close(worker.output);
+	worker.input = worker.output = -1;
+
+	if (worker.pid > 0)
+	{
+		// Closed input is the request to finish, but there is no time to wait for it.
+		::kill(worker.pid, SIGKILL);
+		while (::waitpid(worker.pid, nullptr, 0) < 0 && errno == EINTR) { }
+	}
+
+	worker.pid = -1;
+	worker.busy = false;
+}
+
+void CallTransformation::restart(Worker& worker, const char* reason)
+{
+	LOG_WARNING("stage {}: restarting {} ({})", getID(), command_, reason);
+	restarts_.fetch_add(1, std::memory_order::relaxed);
+
+	stop(worker);
+	if (!spawn(worker))
+		LOG_ERROR("stage {}: cannot restart {}", getID(), command_);
+}
+
+bool CallTransformation::start_call(Worker& worker, const RoutingTable<Route>::ReadGuard& routes)
+{
+	const auto& table = routes.table();
+
+	if (worker.pid < 0 && !spawn(worker))
+		return false;
+
+	for (size_t i = 0; i < table.size(); ++i)
+	{
+		unsigned int src = static_cast<unsigned int>((next_src_ + i) % table.size());
+		if (!take(table[src], worker.request))
+			continue;
+
+		auto size = static_cast<uint32_t>(worker.request.size());
+		worker.request_header = { static_cast<uint8_t>(size >> 24), static_cast<uint8_t>(size >> 16),
+			static_cast<uint8_t>(size >> 8), static_cast<uint8_t>(size) };
+		worker.written = 0;
+		worker.received = 0;
+		worker.src = src;
+		worker.busy = true;
+		worker.deadline = Clock::now() + timeout_;
+		next_src_ = src + 1;
+		return true;
+	}
+
+	return false;
+}
+
+bool CallTransformation::write_request(Worker& worker)
+{
+	const size_t header = worker.request_header.size();
+	const size_t total = header + worker.request.size();
+
+	while (worker.written < total)
+	{
+		iovec parts[2];
+		int count = 0;
+
+		if (worker.written < header)
+			parts[count++] = iovec{ worker.request_header.data() + worker.written, header - worker.written };
+		size_t offset = worker.written > header ? worker.written - header : 0;
+		if (offset < worker.request.size())
+			parts[count++] = iovec{ worker.request.data() + offset, worker.request.size() - offset };
+
+		auto ret = ::writev(worker.input, parts, count);
+		if (ret < 0)
+			return errno == EAGAIN || errno == EINTR;
+		worker.written += static_cast<size_t>(ret);
+	}
+
+	return true;
+}
+
+int CallTransformation::read_answer(Worker& worker)
+{
+	const size_t header = worker.answer_header.size();
+
+	for (;;)
+	{
+		uint8_t* target;
+		size_t wanted;
+
+		if (worker.received < header)
+		{
+			target = worker.answer_header.data() + worker.received;
+			wanted = header - worker.received;
+		}
+		else
+		{
+			if (worker.received == header)
+			{
+				size_t size = (static_cast<size_t>(worker.answer_header[0]) << 24) | (static_cast<size_t>(worker.answer_header[1]) << 16) |
+					(static_cast<size_t>(worker.answer_header[2]) << 8) | worker.answer_header[3];
+				if (size > MAX_ANSWER)
+					return -1;
+				worker.answer.resize(size);
+			}
+
+			size_t offset = worker.received - header;
+			if (offset == worker.answer.size())
+			{
+				// Answer for the whole request must be read, application may answer before reading it all.
+				return worker.written == header + worker.request.size() ? 1 : 0;
+			}
+			target = worker.answer.data() + offset;
+			wanted = worker.answer.size() - offset;
+		}
+
+		auto ret = ::read(worker.output, target, wanted);
+		if (ret == 0)
+			return -1;
+		if (ret < 0)
+			return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+		worker.received += static_cast<size_t>(ret);
+	}
+}
+
+#else
+
+void CallTransformation::run()
+{
+	LOG_ERROR("stage {}: call is not supported on this system", getID());
+}
+
+#endif
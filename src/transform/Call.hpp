@@ -0,0 +1,146 @@
+/**
+ *  @file   Call.hpp
+ *  @brief  Passes data through external applications.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Applications are started once (posix_spawn) and kept running in a pool, every message is a
+ *  call to one of the idle workers. Data goes to the application standard input and the answer is
+ *  read from its standard output, both framed with 4-byte big-endian length. Answer of length 0
+ *  means that nothing is passed on.
+ *
+ *  All workers are driven by the stage thread with non-blocking pipes and poll(), so as many calls
+ *  as there are workers are in progress at once (answers are passed on in the order they come).
+ *  Worker that crashes, breaks the framing or does not answer in time is killed and started again;
+ *  its call is dropped.
+ */
+
+#ifndef SRC_TRANSFORM_CALL_HPP_
+#define SRC_TRANSFORM_CALL_HPP_
+
+#include "../core/Stage.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+class CallTransformation : public TransformStage
+{
+public:
+	/**
+	* Destructor. Closes the wake up pipe.
+	*/
+	virtual ~CallTransformation();
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "call"
+	* command = "/usr/bin/application"			# searched in PATH if it has no slash
+	*
+	* Optional configuration:
+	* arg1 = "argument"							# application arguments
+	* argN = ...
+	* workers = 1								# number of application instances, def: 1
+	* timeout = 1000							# max time of the single call [ms], 0 - no limit, def: 1000
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Start workers, pass messages to them and answers to all other cooperatives. Workers are
+	* stopped after work flag is cleared.
+	*/
+	void run() override;
+
+	/**
+	* Add message to the queue and wake up the stage thread waiting for the workers.
+	*/
+	virtual bool add_to_queue(std::vector<uint8_t> data, unsigned int id = 0) override;
+
+	/**
+	* Get number of worker restarts (crashes, timeouts and protocol errors).
+	*/
+	uint64_t getRestarts() const {
+		return restarts_.load(std::memory_order::relaxed);
+	}
+
+	/**
+	* Get number of calls that were not answered in time.
+	*/
+	uint64_t getTimeouts() const {
+		return timeouts_.load(std::memory_order::relaxed);
+	}
+
+protected:
+	/**
+	* Requests of the calls in progress are held until they are answered.
+	*/
+	size_t held_data() const override;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	* Single application instance along with the call it is processing.
+	*/
+	struct Worker
+	{
+		int pid{ -1 };											/*!< Process ID (-1 if not running) */
+		int input{ -1 };										/*!< Application standard input (written) */
+		int output{ -1 };										/*!< Application standard output (read) */
+
+		bool busy{ false };
+		unsigned int src{ 0 };									/*!< Cooperative the call came from */
+		Clock::time_point deadline;
+		std::array<uint8_t, 4> request_header{};
+		std::vector<uint8_t> request;
+		size_t written{ 0 };									/*!< Header and request bytes written */
+		std::array<uint8_t, 4> answer_header{};
+		std::vector<uint8_t> answer;
+		size_t received{ 0 };									/*!< Header and answer bytes read */
+	};
+
+	bool spawn(Worker& worker);
+	void stop(Worker& worker);
+	void restart(Worker& worker, const char* reason);
+
+	/**
+	* Take the next message (cooperatives are served in turns) and start the call on the worker.
+	* @return False if there are no messages waiting.
+	*/
+	bool start_call(Worker& worker, const RoutingTable<Route>::ReadGuard& routes);
+
+	/**
+	* Write as much of the request as the pipe takes.
+	* @return False if writing failed.
+	*/
+	bool write_request(Worker& worker);
+
+	/**
+	* Read as much of the answer as there is.
+	* @return 1 if answer is complete, 0 if there is more to read, -1 on error or end of stream.
+	*/
+	int read_answer(Worker& worker);
+
+	std::string command_;
+	std::vector<std::string> arguments_;						/*!< Arguments including the command as argv[0] */
+	size_t worker_count_{ 1 };
+	std::chrono::milliseconds timeout_{ 1000 };
+
+	std::vector<Worker> workers_;
+	size_t abandoned_{ 0 };									/*!< Requests of the calls given up when the stage stopped */
+	unsigned int next_src_{ 0 };
+	int wake_pipe_[2]{ -1, -1 };								/*!< Pipe used to wake the stage thread up */
+	std::atomic<uint64_t> restarts_{ 0 };
+	std::atomic<uint64_t> timeouts_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_CALL_HPP_ */
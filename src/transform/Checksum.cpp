@@ -0,0 +1,145 @@
+/**
+ *  @file   Checksum.cpp
+ *  @brief  Appends, verifies or strips message checksums.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Checksum.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	ALGORITHM,
+	MODE,
+	CHECKSUM_BIG_ENDIAN,
+	DROP_INVALID,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::ALGORITHM, {"algorithm", SettingType::STRING}},
+	{SettingLabel::MODE, {"mode", SettingType::STRING}},
+	{SettingLabel::CHECKSUM_BIG_ENDIAN, {"big_endian", SettingType::BOOL}},
+	{SettingLabel::DROP_INVALID, {"drop_invalid", SettingType::BOOL}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+bool ChecksumTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string algorithm{ "crc32c" }, mode{ "append" };
+	Crc::Algorithm selected;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	big_endian_ = true;
+	drop_invalid_ = true;
+
+	config.get(section, SETTINGS.at(SettingLabel::ALGORITHM).setting_name, algorithm);
+	if (!Crc::parse(algorithm, selected))
+		return false;
+	crc_ = Crc{ selected };
+
+	config.get(section, SETTINGS.at(SettingLabel::MODE).setting_name, mode);
+	if (mode == "append")
+		mode_ = Mode::APPEND;
+	else if (mode == "verify")
+		mode_ = Mode::VERIFY;
+	else if (mode == "strip")
+		mode_ = Mode::STRIP;
+	else
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::CHECKSUM_BIG_ENDIAN).setting_name, big_endian_);
+	config.get(section, SETTINGS.at(SettingLabel::DROP_INVALID).setting_name, drop_invalid_);
+
+	return true;
+}
+
+void ChecksumTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				if (process(data))
+					send_to_all(std::move(data), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+}
+
+bool ChecksumTransformation::process(std::vector<uint8_t>& data)
+{
+	const size_t size = crc_.size();
+
+	if (mode_ == Mode::APPEND)
+	{
+		auto crc = crc_.compute(data.data(), data.size());
+		data.resize(data.size() + size);
+		store(crc, data.data() + data.size() - size);
+		return true;
+	}
+
+	++verified_;
+	if (data.size() < size || crc_.compute(data.data(), data.size() - size) != load(data.data() + data.size() - size))
+	{
+		++mismatches_;
+		LOG_WARNING("stage {}: checksum mismatch in {} byte message ({} so far)", getID(), data.size(), mismatches_);
+		if (drop_invalid_)
+			return false;
+		// Trailer of the broken message may not be a trailer at all, so it is left as it is.
+		return true;
+	}
+
+	if (mode_ == Mode::STRIP)
+		data.resize(data.size() - size);
+
+	return !data.empty();
+}
+
+void ChecksumTransformation::store(uint64_t crc, uint8_t* trailer) const noexcept
+{
+	const size_t size = crc_.size();
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		auto shift = 8 * (big_endian_ ? size - 1 - i : i);
+		trailer[i] = static_cast<uint8_t>(crc >> shift);
+	}
+}
+
+uint64_t ChecksumTransformation::load(const uint8_t* trailer) const noexcept
+{
+	const size_t size = crc_.size();
+	uint64_t crc = 0;
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		auto byte = big_endian_ ? trailer[i] : trailer[size - 1 - i];
+		crc = (crc << 8) | byte;
+	}
+
+	return crc;
+}
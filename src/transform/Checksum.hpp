@@ -0,0 +1,89 @@
+/**
+ *  @file   Checksum.hpp
+ *  @brief  Appends, verifies or strips message checksums.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Checksum is kept in the trailer - the last bytes of the message. Sending side appends it, receiving
+ *  side verifies it (and optionally strips it), so corruption on the way between two pipelines is
+ *  detected. Messages with wrong checksum are counted and dropped or passed on.
+ */
+
+#ifndef SRC_TRANSFORM_CHECKSUM_HPP_
+#define SRC_TRANSFORM_CHECKSUM_HPP_
+
+#include "Crc.hpp"
+#include "../core/Stage.hpp"
+
+#include <string>
+#include <vector>
+
+class ChecksumTransformation : public TransformStage
+{
+public:
+	enum class Mode
+	{
+		APPEND,												/*!< Append checksum of the message */
+		VERIFY,												/*!< Check trailer, leave it in the message */
+		STRIP												/*!< Check trailer and remove it */
+	};
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "checksum"
+	*
+	* Optional configuration:
+	* algorithm = "crc32c"					# crc32c, crc32 or crc64, def: crc32c
+	* mode = "append"						# append, verify or strip, def: append
+	* big_endian = true						# byte order of the checksum in the trailer, def: true
+	* drop_invalid = true					# drop messages with wrong checksum, def: true
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Process every message and send it to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Append, verify or strip checksum of the message.
+	* @param[in,out] data message
+	* @return False if message should be dropped.
+	*/
+	bool process(std::vector<uint8_t>& data);
+
+	/**
+	* Get number of verified messages.
+	*/
+	uint64_t getVerified() const {
+		return verified_;
+	}
+
+	/**
+	* Get number of messages with wrong checksum (or too short to have one).
+	*/
+	uint64_t getMismatches() const {
+		return mismatches_;
+	}
+
+private:
+	void store(uint64_t crc, uint8_t* trailer) const noexcept;
+	uint64_t load(const uint8_t* trailer) const noexcept;
+
+	Crc crc_;
+	Mode mode_{ Mode::APPEND };
+	bool big_endian_{ true };
+	bool drop_invalid_{ true };
+
+	uint64_t verified_{ 0 };
+	uint64_t mismatches_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_CHECKSUM_HPP_ */
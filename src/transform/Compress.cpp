@@ -0,0 +1,379 @@
+/**
+ *  @file   Compress.cpp
+ *  @brief  Compresses data into frames and decompresses them back.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Compress.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	BLOCK_SIZE,
+	MAX_FRAME,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::BLOCK_SIZE, {"block_size", SettingType::UNSIGNED}},
+	{SettingLabel::MAX_FRAME, {"max_frame", SettingType::UNSIGNED}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+static constexpr size_t HEADER_SIZE = 16;
+static constexpr uint8_t METHOD_STORED = 0;
+static constexpr uint8_t METHOD_LZ = 1;
+static constexpr uint32_t MAX_DATA = 0xffffffffu - HEADER_SIZE;
+
+static void write32(uint8_t* at, uint64_t value) noexcept
+{
+	at[0] = static_cast<uint8_t>(value >> 24);
+	at[1] = static_cast<uint8_t>(value >> 16);
+	at[2] = static_cast<uint8_t>(value >> 8);
+	at[3] = static_cast<uint8_t>(value);
+}
+
+static uint32_t read32(const uint8_t* at) noexcept
+{
+	return (static_cast<uint32_t>(at[0]) << 24) | (static_cast<uint32_t>(at[1]) << 16) | (static_cast<uint32_t>(at[2]) << 8) | at[3];
+}
+
+bool CompressTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	block_size_ = 65536;
+	blocks_.clear();
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::BLOCK_SIZE).setting_name, block_size_);
+
+	return block_size_ <= MAX_DATA;
+}
+
+void CompressTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			// Blocks left by unregistered cooperatives go to everyone still registered.
+			frames_.clear();
+			check_sources(routes);
+			for (auto& frame : frames_)
+				send_to_all(std::move(frame), routes);
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				frames_.clear();
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				compress(std::move(data), src, frames_);
+				for (auto& frame : frames_)
+					send_to_all(std::move(frame), routes, src);
+			}
+
+			// Blocks are filled only while data keeps coming - it is not held back when the stage waits.
+			for (unsigned int src = 0; idle && src < blocks_.size(); ++src)
+			{
+				if (flush(data, src))
+					send_to_all(std::move(data), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+
+	RoutingTable<Route>::ReadGuard routes{ routes_ };
+	std::vector<uint8_t> data;
+
+	for (unsigned int src = 0; src < blocks_.size(); ++src)
+	{
+		if (flush(data, src))
+			send_to_all(std::move(data), routes, src);
+	}
+}
+
+void CompressTransformation::source_changed(unsigned int slot)
+{
+	// Block left by the unregistered cooperative goes out before the data of the new one.
+	std::vector<uint8_t> frame;
+	if (flush(frame, slot))
+		frames_.push_back(std::move(frame));
+}
+
+size_t CompressTransformation::held_data() const
+{
+	size_t held = 0;
+	for (const auto& block : blocks_)
+		held += block.size();
+	return held;
+}
+
+void CompressTransformation::compress(std::vector<uint8_t>&& data, unsigned int src, std::vector<std::vector<uint8_t>>& frames)
+{
+	if (blocks_.size() <= src)
+		blocks_.resize(src + 1);
+
+	auto& block = blocks_[src];
+	if (data.empty())
+		return;
+
+	if (block.empty() && data.size() >= block_size_)
+	{
+		// Message filling the whole block does not have to be copied into it.
+		for (size_t pos = 0; pos < data.size(); pos += MAX_DATA)
+		{
+			frames.emplace_back();
+			frame(data.data() + pos, std::min<size_t>(data.size() - pos, MAX_DATA), frames.back());
+		}
+		return;
+	}
+
+	if (block.empty())
+		block = std::move(data);
+	else
+		block.insert(block.end(), data.begin(), data.end());
+
+	if (block.size() >= block_size_)
+	{
+		frames.emplace_back();
+		frame(block.data(), block.size(), frames.back());
+		block.clear();
+	}
+}
+
+bool CompressTransformation::flush(std::vector<uint8_t>& frame, unsigned int src)
+{
+	if (src >= blocks_.size() || blocks_[src].empty())
+		return false;
+
+	this->frame(blocks_[src].data(), blocks_[src].size(), frame);
+	blocks_[src].clear();
+	return true;
+}
+
+void FrameEncoder::encode(const uint8_t* data, size_t size, std::vector<uint8_t>& frame)
+{
+	frame.resize(HEADER_SIZE + LzCodec::bound(size));
+	uint8_t* header = frame.data();
+
+	auto payload = codec_.compress(data, size, header + HEADER_SIZE);
+	header[3] = METHOD_LZ;
+	if (payload >= size)
+	{
+		std::memcpy(header + HEADER_SIZE, data, size);
+		payload = size;
+		header[3] = METHOD_STORED;
+	}
+
+	std::memcpy(header, "SWZ", 3);
+	write32(header + 4, payload);
+	write32(header + 8, size);
+	write32(header + 12, crc_.compute(data, size));
+	frame.resize(HEADER_SIZE + payload);
+}
+
+void CompressTransformation::frame(const uint8_t* data, size_t size, std::vector<uint8_t>& frame)
+{
+	encoder_.encode(data, size, frame);
+
+	bytes_in_ += size;
+	bytes_out_ += frame.size();
+}
+
+bool DecompressTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	max_frame_ = 1 << 26;
+	tails_.clear();
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::MAX_FRAME).setting_name, max_frame_);
+
+	return max_frame_ != 0 && max_frame_ <= MAX_DATA;
+}
+
+void DecompressTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			check_sources(routes);										// Frames of unregistered cooperatives are dropped.
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				blocks_.clear();
+				decompress(std::move(data), src, blocks_);
+				for (auto& block : blocks_)
+					send_to_all(std::move(block), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+}
+
+void DecompressTransformation::source_changed(unsigned int slot)
+{
+	// Frame of the unregistered cooperative is never going to be completed.
+	if (slot < tails_.size() && !tails_[slot].empty())
+		drop(tails_[slot], 0);
+}
+
+size_t DecompressTransformation::held_data() const
+{
+	size_t held = 0;
+	for (const auto& tail : tails_)
+		held += tail.size();
+	return held;
+}
+
+void DecompressTransformation::decompress(std::vector<uint8_t>&& data, unsigned int src, std::vector<std::vector<uint8_t>>& blocks)
+{
+	if (tails_.size() <= src)
+		tails_.resize(src + 1);
+
+	auto& tail = tails_[src];
+	const uint8_t* bytes = data.data();
+	size_t size = data.size(), pos = 0;
+
+	if (!tail.empty())
+	{
+		for (;;)
+		{
+			auto need = missing(tail);
+			if (need == INVALID)
+			{
+				drop(tail, size - pos);
+				return;
+			}
+			if (need == 0)
+				break;
+			if (pos == size)
+				return;
+
+			auto take = std::min(need, size - pos);
+			tail.insert(tail.end(), bytes + pos, bytes + pos + take);
+			pos += take;
+		}
+
+		decode(tail.data(), blocks);
+		tail.clear();
+	}
+
+	while (size - pos >= HEADER_SIZE)
+	{
+		auto length = frame_size(bytes + pos);
+		if (length == INVALID)
+		{
+			drop(tail, size - pos);
+			return;
+		}
+		if (size - pos < length)
+			break;
+
+		decode(bytes + pos, blocks);
+		pos += length;
+	}
+
+	if (pos == 0)
+		tail = std::move(data);
+	else if (pos < size)
+		tail.assign(bytes + pos, bytes + size);
+}
+
+size_t DecompressTransformation::frame_size(const uint8_t* header) const noexcept
+{
+	auto payload = read32(header + 4);
+	auto original = read32(header + 8);
+
+	if (std::memcmp(header, "SWZ", 3) != 0 || original > max_frame_)
+		return INVALID;
+	if (header[3] == METHOD_STORED && payload != original)
+		return INVALID;
+	if (header[3] == METHOD_LZ && payload > LzCodec::bound(original))
+		return INVALID;
+	if (header[3] > METHOD_LZ)
+		return INVALID;
+
+	return HEADER_SIZE + payload;
+}
+
+size_t DecompressTransformation::missing(const std::vector<uint8_t>& tail) const noexcept
+{
+	if (tail.size() < HEADER_SIZE)
+		return HEADER_SIZE - tail.size();
+
+	auto length = frame_size(tail.data());
+	return length == INVALID ? INVALID : length - tail.size();
+}
+
+void DecompressTransformation::decode(const uint8_t* frame, std::vector<std::vector<uint8_t>>& blocks)
+{
+	auto payload = read32(frame + 4);
+	auto original = read32(frame + 8);
+	const uint8_t* data = frame + HEADER_SIZE;
+
+	if (original == 0)
+		return;
+
+	std::vector<uint8_t> block;
+	if (frame[3] == METHOD_STORED)
+	{
+		block.assign(data, data + payload);
+	}
+	else
+	{
+		block.resize(original);
+		if (!LzCodec::decompress(data, payload, block.data(), original))
+			block.clear();
+	}
+
+	if (block.empty() || crc_.compute(block.data(), block.size()) != read32(frame + 12))
+	{
+		// Frame boundaries are still known, so only this frame is lost.
+		LOG_WARNING("stage {}: broken frame with {} bytes of data dropped", getID(), original);
+		++broken_;
+		return;
+	}
+
+	blocks.push_back(std::move(block));
+}
+
+void DecompressTransformation::drop(std::vector<uint8_t>& tail, size_t bytes)
+{
+	// Header is broken, so there is no way to find the next frame - rest of the piece is lost.
+	LOG_WARNING("stage {}: invalid frame header, {} bytes dropped", getID(), tail.size() + bytes);
+	dropped_ += tail.size() + bytes;
+	tail.clear();
+}
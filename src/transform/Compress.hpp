@@ -0,0 +1,206 @@
+/**
+ *  @file   Compress.hpp
+ *  @brief  Compresses data into frames and decompresses them back.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Compressed stream is a sequence of self-contained frames, so it can be written to a file and
+ *  decompressed later from the file read in arbitrary pieces. Frame has a 16 byte header:
+ *
+ *  "SWZ" | method (0 - stored, 1 - LZ) | payload size | data size | CRC32C of the data | payload
+ *
+ *  (sizes and checksum are 4 byte big-endian). Data that does not compress is stored as it is.
+ */
+
+#ifndef SRC_TRANSFORM_COMPRESS_HPP_
+#define SRC_TRANSFORM_COMPRESS_HPP_
+
+#include "Crc.hpp"
+#include "Lz.hpp"
+#include "../core/Stage.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+* Encoder of the single frames - used by the compress stage and by writers of compressed files.
+*/
+class FrameEncoder
+{
+public:
+	/**
+	* Compress data into a frame.
+	* @param[in] data data
+	* @param[in] size size of the data (max 4 GiB - 16 bytes)
+	* @param[out] frame frame
+	*/
+	void encode(const uint8_t* data, size_t size, std::vector<uint8_t>& frame);
+
+private:
+	LzCodec codec_;
+	Crc crc_{ Crc::Algorithm::CRC32C };
+};
+
+class CompressTransformation : public TransformStage
+{
+public:
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "compress"
+	*
+	* Optional configuration:
+	* block_size = 65536						# data from the cooperative is joined into blocks of this size,
+	*										# 0 - every message is a separate frame, def: 65536
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Compress incoming data and send frames to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Add message to the block of the cooperative.
+	* @param[in] data message
+	* @param[in] src cooperative the message came from
+	* @param[out] frames place to append frames of the completed blocks to
+	*/
+	void compress(std::vector<uint8_t>&& data, unsigned int src, std::vector<std::vector<uint8_t>>& frames);
+
+	/**
+	* Compress incomplete block of the cooperative.
+	* @param[out] frame frame with the block
+	* @param[in] src cooperative
+	* @return True if there was a block to compress.
+	*/
+	bool flush(std::vector<uint8_t>& frame, unsigned int src);
+
+	/**
+	* Get number of bytes compressed and bytes of frames produced.
+	*/
+	uint64_t getBytesIn() const {
+		return bytes_in_;
+	}
+
+	uint64_t getBytesOut() const {
+		return bytes_out_;
+	}
+
+protected:
+	/**
+	* Pass on the incomplete block left in the slot by the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+	/**
+	* Incomplete blocks are held back.
+	*/
+	size_t held_data() const override;
+
+private:
+	void frame(const uint8_t* data, size_t size, std::vector<uint8_t>& frame);
+
+	size_t block_size_{ 65536 };
+	FrameEncoder encoder_;
+
+	std::vector<std::vector<uint8_t>> blocks_;					/*!< Incomplete block per cooperative slot */
+	std::vector<std::vector<uint8_t>> frames_;
+	uint64_t bytes_in_{ 0 };
+	uint64_t bytes_out_{ 0 };
+};
+
+class DecompressTransformation : public TransformStage
+{
+public:
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "decompress"
+	*
+	* Optional configuration:
+	* max_frame = 67108864					# max size of the frame data, def: 64 MiB
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Decompress incoming frames and send data to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Decompress frames from the piece of the stream.
+	* @param[in] data piece of the compressed stream from the cooperative
+	* @param[in] src cooperative the data came from
+	* @param[out] blocks place to append decompressed data to
+	*/
+	void decompress(std::vector<uint8_t>&& data, unsigned int src, std::vector<std::vector<uint8_t>>& blocks);
+
+	/**
+	* Get number of frames dropped because they were broken.
+	*/
+	uint64_t getBroken() const {
+		return broken_;
+	}
+
+	/**
+	* Get number of bytes dropped because the stream could not be parsed.
+	*/
+	uint64_t getDropped() const {
+		return dropped_;
+	}
+
+protected:
+	/**
+	* Drop the incomplete frame left in the slot by the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+	/**
+	* Incomplete frames are held back.
+	*/
+	size_t held_data() const override;
+
+private:
+	static constexpr size_t INVALID = std::numeric_limits<size_t>::max();
+
+	/**
+	* Size of the whole frame starting with the header.
+	* @return Size or INVALID if the header is not valid.
+	*/
+	size_t frame_size(const uint8_t* header) const noexcept;
+
+	/**
+	* Bytes missing to complete the held back frame.
+	* @return Number of bytes (0 if complete) or INVALID.
+	*/
+	size_t missing(const std::vector<uint8_t>& tail) const noexcept;
+
+	/**
+	* Decode complete frame and append its data to the output.
+	*/
+	void decode(const uint8_t* frame, std::vector<std::vector<uint8_t>>& blocks);
+
+	void drop(std::vector<uint8_t>& tail, size_t bytes);
+
+	size_t max_frame_{ 1 << 26 };
+	Crc crc_{ Crc::Algorithm::CRC32C };
+
+	std::vector<std::vector<uint8_t>> tails_;					/*!< Incomplete frame per cooperative slot */
+	std::vector<std::vector<uint8_t>> blocks_;
+	uint64_t broken_{ 0 };
+	uint64_t dropped_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_COMPRESS_HPP_ */
@@ -0,0 +1,293 @@
+/**
+ *  @file   Crc.cpp
+ *  @brief  CRC32C, CRC32 and CRC64 checksums.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Crc.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#define SWPL_HAVE_CRC_TARGETS
+#endif
+
+/**
+* Everything the algorithm needs - tables for the portable code and folding constants.
+*/
+struct Crc::Tables
+{
+	unsigned int width{ 0 };								/*!< Bits */
+	uint64_t mask{ 0 };										/*!< Initial value and final xor */
+	std::array<std::array<uint64_t, 256>, 8> slices{};		/*!< Slicing-by-8 tables */
+
+	/**
+	* Constants folding 128 bit block over 128, 256, 384 and 512 bits: pairs for the low and high
+	* qword, bit-reflected x^(64+D-1) mod P and x^(D-1) mod P (one x compensates the reflected product).
+	*/
+	alignas(16) std::array<uint64_t, 8> fold{};
+};
+
+static uint64_t reflect(uint64_t value) noexcept
+{
+	uint64_t result = 0;
+
+	for (int bit = 0; bit < 64; ++bit)
+	{
+		result = (result << 1) | (value & 1);
+		value >>= 1;
+	}
+
+	return result;
+}
+
+/**
+* Compute x^exponent mod P in the plain (not reflected) representation.
+*/
+static uint64_t power_mod(unsigned int exponent, uint64_t poly, unsigned int width) noexcept
+{
+	const uint64_t mask = width == 64 ? ~0ull : (1ull << width) - 1;
+	uint64_t value = 1;
+
+	while (exponent-- > 0)
+	{
+		bool carry = ((value >> (width - 1)) & 1) != 0;
+		value = (value << 1) & mask;
+		if (carry)
+			value ^= poly;
+	}
+
+	return value;
+}
+
+static Crc::Tables make_tables(uint64_t reflected_poly, unsigned int width) noexcept
+{
+	Crc::Tables tables;
+	tables.width = width;
+	tables.mask = width == 64 ? ~0ull : (1ull << width) - 1;
+
+	for (unsigned int byte = 0; byte < 256; ++byte)
+	{
+		uint64_t crc = byte;
+		for (int bit = 0; bit < 8; ++bit)
+			crc = (crc >> 1) ^ ((crc & 1) != 0 ? reflected_poly : 0);
+		tables.slices[0][byte] = crc;
+	}
+
+	for (size_t slice = 1; slice < 8; ++slice)
+	{
+		for (size_t byte = 0; byte < 256; ++byte)
+		{
+			auto previous = tables.slices[slice - 1][byte];
+			tables.slices[slice][byte] = (previous >> 8) ^ tables.slices[0][previous & 0xff];
+		}
+	}
+
+	const uint64_t poly = reflect(reflected_poly) >> (64 - width);
+	for (unsigned int step = 0; step < 4; ++step)
+	{
+		unsigned int distance = 128 * (step + 1);
+		tables.fold[2 * step] = reflect(power_mod(64 + distance - 1, poly, width));
+		tables.fold[2 * step + 1] = reflect(power_mod(distance - 1, poly, width));
+	}
+
+	return tables;
+}
+
+static const Crc::Tables CRC32C_TABLES = make_tables(0x82F63B78ull, 32);
+static const Crc::Tables CRC32_TABLES = make_tables(0xEDB88320ull, 32);
+static const Crc::Tables CRC64_TABLES = make_tables(0xC96C5795D7870F42ull, 64);
+
+/**
+* Slicing-by-8 on the raw CRC register (without initial value and final xor).
+*/
+static uint64_t update_tables(const Crc::Tables& tables, uint64_t crc, const uint8_t* data, size_t size) noexcept
+{
+	const auto& t = tables.slices;
+
+	while (size >= 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+		word = __builtin_bswap64(word);
+#endif
+		word ^= crc;
+		crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^ t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+			t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^ t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+		data += 8;
+		size -= 8;
+	}
+
+	while (size-- > 0)
+		crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xff];
+
+	return crc;
+}
+
+#if defined(SWPL_HAVE_CRC_TARGETS)
+__attribute__((target("sse4.2")))
+static uint64_t update_sse42(uint64_t crc, const uint8_t* data, size_t size) noexcept
+{
+	while (size >= 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		crc = _mm_crc32_u64(crc, word);
+		data += 8;
+		size -= 8;
+	}
+
+	auto crc32 = static_cast<uint32_t>(crc);
+	while (size-- > 0)
+		crc32 = _mm_crc32_u8(crc32, *data++);
+
+	return crc32;
+}
+
+__attribute__((target("pclmul")))
+static inline __m128i fold(__m128i block, __m128i constants) noexcept
+{
+	return _mm_xor_si128(_mm_clmulepi64_si128(block, constants, 0x00), _mm_clmulepi64_si128(block, constants, 0x11));
+}
+
+/**
+* Fold the data into 128 bits congruent to it modulo P, then reduce them with the tables. Data must
+* have at least 64 bytes.
+*/
+__attribute__((target("pclmul")))
+static uint64_t update_pclmul(const Crc::Tables& tables, uint64_t crc, const uint8_t* data, size_t size) noexcept
+{
+	auto load = [](const uint8_t* at) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at)); };
+	auto constants = [&tables](size_t blocks) {
+		return _mm_load_si128(reinterpret_cast<const __m128i*>(tables.fold.data() + 2 * (blocks - 1)));
+	};
+
+	// Initial register value is the same as xoring it into the first bytes and starting from zero.
+	__m128i x0 = _mm_xor_si128(load(data), _mm_cvtsi64_si128(static_cast<long long>(crc)));
+	__m128i x1 = load(data + 16), x2 = load(data + 32), x3 = load(data + 48);
+	data += 64;
+	size -= 64;
+
+	const __m128i by4 = constants(4);
+	while (size >= 64)
+	{
+		x0 = _mm_xor_si128(fold(x0, by4), load(data));
+		x1 = _mm_xor_si128(fold(x1, by4), load(data + 16));
+		x2 = _mm_xor_si128(fold(x2, by4), load(data + 32));
+		x3 = _mm_xor_si128(fold(x3, by4), load(data + 48));
+		data += 64;
+		size -= 64;
+	}
+
+	const __m128i by1 = constants(1);
+	__m128i x = _mm_xor_si128(_mm_xor_si128(fold(x0, constants(3)), fold(x1, constants(2))), _mm_xor_si128(fold(x2, by1), x3));
+	while (size >= 16)
+	{
+		x = _mm_xor_si128(fold(x, by1), load(data));
+		data += 16;
+		size -= 16;
+	}
+
+	alignas(16) uint8_t rest[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(rest), x);
+	crc = update_tables(tables, 0, rest, sizeof(rest));
+	return update_tables(tables, crc, data, size);
+}
+
+/**
+* Check CPU support. Can run before libgcc initializes its CPU model, so it initializes it itself.
+*/
+static bool have_sse42() noexcept
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse4.2");
+}
+
+static bool have_pclmul() noexcept
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("pclmul");
+}
+
+static const bool HAVE_SSE42 = have_sse42();
+static const bool HAVE_PCLMUL = have_pclmul();
+
+/**
+* Below this size folding setup costs more than it saves. crc32 instruction is fast enough to win
+* with folding for longer data - it processes 8 bytes per instruction, but has 3 cycles of latency.
+*/
+static constexpr size_t PCLMUL_MIN_SIZE = 128;
+static constexpr size_t PCLMUL_MIN_SIZE_CRC32C = 1024;
+#endif
+
+bool Crc::parse(std::string_view name, Algorithm& algorithm) noexcept
+{
+	if (name == "crc32c")
+		algorithm = Algorithm::CRC32C;
+	else if (name == "crc32")
+		algorithm = Algorithm::CRC32;
+	else if (name == "crc64")
+		algorithm = Algorithm::CRC64;
+	else
+		return false;
+
+	return true;
+}
+
+Crc::Crc(Algorithm algorithm) noexcept : algorithm_{ algorithm }
+{
+	switch (algorithm)
+	{
+	case Algorithm::CRC32C:
+		tables_ = &CRC32C_TABLES;
+		break;
+	case Algorithm::CRC32:
+		tables_ = &CRC32_TABLES;
+		break;
+	case Algorithm::CRC64:
+	default:
+		tables_ = &CRC64_TABLES;
+		break;
+	}
+}
+
+size_t Crc::size() const noexcept
+{
+	return tables_->width / 8;
+}
+
+uint64_t Crc::update(uint64_t crc, const void* data, size_t size) const noexcept
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	crc ^= tables_->mask;
+
+#if defined(SWPL_HAVE_CRC_TARGETS)
+	if (HAVE_PCLMUL && size >= (algorithm_ == Algorithm::CRC32C ? PCLMUL_MIN_SIZE_CRC32C : PCLMUL_MIN_SIZE))
+		return update_pclmul(*tables_, crc, bytes, size) ^ tables_->mask;
+	if (algorithm_ == Algorithm::CRC32C && HAVE_SSE42)
+		return update_sse42(crc, bytes, size) ^ tables_->mask;
+#endif
+
+	return update_tables(*tables_, crc, bytes, size) ^ tables_->mask;
+}
+
+uint64_t Crc::update_portable(uint64_t crc, const void* data, size_t size) const noexcept
+{
+	return update_tables(*tables_, crc ^ tables_->mask, static_cast<const uint8_t*>(data), size) ^ tables_->mask;
+}
+
+bool Crc::accelerated() const noexcept
+{
+#if defined(SWPL_HAVE_CRC_TARGETS)
+	return HAVE_PCLMUL || (algorithm_ == Algorithm::CRC32C && HAVE_SSE42);
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,85 @@
+/**
+ *  @file   Crc.hpp
+ *  @brief  CRC32C, CRC32 and CRC64 checksums.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Portable implementation processes 8 bytes per step with slicing-by-8 tables. On x86-64 CPUs
+ *  that have them, CRC32C is computed with the SSE4.2 crc32 instruction and CRC32/CRC64 by folding
+ *  16 byte blocks with carry-less multiplication (PCLMULQDQ) - 4 independent accumulators are folded
+ *  over 64 bytes at a time and the last 128 bits are reduced with the tables. Folding is faster than
+ *  the crc32 instruction for long data, so it is used for long CRC32C data too. CPU is checked once
+ *  at startup, binary built for the baseline x86-64 still uses the instructions.
+ *
+ *  All algorithms are the reflected ones with all-ones initial value and final xor: CRC32C
+ *  (Castagnoli, iSCSI), CRC32 (IEEE 802.3, zlib) and CRC64 (ECMA-182 polynomial as used by xz).
+ */
+
+#ifndef SRC_TRANSFORM_CRC_HPP_
+#define SRC_TRANSFORM_CRC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class Crc
+{
+public:
+	enum class Algorithm
+	{
+		CRC32C,
+		CRC32,
+		CRC64
+	};
+
+	/**
+	* Find algorithm by its name (crc32c, crc32 or crc64).
+	* @param[in] name name of the algorithm
+	* @param[out] algorithm algorithm found
+	* @return True if name is known.
+	*/
+	static bool parse(std::string_view name, Algorithm& algorithm) noexcept;
+
+	explicit Crc(Algorithm algorithm = Algorithm::CRC32C) noexcept;
+
+	/**
+	* Get size of the checksum in bytes.
+	*/
+	size_t size() const noexcept;
+
+	/**
+	* Compute checksum of the data.
+	*/
+	uint64_t compute(const void* data, size_t size) const noexcept {
+		return update(0, data, size);
+	}
+
+	/**
+	* Continue computing checksum with the next chunk of data.
+	* @param[in] crc checksum of the previous chunks (0 for the first one)
+	* @param[in] data chunk of data
+	* @param[in] size size of the chunk
+	* @return Checksum of all chunks.
+	*/
+	uint64_t update(uint64_t crc, const void* data, size_t size) const noexcept;
+
+	/**
+	* Same as update() but never uses CPU specific instructions.
+	*/
+	uint64_t update_portable(uint64_t crc, const void* data, size_t size) const noexcept;
+
+	/**
+	* Check if checksum is computed with CPU specific instructions.
+	*/
+	bool accelerated() const noexcept;
+
+	struct Tables;
+
+private:
+	Algorithm algorithm_;
+	const Tables* tables_;
+};
+
+#endif /* SRC_TRANSFORM_CRC_HPP_ */
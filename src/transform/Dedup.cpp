@@ -0,0 +1,139 @@
+/**
+ *  @file   Dedup.cpp
+ *  @brief  Drops messages repeated within the time window.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Dedup.hpp"
+#include "Hash.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	WINDOW,
+	MEMORY,
+	OFFSET,
+	LENGTH,
+	PER_SOURCE,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::WINDOW, {"window", SettingType::UNSIGNED}},
+	{SettingLabel::MEMORY, {"memory", SettingType::UNSIGNED}},
+	{SettingLabel::OFFSET, {"offset", SettingType::UNSIGNED}},
+	{SettingLabel::LENGTH, {"length", SettingType::UNSIGNED}},
+	{SettingLabel::PER_SOURCE, {"per_source", SettingType::BOOL}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+static constexpr uint64_t NS_PER_MS = 1000000;
+
+bool DedupTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	uint64_t window = 1000;
+	size_t memory = 1 << 24;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	offset_ = 0;
+	length_ = 0;
+	per_source_ = false;
+	duplicates_ = 0;
+	evictions_ = 0;
+
+	config.get(section, SETTINGS.at(SettingLabel::WINDOW).setting_name, window);
+	config.get(section, SETTINGS.at(SettingLabel::MEMORY).setting_name, memory);
+	config.get(section, SETTINGS.at(SettingLabel::OFFSET).setting_name, offset_);
+	config.get(section, SETTINGS.at(SettingLabel::LENGTH).setting_name, length_);
+	config.get(section, SETTINGS.at(SettingLabel::PER_SOURCE).setting_name, per_source_);
+
+	if (window == 0 || window > std::numeric_limits<uint64_t>::max() / NS_PER_MS || memory < sizeof(Bucket))
+		return false;
+	window_ = window * NS_PER_MS;
+
+	// Power of two buckets, so the bucket is selected with a mask.
+	size_t buckets = 1;
+	while (buckets * 2 <= memory / sizeof(Bucket))
+		buckets *= 2;
+
+	table_.assign(buckets, Bucket{});
+	mask_ = buckets - 1;
+
+	return true;
+}
+
+void DedupTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+			// Window is counted in milliseconds, one reading per pass over the queues is precise enough.
+			const uint64_t now = clock();
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				if (!duplicate(data, src, now))
+					send_to_all(std::move(data), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+}
+
+bool DedupTransformation::duplicate(const std::vector<uint8_t>& data, unsigned int src, uint64_t now) noexcept
+{
+	const size_t begin = std::min(offset_, data.size());
+	const size_t size = std::min(length_ == 0 ? data.size() : length_, data.size() - begin);
+	const uint64_t hash = Hash::compute(data.data() + begin, size, per_source_ ? src + 1 : 0);
+
+	auto& slots = table_[hash & mask_].slots;
+	Slot* victim = &slots[0];
+
+	for (auto& slot : slots)
+	{
+		if (slot.expires > now && slot.hash == hash)
+		{
+			++duplicates_;
+			return true;
+		}
+		if (slot.expires < victim->expires)
+			victim = &slot;
+	}
+
+	// Slot that expires first is taken - it is free if it has already expired.
+	if (victim->expires > now)
+		++evictions_;
+
+	victim->hash = hash;
+	victim->expires = now + window_;
+	return false;
+}
+
+uint64_t DedupTransformation::clock() noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,116 @@
+/**
+ *  @file   Dedup.hpp
+ *  @brief  Drops messages repeated within the time window.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Every message is hashed (64-bit hash, whole message or its part) and looked up in the table of
+ *  recently seen hashes. Table is an array of cache line sized buckets with 4 slots, the hash selects
+ *  the bucket, so lookup and insert touch a single cache line whatever the load is. Slot keeps the
+ *  hash and the time it stops counting as seen - expired slots are free. When all slots of the bucket
+ *  are live, the one that expires first is evicted, so under overload some duplicates pass, but the
+ *  memory never grows over the budget and nothing is rehashed.
+ *
+ *  Messages are compared by hashes only - two different messages with the same 64-bit hash are
+ *  taken as duplicates, which is unlikely enough to be ignored.
+ */
+
+#ifndef SRC_TRANSFORM_DEDUP_HPP_
+#define SRC_TRANSFORM_DEDUP_HPP_
+
+#include "../core/Stage.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+class DedupTransformation : public TransformStage
+{
+public:
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "dedup"
+	*
+	* Optional configuration:
+	* window = 1000							# time a message counts as seen [ms], def: 1000
+	* memory = 16777216						# size of the table of seen messages [bytes], def: 16 MiB
+	* offset = 0							# first byte of the compared part of the message, def: 0
+	* length = 0							# length of the compared part, 0 - up to the end, def: 0
+	* per_source = false					# look for duplicates only in data of the same cooperative, def: false
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Pass every message that was not seen within the window to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Check the message and remember it as seen.
+	* @param[in] data message
+	* @param[in] src cooperative the message came from
+	* @param[in] now current time [ns]
+	* @return True if message was seen within the window and should be dropped.
+	*/
+	bool duplicate(const std::vector<uint8_t>& data, unsigned int src, uint64_t now) noexcept;
+
+	/**
+	* Get number of dropped duplicates.
+	*/
+	uint64_t getDuplicates() const {
+		return duplicates_;
+	}
+
+	/**
+	* Get number of seen messages forgotten before their window ended (table was too small).
+	*/
+	uint64_t getEvictions() const {
+		return evictions_;
+	}
+
+	/**
+	* Get number of messages the table holds.
+	*/
+	size_t getCapacity() const {
+		return table_.size() * SLOTS;
+	}
+
+	/**
+	* Get time of the steady clock used for the window [ns].
+	*/
+	static uint64_t clock() noexcept;
+
+private:
+	static constexpr size_t SLOTS = 4;
+
+	struct Slot
+	{
+		uint64_t hash{ 0 };
+		uint64_t expires{ 0 };								/*!< Slot is free from that time on */
+	};
+
+	struct alignas(64) Bucket
+	{
+		std::array<Slot, SLOTS> slots;
+	};
+
+	uint64_t window_{ 0 };									/*!< [ns] */
+	size_t offset_{ 0 };
+	size_t length_{ 0 };
+	bool per_source_{ false };
+
+	std::vector<Bucket> table_;
+	uint64_t mask_{ 0 };
+
+	uint64_t duplicates_{ 0 };
+	uint64_t evictions_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_DEDUP_HPP_ */
@@ -0,0 +1,255 @@
+/**
+ *  @file   Fields.cpp
+ *  @brief  Selects columns of delimited (CSV, TSV) records.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Fields.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+enum class SettingLabel
+{
+	COLUMNS,
+	DELIMITER,
+	QUOTE,
+	OUTPUT_DELIMITER,
+	DROP_SHORT,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::COLUMNS, {"columns", SettingType::STRING}},
+	{SettingLabel::DELIMITER, {"delimiter", SettingType::STRING}},
+	{SettingLabel::QUOTE, {"quote", SettingType::STRING}},
+	{SettingLabel::OUTPUT_DELIMITER, {"output_delimiter", SettingType::STRING}},
+	{SettingLabel::DROP_SHORT, {"drop_short", SettingType::BOOL}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Upper limit of the selected column number, so mistyped list does not make the stage hold huge tables.
+*/
+static constexpr size_t MAX_COLUMN = 65536;
+
+static inline uint8_t* put(uint8_t* out, const uint8_t* from, size_t size) noexcept
+{
+	if (size != 0)
+		std::memcpy(out, from, size);
+	return out + size;
+}
+
+bool FieldsTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string columns, value, literal;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	delimiter_ = ',';
+	quote_ = '"';
+	quoting_ = true;
+	drop_short_ = false;
+
+	if (!config.get(section, SETTINGS.at(SettingLabel::COLUMNS).setting_name, value) || !unescape_literal(value, columns) || !parse_columns(columns))
+		return false;
+
+	if (config.get(section, SETTINGS.at(SettingLabel::DELIMITER).setting_name, value))
+	{
+		if (!unescape_literal(value, literal) || literal.size() != 1)
+			return false;
+		delimiter_ = static_cast<uint8_t>(literal[0]);
+	}
+
+	if (config.get(section, SETTINGS.at(SettingLabel::QUOTE).setting_name, value))
+	{
+		if (!unescape_literal(value, literal) || literal.size() > 1)
+			return false;
+		quoting_ = !literal.empty();
+		quote_ = quoting_ ? static_cast<uint8_t>(literal[0]) : 0;
+	}
+
+	output_delimiter_.assign(1, static_cast<char>(delimiter_));
+	if (config.get(section, SETTINGS.at(SettingLabel::OUTPUT_DELIMITER).setting_name, value) && !unescape_literal(value, output_delimiter_))
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::DROP_SHORT).setting_name, drop_short_);
+
+	return !quoting_ || quote_ != delimiter_;
+}
+
+void FieldsTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				if (project(data))
+					send_to_all(std::move(data), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+}
+
+bool FieldsTransformation::project(std::vector<uint8_t>& data)
+{
+	const uint8_t* record = data.data();
+	size_t size = data.size();
+
+	// Line ending is not a part of the last field.
+	if (size > 0 && record[size - 1] == '\n')
+		size -= (size > 1 && record[size - 2] == '\r') ? 2 : 1;
+
+	split(record, size, needed_);
+
+	if (found_ < needed_)
+	{
+		++short_;
+		if (drop_short_)
+			return false;
+	}
+
+	// Output size is known before anything is copied, so it is written with plain copies.
+	const size_t separator = output_delimiter_.size();
+	size_t length = (columns_.size() - 1) * separator + (data.size() - size);
+	for (auto column : columns_)
+	{
+		if (column < found_)
+			length += ends_[column] - (column == 0 ? 0 : ends_[column - 1] + 1);
+	}
+
+	output_.resize(length);
+	uint8_t* out = output_.data();
+	for (size_t i = 0; i < columns_.size(); ++i)
+	{
+		if (i != 0)
+			out = put(out, reinterpret_cast<const uint8_t*>(output_delimiter_.data()), separator);
+
+		auto column = columns_[i];
+		if (column < found_)
+		{
+			auto begin = column == 0 ? 0 : ends_[column - 1] + 1;
+			out = put(out, record + begin, ends_[column] - begin);
+		}
+	}
+	put(out, record + size, data.size() - size);
+
+	// Output is never longer than the record unless columns repeat, so message buffer is reused.
+	data.assign(output_.data(), output_.data() + length);
+	return true;
+}
+
+bool FieldsTransformation::parse_columns(const std::string& value)
+{
+	const char* at = value.data();
+	const char* end = at + value.size();
+
+	columns_.clear();
+	needed_ = 0;
+
+	while (at != end)
+	{
+		size_t first = 0, last = 0;
+
+		while (at != end && *at == ' ')
+			++at;
+		auto result = std::from_chars(at, end, first);
+		if (result.ec != std::errc{} || first == 0 || first > MAX_COLUMN)
+			return false;
+		at = result.ptr;
+		last = first;
+
+		if (at != end && *at == '-')
+		{
+			result = std::from_chars(at + 1, end, last);
+			if (result.ec != std::errc{} || last < first || last > MAX_COLUMN)
+				return false;
+			at = result.ptr;
+		}
+
+		while (at != end && *at == ' ')
+			++at;
+		if (at != end && *at++ != ',')
+			return false;
+
+		for (auto column = first; column <= last; ++column)
+			columns_.push_back(column - 1);
+		needed_ = std::max(needed_, last);
+	}
+
+	ends_.assign(needed_, 0);
+	return !columns_.empty();
+}
+
+inline bool FieldsTransformation::special(const uint8_t* data, size_t at, size_t needed)
+{
+	if (data[at] == quote_ && quoting_)
+		quoted_ = !quoted_;
+	else if (!quoted_)
+		ends_[found_++] = at;
+
+	return found_ == needed;
+}
+
+void FieldsTransformation::split(const uint8_t* data, size_t size, size_t needed)
+{
+	size_t pos = 0;
+
+	found_ = 0;
+	quoted_ = false;
+
+#if defined(__SSE2__)
+	const __m128i delimiter = _mm_set1_epi8(static_cast<char>(delimiter_));
+	// Without quoting the quote compare finds delimiters again, which changes nothing.
+	const __m128i quote = _mm_set1_epi8(static_cast<char>(quoting_ ? quote_ : delimiter_));
+
+	for (; pos + 16 <= size; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		auto found = static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, delimiter), _mm_cmpeq_epi8(block, quote))));
+
+		for (; found != 0; found &= found - 1)
+		{
+			if (special(data, pos + static_cast<size_t>(__builtin_ctz(found)), needed))
+				return;
+		}
+	}
+#endif
+
+	for (; pos < size; ++pos)
+	{
+		if ((data[pos] == delimiter_ || (data[pos] == quote_ && quoting_)) && special(data, pos, needed))
+			return;
+	}
+
+	// Last field ends with the record.
+	ends_[found_++] = size;
+}
@@ -0,0 +1,105 @@
+/**
+ *  @file   Fields.hpp
+ *  @brief  Selects columns of delimited (CSV, TSV) records.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Every message is a single record (so the stage goes after the framer), the selected columns are
+ *  written out in the configured order, joined with the output delimiter. Delimiters inside quoted
+ *  fields do not split them, fields are passed on as they are (with their quotes). Line ending of the
+ *  record (\n or \r\n) is kept.
+ *
+ *  Delimiters and quotes are found 16 bytes at a time with SSE2 compares turned into bitmasks, so
+ *  only the special bytes are looked at one by one. Scanning stops at the last selected column.
+ *  Fields are offsets into the input buffer, output is built in the stage buffer and copied back
+ *  into the message buffer, so no memory is allocated once the buffers have grown.
+ */
+
+#ifndef SRC_TRANSFORM_FIELDS_HPP_
+#define SRC_TRANSFORM_FIELDS_HPP_
+
+#include "../core/Stage.hpp"
+
+#include <string>
+#include <vector>
+
+class FieldsTransformation : public TransformStage
+{
+public:
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "fields"
+	* columns = "3,1,5-7"					# selected columns (counted from 1) in the output order
+	*
+	* Optional configuration:
+	* delimiter = ","						# single byte separating fields, def: ","
+	* quote = "\""							# single byte quoting fields, empty - no quoting, def: "\""
+	* output_delimiter = ","				# literal joining selected fields, def: delimiter
+	* drop_short = false					# drop records without all selected columns, def: false (missing are empty)
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Project every record and send it to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Replace the record with its selected columns.
+	* @param[in,out] data record
+	* @return False if record should be dropped.
+	*/
+	bool project(std::vector<uint8_t>& data);
+
+	/**
+	* Get number of records without all selected columns.
+	*/
+	uint64_t getShort() const {
+		return short_;
+	}
+
+private:
+	/**
+	* Parse list of columns.
+	* @return False if list is empty or invalid.
+	*/
+	bool parse_columns(const std::string& value);
+
+	/**
+	* Find ends of the fields, up to the given number of them (at most needed_).
+	* @param[in] data record without the line ending
+	* @param[in] size size of the record
+	* @param[in] needed number of fields to find
+	*/
+	void split(const uint8_t* data, size_t size, size_t needed);
+
+	/**
+	* Handle special byte found at the position.
+	* @return True if all needed fields are found.
+	*/
+	bool special(const uint8_t* data, size_t at, size_t needed);
+
+	std::vector<size_t> columns_;							/*!< Selected columns, counted from 0 */
+	size_t needed_{ 0 };									/*!< Fields needed to find all selected columns */
+	uint8_t delimiter_{ ',' };
+	uint8_t quote_{ '"' };
+	bool quoting_{ true };
+	std::string output_delimiter_{ "," };
+	bool drop_short_{ false };
+
+	std::vector<size_t> ends_;								/*!< Offsets of the field ends in the current record */
+	size_t found_{ 0 };										/*!< Number of ends found */
+	bool quoted_{ false };
+	std::vector<uint8_t> output_;
+
+	uint64_t short_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_FIELDS_HPP_ */
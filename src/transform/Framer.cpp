@@ -0,0 +1,378 @@
+/**
+ *  @file   Framer.cpp
+ *  @brief  Splits byte stream into records.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Framer.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	MODE,
+	DELIMITER,
+	KEEP_DELIMITER,
+	LENGTH_BYTES,
+	LENGTH_BIG_ENDIAN,
+	KEEP_HEADER,
+	RECORD_SIZE,
+	MAX_RECORD,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::MODE, {"mode", SettingType::STRING}},
+	{SettingLabel::DELIMITER, {"delimiter", SettingType::STRING}},
+	{SettingLabel::KEEP_DELIMITER, {"keep_delimiter", SettingType::BOOL}},
+	{SettingLabel::LENGTH_BYTES, {"length_bytes", SettingType::UNSIGNED}},
+	{SettingLabel::LENGTH_BIG_ENDIAN, {"big_endian", SettingType::BOOL}},
+	{SettingLabel::KEEP_HEADER, {"keep_header", SettingType::BOOL}},
+	{SettingLabel::RECORD_SIZE, {"record_size", SettingType::UNSIGNED}},
+	{SettingLabel::MAX_RECORD, {"max_record", SettingType::UNSIGNED}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+bool FramerTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string mode{ "delimiter" }, value;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	delimiter_ = "\n";
+	keep_delimiter_ = true;
+	length_bytes_ = 4;
+	big_endian_ = true;
+	keep_header_ = false;
+	record_size_ = 0;
+	max_record_ = 1 << 20;
+	tails_.clear();
+
+	config.get(section, SETTINGS.at(SettingLabel::MODE).setting_name, mode);
+	if (mode == "delimiter")
+		mode_ = Mode::DELIMITER;
+	else if (mode == "length")
+		mode_ = Mode::LENGTH;
+	else if (mode == "fixed")
+		mode_ = Mode::FIXED;
+	else
+		return false;
+
+	if (config.get(section, SETTINGS.at(SettingLabel::DELIMITER).setting_name, value) && (!unescape_literal(value, delimiter_) || delimiter_.empty()))
+		return false;
+	config.get(section, SETTINGS.at(SettingLabel::KEEP_DELIMITER).setting_name, keep_delimiter_);
+	config.get(section, SETTINGS.at(SettingLabel::LENGTH_BYTES).setting_name, length_bytes_);
+	config.get(section, SETTINGS.at(SettingLabel::LENGTH_BIG_ENDIAN).setting_name, big_endian_);
+	config.get(section, SETTINGS.at(SettingLabel::KEEP_HEADER).setting_name, keep_header_);
+	config.get(section, SETTINGS.at(SettingLabel::RECORD_SIZE).setting_name, record_size_);
+	config.get(section, SETTINGS.at(SettingLabel::MAX_RECORD).setting_name, max_record_);
+
+	if (length_bytes_ != 1 && length_bytes_ != 2 && length_bytes_ != 4)
+		return false;
+	if (mode_ == Mode::FIXED && record_size_ == 0)
+		return false;
+
+	return max_record_ != 0;
+}
+
+void FramerTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			// Records left by unregistered cooperatives go to everyone still registered.
+			records_.clear();
+			check_sources(routes);
+			for (auto& record : records_)
+				send_to_all(std::move(record), routes);
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				records_.clear();
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				frame(std::move(data), src, records_);
+				for (auto& record : records_)
+					send_to_all(std::move(record), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+
+	// Last line does not have to be ended with the delimiter.
+	RoutingTable<Route>::ReadGuard routes{ routes_ };
+	std::vector<uint8_t> data;
+
+	for (unsigned int src = 0; src < tails_.size(); ++src)
+	{
+		if (flush(data, src))
+			send_to_all(std::move(data), routes, src);
+	}
+}
+
+void FramerTransformation::source_changed(unsigned int slot)
+{
+	// Record left by the unregistered cooperative goes out before the data of the new one.
+	std::vector<uint8_t> record;
+	if (flush(record, slot))
+		records_.push_back(std::move(record));
+}
+
+size_t FramerTransformation::held_data() const
+{
+	size_t held = 0;
+	for (const auto& tail : tails_)
+		held += tail.size();
+	return held;
+}
+
+void FramerTransformation::frame(std::vector<uint8_t>&& data, unsigned int src, std::vector<std::vector<uint8_t>>& records)
+{
+	if (tails_.size() <= src)
+		tails_.resize(src + 1);
+
+	auto& tail = tails_[src];
+	const uint8_t* bytes = data.data();
+	size_t size = data.size(), pos = 0;
+
+	if (!tail.empty())
+	{
+		pos = complete(tail, bytes, size, records);
+		if (!tail.empty())
+			return;
+	}
+
+	while (pos < size)
+	{
+		auto end = record_end(bytes, pos, size);
+		if (end == INCOMPLETE)
+			break;
+		if (end == INVALID)
+		{
+			drop(tail, size - pos);
+			return;
+		}
+
+		if (end == size)
+		{
+			// Last record keeps the buffer of the piece.
+			data.erase(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(pos));
+			emit(std::move(data), true, records);
+			return;
+		}
+
+		emit(bytes + pos, bytes + end, records);
+		pos = end;
+	}
+
+	if (pos == size)
+		return;
+
+	// So does the incomplete one held back.
+	data.erase(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(pos));
+	tail = std::move(data);
+
+	if (mode_ == Mode::DELIMITER && tail.size() >= max_record_)
+	{
+		emit(std::move(tail), false, records);
+		tail.clear();
+	}
+}
+
+bool FramerTransformation::flush(std::vector<uint8_t>& data, unsigned int src)
+{
+	if (src >= tails_.size() || tails_[src].empty())
+		return false;
+
+	data = std::move(tails_[src]);
+	tails_[src].clear();
+	return mode_ == Mode::DELIMITER;
+}
+
+size_t FramerTransformation::find_delimiter(const uint8_t* data, size_t pos, size_t size) const noexcept
+{
+	const auto first = static_cast<unsigned char>(delimiter_[0]);
+	const size_t length = delimiter_.size();
+
+	while (pos < size)
+	{
+		auto hit = static_cast<const uint8_t*>(std::memchr(data + pos, first, size - pos));
+		if (hit == nullptr)
+			return size;
+
+		auto at = static_cast<size_t>(hit - data);
+		if (length == 1)
+			return at;
+		if (size - at < length)
+			return size;
+		if (std::memcmp(hit + 1, delimiter_.data() + 1, length - 1) == 0)
+			return at;
+		pos = at + 1;
+	}
+
+	return size;
+}
+
+size_t FramerTransformation::record_end(const uint8_t* data, size_t pos, size_t size) const noexcept
+{
+	switch (mode_)
+	{
+	case Mode::DELIMITER:
+	{
+		auto at = find_delimiter(data, pos, size);
+		return at == size ? INCOMPLETE : at + delimiter_.size();
+	}
+	case Mode::LENGTH:
+	{
+		if (size - pos < length_bytes_)
+			return INCOMPLETE;
+		auto record = length(data + pos);
+		if (record > max_record_)
+			return INVALID;
+		return size - pos - length_bytes_ < record ? INCOMPLETE : pos + length_bytes_ + record;
+	}
+	case Mode::FIXED:
+		return size - pos < record_size_ ? INCOMPLETE : pos + record_size_;
+	}
+
+	return INCOMPLETE;
+}
+
+size_t FramerTransformation::complete(std::vector<uint8_t>& tail, const uint8_t* data, size_t size, std::vector<std::vector<uint8_t>>& records)
+{
+	if (mode_ == Mode::DELIMITER)
+	{
+		const size_t length = delimiter_.size();
+		size_t end = INCOMPLETE;
+
+		// Delimiter can be split between the tail and the data, the earliest occurrence counts.
+		for (size_t held = std::min(length - 1, tail.size()); held > 0 && end == INCOMPLETE; --held)
+		{
+			if (size >= length - held && std::memcmp(tail.data() + tail.size() - held, delimiter_.data(), held) == 0 &&
+				std::memcmp(data, delimiter_.data() + held, length - held) == 0)
+				end = length - held;
+		}
+
+		if (end == INCOMPLETE)
+		{
+			auto at = find_delimiter(data, 0, size);
+			if (at == size)
+			{
+				tail.insert(tail.end(), data, data + size);
+				if (tail.size() >= max_record_)
+				{
+					emit(std::move(tail), false, records);
+					tail.clear();
+				}
+				return size;
+			}
+			end = at + length;
+		}
+
+		tail.insert(tail.end(), data, data + end);
+		emit(std::move(tail), true, records);
+		tail.clear();
+		return end;
+	}
+
+	size_t pos = 0;
+	for (;;)
+	{
+		auto need = missing(tail);
+		if (need == INVALID)
+		{
+			drop(tail, size - pos);
+			return size;
+		}
+		if (need == 0)
+		{
+			emit(std::move(tail), true, records);
+			tail.clear();
+			return pos;
+		}
+		if (pos == size)
+			return size;
+
+		auto take = std::min(need, size - pos);
+		tail.insert(tail.end(), data + pos, data + pos + take);
+		pos += take;
+	}
+}
+
+size_t FramerTransformation::missing(const std::vector<uint8_t>& tail) const noexcept
+{
+	if (mode_ == Mode::FIXED)
+		return record_size_ - tail.size();
+
+	if (tail.size() < length_bytes_)
+		return length_bytes_ - tail.size();
+
+	auto record = length(tail.data());
+	if (record > max_record_)
+		return INVALID;
+	return length_bytes_ + record - tail.size();
+}
+
+void FramerTransformation::emit(std::vector<uint8_t>&& record, bool complete, std::vector<std::vector<uint8_t>>& records) const
+{
+	if (complete && mode_ == Mode::DELIMITER && !keep_delimiter_)
+		record.resize(record.size() - delimiter_.size());
+	else if (mode_ == Mode::LENGTH && !keep_header_)
+		record.erase(record.begin(), record.begin() + static_cast<std::ptrdiff_t>(length_bytes_));
+
+	// Empty records (empty lines, zero length) carry nothing to pass on.
+	if (!record.empty())
+		records.push_back(std::move(record));
+}
+
+void FramerTransformation::emit(const uint8_t* begin, const uint8_t* end, std::vector<std::vector<uint8_t>>& records) const
+{
+	if (mode_ == Mode::DELIMITER && !keep_delimiter_)
+		end -= delimiter_.size();
+	else if (mode_ == Mode::LENGTH && !keep_header_)
+		begin += length_bytes_;
+
+	if (begin != end)
+		records.emplace_back(begin, end);
+}
+
+size_t FramerTransformation::length(const uint8_t* header) const noexcept
+{
+	size_t value = 0;
+
+	for (size_t i = 0; i < length_bytes_; ++i)
+	{
+		auto byte = big_endian_ ? header[i] : header[length_bytes_ - 1 - i];
+		value = (value << 8) | byte;
+	}
+
+	return value;
+}
+
+void FramerTransformation::drop(std::vector<uint8_t>& tail, size_t bytes)
+{
+	// Length field is broken, so there is no way to find the next record - rest of the piece is lost.
+	LOG_WARNING("stage {}: record length exceeds {}, {} bytes dropped", getID(), max_record_, tail.size() + bytes);
+	dropped_ += tail.size() + bytes;
+	tail.clear();
+}
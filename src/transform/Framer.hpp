@@ -0,0 +1,153 @@
+/**
+ *  @file   Framer.hpp
+ *  @brief  Splits byte stream into records.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  IOs pass data on in the pieces they were read in. Framer turns the stream from every cooperative
+ *  into separate messages - records ended with a delimiter, preceded by their length or of a fixed
+ *  size. Incomplete record at the end of a piece is held back until the rest of it comes.
+ *
+ *  Delimiters are searched for with memchr (vectorized by the C library). Last record of the piece
+ *  (or the incomplete one held back) is moved to the front of the piece buffer and keeps it, other
+ *  records get a buffer of their exact size.
+ */
+
+#ifndef SRC_TRANSFORM_FRAMER_HPP_
+#define SRC_TRANSFORM_FRAMER_HPP_
+
+#include "../core/Stage.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+class FramerTransformation : public TransformStage
+{
+public:
+	enum class Mode
+	{
+		DELIMITER,											/*!< Records end with the delimiter */
+		LENGTH,												/*!< Records are preceded by their length */
+		FIXED												/*!< Records have the same size */
+	};
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "framer"
+	*
+	* Optional configuration:
+	* mode = "delimiter"						# delimiter, length or fixed, def: delimiter
+	* delimiter = "\n"						# delimiter mode: literal ending records, def: "\n"
+	* keep_delimiter = true					# delimiter mode: leave delimiter in the record, def: true
+	* length_bytes = 4						# length mode: size of the length field (1, 2 or 4), def: 4
+	* big_endian = true						# length mode: byte order of the length field, def: true
+	* keep_header = false					# length mode: leave length field in the record, def: false
+	* record_size = 0						# fixed mode: size of the record, must be set
+	* max_record = 1048576					# max bytes held back waiting for the end of record, def: 1 MiB
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Split incoming data into records and send them to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Split the piece of the stream into records.
+	* @param[in] data piece of the stream from the cooperative
+	* @param[in] src cooperative the data came from
+	* @param[out] records place to append complete records to
+	*/
+	void frame(std::vector<uint8_t>&& data, unsigned int src, std::vector<std::vector<uint8_t>>& records);
+
+	/**
+	* Take incomplete record held back from the cooperative, when no more data is going to come
+	* from it. Only delimiter mode passes such record on, in other modes it is dropped.
+	* @param[out] data record
+	* @param[in] src cooperative
+	* @return True if there was a record to pass on.
+	*/
+	bool flush(std::vector<uint8_t>& data, unsigned int src);
+
+	/**
+	* Get number of bytes dropped because of the invalid record length.
+	*/
+	uint64_t getDropped() const {
+		return dropped_;
+	}
+
+protected:
+	/**
+	* Pass on the incomplete record left in the slot by the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+	/**
+	* Incomplete records are held back.
+	*/
+	size_t held_data() const override;
+
+private:
+	static constexpr size_t INCOMPLETE = std::numeric_limits<size_t>::max();
+	static constexpr size_t INVALID = std::numeric_limits<size_t>::max() - 1;
+
+	/**
+	* Find the delimiter.
+	* @return Offset of the delimiter or size if there is no complete one.
+	*/
+	size_t find_delimiter(const uint8_t* data, size_t pos, size_t size) const noexcept;
+
+	/**
+	* Find the end of the record starting at pos.
+	* @return Offset just past the record, INCOMPLETE or INVALID (length exceeds max_record).
+	*/
+	size_t record_end(const uint8_t* data, size_t pos, size_t size) const noexcept;
+
+	/**
+	* Complete the record held back with the beginning of the data.
+	* @return Number of data bytes used.
+	*/
+	size_t complete(std::vector<uint8_t>& tail, const uint8_t* data, size_t size, std::vector<std::vector<uint8_t>>& records);
+
+	/**
+	* Bytes missing to complete the held back record in length and fixed modes.
+	* @return Number of bytes (0 if complete) or INVALID.
+	*/
+	size_t missing(const std::vector<uint8_t>& tail) const noexcept;
+
+	/**
+	* Drop delimiter or length field (if configured so) and append record to the output.
+	*/
+	void emit(std::vector<uint8_t>&& record, bool complete, std::vector<std::vector<uint8_t>>& records) const;
+	void emit(const uint8_t* begin, const uint8_t* end, std::vector<std::vector<uint8_t>>& records) const;
+
+	/**
+	* Record length stored in the length field.
+	*/
+	size_t length(const uint8_t* header) const noexcept;
+
+	void drop(std::vector<uint8_t>& tail, size_t bytes);
+
+	Mode mode_{ Mode::DELIMITER };
+	std::string delimiter_{ "\n" };
+	bool keep_delimiter_{ true };
+	size_t length_bytes_{ 4 };
+	bool big_endian_{ true };
+	bool keep_header_{ false };
+	size_t record_size_{ 0 };
+	size_t max_record_{ 1 << 20 };
+
+	std::vector<std::vector<uint8_t>> tails_;					/*!< Incomplete record per cooperative slot */
+	std::vector<std::vector<uint8_t>> records_;
+	uint64_t dropped_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_FRAMER_HPP_ */
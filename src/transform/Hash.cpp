@@ -0,0 +1,117 @@
+/**
+ *  @file   Hash.cpp
+ *  @brief  Fast 64-bit non-cryptographic hash.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Hash.hpp"
+
+#include <cstring>
+
+static constexpr uint64_t P0 = 0xa0761d6478bd642full;
+static constexpr uint64_t P1 = 0xe7037ed1a0b428dbull;
+static constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+static constexpr uint64_t P3 = 0x589965cc75374cc3ull;
+
+static inline uint64_t read64(const uint8_t* at) noexcept
+{
+	uint64_t value;
+	std::memcpy(&value, at, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	value = __builtin_bswap64(value);
+#endif
+	return value;
+}
+
+static inline uint64_t read32(const uint8_t* at) noexcept
+{
+	uint32_t value;
+	std::memcpy(&value, at, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	value = __builtin_bswap32(value);
+#endif
+	return value;
+}
+
+/**
+* Full 128-bit product of a and b, low half to a, high half to b.
+*/
+static inline void multiply(uint64_t& a, uint64_t& b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	a = static_cast<uint64_t>(product);
+	b = static_cast<uint64_t>(product >> 64);
+#else
+	uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffffull, lb = b & 0xffffffffull;
+	uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+	uint64_t middle = (ll >> 32) + (hl & 0xffffffffull) + (lh & 0xffffffffull);
+	a = (middle << 32) | (ll & 0xffffffffull);
+	b = hh + (hl >> 32) + (lh >> 32) + (middle >> 32);
+#endif
+}
+
+uint64_t Hash::mix(uint64_t a, uint64_t b) noexcept
+{
+	multiply(a, b);
+	return a ^ b;
+}
+
+uint64_t Hash::compute(const uint8_t* data, size_t size, uint64_t seed) noexcept
+{
+	const uint8_t* at = data;
+	uint64_t a = 0, b = 0;
+
+	seed ^= mix(seed ^ P0, P1);
+
+	if (size <= 16)
+	{
+		if (size >= 4)
+		{
+			// Two overlapping pairs of 4 byte loads cover 4 to 16 bytes.
+			const size_t step = (size >> 3) << 2;
+			a = (read32(at) << 32) | read32(at + step);
+			b = (read32(at + size - 4) << 32) | read32(at + size - 4 - step);
+		}
+		else if (size > 0)
+		{
+			a = (static_cast<uint64_t>(at[0]) << 16) | (static_cast<uint64_t>(at[size >> 1]) << 8) | at[size - 1];
+		}
+	}
+	else
+	{
+		size_t left = size;
+		if (left > 48)
+		{
+			uint64_t lane1 = seed, lane2 = seed;
+			do
+			{
+				seed = mix(read64(at) ^ P1, read64(at + 8) ^ seed);
+				lane1 = mix(read64(at + 16) ^ P2, read64(at + 24) ^ lane1);
+				lane2 = mix(read64(at + 32) ^ P3, read64(at + 40) ^ lane2);
+				at += 48;
+				left -= 48;
+			} while (left > 48);
+			seed ^= lane1 ^ lane2;
+		}
+
+		while (left > 16)
+		{
+			seed = mix(read64(at) ^ P1, read64(at + 8) ^ seed);
+			at += 16;
+			left -= 16;
+		}
+
+		// Last 16 bytes are read whole, overlapping the ones already mixed.
+		a = read64(at + left - 16);
+		b = read64(at + left - 8);
+	}
+
+	a ^= P1;
+	b ^= seed;
+	multiply(a, b);
+	return mix(a ^ P0 ^ size, b ^ P1);
+}
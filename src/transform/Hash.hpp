@@ -0,0 +1,40 @@
+/**
+ *  @file   Hash.hpp
+ *  @brief  Fast 64-bit non-cryptographic hash.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Hash follows the wyhash design: input is consumed 48 bytes at a time by three independent
+ *  multiply-xor lanes (64 x 64 -> 128 bit multiplication folded to 64 bits), short inputs are read
+ *  with a few overlapping loads and no loop. It runs at memory speed for large messages and takes
+ *  a few nanoseconds for short ones. Data is read as little endian, so the hash is the same on
+ *  every platform. It is not resistant to crafted collisions.
+ */
+
+#ifndef SRC_TRANSFORM_HASH_HPP_
+#define SRC_TRANSFORM_HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+class Hash
+{
+public:
+	/**
+	* Compute hash of the data.
+	* @param[in] data data
+	* @param[in] size size of the data
+	* @param[in] seed seed, different seeds give independent hashes
+	* @return 64-bit hash.
+	*/
+	static uint64_t compute(const uint8_t* data, size_t size, uint64_t seed = 0) noexcept;
+
+	/**
+	* Mix two 64-bit values into one.
+	*/
+	static uint64_t mix(uint64_t a, uint64_t b) noexcept;
+};
+
+#endif /* SRC_TRANSFORM_HASH_HPP_ */
@@ -0,0 +1,68 @@
+/**
+ *  @file   Literal.cpp
+ *  @brief  Byte literals given in the configuration.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Literal.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+std::string unquote(const std::string& value)
+{
+	if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+		return value.substr(1, value.size() - 2);
+	return value;
+}
+
+bool unescape_literal(const std::string& value, std::string& literal)
+{
+	size_t begin = 0, end = value.size();
+
+	if (end >= 2 && value.front() == '"' && value.back() == '"')
+	{
+		begin++;
+		end--;
+	}
+
+	literal.clear();
+	for (size_t i = begin; i < end; ++i)
+	{
+		if (value[i] != '\\')
+		{
+			literal.push_back(value[i]);
+			continue;
+		}
+
+		if (++i >= end)
+			return false;
+
+		switch (value[i])
+		{
+		case 'n': literal.push_back('\n'); break;
+		case 'r': literal.push_back('\r'); break;
+		case 't': literal.push_back('\t'); break;
+		case '\\': literal.push_back('\\'); break;
+		case '"': literal.push_back('"'); break;
+		case 'x':
+		{
+			if (i + 2 >= end)
+				return false;
+			auto digits = value.substr(i + 1, 2);
+			if (!std::all_of(digits.begin(), digits.end(), [](unsigned char c) { return std::isxdigit(c); }))
+				return false;
+			literal.push_back(static_cast<char>(std::stoi(digits, nullptr, 16)));
+			i += 2;
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,31 @@
+/**
+ *  @file   Literal.hpp
+ *  @brief  Byte literals given in the configuration.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#ifndef SRC_TRANSFORM_LITERAL_HPP_
+#define SRC_TRANSFORM_LITERAL_HPP_
+
+#include <string>
+
+/**
+* Strip the quotes around the configuration value (if there are any).
+* @param[in] value configuration value
+* @return Value without the quotes.
+*/
+std::string unquote(const std::string& value);
+
+/**
+* Convert value from the configuration to the literal: strip the quotes (if there are any)
+* and resolve \n \r \t \\ \" and \xHH escapes.
+* @param[in] value configuration value
+* @param[out] literal bytes of the literal
+* @return False if value has invalid escape sequence.
+*/
+bool unescape_literal(const std::string& value, std::string& literal);
+
+#endif /* SRC_TRANSFORM_LITERAL_HPP_ */
@@ -0,0 +1,292 @@
+/**
+ *  @file   Lz.cpp
+ *  @brief  Fast LZ77 block codec.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Lz.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t LAST_LITERALS = 5;					/*!< Block always ends with that many literals */
+static constexpr size_t MATCH_LIMIT = 12;					/*!< No match starts within that many last bytes */
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr unsigned int SKIP_TRIGGER = 6;				/*!< Every 2^SKIP_TRIGGER misses the search step grows */
+
+static inline uint32_t read32(const uint8_t* at) noexcept
+{
+	uint32_t value;
+	std::memcpy(&value, at, sizeof(value));
+	return value;
+}
+
+static inline uint64_t read64(const uint8_t* at) noexcept
+{
+	uint64_t value;
+	std::memcpy(&value, at, sizeof(value));
+	return value;
+}
+
+/**
+* Count equal bytes, a must not go past the end.
+*/
+static inline size_t common(const uint8_t* a, const uint8_t* b, const uint8_t* end) noexcept
+{
+	const uint8_t* start = a;
+
+	while (a + 8 <= end)
+	{
+		uint64_t diff = read64(a) ^ read64(b);
+		if (diff != 0)
+		{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+			return static_cast<size_t>(a - start) + static_cast<size_t>(__builtin_clzll(diff)) / 8;
+#else
+			return static_cast<size_t>(a - start) + static_cast<size_t>(__builtin_ctzll(diff)) / 8;
+#endif
+		}
+		a += 8;
+		b += 8;
+	}
+
+	while (a < end && *a == *b)
+	{
+		++a;
+		++b;
+	}
+
+	return static_cast<size_t>(a - start);
+}
+
+/**
+* Write length above 14 as 15 in the token nibble and the rest in the extension bytes.
+*/
+static inline uint8_t* write_length(uint8_t* op, size_t length) noexcept
+{
+	length -= 15;
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = static_cast<uint8_t>(length);
+	return op;
+}
+
+static inline uint8_t* write_literals(uint8_t* op, uint8_t* token, const uint8_t* literals, size_t length) noexcept
+{
+	if (length >= 15)
+	{
+		*token = 15 << 4;
+		op = write_length(op, length);
+	}
+	else
+	{
+		*token = static_cast<uint8_t>(length << 4);
+	}
+
+	if (length != 0)
+		std::memcpy(op, literals, length);
+	return op + length;
+}
+
+size_t LzCodec::compress(const uint8_t* src, size_t size, uint8_t* dst)
+{
+	uint8_t* op = dst;
+	size_t anchor = 0;
+
+	if (size > MATCH_LIMIT)
+	{
+		if (table_.empty() || size >= std::numeric_limits<uint32_t>::max() - base_)
+		{
+			table_.assign(size_t{ 1 } << HASH_BITS, 0);
+			base_ = 0;
+		}
+
+		auto hash = [](uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); };
+		const size_t limit = size - MATCH_LIMIT;
+		const uint8_t* const match_end = src + size - LAST_LITERALS;
+
+		table_[hash(read32(src))] = base_;
+		size_t ip = 1;
+
+		while (ip <= limit)
+		{
+			size_t match = 0, misses = size_t{ 1 } << SKIP_TRIGGER, next = ip;
+			bool found = false;
+
+			// Data that does not compress is searched with the growing step.
+			while (!found)
+			{
+				ip = next;
+				if (ip > limit)
+					break;
+				next = ip + (misses++ >> SKIP_TRIGGER);
+
+				auto sequence = read32(src + ip);
+				auto& slot = table_[hash(sequence)];
+				uint32_t entry = slot;
+				slot = static_cast<uint32_t>(base_ + ip);
+
+				if (entry >= base_)
+				{
+					match = entry - base_;
+					found = (ip - match <= MAX_OFFSET && read32(src + match) == sequence);
+				}
+			}
+
+			if (!found)
+				break;
+
+			while (ip > anchor && match > 0 && src[ip - 1] == src[match - 1])
+			{
+				--ip;
+				--match;
+			}
+
+			size_t length = MIN_MATCH + common(src + ip + MIN_MATCH, src + match + MIN_MATCH, match_end);
+			uint8_t* token = op++;
+			op = write_literals(op, token, src + anchor, ip - anchor);
+
+			size_t offset = ip - match;
+			*op++ = static_cast<uint8_t>(offset);
+			*op++ = static_cast<uint8_t>(offset >> 8);
+			if (length - MIN_MATCH >= 15)
+			{
+				*token |= 15;
+				op = write_length(op, length - MIN_MATCH);
+			}
+			else
+			{
+				*token |= static_cast<uint8_t>(length - MIN_MATCH);
+			}
+
+			ip += length;
+			anchor = ip;
+			if (ip <= limit)
+				table_[hash(read32(src + ip - 2))] = static_cast<uint32_t>(base_ + ip - 2);
+		}
+
+		base_ += static_cast<uint32_t>(size);
+	}
+
+	uint8_t* token = op++;
+	op = write_literals(op, token, src + anchor, size - anchor);
+	return static_cast<size_t>(op - dst);
+}
+
+/**
+* Read the length extension bytes.
+*/
+static inline bool read_length(const uint8_t*& ip, const uint8_t* iend, size_t& length) noexcept
+{
+	uint8_t byte;
+
+	do
+	{
+		if (ip == iend)
+			return false;
+		byte = *ip++;
+		length += byte;
+	} while (byte == 255);
+
+	return true;
+}
+
+static inline void copy16(uint8_t* to, const uint8_t* from) noexcept
+{
+	std::memcpy(to, from, 16);
+}
+
+/**
+* Copy the match. Bytes past the match can be overwritten if there is room in the output.
+*/
+static inline void copy_match(uint8_t* op, size_t offset, size_t length, const uint8_t* oend) noexcept
+{
+	const uint8_t* match = op - offset;
+	uint8_t* const end = op + length;
+
+	if (offset < 8)
+	{
+		// Repeat the short pattern until it is at least 8 bytes long, then copy it in chunks.
+		size_t distance = offset;
+		while (distance < 8)
+			distance += offset;
+
+		uint8_t* head = op + std::min(distance, length);
+		while (op < head)
+			*op++ = *match++;
+		match = op - distance;
+		offset = distance;
+	}
+
+	if (oend - end < 16)
+	{
+		while (op < end)
+			*op++ = *match++;
+	}
+	else if (offset >= 16)
+	{
+		for (; op < end; op += 16, match += 16)
+			copy16(op, match);
+	}
+	else
+	{
+		for (; op < end; op += 8, match += 8)
+			std::memcpy(op, match, 8);
+	}
+}
+
+bool LzCodec::decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t original) noexcept
+{
+	const uint8_t* ip = src;
+	const uint8_t* const iend = src + size;
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + original;
+
+	for (;;)
+	{
+		if (ip == iend)
+			return false;
+
+		unsigned int token = *ip++;
+		size_t length = token >> 4;
+		if (length == 15 && !read_length(ip, iend, length))
+			return false;
+		if (length > static_cast<size_t>(iend - ip) || length > static_cast<size_t>(oend - op))
+			return false;
+
+		if (length <= 16 && iend - ip >= 16 && oend - op >= 16)
+			copy16(op, ip);
+		else if (length != 0)
+			std::memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		if (ip == iend)
+			return op == oend;
+		if (iend - ip < 2)
+			return false;
+
+		size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+		ip += 2;
+		if (offset == 0 || offset > static_cast<size_t>(op - dst))
+			return false;
+
+		length = token & 15;
+		if (length == 15 && !read_length(ip, iend, length))
+			return false;
+		length += MIN_MATCH;
+		if (length > static_cast<size_t>(oend - op))
+			return false;
+
+		copy_match(op, offset, length, oend);
+		op += length;
+	}
+}
@@ -0,0 +1,64 @@
+/**
+ *  @file   Lz.hpp
+ *  @brief  Fast LZ77 block codec.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Block is a list of sequences, every one made of a token byte (high nibble - number of literals,
+ *  low nibble - match length minus 4, value 15 continues in the following bytes, 255 meaning "add
+ *  and read next"), the literals, 2 byte little endian match offset and the match length extension.
+ *  The last sequence has only literals. Matches are at most 65535 bytes back.
+ *
+ *  Compressor finds matches with a single-entry hash table of 4 byte sequences and skips faster
+ *  through data it can not compress. Decompressor copies 16 bytes at a time (overshooting within
+ *  the output buffer where possible) and checks every length and offset, so broken data never
+ *  makes it read or write out of the buffers.
+ */
+
+#ifndef SRC_TRANSFORM_LZ_HPP_
+#define SRC_TRANSFORM_LZ_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LzCodec
+{
+public:
+	/**
+	* Get maximal size of the compressed data (data that does not compress grows a bit).
+	* @param[in] size size of the data
+	*/
+	static constexpr size_t bound(size_t size) noexcept {
+		return size + size / 255 + 16;
+	}
+
+	/**
+	* Compress the data.
+	* @param[in] src data
+	* @param[in] size size of the data
+	* @param[out] dst place for the compressed data, at least bound(size) bytes
+	* @return Size of the compressed data.
+	*/
+	size_t compress(const uint8_t* src, size_t size, uint8_t* dst);
+
+	/**
+	* Decompress the block.
+	* @param[in] src compressed data
+	* @param[in] size size of the compressed data
+	* @param[out] dst place for the data
+	* @param[in] original size of the data, exactly that much must be decoded
+	* @return False if the block is broken.
+	*/
+	static bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t original) noexcept;
+
+private:
+	static constexpr unsigned int HASH_BITS = 14;
+
+	std::vector<uint32_t> table_;							/*!< Hash of 4 bytes to their position + base_ */
+	uint32_t base_{ 0 };									/*!< Positions below it come from the previous blocks */
+};
+
+#endif /* SRC_TRANSFORM_LZ_HPP_ */
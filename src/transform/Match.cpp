@@ -0,0 +1,271 @@
+/**
+ *  @file   Match.cpp
+ *  @brief  Passes messages containing configured patterns.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Match.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	PATTERN,
+	REGEX,
+	PASS,
+	DEFAULT,
+	STREAM,
+	DFA_STATES,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::PATTERN, {"pattern", SettingType::STRING}},
+	{SettingLabel::REGEX, {"regex", SettingType::STRING}},
+	{SettingLabel::PASS, {"pass", SettingType::STRING}},
+	{SettingLabel::DEFAULT, {"default", SettingType::STRING}},
+	{SettingLabel::STREAM, {"stream", SettingType::BOOL}},
+	{SettingLabel::DFA_STATES, {"dfa_states", SettingType::INTEGER}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Escape literal, so it can be a part of regular expression.
+*/
+static std::string literal_regex(const std::string& literal)
+{
+	static const char hex[] = "0123456789abcdef";
+	std::string regex;
+
+	for (auto c : literal)
+	{
+		auto byte = static_cast<uint8_t>(c);
+		if (std::isalnum(byte))
+			regex.push_back(c);
+		else
+			regex.append({ '\\', 'x', hex[byte >> 4], hex[byte & 0x0f] });
+	}
+
+	return regex;
+}
+
+bool MatchTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::vector<std::pair<bool, std::string>> rules;				// (is regular expression, pattern)
+	std::string value;
+	long dfa_states = 4096;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	automaton_ = AhoCorasick{};
+	regexes_ = RegexSet{};
+	pattern_output_.clear();
+	outputs_.assign(1, std::string{});
+	default_ = NO_OUTPUT;
+	stream_ = false;
+	streams_.clear();
+
+	auto output = [this](const std::string& name) {
+		auto it = std::find(outputs_.begin() + 1, outputs_.end(), name);
+		if (it != outputs_.end())
+			return static_cast<size_t>(it - outputs_.begin());
+		outputs_.push_back(name);
+		return outputs_.size() - 1;
+	};
+
+	for (unsigned int i = 1; ; ++i)
+	{
+		auto index = std::to_string(i);
+		std::string literal;
+
+		if (config.get(section, SETTINGS.at(SettingLabel::PATTERN).setting_name + index, value))
+		{
+			if (!unescape_literal(value, literal) || literal.empty())
+				return false;
+			rules.emplace_back(false, literal);
+		}
+		else if (config.get(section, SETTINGS.at(SettingLabel::REGEX).setting_name + index, value))
+			rules.emplace_back(true, unquote(value));
+		else
+			break;
+
+		if (config.get(section, SETTINGS.at(SettingLabel::PASS).setting_name + index, value))
+			pattern_output_.push_back(output(value));
+		else
+			pattern_output_.push_back(0);
+	}
+
+	if (rules.empty())
+		return false;
+
+	if (config.get(section, SETTINGS.at(SettingLabel::DEFAULT).setting_name, value))
+		default_ = output(value);
+	config.get(section, SETTINGS.at(SettingLabel::STREAM).setting_name, stream_);
+	if (config.get(section, SETTINGS.at(SettingLabel::DFA_STATES).setting_name, dfa_states)
+		&& (dfa_states < 2 || static_cast<size_t>(dfa_states) > RegexSet::MAX_CACHE_LIMIT))
+		return false;
+
+	// Single pass over the data - if any rule needs the regex engine, literals go there too.
+	use_regexes_ = std::any_of(rules.begin(), rules.end(), [](const auto& rule) { return rule.first; });
+	for (const auto& [regex, pattern] : rules)
+	{
+		if (use_regexes_ && regexes_.add(regex ? pattern : literal_regex(pattern)) < 0)
+			return false;
+		if (!use_regexes_)
+			automaton_.add(pattern);
+	}
+	regexes_.set_cache_limit(static_cast<size_t>(dfa_states));
+	regexes_.compile();
+	automaton_.compile();
+
+	std::vector<size_t> reachable = pattern_output_;
+	std::sort(reachable.begin(), reachable.end());
+	reachable_ = static_cast<size_t>(std::unique(reachable.begin(), reachable.end()) - reachable.begin());
+
+	selected_.assign(outputs_.size(), 0);
+	output_ids_.assign(outputs_.size(), 0);
+
+	return true;
+}
+
+void MatchTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			resolve(routes);
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				if (select(data, selected_, src) != 0)
+					dispatch(std::move(data), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+}
+
+void MatchTransformation::source_changed(unsigned int slot)
+{
+	if (slot < streams_.size())
+		streams_[slot] = ScanState{};
+}
+
+size_t MatchTransformation::select(const std::vector<uint8_t>& data, std::vector<uint8_t>& selected, unsigned int src)
+{
+	size_t hits = 0;
+
+	selected.assign(outputs_.size(), 0);
+
+	// In stream mode whole message must be scanned to keep the state right for the next one.
+	auto on_match = [&](size_t pattern) {
+		auto output = pattern_output_[pattern];
+		if (selected[output] == 0)
+		{
+			selected[output] = 1;
+			hits++;
+		}
+		return stream_ || hits < reachable_;
+	};
+
+	if (!stream_)
+		message_.literal = AhoCorasick::START;
+	else if (streams_.size() <= src)
+		streams_.resize(src + 1);
+
+	auto& state = stream_ ? streams_[src] : message_;
+
+	if (use_regexes_)
+	{
+		// Data end is the end of line only if messages are not parts of a stream.
+		if (stream_)
+			regexes_.scan(data.data(), data.size(), state.regex, on_match);
+		else
+			regexes_.match(data.data(), data.size(), on_match);
+	}
+	else
+		automaton_.scan(data.data(), data.size(), state.literal, [&](size_t pattern, size_t) { return on_match(pattern); });
+
+	if (hits == 0 && default_ != NO_OUTPUT)
+	{
+		selected[default_] = 1;
+		hits = 1;
+	}
+
+	return hits;
+}
+
+void MatchTransformation::resolve(const RoutingTable<Route>::ReadGuard& routes)
+{
+	if (routes.version() == routes_version_)
+		return;
+
+	const auto& table = routes.table();
+
+	routes_version_ = routes.version();
+	std::fill(output_ids_.begin(), output_ids_.end(), 0);
+
+	for (unsigned int dst = 0; dst < table.size(); ++dst)
+	{
+		if (table[dst].outgoing == nullptr)
+			continue;
+
+		auto it = std::find(outputs_.begin() + 1, outputs_.end(), table[dst].outgoing->getName());
+		if (it != outputs_.end())
+			output_ids_[static_cast<size_t>(it - outputs_.begin())] = dst;
+	}
+}
+
+void MatchTransformation::dispatch(std::vector<uint8_t>&& data, const RoutingTable<Route>::ReadGuard& routes, unsigned int src)
+{
+	const auto& table = routes.table();
+
+	targets_.clear();
+
+	for (size_t output = 1; output < outputs_.size(); ++output)
+	{
+		auto id = output_ids_[output];
+		if (selected_[output] != 0 && id != 0 && id != src && table[id].outgoing != nullptr)
+			targets_.push_back(table[id].outgoing);
+	}
+
+	// Cooperatives that are not named outputs get data matching patterns without pass.
+	if (selected_[0] != 0)
+	{
+		for (unsigned int dst = 0; dst < table.size(); ++dst)
+		{
+			if (dst == src || table[dst].outgoing == nullptr)
+				continue;
+			if (std::find(output_ids_.begin() + 1, output_ids_.end(), dst) != output_ids_.end())
+				continue;
+			targets_.push_back(table[dst].outgoing);
+		}
+	}
+
+	for (size_t i = 0; i + 1 < targets_.size(); ++i)
+		send(std::vector<uint8_t>(data), *targets_[i]);
+	if (!targets_.empty())
+		send(std::move(data), *targets_.back());					// Last receiver does not need a copy.
+}
@@ -0,0 +1,119 @@
+/**
+ *  @file   Match.hpp
+ *  @brief  Passes messages containing configured patterns.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  All patterns are searched for at once in a single pass over the message - literals with AhoCorasick,
+ *  or, if any regular expression is configured, everything with RegexSet (literals are escaped). Message
+ *  goes to the outputs of every pattern it contains - once per output even if more patterns routed
+ *  there matched. Scanning stops as soon as all the outputs patterns can select are selected.
+ *
+ *  In stream mode messages from every cooperative are treated as consecutive chunks of one stream,
+ *  so patterns split between messages are found too (message completing the pattern is passed).
+ */
+
+#ifndef SRC_TRANSFORM_MATCH_HPP_
+#define SRC_TRANSFORM_MATCH_HPP_
+
+#include "AhoCorasick.hpp"
+#include "Regex.hpp"
+#include "../core/Stage.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+class MatchTransformation : public TransformStage
+{
+public:
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "match"
+	* pattern1 = "literal"				# quotes are optional, \n \r \t \\ \" and \xHH escapes are allowed
+	*
+	* Optional configuration:
+	* pass1 = "stage section"			# where data matching pattern1 goes, def: all other cooperatives
+	* patternN = ...
+	* regexN = "expression"				# regular expression instead of the literal patternN
+	* passN = ...
+	* default = "stage section"			# where data matching no pattern goes, def: dropped
+	* stream = false					# find patterns split between messages, def: false
+	* dfa_states = 4096					# max cached DFA states for regular expressions (2 - 8388608), def: 4096
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Match every message and pass it on to the selected outputs.
+	*/
+	void run() override;
+
+	/**
+	* Find outputs selected by the message.
+	* @param[in] data message
+	* @param[out] selected flags of the selected outputs (index 0 - cooperatives not named as outputs)
+	* @param[in] src cooperative the message came from (stream mode keeps scanning state per cooperative)
+	* @return Number of outputs selected.
+	*/
+	size_t select(const std::vector<uint8_t>& data, std::vector<uint8_t>& selected, unsigned int src = 0);
+
+	/**
+	* Get names of the outputs. Output 0 (cooperatives not named as any output) has an empty name.
+	*/
+	const std::vector<std::string>& getOutputs() const {
+		return outputs_;
+	}
+
+protected:
+	/**
+	* Reset the scanning state left in the slot by the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+private:
+	static constexpr size_t NO_OUTPUT = std::numeric_limits<size_t>::max();
+
+	/**
+	* Find slots of the named outputs in the routing table if it has changed.
+	*/
+	void resolve(const RoutingTable<Route>::ReadGuard& routes);
+
+	/**
+	* Send message to all selected outputs except the one it came from.
+	*/
+	void dispatch(std::vector<uint8_t>&& data, const RoutingTable<Route>::ReadGuard& routes, unsigned int src);
+
+	/**
+	* Scanning state carried between messages in stream mode.
+	*/
+	struct ScanState
+	{
+		AhoCorasick::State literal{ AhoCorasick::START };
+		RegexSet::Stream regex;
+	};
+
+	AhoCorasick automaton_;									/*!< Literals (if there are no regular expressions) */
+	RegexSet regexes_;										/*!< All patterns if any regular expression is used */
+	bool use_regexes_{ false };
+	bool stream_{ false };
+	std::vector<ScanState> streams_;							/*!< Stream mode: state per cooperative slot */
+	ScanState message_;										/*!< Message mode: state reset for every message */
+	std::vector<size_t> pattern_output_;						/*!< Output selected by every pattern */
+	std::vector<std::string> outputs_;							/*!< Output names (0 - unnamed cooperatives) */
+	size_t reachable_{ 0 };										/*!< Outputs patterns can select */
+	size_t default_{ NO_OUTPUT };								/*!< Output for data matching nothing */
+
+	std::vector<unsigned int> output_ids_;						/*!< Slots of the named outputs (0 - not linked) */
+	uint64_t routes_version_{ std::numeric_limits<uint64_t>::max() };	/*!< Routing table version output_ids_ come from */
+	std::vector<uint8_t> selected_;
+	std::vector<Stage*> targets_;
+};
+
+#endif /* SRC_TRANSFORM_MATCH_HPP_ */
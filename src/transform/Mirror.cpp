@@ -1,25 +1,30 @@
 
 #include "Mirror.hpp"
 
-#include <algorithm>
-#include <execution>
-#include <chrono>
-#include <thread>
-#include <condition_variable>
-
 void MirrorTransformation::run()
 {
 	while (get_work_flag())
 	{
-		std::condition_variable cv;
-		
-		std::for_each(std::execution::par_unseq, std::begin(incoming_data_), std::end(incoming_data_), [](const auto& q) {
-			if (q.second.queue.size() > 0)
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			for (unsigned int src = 0; src < table.size(); ++src)
 			{
-				
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				// Mirror to every cooperative except the one data came from.
+				send_to_all(std::move(data), routes, src);
 			}
-			});
+		}
 
+		if (idle)
+			wait_for_data(sequence);
 	}
-
 }
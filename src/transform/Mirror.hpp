@@ -1,11 +1,15 @@
 
+#ifndef SRC_TRANSFORM_MIRROR_HPP_
+#define SRC_TRANSFORM_MIRROR_HPP_
 
 #include "../core/Stage.hpp"
 
 class MirrorTransformation : public TransformStage
 {
 public:
-	void run();
+	void run() override;
 protected:
 
-};
\ No newline at end of file
+};
+
+#endif /* SRC_TRANSFORM_MIRROR_HPP_ */
@@ -0,0 +1,212 @@
+/**
+ *  @file   Patch.cpp
+ *  @brief  Replaces configured byte sequences in the passing data.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Patch.hpp"
+#include "Literal.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	FIND,
+	REPLACE,
+	STREAM,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::FIND, {"find", SettingType::STRING}},
+	{SettingLabel::REPLACE, {"replace", SettingType::STRING}},
+	{SettingLabel::STREAM, {"stream", SettingType::BOOL}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+bool PatchTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string value;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	automaton_ = AhoCorasick{};
+	replacements_.clear();
+	streams_.clear();
+	stream_ = true;
+
+	for (unsigned int i = 1; config.get(section, SETTINGS.at(SettingLabel::FIND).setting_name + std::to_string(i), value); ++i)
+	{
+		std::string find, replace;
+
+		if (!unescape_literal(value, find) || automaton_.add(find) < 0)
+			return false;
+		if (!config.get(section, SETTINGS.at(SettingLabel::REPLACE).setting_name + std::to_string(i), value) || !unescape_literal(value, replace))
+			return false;
+
+		replacements_.push_back(std::move(replace));
+	}
+
+	if (replacements_.empty())
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::STREAM).setting_name, stream_);
+	automaton_.compile();
+
+	return true;
+}
+
+void PatchTransformation::run()
+{
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			// Bytes held back from unregistered cooperatives go to everyone still registered.
+			check_sources(routes);
+			for (auto& held : held_)
+				send_to_all(std::move(held), routes);
+			held_.clear();
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				patch(data, src);
+				if (!data.empty())
+					send_to_all(std::move(data), routes, src);
+			}
+		}
+
+		if (idle)
+			wait_for_data(sequence);
+	}
+
+	// No more data is going to complete the held back sequences.
+	RoutingTable<Route>::ReadGuard routes{ routes_ };
+	std::vector<uint8_t> data;
+
+	for (unsigned int src = 0; src < streams_.size(); ++src)
+	{
+		if (flush(data, src))
+			send_to_all(std::move(data), routes, src);
+	}
+}
+
+void PatchTransformation::source_changed(unsigned int slot)
+{
+	// Bytes held back from the unregistered cooperative go out before the data of the new one.
+	std::vector<uint8_t> data;
+	if (flush(data, slot))
+		held_.push_back(std::move(data));
+}
+
+size_t PatchTransformation::held_data() const
+{
+	size_t held = 0;
+	for (const auto& data : held_)
+		held += data.size();
+	for (const auto& stream : streams_)
+		held += stream.tail.size();
+	return held;
+}
+
+size_t PatchTransformation::patch(std::vector<uint8_t>& data, unsigned int src)
+{
+	Stream single;
+
+	if (stream_ && streams_.size() <= src)
+		streams_.resize(src + 1);
+
+	auto& stream = stream_ ? streams_[src] : single;
+	const size_t held = stream.tail.size();
+	const size_t total = held + data.size();
+	size_t last = 0;											// End of the last replacement
+
+	edits_.clear();
+	automaton_.scan(data.data(), data.size(), stream.state, [&](size_t rule, size_t end) {
+		auto length = automaton_.pattern(rule).size();
+		end += held;
+
+		// Sequences starting before the held back bytes overlap some replacement from the previous message.
+		if (end >= last + length)
+		{
+			edits_.push_back(Edit{ end - length, end, rule });
+			last = end;
+		}
+		return true;
+	});
+
+	// Bytes that may be the beginning of some sequence wait for the next message.
+	size_t keep = total;
+	if (stream_)
+		keep = std::max(last, total - std::min(total, automaton_.depth(stream.state)));
+
+	if (edits_.empty() && held == 0)
+	{
+		if (keep < total)
+		{
+			stream.tail.assign(data.begin() + static_cast<std::ptrdiff_t>(keep), data.end());
+			data.resize(keep);
+		}
+		return 0;
+	}
+
+	size_t pos = 0;
+
+	spare_.clear();
+	for (const auto& edit : edits_)
+	{
+		append(spare_, stream.tail, data, pos, edit.begin);
+		spare_.insert(spare_.end(), replacements_[edit.rule].begin(), replacements_[edit.rule].end());
+		pos = edit.end;
+	}
+	append(spare_, stream.tail, data, pos, keep);
+
+	spare_tail_.clear();
+	append(spare_tail_, stream.tail, data, keep, total);
+	std::swap(stream.tail, spare_tail_);
+
+	// Original message buffer is reused for the next patched message.
+	std::swap(data, spare_);
+
+	return edits_.size();
+}
+
+bool PatchTransformation::flush(std::vector<uint8_t>& data, unsigned int src)
+{
+	if (src >= streams_.size() || streams_[src].tail.empty())
+		return false;
+
+	data = std::move(streams_[src].tail);
+	streams_[src] = Stream{};
+	return true;
+}
+
+void PatchTransformation::append(std::vector<uint8_t>& out, const std::vector<uint8_t>& tail, const std::vector<uint8_t>& data, size_t from, size_t to)
+{
+	if (from < tail.size())
+	{
+		auto upto = std::min(to, tail.size());
+		out.insert(out.end(), tail.begin() + static_cast<std::ptrdiff_t>(from), tail.begin() + static_cast<std::ptrdiff_t>(upto));
+		from = upto;
+	}
+
+	if (from < to)
+		out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(from - tail.size()), data.begin() + static_cast<std::ptrdiff_t>(to - tail.size()));
+}
@@ -0,0 +1,117 @@
+/**
+ *  @file   Patch.hpp
+ *  @brief  Replaces configured byte sequences in the passing data.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  All rules are applied in a single pass (AhoCorasick). Replacement happens as soon as some
+ *  sequence is complete - among sequences ending at the same byte the longest one wins, and
+ *  sequences overlapping already replaced data are left alone.
+ *
+ *  Messages from every cooperative are a stream, so sequence split between two messages is
+ *  replaced too: end of the message that may start a sequence is held back and put in front of
+ *  the next message from the same cooperative (or sent as it is when the stage stops). Message
+ *  nothing is replaced in is passed on in its original buffer, otherwise it is rebuilt in the
+ *  buffer of the previous rebuilt message.
+ */
+
+#ifndef SRC_TRANSFORM_PATCH_HPP_
+#define SRC_TRANSFORM_PATCH_HPP_
+
+#include "AhoCorasick.hpp"
+#include "../core/Stage.hpp"
+
+#include <string>
+#include <vector>
+
+class PatchTransformation : public TransformStage
+{
+public:
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "patch"
+	* find1 = "literal"					# quotes are optional, \n \r \t \\ \" and \xHH escapes are allowed
+	* replace1 = "literal"				# may be empty to remove find1
+	*
+	* Optional configuration:
+	* findN = ...
+	* replaceN = ...
+	* stream = true						# replace sequences split between messages, def: true
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Patch every message and pass it on to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Apply the rules to the message.
+	* @param[in,out] data message, replaced with the patched data (empty if everything was held back)
+	* @param[in] src cooperative the message came from
+	* @return Number of replacements done.
+	*/
+	size_t patch(std::vector<uint8_t>& data, unsigned int src = 0);
+
+	/**
+	* Take data held back from the cooperative, when no more data is going to come from it.
+	* @param[out] data data held back
+	* @param[in] src cooperative
+	* @return True if there was any data held back.
+	*/
+	bool flush(std::vector<uint8_t>& data, unsigned int src);
+
+protected:
+	/**
+	* Pass on the bytes held back in the slot by the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+	/**
+	* Bytes that may start a sequence are held back.
+	*/
+	size_t held_data() const override;
+
+private:
+	/**
+	* Replacement of the range in the data (offsets include the held back bytes).
+	*/
+	struct Edit
+	{
+		size_t begin;
+		size_t end;
+		size_t rule;
+	};
+
+	/**
+	* State of the stream from one cooperative.
+	*/
+	struct Stream
+	{
+		AhoCorasick::State state{ AhoCorasick::START };
+		std::vector<uint8_t> tail;									/*!< Bytes held back - prefix of some sequence */
+	};
+
+	/**
+	* Append range of the held back bytes followed by the message to the buffer.
+	*/
+	static void append(std::vector<uint8_t>& out, const std::vector<uint8_t>& tail, const std::vector<uint8_t>& data, size_t from, size_t to);
+
+	AhoCorasick automaton_;
+	std::vector<std::string> replacements_;						/*!< Replacement of every rule */
+	bool stream_{ true };
+	std::vector<Stream> streams_;								/*!< State per cooperative slot */
+	std::vector<std::vector<uint8_t>> held_;					/*!< Bytes held back by the unregistered cooperatives */
+	std::vector<Edit> edits_;
+	std::vector<uint8_t> spare_;								/*!< Recycled buffer the next patched message is built in */
+	std::vector<uint8_t> spare_tail_;
+};
+
+#endif /* SRC_TRANSFORM_PATCH_HPP_ */
@@ -0,0 +1,297 @@
+/**
+ *  @file   RateLimit.cpp
+ *  @brief  Limits and shapes the rate of the passing data.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "RateLimit.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	MODE,
+	BYTES_PER_SECOND,
+	MESSAGES_PER_SECOND,
+	BURST_BYTES,
+	BURST_MESSAGES,
+	PER_SOURCE,
+	TIMESTAMP_OFFSET,
+	TIMESTAMP_UNIT,
+	TIMESTAMP_BIG_ENDIAN,
+	SPEED,
+	MAX_BUFFERED,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::MODE, {"mode", SettingType::STRING}},
+	{SettingLabel::BYTES_PER_SECOND, {"bytes_per_second", SettingType::DOUBLE}},
+	{SettingLabel::MESSAGES_PER_SECOND, {"messages_per_second", SettingType::DOUBLE}},
+	{SettingLabel::BURST_BYTES, {"burst_bytes", SettingType::DOUBLE}},
+	{SettingLabel::BURST_MESSAGES, {"burst_messages", SettingType::DOUBLE}},
+	{SettingLabel::PER_SOURCE, {"per_source", SettingType::BOOL}},
+	{SettingLabel::TIMESTAMP_OFFSET, {"timestamp_offset", SettingType::UNSIGNED}},
+	{SettingLabel::TIMESTAMP_UNIT, {"timestamp_unit", SettingType::STRING}},
+	{SettingLabel::TIMESTAMP_BIG_ENDIAN, {"big_endian", SettingType::BOOL}},
+	{SettingLabel::SPEED, {"speed", SettingType::DOUBLE}},
+	{SettingLabel::MAX_BUFFERED, {"max_buffered", SettingType::UNSIGNED}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+static constexpr double NS_PER_SECOND = 1e9;
+
+/**
+* Condition variable timeout overshoots by tens of microseconds, last part of the wait is spun.
+*/
+static constexpr uint64_t SPIN_NS = 100000;
+
+/**
+* Default burst covers that part of a second.
+*/
+static constexpr double DEFAULT_BURST = 0.01;
+
+bool RateLimitTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string mode{ "rate" }, unit{ "ns" };
+	double bytes_rate = 0.0, messages_rate = 0.0, burst_bytes = 0.0, burst_messages = 0.0;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	per_source_ = false;
+	timestamp_offset_ = 16;
+	big_endian_ = false;
+	speed_ = 1.0;
+	max_buffered_ = 1 << 20;
+
+	config.get(section, SETTINGS.at(SettingLabel::MODE).setting_name, mode);
+	if (mode == "rate")
+		mode_ = Mode::RATE;
+	else if (mode == "replay")
+		mode_ = Mode::REPLAY;
+	else
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::BYTES_PER_SECOND).setting_name, bytes_rate);
+	config.get(section, SETTINGS.at(SettingLabel::MESSAGES_PER_SECOND).setting_name, messages_rate);
+	config.get(section, SETTINGS.at(SettingLabel::BURST_BYTES).setting_name, burst_bytes);
+	config.get(section, SETTINGS.at(SettingLabel::BURST_MESSAGES).setting_name, burst_messages);
+	config.get(section, SETTINGS.at(SettingLabel::PER_SOURCE).setting_name, per_source_);
+	config.get(section, SETTINGS.at(SettingLabel::TIMESTAMP_OFFSET).setting_name, timestamp_offset_);
+	config.get(section, SETTINGS.at(SettingLabel::TIMESTAMP_UNIT).setting_name, unit);
+	config.get(section, SETTINGS.at(SettingLabel::TIMESTAMP_BIG_ENDIAN).setting_name, big_endian_);
+	config.get(section, SETTINGS.at(SettingLabel::SPEED).setting_name, speed_);
+	config.get(section, SETTINGS.at(SettingLabel::MAX_BUFFERED).setting_name, max_buffered_);
+
+	if (unit == "ns")
+		timestamp_unit_ = 1;
+	else if (unit == "us")
+		timestamp_unit_ = 1000;
+	else if (unit == "ms")
+		timestamp_unit_ = 1000000;
+	else if (unit == "s")
+		timestamp_unit_ = 1000000000;
+	else
+		return false;
+
+	if (bytes_rate < 0.0 || messages_rate < 0.0 || burst_bytes < 0.0 || burst_messages < 0.0 || !(speed_ > 0.0) || max_buffered_ == 0)
+		return false;
+	if (mode_ == Mode::RATE && bytes_rate == 0.0 && messages_rate == 0.0)
+		return false;
+
+	bytes_rate_ = bytes_rate / NS_PER_SECOND;
+	messages_rate_ = messages_rate / NS_PER_SECOND;
+	burst_bytes_ = burst_bytes > 0.0 ? burst_bytes : std::max(bytes_rate * DEFAULT_BURST, 1.0);
+	burst_messages_ = burst_messages > 0.0 ? burst_messages : std::max(std::floor(messages_rate * DEFAULT_BURST), 1.0);
+
+	sources_.clear();
+	wheel_ = TimerWheel<Held>{ TICK_NS, clock() };
+	buffered_ = 0;
+
+	return true;
+}
+
+void RateLimitTransformation::run()
+{
+	auto send = [this](RoutingTable<Route>::ReadGuard& routes) {
+		return [this, &routes](std::vector<uint8_t>&& data, unsigned int src) { send_to_all(std::move(data), routes, src); };
+	};
+
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool taken = false;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			for (unsigned int src = 0; src < table.size() && buffered_ < max_buffered_; ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				taken = true;
+				schedule(std::move(data), src, clock());
+			}
+
+			release(clock(), send(routes));
+		}
+
+		if (taken && buffered_ < max_buffered_)
+			continue;
+
+		auto next = wheel_.next_time();
+		if (next == TimerWheel<Held>::NEVER)
+			wait_for_data(sequence);
+		else
+			pause(next, sequence, buffered_ < max_buffered_);
+	}
+
+	// Stopping stage does not lose the held data.
+	RoutingTable<Route>::ReadGuard routes{ routes_ };
+	release(TimerWheel<Held>::NEVER - 1, send(routes));
+}
+
+uint64_t RateLimitTransformation::schedule(std::vector<uint8_t>&& data, unsigned int src, uint64_t now)
+{
+	auto& state = source(src);
+	uint64_t at = std::max(now, state.last_release);
+
+	if (mode_ == Mode::RATE)
+	{
+		const auto size = static_cast<double>(data.size());
+		if (!state.started)
+		{
+			// Buckets start full.
+			state.started = true;
+			state.bytes = Bucket{ bytes_rate_, burst_bytes_, burst_bytes_, at };
+			state.messages = Bucket{ messages_rate_, burst_messages_, burst_messages_, at };
+		}
+
+		at = std::max(state.bytes.ready(at, size), state.messages.ready(at, 1.0));
+		state.bytes.consume(at, size);
+		state.messages.consume(at, 1.0);
+	}
+	else
+	{
+		uint64_t value;
+		if (timestamp(data, value))
+		{
+			value *= timestamp_unit_;
+			if (!state.started)
+			{
+				state.started = true;
+				state.first_timestamp = value;
+				state.start = at;
+			}
+
+			// Timestamps going back in time do not reorder messages.
+			if (value > state.first_timestamp)
+				at = std::max(at, state.start + static_cast<uint64_t>(static_cast<double>(value - state.first_timestamp) / speed_));
+		}
+	}
+
+	state.last_release = at;
+	buffered_ += data.size();
+	wheel_.schedule(at, Held{ std::move(data), src });
+	return at;
+}
+
+uint64_t RateLimitTransformation::clock() noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t RateLimitTransformation::Bucket::ready(uint64_t now, double cost) const noexcept
+{
+	if (rate == 0.0)
+		return now;
+
+	double available = std::min(burst, tokens + static_cast<double>(now - last) * rate);
+	double needed = std::min(cost, burst);
+	if (available >= needed)
+		return now;
+
+	return now + static_cast<uint64_t>(std::ceil((needed - available) / rate));
+}
+
+void RateLimitTransformation::Bucket::consume(uint64_t now, double cost) noexcept
+{
+	if (rate == 0.0)
+		return;
+
+	tokens = std::min(burst, tokens + static_cast<double>(now - last) * rate) - cost;
+	last = now;
+}
+
+bool RateLimitTransformation::timestamp(const std::vector<uint8_t>& data, uint64_t& value) const noexcept
+{
+	if (data.size() < timestamp_offset_ + 8)
+		return false;
+
+	value = 0;
+	for (size_t i = 0; i < 8; ++i)
+	{
+		auto byte = big_endian_ ? data[timestamp_offset_ + i] : data[timestamp_offset_ + 7 - i];
+		value = (value << 8) | byte;
+	}
+
+	return true;
+}
+
+void RateLimitTransformation::pause(uint64_t until, unsigned int sequence, bool wake_on_data)
+{
+	while (get_work_flag())
+	{
+		auto now = clock();
+		if (now >= until)
+			return;
+
+		if (until - now <= SPIN_NS)
+		{
+			if (wake_on_data && data_sequence() != sequence)
+				return;
+			std::this_thread::yield();
+			continue;
+		}
+
+		auto deadline = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(until - SPIN_NS));
+		if (wait_for_data_until(sequence, deadline))
+		{
+			// Data that can not be taken yet does not end the wait.
+			if (wake_on_data)
+				return;
+			sequence = data_sequence();
+		}
+	}
+}
+
+void RateLimitTransformation::source_changed(unsigned int slot)
+{
+	// New cooperative starts with full buckets instead of those left by the unregistered one.
+	if (per_source_ && slot < sources_.size())
+		sources_[slot] = Source{};
+}
+
+RateLimitTransformation::Source& RateLimitTransformation::source(unsigned int src)
+{
+	size_t index = per_source_ ? src : 0;
+
+	if (sources_.size() <= index)
+		sources_.resize(index + 1);
+
+	return sources_[index];
+}
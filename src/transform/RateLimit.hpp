@@ -0,0 +1,181 @@
+/**
+ *  @file   RateLimit.hpp
+ *  @brief  Limits and shapes the rate of the passing data.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  In rate mode every message gets its release time from token buckets (bytes and messages per
+ *  second, each with its burst) when it is taken from the queue. In replay mode release time comes
+ *  from the timestamp carried in the message - gaps between timestamps are reproduced. Messages wait
+ *  in a timer wheel, so there is no sleep per message - stage sleeps until the next tick that has
+ *  something to release and the last stretch of the wait is spun to keep sub-millisecond precision.
+ *
+ *  Held messages are limited by size; when the limit is reached the stage stops taking data and the
+ *  queues before it fill up, so fast inputs are slowed down instead of losing data.
+ */
+
+#ifndef SRC_TRANSFORM_RATELIMIT_HPP_
+#define SRC_TRANSFORM_RATELIMIT_HPP_
+
+#include "../core/Stage.hpp"
+#include "../core/TimerWheel.hpp"
+
+#include <string>
+#include <vector>
+
+class RateLimitTransformation : public TransformStage
+{
+public:
+	enum class Mode
+	{
+		RATE,												/*!< Token buckets */
+		REPLAY												/*!< Timestamps carried in the messages */
+	};
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "ratelimit"
+	* bytes_per_second = 1000000				# rate mode: at least one of the rates, 0 - no limit
+	* messages_per_second = 1000
+	*
+	* Optional configuration:
+	* mode = "rate"							# rate or replay, def: rate
+	* burst_bytes = 10000					# bytes passed at once after idle time, def: 10 ms of the rate
+	* burst_messages = 10					# messages passed at once after idle time, def: 10 ms of the rate
+	* per_source = false					# separate limits (or timelines) for every cooperative, def: false
+	* timestamp_offset = 16					# replay mode: offset of the 8 byte timestamp, def: 16 (generator header)
+	* timestamp_unit = "ns"					# replay mode: ns, us, ms or s, def: ns
+	* big_endian = false					# replay mode: byte order of the timestamp, def: false
+	* speed = 1.0							# replay mode: speed of the replay, def: 1.0
+	* max_buffered = 1048576				# max bytes held in the stage, def: 1 MiB
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Release messages to all other cooperatives at their scheduled times.
+	*/
+	void run() override;
+
+	/**
+	* Compute release time of the message and hold it until then.
+	* @param[in] data message
+	* @param[in] src cooperative the message came from
+	* @param[in] now current time [ns]
+	* @return Release time [ns].
+	*/
+	uint64_t schedule(std::vector<uint8_t>&& data, unsigned int src, uint64_t now);
+
+	/**
+	* Release messages due at the given time.
+	* @param[in] now current time [ns]
+	* @param[in] on_release callable void(std::vector<uint8_t>&& data, unsigned int src)
+	* @return Number of released messages.
+	*/
+	template<typename Callback>
+	size_t release(uint64_t now, Callback&& on_release) {
+		return wheel_.expire(now, [this, &on_release](Held&& held) {
+			buffered_ -= held.data.size();
+			on_release(std::move(held.data), held.src);
+		});
+	}
+
+	/**
+	* Get number of bytes held in the stage.
+	*/
+	size_t getBuffered() const {
+		return buffered_;
+	}
+
+	/**
+	* Get time of the steady clock used for scheduling [ns].
+	*/
+	static uint64_t clock() noexcept;
+
+protected:
+	/**
+	* Reset the limits of the slot taken over from the unregistered cooperative.
+	*/
+	void source_changed(unsigned int slot) override;
+
+	/**
+	* Messages waiting for their release time are held.
+	*/
+	size_t held_data() const override {
+		return buffered_;
+	}
+
+private:
+	static constexpr uint64_t TICK_NS = 1000;				/*!< Scheduling resolution */
+
+	struct Held
+	{
+		std::vector<uint8_t> data;
+		unsigned int src{ 0 };
+	};
+
+	/**
+	* Token bucket. Tokens can drop below zero - message larger than the burst passes when the bucket
+	* is full and the debt delays the following ones.
+	*/
+	struct Bucket
+	{
+		double rate{ 0.0 };									/*!< Tokens per ns (0 - no limit) */
+		double burst{ 0.0 };
+		double tokens{ 0.0 };
+		uint64_t last{ 0 };									/*!< Time tokens were computed at */
+
+		uint64_t ready(uint64_t now, double cost) const noexcept;
+		void consume(uint64_t now, double cost) noexcept;
+	};
+
+	/**
+	* Limits and timeline of the cooperative (or of all of them).
+	*/
+	struct Source
+	{
+		Bucket bytes;
+		Bucket messages;
+		bool started{ false };
+		uint64_t first_timestamp{ 0 };						/*!< Replay: timestamp of the first message [ns] */
+		uint64_t start{ 0 };								/*!< Replay: time the first message was released at */
+		uint64_t last_release{ 0 };
+	};
+
+	/**
+	* Read timestamp from the message.
+	* @return False if message is too short to have it.
+	*/
+	bool timestamp(const std::vector<uint8_t>& data, uint64_t& value) const noexcept;
+
+	/**
+	* Wait until the time, new data (if it can be taken) or stop.
+	*/
+	void pause(uint64_t until, unsigned int sequence, bool wake_on_data);
+
+	Source& source(unsigned int src);
+
+	Mode mode_{ Mode::RATE };
+	double bytes_rate_{ 0.0 };
+	double messages_rate_{ 0.0 };
+	double burst_bytes_{ 0.0 };
+	double burst_messages_{ 0.0 };
+	bool per_source_{ false };
+	size_t timestamp_offset_{ 16 };
+	uint64_t timestamp_unit_{ 1 };							/*!< Nanoseconds per timestamp unit */
+	bool big_endian_{ false };
+	double speed_{ 1.0 };
+	size_t max_buffered_{ 1 << 20 };
+
+	std::vector<Source> sources_;							/*!< Per cooperative slot or single shared one */
+	TimerWheel<Held> wheel_{ TICK_NS };
+	size_t buffered_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_RATELIMIT_HPP_ */
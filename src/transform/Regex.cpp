@@ -0,0 +1,689 @@
+/**
+ *  @file   Regex.cpp
+ *  @brief  Set of regular expressions matched with a lazily built DFA.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Regex.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+/**
+* NFA size limit - protects against expressions like (a{1000}){1000}.
+*/
+static constexpr size_t MAX_NODES = 1 << 20;
+
+/**
+* Parsed expression.
+*/
+struct RegexSet::Ast
+{
+	enum class Type
+	{
+		SET,
+		CONCAT,
+		ALTERNATE,
+		REPEAT,
+		LINE_START,
+		LINE_END
+	};
+
+	Ast() = default;
+	explicit Ast(Type ast_type) : type(ast_type) { }
+
+	Type type{ Type::CONCAT };
+	std::bitset<256> bytes;									/*!< SET: accepted bytes */
+	std::vector<Ast> children;
+	int min{ 0 };											/*!< REPEAT: minimal count */
+	int max{ -1 };											/*!< REPEAT: maximal count (-1 - unlimited) */
+};
+
+/**
+* Recursive descent parser of the expression.
+*/
+class RegexSet::Parser
+{
+public:
+	explicit Parser(std::string_view pattern) : pattern_(pattern) { }
+
+	/**
+	* Parse the whole expression.
+	* @return False if expression is not valid.
+	*/
+	bool parse(Ast& result) {
+		if (pattern_.substr(0, 4) == "(?i)")
+		{
+			icase_ = true;
+			pos_ = 4;
+		}
+		return alternation(result) && pos_ == pattern_.size();
+	}
+
+private:
+	bool end() const {
+		return pos_ >= pattern_.size();
+	}
+
+	char peek() const {
+		return pattern_[pos_];
+	}
+
+	bool alternation(Ast& result) {
+		Ast branch;
+		if (!concatenation(branch))
+			return false;
+		if (end() || peek() != '|')
+		{
+			result = std::move(branch);
+			return true;
+		}
+
+		result = Ast{ Ast::Type::ALTERNATE };
+		result.children.push_back(std::move(branch));
+		while (!end() && peek() == '|')
+		{
+			pos_++;
+			if (!concatenation(branch))
+				return false;
+			result.children.push_back(std::move(branch));
+		}
+		return true;
+	}
+
+	bool concatenation(Ast& result) {
+		result = Ast{ Ast::Type::CONCAT };
+		while (!end() && peek() != '|' && peek() != ')')
+		{
+			Ast piece;
+			if (!repetition(piece))
+				return false;
+			result.children.push_back(std::move(piece));
+		}
+		return true;
+	}
+
+	bool repetition(Ast& result) {
+		if (!atom(result))
+			return false;
+
+		while (!end())
+		{
+			int min = 0, max = -1;
+			auto c = peek();
+
+			if (c == '*')
+				pos_++;
+			else if (c == '+')
+			{
+				min = 1;
+				pos_++;
+			}
+			else if (c == '?')
+			{
+				max = 1;
+				pos_++;
+			}
+			else if (c == '{')
+			{
+				auto parsed = counter(min, max);
+				if (parsed < 0)
+					return false;
+				if (parsed == 0)
+					break;
+			}
+			else
+				break;
+
+			// Laziness does not change whether expression matches.
+			if (!end() && peek() == '?')
+				pos_++;
+
+			Ast repeat{ Ast::Type::REPEAT };
+			repeat.min = min;
+			repeat.max = max;
+			repeat.children.push_back(std::move(result));
+			result = std::move(repeat);
+		}
+		return true;
+	}
+
+	/**
+	* Parse {n}, {n,} or {n,m}. If it does not look like a counter, position is left untouched
+	* and brace is treated as a literal.
+	* @return 1 if counter was parsed, 0 if it is not a counter, -1 if its values are not valid.
+	*/
+	int counter(int& min, int& max) {
+		size_t pos = pos_ + 1;
+		auto number = [&](int& value) {
+			size_t begin = pos;
+			value = 0;
+			while (pos < pattern_.size() && std::isdigit(static_cast<unsigned char>(pattern_[pos])) && value <= MAX_REPEAT)
+				value = value * 10 + (pattern_[pos++] - '0');
+			return pos > begin;
+		};
+
+		if (!number(min))
+			return 0;
+		max = min;
+		if (pos < pattern_.size() && pattern_[pos] == ',')
+		{
+			pos++;
+			if (!number(max))
+				max = -1;
+		}
+		if (pos >= pattern_.size() || pattern_[pos] != '}')
+			return 0;
+		if (min > MAX_REPEAT || max > MAX_REPEAT || (max >= 0 && max < min))
+			return -1;
+
+		pos_ = pos + 1;
+		return 1;
+	}
+
+	bool atom(Ast& result) {
+		auto c = peek();
+		pos_++;
+
+		switch (c)
+		{
+		case '(':
+			if (pattern_.substr(pos_, 2) == "?:")
+				pos_ += 2;
+			if (!alternation(result) || end() || peek() != ')')
+				return false;
+			pos_++;
+			return true;
+		case '*':
+		case '+':
+		case '?':
+			return false;										// Nothing to repeat.
+		case '^':
+			result = Ast{ Ast::Type::LINE_START };
+			return true;
+		case '$':
+			result = Ast{ Ast::Type::LINE_END };
+			return true;
+		case '.':
+			result = Ast{ Ast::Type::SET };
+			result.bytes.set();
+			result.bytes.reset('\n');
+			return true;
+		case '[':
+			result = Ast{ Ast::Type::SET };
+			return bracket(result.bytes);
+		case '\\':
+			result = Ast{ Ast::Type::SET };
+			return escape(result.bytes);
+		default:
+			result = Ast{ Ast::Type::SET };
+			literal(static_cast<uint8_t>(c), result.bytes);
+			return true;
+		}
+	}
+
+	/**
+	* Get the only byte in the set.
+	*/
+	static int single(const std::bitset<256>& bytes) {
+		for (int b = 0; b < 256; ++b)
+		{
+			if (bytes.test(static_cast<size_t>(b)))
+				return b;
+		}
+		return -1;
+	}
+
+	void literal(uint8_t c, std::bitset<256>& bytes) const {
+		bytes.set(c);
+		if (icase_ && std::isalpha(c))
+		{
+			bytes.set(static_cast<uint8_t>(std::tolower(c)));
+			bytes.set(static_cast<uint8_t>(std::toupper(c)));
+		}
+	}
+
+	/**
+	* Parse escape sequence (backslash already consumed) and add its bytes to the set.
+	*/
+	bool escape(std::bitset<256>& bytes) {
+		if (end())
+			return false;
+
+		auto c = peek();
+		pos_++;
+
+		auto add_class = [&](int (*predicate)(int), bool negate) {
+			for (unsigned int b = 0; b < 256; ++b)
+			{
+				if ((predicate(static_cast<int>(b)) != 0) != negate)
+					bytes.set(b);
+			}
+		};
+
+		switch (c)
+		{
+		case 'd': add_class([](int b) { return std::isdigit(b); }, false); break;
+		case 'D': add_class([](int b) { return std::isdigit(b); }, true); break;
+		case 'w': add_class([](int b) { return static_cast<int>(std::isalnum(b) || b == '_'); }, false); break;
+		case 'W': add_class([](int b) { return static_cast<int>(std::isalnum(b) || b == '_'); }, true); break;
+		case 's': add_class([](int b) { return std::isspace(b); }, false); break;
+		case 'S': add_class([](int b) { return std::isspace(b); }, true); break;
+		case 'n': bytes.set('\n'); break;
+		case 'r': bytes.set('\r'); break;
+		case 't': bytes.set('\t'); break;
+		case 'f': bytes.set('\f'); break;
+		case 'v': bytes.set('\v'); break;
+		case 'x':
+		{
+			if (pos_ + 2 > pattern_.size() || !std::isxdigit(static_cast<unsigned char>(pattern_[pos_]))
+				|| !std::isxdigit(static_cast<unsigned char>(pattern_[pos_ + 1])))
+				return false;
+			bytes.set(static_cast<uint8_t>(std::stoi(std::string(pattern_.substr(pos_, 2)), nullptr, 16)));
+			pos_ += 2;
+			break;
+		}
+		default:
+			if (std::isalnum(static_cast<unsigned char>(c)))
+				return false;									// Unknown escape, reserved.
+			literal(static_cast<uint8_t>(c), bytes);
+		}
+		return true;
+	}
+
+	/**
+	* Parse bracket expression (opening bracket already consumed).
+	*/
+	bool bracket(std::bitset<256>& bytes) {
+		bool negate = false, first = true;
+
+		if (!end() && peek() == '^')
+		{
+			negate = true;
+			pos_++;
+		}
+
+		while (!end() && (peek() != ']' || first))
+		{
+			std::bitset<256> item;
+			int low = -1;
+
+			first = false;
+			if (peek() == '\\')
+			{
+				pos_++;
+				if (!escape(item))
+					return false;
+				if (item.count() == 1)
+					low = single(item);
+			}
+			else
+			{
+				low = static_cast<uint8_t>(peek());
+				pos_++;
+			}
+
+			// Range
+			if (low >= 0 && pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']')
+			{
+				int high = static_cast<uint8_t>(pattern_[pos_ + 1]);
+				pos_ += 2;
+				if (high == '\\')
+				{
+					std::bitset<256> upper;
+					if (!escape(upper) || upper.count() != 1)
+						return false;
+					high = single(upper);
+				}
+				if (high < low)
+					return false;
+				for (int b = low; b <= high; ++b)
+					literal(static_cast<uint8_t>(b), item);
+			}
+			else if (low >= 0)
+				literal(static_cast<uint8_t>(low), item);
+
+			bytes |= item;
+		}
+
+		if (end())
+			return false;
+		pos_++;
+
+		if (negate)
+			bytes.flip();
+		return true;
+	}
+
+	std::string_view pattern_;
+	size_t pos_{ 0 };
+	bool icase_{ false };
+};
+
+size_t RegexSet::KeyHash::operator()(const std::vector<uint32_t>& key) const noexcept
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+
+	for (auto value : key)
+		hash = (hash ^ value) * 0x100000001b3ull;
+
+	return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+int RegexSet::add(std::string_view pattern)
+{
+	Ast ast;
+	Parser parser{ pattern };
+	auto size = nodes_.size();
+
+	if (!parser.parse(ast))
+		return -1;
+
+	auto accept = add_node(NodeType::ACCEPT);
+	nodes_[accept].expression = static_cast<uint32_t>(patterns_);
+	auto start = emit(ast, accept);
+
+	if (nodes_.size() > MAX_NODES)
+	{
+		nodes_.resize(size);
+		return -1;
+	}
+
+	starts_.push_back(start);
+	return static_cast<int>(patterns_++);
+}
+
+uint32_t RegexSet::add_node(NodeType type, uint32_t out, uint32_t out2)
+{
+	Node node;
+
+	node.type = type;
+	node.out = out;
+	node.out2 = out2;
+	nodes_.push_back(node);
+
+	return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+uint32_t RegexSet::emit(const Ast& ast, uint32_t next)
+{
+	// NFA is built backwards - every fragment is emitted knowing where it continues.
+	if (nodes_.size() > MAX_NODES)
+		return next;
+
+	switch (ast.type)
+	{
+	case Ast::Type::SET:
+	{
+		auto node = add_node(NodeType::SET, next);
+		nodes_[node].bytes = ast.bytes;
+		return node;
+	}
+	case Ast::Type::LINE_START:
+		return add_node(NodeType::LINE_START, next);
+	case Ast::Type::LINE_END:
+		return add_node(NodeType::LINE_END, next);
+	case Ast::Type::CONCAT:
+		for (auto child = ast.children.rbegin(); child != ast.children.rend(); ++child)
+			next = emit(*child, next);
+		return next;
+	case Ast::Type::ALTERNATE:
+	{
+		std::vector<uint32_t> entries;
+		for (const auto& child : ast.children)
+			entries.push_back(emit(child, next));
+
+		auto start = entries.back();
+		for (size_t i = entries.size() - 1; i-- > 0;)
+			start = add_node(NodeType::SPLIT, entries[i], start);
+		return start;
+	}
+	case Ast::Type::REPEAT:
+	default:
+	{
+		auto tail = next;
+		const auto& child = ast.children.front();
+
+		if (ast.max < 0)
+		{
+			auto loop = add_node(NodeType::SPLIT, 0, next);
+			auto body = emit(child, loop);
+			nodes_[loop].out = body;
+			tail = loop;
+		}
+		else
+		{
+			for (int i = ast.min; i < ast.max; ++i)
+			{
+				auto body = emit(child, tail);
+				tail = add_node(NodeType::SPLIT, body, next);
+			}
+		}
+
+		for (int i = 0; i < ast.min; ++i)
+			tail = emit(child, tail);
+		return tail;
+	}
+	}
+}
+
+void RegexSet::compile()
+{
+	// Bytes treated the same way by every SET node share a class. New line is always separate
+	// as it moves the line anchors.
+	std::map<std::vector<bool>, uint8_t> signatures;
+	std::vector<const Node*> sets;
+
+	for (const auto& node : nodes_)
+	{
+		if (node.type == NodeType::SET)
+			sets.push_back(&node);
+	}
+
+	for (unsigned int b = 0; b < 256; ++b)
+	{
+		std::vector<bool> signature(sets.size() + 1);
+		for (size_t i = 0; i < sets.size(); ++i)
+			signature[i] = sets[i]->bytes.test(b);
+		signature[sets.size()] = (b == '\n');
+
+		auto it = signatures.try_emplace(std::move(signature), static_cast<uint8_t>(signatures.size() & 0xff)).first;
+		classes_[b] = it->second;
+	}
+	stride_ = signatures.size();
+
+	visited_.assign(nodes_.size(), 0);
+	mark_ = 0;
+	flush();
+	flushes_ = 0;
+}
+
+void RegexSet::flush()
+{
+	states_.clear();
+	transitions_.clear();
+	index_.clear();
+	generation_++;
+	flushes_++;
+}
+
+void RegexSet::closure(uint32_t node, bool line_start, bool line_end, std::vector<uint32_t>& nodes, std::vector<uint32_t>& accepts)
+{
+	std::vector<uint32_t> stack{ node };
+
+	while (!stack.empty())
+	{
+		auto current = stack.back();
+		stack.pop_back();
+
+		if (visited_[current] == mark_)
+			continue;
+		visited_[current] = mark_;
+
+		const auto& n = nodes_[current];
+		switch (n.type)
+		{
+		case NodeType::SET:
+			nodes.push_back(current);
+			break;
+		case NodeType::SPLIT:
+			stack.push_back(n.out2);
+			stack.push_back(n.out);
+			break;
+		case NodeType::EMPTY:
+			stack.push_back(n.out);
+			break;
+		case NodeType::LINE_START:
+			if (line_start)
+				stack.push_back(n.out);
+			break;
+		case NodeType::LINE_END:
+			if (line_end)
+				stack.push_back(n.out);
+			else
+				nodes.push_back(current);
+			break;
+		case NodeType::ACCEPT:
+			accepts.push_back(n.expression);
+			break;
+		}
+	}
+}
+
+RegexSet::DfaState RegexSet::initial()
+{
+	DfaState state;
+
+	state.line_start = true;
+	++mark_;
+	for (auto start : starts_)
+		closure(start, true, false, state.nodes, state.accepts);
+
+	return state;
+}
+
+uint32_t RegexSet::intern(DfaState&& state)
+{
+	std::sort(state.nodes.begin(), state.nodes.end());
+	std::sort(state.accepts.begin(), state.accepts.end());
+	state.accepts.erase(std::unique(state.accepts.begin(), state.accepts.end()), state.accepts.end());
+
+	std::vector<uint32_t> key;
+	key.reserve(state.nodes.size() + state.accepts.size() + 2);
+	key.push_back(state.line_start ? 1 : 0);
+	key.push_back(static_cast<uint32_t>(state.accepts.size()));
+	key.insert(key.end(), state.accepts.begin(), state.accepts.end());
+	key.insert(key.end(), state.nodes.begin(), state.nodes.end());
+
+	auto it = index_.find(key);
+	if (it != index_.end())
+		return it->second;
+
+	if (states_.size() >= cache_limit_)
+		flush();
+
+	auto encoded = static_cast<uint32_t>(states_.size() * stride_) | (state.accepts.empty() ? 0 : MATCH);
+	states_.push_back(std::move(state));
+	transitions_.resize(transitions_.size() + stride_, NO_STATE);
+	index_.emplace(std::move(key), encoded);
+
+	return encoded;
+}
+
+uint32_t RegexSet::build(uint32_t current, uint8_t byte)
+{
+	const auto& from = states_[(current & ~MATCH) / stride_];
+	std::vector<uint32_t> reached = from.nodes;
+	DfaState next;
+
+	next.line_start = (byte == '\n');
+
+	// New line comes - $ nodes are passed at the current position first.
+	if (byte == '\n')
+	{
+		++mark_;
+		for (auto node : from.nodes)
+			visited_[node] = mark_;
+		for (auto node : from.nodes)
+		{
+			if (nodes_[node].type == NodeType::LINE_END)
+				closure(nodes_[node].out, from.line_start, true, reached, next.accepts);
+		}
+	}
+
+	++mark_;
+	for (auto node : reached)
+	{
+		if (nodes_[node].type == NodeType::SET && nodes_[node].bytes.test(byte))
+			closure(nodes_[node].out, next.line_start, false, next.nodes, next.accepts);
+	}
+	// Search is unanchored - every expression can start at any position.
+	for (auto start : starts_)
+		closure(start, next.line_start, false, next.nodes, next.accepts);
+
+	auto generation = generation_;
+	auto target = intern(std::move(next));
+	if (generation == generation_)
+		transitions_[(current & ~MATCH) + classes_[byte]] = target;
+
+	return target;
+}
+
+std::vector<uint32_t> RegexSet::at_end(uint32_t current)
+{
+	const auto& state = states_[(current & ~MATCH) / stride_];
+	std::vector<uint32_t> reached, accepts;
+
+	++mark_;
+	for (auto node : state.nodes)
+	{
+		if (nodes_[node].type == NodeType::LINE_END)
+			closure(nodes_[node].out, state.line_start, true, reached, accepts);
+	}
+
+	std::sort(accepts.begin(), accepts.end());
+	accepts.erase(std::unique(accepts.begin(), accepts.end()), accepts.end());
+	return accepts;
+}
+
+uint32_t RegexSet::enter(Stream& stream)
+{
+	if (stream.state == NO_STATE)
+	{
+		if (start_generation_ != generation_ || start_ == NO_STATE)
+		{
+			start_ = intern(initial());
+			start_generation_ = generation_;
+		}
+		return start_;
+	}
+
+	if (stream.generation == generation_)
+		return stream.state;
+
+	// Cache has been flushed since the stream was scanned.
+	DfaState state;
+	state.nodes = stream.nodes;
+	state.line_start = stream.line_start;
+	return intern(std::move(state));
+}
+
+bool RegexSet::leave(Stream& stream, uint32_t current, bool result)
+{
+	// Stream staying in the same state already has its NFA states.
+	if (stream.state == current && stream.generation == generation_)
+		return result;
+
+	const auto& state = states_[(current & ~MATCH) / stride_];
+
+	stream.state = current;
+	stream.generation = generation_;
+	stream.nodes.assign(state.nodes.begin(), state.nodes.end());
+	stream.line_start = state.line_start;
+
+	return result;
+}
@@ -0,0 +1,299 @@
+/**
+ *  @file   Regex.hpp
+ *  @brief  Set of regular expressions matched with a lazily built DFA.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Expressions are parsed into one Thompson NFA. DFA states (sets of NFA states) are built on
+ *  demand, when a byte leads to a transition that has not been seen yet, and cached - so after a
+ *  short warm up scanning costs a single table lookup per byte. Number of cached states is bounded;
+ *  when the cache is full it is flushed and built again from the current position.
+ *
+ *  Search is unanchored and every expression reports whether it occurs in the data. Scanning state
+ *  can be carried between chunks, so expressions split between two reads still match.
+ *
+ *  Supported syntax: literals, ., [...] and [^...] with ranges, \d \D \w \W \s \S, \n \r \t \xHH,
+ *  escaped punctuation, grouping (...) and (?:...), alternation |, quantifiers * + ? {n} {n,} {n,m},
+ *  line anchors ^ and $ (start/end of data or next to \n) and (?i) prefix for case insensitivity.
+ */
+
+#ifndef SRC_TRANSFORM_REGEX_HPP_
+#define SRC_TRANSFORM_REGEX_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class RegexSet
+{
+public:
+	/**
+	* Largest cache limit - offsets of the states (state * byte classes) must stay below the MATCH flag.
+	*/
+	static constexpr size_t MAX_CACHE_LIMIT = 0x80000000u / 256;
+
+	/**
+	* Scanning state of a single stream.
+	*/
+	struct Stream
+	{
+		uint32_t state{ NO_STATE };							/*!< DFA state (valid in the cache generation) */
+		uint64_t generation{ 0 };							/*!< Cache generation the state comes from */
+		std::vector<uint32_t> nodes;						/*!< NFA states, to rebuild the state after flush */
+		bool line_start{ true };
+
+		/**
+		* Start from the beginning of data again.
+		*/
+		void reset() noexcept {
+			state = NO_STATE;
+			line_start = true;
+		}
+	};
+
+	/**
+	* Add expression to the set. Set must be compiled again before scanning.
+	* @param[in] pattern regular expression
+	* @return Index of the expression or -1 if it is not valid.
+	*/
+	int add(std::string_view pattern);
+
+	/**
+	* Prepare the set for scanning (drops all cached states).
+	*/
+	void compile();
+
+	/**
+	* Get number of expressions.
+	*/
+	size_t size() const noexcept {
+		return patterns_;
+	}
+
+	/**
+	* Set the maximal number of cached DFA states.
+	* @param[in] limit number of states (2 to MAX_CACHE_LIMIT)
+	*/
+	void set_cache_limit(size_t limit) noexcept {
+		cache_limit_ = std::clamp<size_t>(limit, 2, MAX_CACHE_LIMIT);
+	}
+
+	/**
+	* Get number of cache flushes since compile() - high number means the limit is too low.
+	*/
+	uint64_t flushes() const noexcept {
+		return flushes_;
+	}
+
+	/**
+	* Get number of currently cached DFA states.
+	*/
+	size_t cached() const noexcept {
+		return states_.size();
+	}
+
+	/**
+	* Scan the data. Callback is called with the expression index every time the expression matches
+	* (possibly many times for the same expression) and returns false to stop scanning.
+	* @param[in] data data to scan
+	* @param[in] size size of the data
+	* @param[in,out] stream state of the stream (default constructed for the beginning of data)
+	* @param[in] on_match callable bool(size_t expression)
+	* @return False if scanning was stopped by the callback, otherwise true.
+	*/
+	template<typename Callback>
+	bool scan(const uint8_t* data, size_t size, Stream& stream, Callback&& on_match) {
+		bool fresh = (stream.state == NO_STATE);
+		uint32_t current = enter(stream);
+
+		return leave(stream, current, walk(data, size, fresh, current, on_match));
+	}
+
+	/**
+	* Scan the whole data including its end, as scan() followed by finish() on a new stream, but
+	* without keeping the state for the next data.
+	* @param[in] data data to scan
+	* @param[in] size size of the data
+	* @param[in] on_match callable bool(size_t expression)
+	* @return False if scanning was stopped by the callback, otherwise true.
+	*/
+	template<typename Callback>
+	bool match(const uint8_t* data, size_t size, Callback&& on_match) {
+		Stream stream;
+		uint32_t current = enter(stream);
+
+		if (!walk(data, size, true, current, on_match))
+			return false;
+
+		for (auto expression : at_end(current))
+		{
+			if (!on_match(static_cast<size_t>(expression)))
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	* Report expressions matching at the end of data (ending with $). Stream is not usable afterwards.
+	* @param[in,out] stream state of the stream
+	* @param[in] on_match callable bool(size_t expression)
+	*/
+	template<typename Callback>
+	void finish(Stream& stream, Callback&& on_match) {
+		uint32_t current = enter(stream);
+
+		for (auto expression : at_end(current))
+		{
+			if (!on_match(static_cast<size_t>(expression)))
+				break;
+		}
+	}
+
+private:
+	static constexpr uint32_t NO_STATE = std::numeric_limits<uint32_t>::max();
+	static constexpr uint32_t MATCH = 0x80000000u;			/*!< Flag of states where some expression matches */
+	static constexpr int MAX_REPEAT = 1000;				/*!< Limit of {n,m} counters */
+
+	enum class NodeType : uint8_t
+	{
+		SET,												/*!< Consume byte from the set */
+		SPLIT,												/*!< Epsilon to out and out2 */
+		EMPTY,												/*!< Epsilon to out */
+		LINE_START,											/*!< ^ - epsilon at the beginning of line */
+		LINE_END,											/*!< $ - epsilon before \n or at the end of data */
+		ACCEPT												/*!< Expression matched */
+	};
+
+	struct Node
+	{
+		NodeType type{ NodeType::EMPTY };
+		uint32_t out{ 0 };
+		uint32_t out2{ 0 };
+		std::bitset<256> bytes;								/*!< SET: accepted bytes */
+		uint32_t expression{ 0 };							/*!< ACCEPT: expression index */
+	};
+
+	struct Ast;
+	class Parser;
+
+	/**
+	* DFA state - NFA states reached (SET and LINE_END nodes) and expressions matched on entering it.
+	*/
+	struct DfaState
+	{
+		std::vector<uint32_t> nodes;
+		std::vector<uint32_t> accepts;
+		bool line_start{ false };
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const std::vector<uint32_t>& key) const noexcept;
+	};
+
+	uint32_t emit(const Ast& ast, uint32_t next);
+	uint32_t add_node(NodeType type, uint32_t out = 0, uint32_t out2 = 0);
+
+	/**
+	* Follow epsilon transitions from the node. Nodes visited since the last mark_ bump are skipped.
+	* @param[in] node node to start from
+	* @param[in] line_start position is at the beginning of line (^ can be passed)
+	* @param[in] line_end position is at the end of line ($ can be passed), otherwise $ nodes are
+	*            kept unresolved as they depend on the next byte
+	* @param[out] nodes SET and unresolved LINE_END nodes reached
+	* @param[out] accepts expressions matched
+	*/
+	void closure(uint32_t node, bool line_start, bool line_end, std::vector<uint32_t>& nodes, std::vector<uint32_t>& accepts);
+
+	/**
+	* State at the beginning of data.
+	*/
+	DfaState initial();
+
+	/**
+	* Find or create DFA state. Cache is flushed if it is full, so previously returned states
+	* are valid only if generation_ has not changed.
+	* @return Encoded state (premultiplied, flagged).
+	*/
+	uint32_t intern(DfaState&& state);
+
+	/**
+	* Compute (and cache) transition that is not known yet.
+	*/
+	uint32_t build(uint32_t current, uint8_t byte);
+
+	/**
+	* Drop all cached states.
+	*/
+	void flush();
+
+	/**
+	* Expressions matching at the end of data in the given state.
+	*/
+	std::vector<uint32_t> at_end(uint32_t current);
+
+	uint32_t enter(Stream& stream);
+	bool leave(Stream& stream, uint32_t current, bool result);
+
+	/**
+	* Move through the data from the current state.
+	* @return False if scanning was stopped by the callback, otherwise true.
+	*/
+	template<typename Callback>
+	bool walk(const uint8_t* data, size_t size, bool fresh, uint32_t& current, Callback& on_match) {
+		// Expressions matching empty data match at the very beginning.
+		if (fresh && (current & MATCH) != 0 && !report(current, on_match))
+			return false;
+
+		for (size_t pos = 0; pos < size; ++pos)
+		{
+			uint32_t next = transitions_[(current & ~MATCH) + classes_[data[pos]]];
+			if (next == NO_STATE)
+				next = build(current, data[pos]);
+			current = next;
+
+			if ((current & MATCH) != 0 && !report(current, on_match))
+				return false;
+		}
+		return true;
+	}
+
+	template<typename Callback>
+	bool report(uint32_t current, Callback& on_match) const {
+		for (auto expression : states_[(current & ~MATCH) / stride_].accepts)
+		{
+			if (!on_match(static_cast<size_t>(expression)))
+				return false;
+		}
+		return true;
+	}
+
+	std::vector<Node> nodes_;								/*!< NFA */
+	std::vector<uint32_t> starts_;							/*!< Start nodes of all expressions */
+	size_t patterns_{ 0 };
+
+	std::array<uint8_t, 256> classes_{};					/*!< Bytes no expression distinguishes share a class */
+	size_t stride_{ 1 };									/*!< Number of byte classes */
+	size_t cache_limit_{ 4096 };
+	uint64_t generation_{ 1 };								/*!< Bumped on every flush */
+	uint64_t flushes_{ 0 };
+
+	std::vector<DfaState> states_;
+	std::vector<uint32_t> transitions_;						/*!< stride_ per state, premultiplied and flagged targets */
+	std::unordered_map<std::vector<uint32_t>, uint32_t, KeyHash> index_;	/*!< Key of the state to its encoded value */
+	uint32_t start_{ NO_STATE };							/*!< Encoded initial state */
+	uint64_t start_generation_{ 0 };						/*!< Cache generation start_ comes from */
+	std::vector<uint32_t> visited_;							/*!< Closure marks (stamped with mark_) */
+	uint32_t mark_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_REGEX_HPP_ */
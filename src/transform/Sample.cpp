@@ -0,0 +1,200 @@
+/**
+ *  @file   Sample.cpp
+ *  @brief  Passes on only a sample of the messages.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ */
+
+#include "Sample.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <cmath>
+#include <unordered_map>
+
+enum class SettingLabel
+{
+	MODE,
+	EVERY,
+	PROBABILITY,
+	SIZE,
+	WINDOW,
+	SEED,
+	EMPTY
+};
+
+static const std::unordered_map<SettingLabel, Setting> SETTINGS(
+{
+	{SettingLabel::MODE, {"mode", SettingType::STRING}},
+	{SettingLabel::EVERY, {"every", SettingType::UNSIGNED}},
+	{SettingLabel::PROBABILITY, {"probability", SettingType::DOUBLE}},
+	{SettingLabel::SIZE, {"size", SettingType::UNSIGNED}},
+	{SettingLabel::WINDOW, {"window", SettingType::UNSIGNED}},
+	{SettingLabel::SEED, {"seed", SettingType::UNSIGNED}},
+	{SettingLabel::EMPTY, {"", SettingType::UNKNOWN}}
+});
+
+/**
+* Upper limit of the reservoir size, reservoir slots are allocated up front.
+*/
+static constexpr size_t MAX_SIZE = 1 << 20;
+
+bool SampleTransformation::configure(ConfigurationManager& config, const std::string& section)
+{
+	std::string mode{ "nth" };
+	uint64_t window = 1000, seed = 0;
+
+	if (!config.validate(section, SETTINGS))
+		return false;
+
+	every_ = 10;
+	probability_ = 0.01;
+	size_ = 10;
+	counter_ = 0;
+	skipped_ = 0;
+	reservoirs_.clear();
+
+	config.get(section, SETTINGS.at(SettingLabel::MODE).setting_name, mode);
+	if (mode == "nth")
+		mode_ = Mode::NTH;
+	else if (mode == "probability")
+		mode_ = Mode::PROBABILITY;
+	else if (mode == "reservoir")
+		mode_ = Mode::RESERVOIR;
+	else
+		return false;
+
+	config.get(section, SETTINGS.at(SettingLabel::EVERY).setting_name, every_);
+	config.get(section, SETTINGS.at(SettingLabel::PROBABILITY).setting_name, probability_);
+	config.get(section, SETTINGS.at(SettingLabel::SIZE).setting_name, size_);
+	config.get(section, SETTINGS.at(SettingLabel::WINDOW).setting_name, window);
+	config.get(section, SETTINGS.at(SettingLabel::SEED).setting_name, seed);
+
+	if (every_ == 0 || !(probability_ > 0.0 && probability_ <= 1.0) || size_ == 0 || size_ > MAX_SIZE || window == 0)
+		return false;
+
+	window_ = std::chrono::milliseconds(window);
+	random_.seed(seed != 0 ? seed : std::random_device{}());
+	if (mode_ == Mode::PROBABILITY)
+		counter_ = draw_skip();
+
+	return true;
+}
+
+void SampleTransformation::run()
+{
+	auto window_end = std::chrono::steady_clock::now() + window_;
+
+	while (get_work_flag())
+	{
+		auto sequence = data_sequence();
+		bool idle = true;
+
+		{
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			const auto& table = routes.table();
+			std::vector<uint8_t> data;
+
+			for (unsigned int src = 0; src < table.size(); ++src)
+			{
+				if (!take(table[src], data))
+					continue;
+
+				idle = false;
+				if (sample(data, src))
+					send_to_all(std::move(data), routes, src);
+			}
+
+			if (mode_ == Mode::RESERVOIR && std::chrono::steady_clock::now() >= window_end)
+			{
+				drain([&routes, this](std::vector<uint8_t>&& sampled, unsigned int src) { send_to_all(std::move(sampled), routes, src); });
+				// Windows follow each other without gaps, ones missed while the stage was busy are skipped.
+				auto now = std::chrono::steady_clock::now();
+				while (window_end <= now)
+					window_end += window_;
+			}
+		}
+
+		if (!idle)
+			continue;
+
+		if (mode_ == Mode::RESERVOIR)
+			wait_for_data_until(sequence, window_end);
+		else
+			wait_for_data(sequence);
+	}
+
+	// Stopping stage passes on what was sampled in the last, unfinished window.
+	RoutingTable<Route>::ReadGuard routes{ routes_ };
+	drain([&routes, this](std::vector<uint8_t>&& sampled, unsigned int src) { send_to_all(std::move(sampled), routes, src); });
+}
+
+size_t SampleTransformation::held_data() const
+{
+	size_t held = 0;
+	for (const auto& reservoir : reservoirs_)
+	{
+		const size_t count = std::min<uint64_t>(reservoir.seen, reservoir.slots.size());
+		for (size_t i = 0; i < count; ++i)
+			held += reservoir.slots[i].data.size();
+	}
+	return held;
+}
+
+bool SampleTransformation::sample(std::vector<uint8_t>& data, unsigned int src)
+{
+	switch (mode_)
+	{
+	case Mode::NTH:
+		if (counter_ == 0)
+		{
+			counter_ = every_ - 1;
+			return true;
+		}
+		--counter_;
+		break;
+	case Mode::PROBABILITY:
+		if (counter_ == 0)
+		{
+			counter_ = draw_skip();
+			return true;
+		}
+		--counter_;
+		break;
+	case Mode::RESERVOIR:
+	default:
+	{
+		if (reservoirs_.size() <= src)
+			reservoirs_.resize(src + 1);
+
+		auto& reservoir = reservoirs_[src];
+		if (reservoir.slots.empty())
+			reservoir.slots.resize(size_);
+
+		// Algorithm R: n-th message replaces a random slot with probability size / n.
+		auto seen = reservoir.seen++;
+		auto slot = seen < size_ ? seen : std::uniform_int_distribution<uint64_t>{ 0, seen }(random_);
+		if (slot < size_)
+		{
+			reservoir.slots[slot].data.swap(data);
+			reservoir.slots[slot].order = seen;
+		}
+		return false;
+	}
+	}
+
+	++skipped_;
+	return false;
+}
+
+uint64_t SampleTransformation::draw_skip()
+{
+	if (probability_ >= 1.0)
+		return 0;
+
+	// Number of failures before the first success, u is drawn from (0, 1].
+	double u = 1.0 - std::generate_canonical<double, 64>(random_);
+	double skip = std::floor(std::log(u) / std::log1p(-probability_));
+	return skip < 1e18 ? static_cast<uint64_t>(skip) : static_cast<uint64_t>(1e18);
+}
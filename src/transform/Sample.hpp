@@ -0,0 +1,146 @@
+/**
+ *  @file   Sample.hpp
+ *  @brief  Passes on only a sample of the messages.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Three modes: every N-th message, every message with the given probability or a reservoir - a
+ *  uniform random sample of fixed size from every time window (tumbling), passed on in the order the
+ *  messages came in when the window ends. Probabilistic mode draws the number of messages to skip
+ *  (geometric distribution), so there is one random number per passed message, not per message.
+ *  Reservoir of every cooperative is a fixed ring of slots whose buffers are reused.
+ */
+
+#ifndef SRC_TRANSFORM_SAMPLE_HPP_
+#define SRC_TRANSFORM_SAMPLE_HPP_
+
+#include "../core/Stage.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+class SampleTransformation : public TransformStage
+{
+public:
+	enum class Mode
+	{
+		NTH,												/*!< Every N-th message */
+		PROBABILITY,										/*!< Every message with the probability */
+		RESERVOIR											/*!< Fixed number of random messages per window */
+	};
+
+	/**
+	* Method allowing stage to configure itself using external configuration source.
+	* Demanded configuration:
+	* [section_name]
+	* type = "sample"
+	*
+	* Optional configuration:
+	* mode = "nth"							# nth, probability or reservoir, def: nth
+	* every = 10							# nth mode: pass every that many messages, def: 10
+	* probability = 0.01					# probability mode: probability of passing the message, def: 0.01
+	* size = 10								# reservoir mode: messages passed per window, def: 10
+	* window = 1000							# reservoir mode: length of the window [ms], def: 1000
+	* seed = 0								# seed of the random numbers, 0 - random, def: 0
+	* @param[in] config reference to the configuration manager facility
+	* @param[in] section place where stage configuration is stored
+	* @return True if configuration is valid, otherwise false.
+	*/
+	virtual bool configure(ConfigurationManager& config, const std::string& section) override;
+
+	/**
+	* Pass sampled messages to all other cooperatives.
+	*/
+	void run() override;
+
+	/**
+	* Sample the message.
+	* @param[in,out] data message, in reservoir mode it can be moved into the reservoir
+	* @param[in] src cooperative the message came from
+	* @return True if message should be passed on now.
+	*/
+	bool sample(std::vector<uint8_t>& data, unsigned int src);
+
+	/**
+	* End the reservoir window - pass on the sampled messages and empty the reservoirs.
+	* @param[in] on_sample callable void(std::vector<uint8_t>&& data, unsigned int src)
+	* @return Number of passed messages.
+	*/
+	template<typename Callback>
+	size_t drain(Callback&& on_sample) {
+		size_t passed = 0;
+
+		for (unsigned int src = 0; src < reservoirs_.size(); ++src)
+		{
+			auto& reservoir = reservoirs_[src];
+			const size_t count = std::min<uint64_t>(reservoir.seen, reservoir.slots.size());
+
+			order_.clear();
+			for (size_t i = 0; i < count; ++i)
+				order_.push_back(i);
+			std::sort(order_.begin(), order_.end(), [&reservoir](size_t a, size_t b) { return reservoir.slots[a].order < reservoir.slots[b].order; });
+
+			for (auto i : order_)
+			{
+				// Moved out buffer is replaced with an empty one, slot gets a new buffer when it is used.
+				on_sample(std::move(reservoir.slots[i].data), src);
+				++passed;
+			}
+			skipped_ += reservoir.seen - count;
+			reservoir.seen = 0;
+		}
+
+		return passed;
+	}
+
+	/**
+	* Get number of messages that were not passed on.
+	*/
+	uint64_t getSkipped() const {
+		return skipped_;
+	}
+
+protected:
+	/**
+	* Messages in the reservoirs are held until the window ends.
+	*/
+	size_t held_data() const override;
+
+private:
+	struct Slot
+	{
+		std::vector<uint8_t> data;
+		uint64_t order{ 0 };								/*!< Number of the message in the window */
+	};
+
+	struct Reservoir
+	{
+		std::vector<Slot> slots;
+		uint64_t seen{ 0 };									/*!< Messages in the current window */
+	};
+
+	/**
+	* Draw number of messages to skip before the next passed one.
+	*/
+	uint64_t draw_skip();
+
+	Mode mode_{ Mode::NTH };
+	uint64_t every_{ 10 };
+	double probability_{ 0.01 };
+	size_t size_{ 10 };
+	std::chrono::milliseconds window_{ 1000 };
+
+	std::mt19937_64 random_;
+	uint64_t counter_{ 0 };									/*!< Nth: messages since the last passed one, probability: messages left to skip */
+	std::vector<Reservoir> reservoirs_;						/*!< Indexed by cooperative slot */
+	std::vector<size_t> order_;
+
+	uint64_t skipped_{ 0 };
+};
+
+#endif /* SRC_TRANSFORM_SAMPLE_HPP_ */
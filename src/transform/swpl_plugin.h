@@ -0,0 +1,98 @@
+/**
+ *  @file   swpl_plugin.h
+ *  @brief  C interface of the api transform plugins.
+ *
+ *  @author Piotr "asmie" Olszewski
+ *
+ *  @date   2026.10.19
+ *
+ *  Plugin is a shared library exporting swpl_plugin_entry(). It gets batches of messages as views
+ *  of the pipeline buffers and passes data on with host->emit():
+ *  - view of the whole input message - the message buffer itself is passed on (no copy),
+ *  - buffer taken from host->alloc() - the buffer is passed on (no copy),
+ *  - any other memory (part of the input message, plugin own memory) - data is copied.
+ *
+ *  Views of the input messages and buffers from host->alloc() are valid only until process()
+ *  returns, buffers that were not emitted go back to the host. Every plugin instance is used by
+ *  a single thread. Interface is plain C, so plugins can be written in any language having C ABI.
+ */
+
+#ifndef SRC_TRANSFORM_SWPL_PLUGIN_H_
+#define SRC_TRANSFORM_SWPL_PLUGIN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of this interface. Host refuses plugins built for a different one. */
+#define SWPL_PLUGIN_ABI_VERSION		1
+
+/** Name of the symbol returning plugin description. */
+#define SWPL_PLUGIN_ENTRY			"swpl_plugin_entry"
+
+/** Log levels for host->log(). */
+#define SWPL_PLUGIN_LOG_ERROR		1
+#define SWPL_PLUGIN_LOG_WARNING		2
+#define SWPL_PLUGIN_LOG_INFO		3
+#define SWPL_PLUGIN_LOG_VERBOSE		4
+
+/**
+ * View of the message.
+ */
+typedef struct swpl_view
+{
+	const uint8_t* data;
+	size_t size;
+} swpl_view;
+
+/**
+ * Services of the host. Handle must be passed back as the first argument of every function.
+ */
+typedef struct swpl_host
+{
+	void* handle;
+
+	/** Get buffer for the output message. Returns NULL if it cannot be allocated. Only in process(). */
+	uint8_t* (*alloc)(void* handle, size_t size);
+
+	/** Pass message on to the next stages. Returns 0 on success. Only in process(). */
+	int (*emit)(void* handle, const uint8_t* data, size_t size);
+
+	/** Write message to the swpl log. */
+	void (*log)(void* handle, int level, const char* message);
+} swpl_host;
+
+/**
+ * Plugin description returned by swpl_plugin_entry(). Functions that are not needed can be NULL
+ * (except process).
+ */
+typedef struct swpl_plugin
+{
+	uint32_t abi_version;										/**< SWPL_PLUGIN_ABI_VERSION */
+
+	/** Create plugin instance. Returns its context (may be NULL if plugin has no state). */
+	void* (*init)(const swpl_host* host);
+
+	/** Set single option (every key of the stage section except type and library). Returns 0 if valid. */
+	int (*configure)(void* context, const char* key, const char* value);
+
+	/** Process batch of messages coming from one stage. Returns 0 on success. */
+	int (*process)(void* context, const swpl_view* messages, size_t count, const swpl_host* host);
+
+	/** Destroy plugin instance. */
+	void (*destroy)(void* context);
+} swpl_plugin;
+
+/**
+ * Type of the function plugin exports as SWPL_PLUGIN_ENTRY.
+ */
+typedef const swpl_plugin* (*swpl_plugin_entry_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_TRANSFORM_SWPL_PLUGIN_H_ */
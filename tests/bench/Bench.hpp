@@ -0,0 +1,127 @@
+/**
+ *  @file   Bench.hpp
+ *  @brief  Minimal microbenchmark harness.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ *  Benchmark groups are registered with SWPL_BENCH() and call BenchContext::measure() for every
+ *  variant (eg. number of producers or chunk size). Iteration count is calibrated so that single
+ *  run lasts at least the requested time, the best of few repetitions is reported. Results are
+ *  written as JSON, so they can be compared between releases.
+ */
+
+#ifndef TESTS_BENCH_BENCH_HPP_
+#define TESTS_BENCH_BENCH_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+* Result of the single benchmark variant.
+*/
+struct BenchResult
+{
+	std::string name;
+	std::vector<std::pair<std::string, std::string>> params;		/*!< Variant parameters */
+	uint64_t iterations{ 0 };
+	double seconds{ 0.0 };												/*!< Duration of the best repetition */
+	uint64_t items_per_iteration{ 1 };
+	uint64_t bytes_per_iteration{ 0 };
+	std::vector<std::pair<std::string, double>> extra;				/*!< Additional values (eg. latency quantiles) */
+};
+
+/**
+* Benchmark options set from the command line.
+*/
+struct BenchOptions
+{
+	std::string filter;													/*!< Only benchmarks containing this are run */
+	double min_time{ 0.2 };												/*!< Minimal duration of single repetition [s] */
+	unsigned int repetitions{ 3 };
+};
+
+class BenchContext
+{
+public:
+	using Params = std::vector<std::pair<std::string, std::string>>;
+
+	explicit BenchContext(const BenchOptions& options) : options_(options) {}
+
+	/**
+	* Measure the body. Body must execute given number of iterations of the measured operation.
+	* @param[in] name name of the benchmark
+	* @param[in] params variant parameters
+	* @param[in] body measured code
+	* @param[in] items operations done in every iteration
+	* @param[in] bytes bytes processed in every iteration
+	* @return Index of the result, caller can add extra values to it with result() (result is discarded if name
+	* is not selected).
+	*/
+	size_t measure(const std::string& name, const Params& params, const std::function<void(uint64_t)>& body,
+		uint64_t items = 1, uint64_t bytes = 0);
+
+	/**
+	* Check if benchmark with given name is selected by the filter.
+	*/
+	bool selected(const std::string& name) const {
+		return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+	}
+
+	/**
+	* Get result of the measurement. Reference is valid only until the next measure() call.
+	* @param[in] index index returned by measure()
+	*/
+	BenchResult& result(size_t index) {
+		return index < results_.size() ? results_[index] : skipped_ = BenchResult{};
+	}
+
+	const std::vector<BenchResult>& results() const {
+		return results_;
+	}
+
+private:
+	const BenchOptions& options_;
+	std::vector<BenchResult> results_;
+	BenchResult skipped_;												/*!< Sink for benchmarks not selected by the filter */
+
+	static constexpr size_t SKIPPED = static_cast<size_t>(-1);
+};
+
+/**
+* Make the value observable, so computation of it is not optimized away.
+*/
+template<typename T>
+inline void bench_keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &value;
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+using BenchFunction = void (*)(BenchContext&);
+
+/**
+* Adds benchmark group to the global list during static initialization.
+*/
+struct BenchRegistrar
+{
+	BenchRegistrar(const char* name, BenchFunction function);
+};
+
+#define SWPL_BENCH(function) \
+	static void function(BenchContext& bench); \
+	static BenchRegistrar registrar_##function(#function, function); \
+	static void function(BenchContext& bench)
+
+#endif /* TESTS_BENCH_BENCH_HPP_ */
@@ -0,0 +1,80 @@
+/**
+ *  @file   Call_bench.cpp
+ *  @brief  Benchmarks of calling external applications.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Call.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* Stage on both ends of the call stage - feeds it and counts the answers.
+*/
+class CallEnd : public Stage
+{
+public:
+	void run() override { }
+
+	size_t drain() {
+		size_t count = 0;
+		std::vector<uint8_t> data;
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		for (const auto& route : routes.table())
+		{
+			while (take(route, data))
+				count++;
+		}
+		return count;
+	}
+};
+
+SWPL_BENCH(call)
+{
+	auto& config = ConfigurationManager::instance();
+	constexpr size_t size = 4096;
+
+	// cat is the cheapest application possible, so this is the cost of the call itself.
+	for (size_t workers : { 1, 2, 4 })
+	{
+		std::string content = "[call]\ntype = call\ncommand = cat\nworkers = " + std::to_string(workers) + "\n";
+		config.parseFromMemory(content);
+
+		CallTransformation call;
+		CallEnd source, sink;
+		if (!call.configure(config, "call"))
+			return;
+
+		for (auto* end : { &source, &sink })
+		{
+			call.register_coop(end->getID(), end);
+			end->register_coop(call.getID(), &call);
+		}
+
+		call.set_work_flag(true);
+		std::thread worker(&CallTransformation::run, &call);
+
+		bench.measure("call_cat", { { "workers", std::to_string(workers) }, { "size", std::to_string(size) } }, [&](uint64_t iterations) {
+			uint64_t sent = 0, answered = 0;
+			while (answered < iterations)
+			{
+				// Keep a few calls waiting for every worker.
+				while (sent < iterations && sent - answered < workers * 4 && call.add_to_queue(std::vector<uint8_t>(size), source.getID()))
+					sent++;
+				answered += sink.drain();
+				std::this_thread::yield();
+			}
+		}, 1, size);
+
+		call.set_work_flag(false);
+		worker.join();
+	}
+}
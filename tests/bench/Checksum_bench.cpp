@@ -0,0 +1,49 @@
+/**
+ *  @file   Checksum_bench.cpp
+ *  @brief  Benchmarks of the checksums.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Crc.hpp"
+
+#include <string>
+#include <vector>
+
+SWPL_BENCH(checksum)
+{
+	const std::pair<const char*, Crc::Algorithm> algorithms[] = {
+		{ "crc32c", Crc::Algorithm::CRC32C }, { "crc32", Crc::Algorithm::CRC32 }, { "crc64", Crc::Algorithm::CRC64 }
+	};
+
+	for (size_t size : { 64, 1500, 65536 })
+	{
+		std::vector<uint8_t> data(size);
+		for (size_t i = 0; i < size; ++i)
+			data[i] = static_cast<uint8_t>(i * 131 + 7);
+
+		for (const auto& [name, algorithm] : algorithms)
+		{
+			Crc crc{ algorithm };
+			uint64_t sum = 0;
+
+			bench.measure("checksum", { { "algorithm", name }, { "engine", crc.accelerated() ? "cpu" : "table" }, { "size", std::to_string(size) } },
+				[&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i)
+					sum += crc.compute(data.data(), data.size());
+				bench_keep(sum);
+			}, 1, size);
+
+			bench.measure("checksum", { { "algorithm", name }, { "engine", "portable" }, { "size", std::to_string(size) } },
+				[&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i)
+					sum += crc.update_portable(0, data.data(), data.size());
+				bench_keep(sum);
+			}, 1, size);
+		}
+	}
+}
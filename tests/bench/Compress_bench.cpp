@@ -0,0 +1,91 @@
+/**
+ *  @file   Compress_bench.cpp
+ *  @brief  Benchmarks of the LZ codec compared with memcpy.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Lz.hpp"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static constexpr size_t BLOCK_SIZE = 65536;
+
+/**
+* Generate block of data: text - log-like lines, binary - mostly repeated records with counters,
+* random - incompressible.
+*/
+static std::vector<uint8_t> block(const std::string& kind)
+{
+	std::mt19937 random{ 1 };
+	std::vector<uint8_t> data;
+
+	while (data.size() < BLOCK_SIZE)
+	{
+		if (kind == "text")
+		{
+			std::string line = "2026-10-19 10:" + std::to_string(random() % 60) + " INFO stage " + std::to_string(random() % 16) +
+				": connection from 10.0.0." + std::to_string(random() % 256) + " accepted\n";
+			data.insert(data.end(), line.begin(), line.end());
+		}
+		else if (kind == "binary")
+		{
+			uint8_t record[32] = { 0xAA, 0x55, 0, 1 };
+			auto counter = static_cast<uint32_t>(data.size());
+			std::memcpy(record + 4, &counter, sizeof(counter));
+			record[8] = static_cast<uint8_t>(random() % 4);
+			data.insert(data.end(), record, record + sizeof(record));
+		}
+		else
+		{
+			data.push_back(static_cast<uint8_t>(random()));
+		}
+	}
+	data.resize(BLOCK_SIZE);
+
+	return data;
+}
+
+SWPL_BENCH(compress)
+{
+	for (const std::string kind : { "text", "binary", "random" })
+	{
+		auto data = block(kind);
+		std::vector<uint8_t> compressed(LzCodec::bound(data.size())), output(data.size());
+		LzCodec codec;
+		size_t size = codec.compress(data.data(), data.size(), compressed.data());
+		double ratio = static_cast<double>(data.size()) / static_cast<double>(size);
+
+		auto packed = bench.measure("lz_compress", { { "data", kind } }, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+				size = codec.compress(data.data(), data.size(), compressed.data());
+			bench_keep(size);
+		}, 1, BLOCK_SIZE);
+		bench.result(packed).extra.emplace_back("ratio", ratio);
+
+		auto unpacked = bench.measure("lz_decompress", { { "data", kind } }, [&](uint64_t iterations) {
+			bool valid = true;
+			for (uint64_t i = 0; i < iterations; ++i)
+				valid &= LzCodec::decompress(compressed.data(), size, output.data(), output.size());
+			bench_keep(valid);
+		}, 1, BLOCK_SIZE);
+		bench.result(unpacked).extra.emplace_back("ratio", ratio);
+	}
+
+	auto data = block("text");
+	std::vector<uint8_t> output(data.size());
+	bench.measure("lz_memcpy", {}, [&](uint64_t iterations) {
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			std::memcpy(output.data(), data.data(), data.size());
+			bench_keep(output.data());
+		}
+	}, 1, BLOCK_SIZE);
+}
@@ -0,0 +1,113 @@
+/**
+ *  @file   Config_bench.cpp
+ *  @brief  Benchmarks of configuration parsing.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "config/ConfigurationFileINI.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "io/FileIOconfiguration.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+* Generate INI configuration with given number of sections, every one with ten keys.
+*/
+static std::string generate_config(unsigned int sections)
+{
+	std::string config;
+
+	for (unsigned int s = 0; s < sections; ++s)
+	{
+		config += "# stage " + std::to_string(s) + "\n[bench_section" + std::to_string(s) + "]\n";
+		config += "type = file\nname = \"stage number " + std::to_string(s) + "\"\ndirection = bidirectional\n";
+		config += "binary = true\nread_chunk_min = 0\nread_chunk_max = 4096\nwrite_chunk_min = 0\n";
+		config += "write_chunk_max = 4096\nfile = /tmp/bench_file\ndrain_timeout = 1000\n\n";
+	}
+
+	return config;
+}
+
+SWPL_BENCH(config_parse)
+{
+	for (unsigned int sections : { 10, 100, 1000, 10000 })
+	{
+		const auto config = generate_config(sections);
+
+		bench.measure("config_parse", { { "sections", std::to_string(sections) } }, [&config](uint64_t iterations) {
+			auto& manager = ConfigurationManager::instance();
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				std::string copy(config);
+				manager.parseFromMemory(copy);
+			}
+		}, 1, config.size());
+	}
+}
+
+SWPL_BENCH(config_parse_ini)
+{
+	// Parser alone, without conversion of the values by the manager.
+	for (unsigned int sections : { 1000, 10000 })
+	{
+		const auto config = generate_config(sections);
+
+		bench.measure("config_parse_ini", { { "sections", std::to_string(sections) } }, [&config](uint64_t iterations) {
+			ConfigurationFileINI parser;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				ConfigurationFile::ConfigurationStructure settings;
+				parser.parseText(config, settings);
+			}
+		}, 1, config.size());
+	}
+}
+
+SWPL_BENCH(config_read_ini)
+{
+	// Tokenizer alone - values are only counted, nothing is stored.
+	for (unsigned int sections : { 1000, 10000 })
+	{
+		const auto config = generate_config(sections);
+
+		bench.measure("config_read_ini", { { "sections", std::to_string(sections) } }, [&config](uint64_t iterations) {
+			ConfigurationFileINI parser;
+			size_t values = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+				parser.readText(config, [&values](std::string_view, std::string_view, std::string_view) { ++values; });
+			bench_keep(values);
+		}, 1, config.size());
+	}
+}
+
+SWPL_BENCH(config_configure)
+{
+	// Startup of a large pipeline - every stage reads its settings from the parsed configuration.
+	for (unsigned int sections : { 1000, 10000 })
+	{
+		auto config = generate_config(sections);
+		auto& manager = ConfigurationManager::instance();
+		manager.parseFromMemory(config);
+
+		std::vector<std::string> names;
+		for (unsigned int s = 0; s < sections; ++s)
+			names.push_back("bench_section" + std::to_string(s));
+
+		bench.measure("config_configure", { { "sections", std::to_string(sections) } }, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				for (const auto& name : names)
+				{
+					FileIOconfiguration configuration;
+					configuration.configure(manager, name);
+				}
+			}
+		}, sections);
+	}
+}
@@ -0,0 +1,67 @@
+/**
+ *  @file   Dedup_bench.cpp
+ *  @brief  Benchmarks of the hash and the deduplication table.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Dedup.hpp"
+#include "transform/Hash.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+SWPL_BENCH(hash)
+{
+	for (size_t size : { 16, 64, 256, 1500, 65536 })
+	{
+		std::vector<uint8_t> data(size, 0x5a);
+		bench.measure("hash64", { { "size", std::to_string(size) } }, [&data](uint64_t iterations) {
+			uint64_t hash = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+				hash ^= Hash::compute(data.data(), data.size(), i);
+			bench_keep(hash);
+		}, 1, size);
+	}
+}
+
+SWPL_BENCH(dedup)
+{
+	// Table of 1 MiB (64k messages) in the cache and 64 MiB (4M messages) out of it, kept full.
+	for (const std::string memory : { "1048576", "67108864" })
+	{
+		std::string config = "[dedup]\ntype = dedup\nwindow = 60000\nmemory = " + memory + "\n";
+		auto& cm = ConfigurationManager::instance();
+		cm.parseFromMemory(config);
+
+		DedupTransformation dedup;
+		dedup.configure(cm, "dedup");
+		std::vector<uint8_t> message(256, 0x33);
+		uint64_t counter = 0;
+
+		for (size_t i = 0; i < dedup.getCapacity(); ++i, ++counter)
+		{
+			std::memcpy(message.data(), &counter, sizeof(counter));
+			dedup.duplicate(message, 0, 1);
+		}
+
+		// Every second message repeats the previous one.
+		auto result = bench.measure("dedup_lookup", { { "memory", memory } }, [&](uint64_t iterations) {
+			bool dropped = false;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				counter += i & 1;
+				std::memcpy(message.data(), &counter, sizeof(counter));
+				dropped ^= dedup.duplicate(message, 0, 1);
+			}
+			bench_keep(dropped);
+		}, 1, message.size());
+		bench.result(result).extra.emplace_back("evictions", static_cast<double>(dedup.getEvictions()));
+	}
+}
@@ -0,0 +1,63 @@
+/**
+ *  @file   Fields_bench.cpp
+ *  @brief  Benchmarks of the column projection.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Fields.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+* Record of 40 columns: numbers, short words and a few quoted fields with delimiters inside.
+*/
+static std::string record()
+{
+	std::string line;
+
+	for (int i = 1; i <= 40; ++i)
+	{
+		if (i % 10 == 0)
+			line += "\"quoted, with delimiter " + std::to_string(i) + "\"";
+		else if (i % 2 == 0)
+			line += "value" + std::to_string(i * 7919);
+		else
+			line += std::to_string(i * 104729);
+		line += i == 40 ? "\n" : ",";
+	}
+
+	return line;
+}
+
+SWPL_BENCH(fields)
+{
+	const auto text = record();
+	const std::vector<uint8_t> line(text.begin(), text.end());
+
+	// Columns at the front let the scan stop early, the last one needs the whole record.
+	for (const std::string columns : { "2,5", "38,3", "40" })
+	{
+		std::string config = "[fields]\ntype = fields\ncolumns = " + columns + "\n";
+		auto& cm = ConfigurationManager::instance();
+		cm.parseFromMemory(config);
+
+		FieldsTransformation fields;
+		fields.configure(cm, "fields");
+		std::vector<uint8_t> data;
+
+		bench.measure("fields_project", { { "columns", columns } }, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				data.assign(line.begin(), line.end());
+				bench_keep(fields.project(data));
+			}
+		}, 1, line.size());
+	}
+}
@@ -0,0 +1,49 @@
+/**
+ *  @file   Framer_bench.cpp
+ *  @brief  Benchmarks of splitting stream into records.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Framer.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <vector>
+
+static constexpr size_t CHUNK_SIZE = 65536;
+
+SWPL_BENCH(framer)
+{
+	auto& config = ConfigurationManager::instance();
+	std::string content = "[lines]\ntype = framer\n";
+	config.parseFromMemory(content);
+
+	for (size_t line : { 16, 80, 1024 })
+	{
+		FramerTransformation framer;
+		if (!framer.configure(config, "lines"))
+			return;
+
+		std::vector<uint8_t> chunk(CHUNK_SIZE, 'x');
+		for (size_t pos = line - 1; pos < CHUNK_SIZE; pos += line)
+			chunk[pos] = '\n';
+
+		std::vector<std::vector<uint8_t>> records;
+		size_t count = 0;
+
+		bench.measure("framer_lines", { { "line", std::to_string(line) } }, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				records.clear();
+				framer.frame(std::vector<uint8_t>(chunk), 1, records);
+				count += records.size();
+			}
+			bench_keep(count);
+		}, CHUNK_SIZE / line, CHUNK_SIZE);
+	}
+}
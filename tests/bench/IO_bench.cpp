@@ -0,0 +1,152 @@
+/**
+ *  @file   IO_bench.cpp
+ *  @brief  Benchmarks of IO throughput.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "io/DeviceIO.hpp"
+#include "io/FileIO.hpp"
+#include "io/RotatingFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define BENCH_FILE "swpl_bench_file"
+#define BENCH_ROTATE_DIR "swpl_bench_rotate"
+
+static constexpr size_t CHUNK_SIZES[] = { 64, 512, 4096, 65536 };
+
+/**
+* Configure the IO from the generated configuration section.
+*/
+static bool configure_io(IO& io, const std::string& section, const std::string& type, const std::string& path,
+	const std::string& direction)
+{
+	auto& config = ConfigurationManager::instance();
+	std::string content = "[" + section + "]\ntype = " + type + "\nname = " + section + "\nfile = " + path
+		+ "\ndirection = " + direction + "\n";
+
+	config.parseFromMemory(content);
+	return io.configure(config, section) && io.open() == 0;
+}
+
+/**
+* Read chunks from the IO, reopening it at the end of the stream.
+*/
+static void read_chunks(IO& io, std::vector<char>& buffer, uint64_t iterations)
+{
+	for (uint64_t i = 0; i < iterations; ++i)
+	{
+		if (io.read(buffer, buffer.size()) <= 0)
+		{
+			io.close();
+			io.open();
+		}
+	}
+}
+
+SWPL_BENCH(file_io)
+{
+	for (auto chunk : CHUNK_SIZES)
+	{
+		std::vector<char> buffer(chunk, 'x');
+		{
+			FileIO output;
+			if (!configure_io(output, "bench_file_out", "file", BENCH_FILE, "output"))
+				continue;
+
+			bench.measure("file_io_write", { { "chunk", std::to_string(chunk) } }, [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; ++i)
+					output.write(buffer, chunk);
+			}, 1, chunk);
+			output.close();
+		}
+
+		FileIO input;
+		if (!configure_io(input, "bench_file_in", "file", BENCH_FILE, "input"))
+			continue;
+
+		bench.measure("file_io_read", { { "chunk", std::to_string(chunk) } }, [&](uint64_t iterations) {
+			read_chunks(input, buffer, iterations);
+		}, 1, chunk);
+		input.close();
+	}
+
+	std::remove(BENCH_FILE);
+}
+
+SWPL_BENCH(rotating_file)
+{
+	static constexpr size_t CHUNK = 4096;
+	std::vector<char> buffer(CHUNK, 'x');
+
+	for (uint64_t size : { 1 << 20, 16 << 20 })
+	{
+		for (bool preallocate : { false, true })
+		{
+			std::filesystem::remove_all(BENCH_ROTATE_DIR);
+			std::filesystem::create_directory(BENCH_ROTATE_DIR);
+
+			RotatingFile::Settings settings;
+			settings.path = BENCH_ROTATE_DIR "/out";
+			settings.size = size;
+			settings.preallocate = preallocate;
+			RotatingFile output(settings);
+			if (!output.open())
+				continue;
+
+			// Rotation must not show up as a latency spike of the write crossing the segment end.
+			int64_t slowest = 0;
+			auto result = bench.measure("rotating_file_write", { { "segment", std::to_string(size) }, { "preallocate", preallocate ? "1" : "0" } },
+				[&](uint64_t iterations) {
+					for (uint64_t i = 0; i < iterations; ++i)
+					{
+						auto start = std::chrono::steady_clock::now();
+						output.write(buffer.data(), CHUNK);
+						slowest = std::max<int64_t>(slowest, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+					}
+				}, 1, CHUNK);
+			bench.result(result).extra.emplace_back("max_write_ns", static_cast<double>(slowest));
+			bench.result(result).extra.emplace_back("rotations", static_cast<double>(output.getRotations()));
+			bench.result(result).extra.emplace_back("stalls", static_cast<double>(output.getStalls()));
+			output.close();
+		}
+	}
+
+	std::filesystem::remove_all(BENCH_ROTATE_DIR);
+}
+
+SWPL_BENCH(device_io)
+{
+	DeviceIO zero, null;
+	if (!configure_io(zero, "bench_dev_zero", "device", "/dev/zero", "input")
+		|| !configure_io(null, "bench_dev_null", "device", "/dev/null", "output"))
+		return;
+
+	for (auto chunk : CHUNK_SIZES)
+	{
+		std::vector<char> buffer(chunk);
+
+		bench.measure("device_io_read", { { "chunk", std::to_string(chunk) } }, [&](uint64_t iterations) {
+			read_chunks(zero, buffer, iterations);
+		}, 1, chunk);
+
+		bench.measure("device_io_write", { { "chunk", std::to_string(chunk) } }, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+				null.write(buffer, chunk);
+		}, 1, chunk);
+	}
+
+	zero.close();
+	null.close();
+}
@@ -0,0 +1,117 @@
+/**
+ *  @file   Journal_bench.cpp
+ *  @brief  Benchmarks of the pipeline journal.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "core/Journal.hpp"
+#include "core/Pipeline.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BENCH_JOURNAL "swpl_bench_journal"
+#define BENCH_JOURNAL_IN "swpl_bench_journal_in"
+#define BENCH_JOURNAL_OUT "swpl_bench_journal_out"
+
+SWPL_BENCH(journal_commit)
+{
+	// Single caller, every batch of changes costs one fdatasync.
+	for (uint64_t batch : { 1, 16, 256 })
+	{
+		std::remove(BENCH_JOURNAL);
+		Journal journal{ BENCH_JOURNAL };
+		if (!journal.open())
+			return;
+
+		bench.measure("journal_commit", { { "batch", std::to_string(batch) } }, [&journal, batch](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				journal.set("stage" + std::to_string(i % batch) + ".read", i);
+				if ((i + 1) % batch == 0 || i + 1 == iterations)
+					journal.sync();
+			}
+		}, 1, 0);
+	}
+
+	// Every caller waits for its own change, concurrent callers share the batches.
+	for (unsigned int threads : { 1, 4, 16 })
+	{
+		std::remove(BENCH_JOURNAL);
+		Journal journal{ BENCH_JOURNAL };
+		if (!journal.open())
+			return;
+
+		auto result = bench.measure("journal_group_commit", { { "threads", std::to_string(threads) } }, [&journal, threads](uint64_t iterations) {
+			std::vector<std::thread> workers;
+			for (unsigned int t = 0; t < threads; ++t)
+			{
+				workers.emplace_back([&journal, t, count = (iterations + threads - 1) / threads]() {
+					const std::string key = "stage" + std::to_string(t) + ".read";
+					for (uint64_t i = 0; i < count; ++i)
+						journal.sync(journal.set(key, i));
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+		}, 1, 0);
+		bench.result(result).extra.emplace_back("commits", static_cast<double>(journal.getCommits()));
+	}
+
+	std::remove(BENCH_JOURNAL);
+}
+
+SWPL_BENCH(journal_pipeline)
+{
+	constexpr size_t FILE_SIZE = 8 << 20;
+	auto& config = ConfigurationManager::instance();
+
+	{
+		std::ofstream in(BENCH_JOURNAL_IN, std::ios::binary);
+		std::vector<char> block(65536, 'x');
+		for (size_t written = 0; written < FILE_SIZE; written += block.size())
+			in.write(block.data(), block.size());
+	}
+
+	// Copy of the file through the pipeline, with checkpoints taken while data is flowing.
+	for (bool journaled : { false, true })
+	{
+		std::string content = "[bench_jin]\ntype = file\nfile = " BENCH_JOURNAL_IN "\ndirection = input\nread_chunk_max = 65536\n"
+			"[bench_jmirror]\ntype = mirror\n"
+			"[bench_jout]\ntype = file\nfile = " BENCH_JOURNAL_OUT "\ndirection = output\n"
+			"[bench_jpipeline]\nstage1 = bench_jin\nstage2 = bench_jmirror\nstage3 = bench_jout\n";
+		if (journaled)
+			content += "journal = " BENCH_JOURNAL "\njournal_interval = 10\n";
+		config.parseFromMemory(content);
+
+		bench.measure("journal_pipeline_copy", { { "journal", journaled ? "on" : "off" } }, [&config](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				std::remove(BENCH_JOURNAL);
+				Pipeline pipeline;
+				if (!pipeline.configure(config, "bench_jpipeline"))
+					return;
+
+				auto output = dynamic_cast<IOStage*>(pipeline.getStage("bench_jout"));
+				pipeline.start();
+				while (output->getWritten() < FILE_SIZE)
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				pipeline.stop();
+			}
+		}, 1, FILE_SIZE);
+	}
+
+	std::remove(BENCH_JOURNAL);
+	std::remove(BENCH_JOURNAL_IN);
+	std::remove(BENCH_JOURNAL_OUT);
+}
@@ -0,0 +1,110 @@
+/**
+ *  @file   Match_bench.cpp
+ *  @brief  Benchmarks of the multi-pattern matcher.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/AhoCorasick.hpp"
+#include "transform/Regex.hpp"
+
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+static constexpr size_t TEXT_SIZE = 65536;
+
+/**
+* Log-like text: lower case words, digits and separators, patterns are capitalized words.
+*/
+static std::string make_text(size_t size)
+{
+	static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789 ,.:=";
+	std::mt19937 random(7);
+	std::string text(size, ' ');
+
+	for (auto& c : text)
+		c = alphabet[random() % (sizeof(alphabet) - 1)];
+	for (size_t pos = 0; pos + 16 < size; pos += 4096)
+		text.replace(pos, 8, "Pattern0");
+
+	return text;
+}
+
+SWPL_BENCH(aho_corasick)
+{
+	auto text = make_text(TEXT_SIZE);
+	const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+
+	for (size_t count : { 1, 4, 16, 64 })
+	{
+		// Capitalized patterns are rare in the text (only the first one is there), first letters vary from 4 patterns up.
+		AhoCorasick automaton;
+		for (size_t i = 0; i < count; ++i)
+			automaton.add(std::string(1, static_cast<char>('A' + ('P' - 'A' + i) % 26)) + "attern" + std::to_string(i));
+		automaton.compile();
+
+		bench.measure("aho_corasick_scan", { { "patterns", std::to_string(count) } }, [&](uint64_t iterations) {
+			size_t found = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				AhoCorasick::State state = AhoCorasick::START;
+				automaton.scan(data, text.size(), state, [&](size_t, size_t) { found++; return true; });
+			}
+			bench_keep(found);
+		}, 1, TEXT_SIZE);
+	}
+
+	// Worst case for the prefilter - every byte can start a pattern.
+	AhoCorasick dense;
+	for (char c = 'a'; c <= 'z'; ++c)
+		dense.add(std::string(1, c) + "qq");
+	dense.compile();
+
+	bench.measure("aho_corasick_scan_dense", { { "patterns", "26" } }, [&](uint64_t iterations) {
+		size_t found = 0;
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			AhoCorasick::State state = AhoCorasick::START;
+			dense.scan(data, text.size(), state, [&](size_t, size_t) { found++; return true; });
+		}
+		bench_keep(found);
+	}, 1, TEXT_SIZE);
+}
+
+SWPL_BENCH(regex)
+{
+	auto text = make_text(TEXT_SIZE);
+	const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+	const char* expression = "Pattern[0-9]+ [A-Z]{3}";
+
+	RegexSet regexes;
+	regexes.add(expression);
+	regexes.add("user=[a-z]+q[0-9]");
+	regexes.compile();
+
+	bench.measure("regex_lazy_dfa", { { "expressions", "2" } }, [&](uint64_t iterations) {
+		size_t found = 0;
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			RegexSet::Stream stream;
+			regexes.scan(data, text.size(), stream, [&](size_t) { found++; return true; });
+		}
+		bench_keep(found);
+	}, 1, TEXT_SIZE);
+
+	// Baseline - backtracking engine, one search per expression (neither matches, so whole text is searched).
+	std::regex first(expression), second("user=[a-z]+q[0-9]");
+
+	bench.measure("regex_std", { { "expressions", "2" } }, [&](uint64_t iterations) {
+		size_t found = 0;
+		for (uint64_t i = 0; i < iterations; ++i)
+			found += std::regex_search(text, first) + std::regex_search(text, second);
+		bench_keep(found);
+	}, 1, TEXT_SIZE);
+}
@@ -0,0 +1,49 @@
+/**
+ *  @file   Patch_bench.cpp
+ *  @brief  Benchmarks of the patch transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Patch.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <vector>
+
+static constexpr size_t MESSAGE_SIZE = 4096;
+
+SWPL_BENCH(patch)
+{
+	auto& config = ConfigurationManager::instance();
+	std::string content = "[patch]\ntype = patch\nfind1 = \"password=\"\nreplace1 = \"pw=\"\nfind2 = \"token:\"\nreplace2 = \"\"\n";
+	config.parseFromMemory(content);
+
+	PatchTransformation patch;
+	if (!patch.configure(config, "patch"))
+		return;
+
+	std::string clean(MESSAGE_SIZE, 'x'), dirty(MESSAGE_SIZE, 'x');
+	for (size_t pos = 0; pos + 16 < MESSAGE_SIZE; pos += 256)
+		dirty.replace(pos, 9, "password=");
+
+	// Message is refilled in place, so clean data shows the cost of the scan alone.
+	for (const auto& [name, text] : { std::make_pair("clean", &clean), std::make_pair("dirty", &dirty) })
+	{
+		std::vector<uint8_t> source(text->begin(), text->end()), data;
+
+		bench.measure("patch_message", { { "data", name } }, [&](uint64_t iterations) {
+			size_t replaced = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				data.assign(source.begin(), source.end());
+				replaced += patch.patch(data, 1);
+			}
+			bench_keep(replaced);
+		}, 1, MESSAGE_SIZE);
+	}
+}
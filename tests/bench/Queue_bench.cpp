@@ -0,0 +1,103 @@
+/**
+ *  @file   Queue_bench.cpp
+ *  @brief  Benchmarks of ConcurrentQueue.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "core/ConcurrentQueue.hpp"
+#include "core/SpillQueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+SWPL_BENCH(queue_push_pop)
+{
+	ConcurrentQueue<uint64_t> queue;
+
+	bench.measure("queue_push_pop_single_thread", {}, [&queue](uint64_t iterations) {
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			queue.push(i);
+			queue.pop();
+		}
+	});
+}
+
+SWPL_BENCH(queue_producers)
+{
+	unsigned int max_producers = std::max(4u, std::thread::hardware_concurrency());
+
+	for (unsigned int producers = 1; producers <= max_producers; producers *= 2)
+	{
+		// Every iteration is one message from every producer, all of them are consumed by a single consumer
+		// (the stage use case).
+		bench.measure("queue_mpsc", { { "producers", std::to_string(producers) } }, [producers](uint64_t iterations) {
+			ConcurrentQueue<uint64_t> queue;
+			std::vector<std::thread> threads;
+			std::atomic<bool> go{ false };
+
+			for (unsigned int p = 0; p < producers; ++p)
+			{
+				threads.emplace_back([&queue, &go, iterations]() {
+					while (!go.load(std::memory_order::acquire))
+						std::this_thread::yield();
+					for (uint64_t i = 0; i < iterations; ++i)
+						queue.push(i);
+				});
+			}
+
+			go.store(true, std::memory_order::release);
+
+			uint64_t consumed = 0;
+			while (consumed < iterations * producers)
+			{
+				if (queue.empty())
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				queue.pop();
+				++consumed;
+			}
+
+			for (auto& thread : threads)
+				thread.join();
+		}, producers);
+	}
+}
+
+SWPL_BENCH(queue_spill)
+{
+	const auto directory = std::filesystem::temp_directory_path().string();
+
+	for (size_t size : { 64, 1024, 16384 })
+	{
+		// Batch of messages written to the spill file and read back, as when the consumer stalls and
+		// catches up.
+		bench.measure("queue_spill_write_read", { { "size", std::to_string(size) } }, [&directory, size](uint64_t iterations) {
+			SpillQueue queue{ SpillSettings{ 0, directory, 64 << 20 }, "bench" };
+			std::vector<uint8_t> data(size, 0x42);
+			const uint64_t batch = std::max<uint64_t>(1, (16u << 20) / size);
+
+			for (uint64_t done = 0; done < iterations; done += batch)
+			{
+				auto count = std::min(batch, iterations - done);
+				for (uint64_t i = 0; i < count; ++i)
+				{
+					data.resize(size);
+					queue.push(data);
+				}
+				for (uint64_t i = 0; i < count; ++i)
+					queue.pop(data);
+			}
+		}, 1, size);
+	}
+}
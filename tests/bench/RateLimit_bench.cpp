@@ -0,0 +1,72 @@
+/**
+ *  @file   RateLimit_bench.cpp
+ *  @brief  Benchmarks of the timer wheel and rate limiting transform scheduling.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "core/TimerWheel.hpp"
+#include "transform/RateLimit.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+static constexpr size_t BATCH = 4096;
+
+SWPL_BENCH(timer_wheel)
+{
+	// Items spread over the given range of 1 us ticks, expired in steps of 100 ticks.
+	for (uint64_t range : { 1000ull, 100000ull, 100000000ull })
+	{
+		std::mt19937_64 random{ 1 };
+		std::vector<uint64_t> times(BATCH);
+
+		bench.measure("wheel_schedule_expire", { { "range_us", std::to_string(range) } }, [&](uint64_t iterations) {
+			size_t expired = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				TimerWheel<uint64_t> wheel{ 1000, 0 };
+				for (auto& time : times)
+					time = (random() % range) * 1000;
+				for (auto time : times)
+					wheel.schedule(time, uint64_t{ time });
+				for (uint64_t now = 0; !wheel.empty(); now = std::max(now + 100000, wheel.next_time()))
+					expired += wheel.expire(now, [](uint64_t&& item) { bench_keep(item); });
+			}
+			bench_keep(expired);
+		}, BATCH);
+	}
+}
+
+SWPL_BENCH(ratelimit)
+{
+	std::string config = "[limit]\ntype = ratelimit\nbytes_per_second = 1000000000\nmessages_per_second = 1000000\n";
+	auto& cm = ConfigurationManager::instance();
+	cm.parseFromMemory(config);
+
+	RateLimitTransformation limit;
+	limit.configure(cm, "limit");
+	std::vector<uint8_t> message(256);
+	uint64_t now = RateLimitTransformation::clock();
+
+	// Schedules a batch of messages and releases them in 1 ms steps, as the stage thread does.
+	bench.measure("ratelimit_schedule_release", { { "size", "256" } }, [&](uint64_t iterations) {
+		size_t released = 0;
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			uint64_t last = now;
+			for (size_t n = 0; n < BATCH; ++n)
+				last = limit.schedule(std::vector<uint8_t>(message), 0, now);
+			for (; now <= last; now += 1000000)
+				released += limit.release(now, [](std::vector<uint8_t>&& data, unsigned int) { bench_keep(data.data()); });
+			released += limit.release(now, [](std::vector<uint8_t>&& data, unsigned int) { bench_keep(data.data()); });
+		}
+		bench_keep(released);
+	}, BATCH, BATCH * 256);
+}
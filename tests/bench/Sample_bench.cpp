@@ -0,0 +1,66 @@
+/**
+ *  @file   Sample_bench.cpp
+ *  @brief  Benchmarks of the sampling and aggregation transforms.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "transform/Aggregate.hpp"
+#include "transform/Sample.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <vector>
+
+SWPL_BENCH(sample)
+{
+	for (const std::string mode : { "nth", "probability", "reservoir" })
+	{
+		std::string config = "[sample]\ntype = sample\nmode = " + mode + "\nevery = 100\nprobability = 0.01\nsize = 100\nseed = 1\n";
+		auto& cm = ConfigurationManager::instance();
+		cm.parseFromMemory(config);
+
+		SampleTransformation sample;
+		sample.configure(cm, "sample");
+		std::vector<uint8_t> data(256);
+
+		// Reservoir is drained every 100000 messages, as if that many came in a window.
+		bench.measure("sample_message", { { "mode", mode } }, [&](uint64_t iterations) {
+			size_t passed = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				if (data.size() != 256)
+					data.resize(256);
+				passed += sample.sample(data, 1) ? 1 : 0;
+				if (i % 100000 == 99999)
+					passed += sample.drain([](std::vector<uint8_t>&& sampled, unsigned int) { bench_keep(sampled.data()); });
+			}
+			bench_keep(passed);
+		}, 1, data.size());
+	}
+}
+
+SWPL_BENCH(aggregate)
+{
+	for (const std::string value : { "none", "column", "binary" })
+	{
+		std::string config = "[aggregate]\ntype = aggregate\nwindow = 60000\nslide = 1000\nvalue = " + value + "\ncolumn = 3\n";
+		auto& cm = ConfigurationManager::instance();
+		cm.parseFromMemory(config);
+
+		AggregateTransformation aggregate;
+		aggregate.configure(cm, "aggregate");
+		std::string text = "2026-10-19T10:00:00,sensor7,1234.5,ok\n";
+		std::vector<uint8_t> data(text.begin(), text.end());
+
+		bench.measure("aggregate_message", { { "value", value } }, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; ++i)
+				aggregate.add(data, 1);
+			bench_keep(aggregate.getInvalid());
+		}, 1, data.size());
+	}
+}
@@ -0,0 +1,91 @@
+/**
+ *  @file   Stage_bench.cpp
+ *  @brief  Benchmarks of passing data between stages.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "Bench.hpp"
+#include "core/Stage.hpp"
+
+#include <thread>
+#include <vector>
+
+/**
+* Stage that sends everything it gets back to the sender.
+*/
+class EchoStage : public Stage
+{
+public:
+	void run() override {
+		std::vector<uint8_t> data;
+
+		while (get_work_flag())
+		{
+			auto sequence = data_sequence();
+			bool idle = true;
+
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			for (const auto& route : routes.table())
+			{
+				while (take(route, data))
+				{
+					idle = false;
+					if (route.outgoing != nullptr)
+						send(std::move(data), *route.outgoing);
+				}
+			}
+
+			if (idle)
+				wait_for_data(sequence);
+		}
+	}
+
+	bool take_from(unsigned int id, std::vector<uint8_t>& data) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		auto route = routes.find(id);
+		return route != nullptr && take(*route, data);
+	}
+};
+
+SWPL_BENCH(stage_hop)
+{
+	for (size_t size : { 64, 4096 })
+	{
+		EchoStage first, second;
+		first.register_coop(second.getID(), &second);
+		second.register_coop(first.getID(), &first);
+
+		// Cost of the hop itself - enqueue and dequeue done by the same thread.
+		bench.measure("stage_add_take", { { "size", std::to_string(size) } }, [&](uint64_t iterations) {
+			std::vector<uint8_t> data(size);
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				first.add_to_queue(std::move(data), second.getID());
+				first.take_from(second.getID(), data);
+			}
+		}, 1, size);
+
+		// Latency between threads - message goes to the echo stage thread and back, iteration is one round trip.
+		second.set_work_flag(true);
+		std::thread echo(&EchoStage::run, &second);
+
+		auto round_trip = bench.measure("stage_round_trip", { { "size", std::to_string(size) } }, [&](uint64_t iterations) {
+			std::vector<uint8_t> data(size);
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				second.add_to_queue(std::move(data), first.getID());
+				while (!first.take_from(second.getID(), data))
+					std::this_thread::yield();
+			}
+		}, 1, size);
+		auto& result = bench.result(round_trip);
+		result.extra.emplace_back("hop_ns", result.seconds * 1e9 / static_cast<double>(result.iterations * 2));
+
+		second.set_work_flag(false);
+		echo.join();
+	}
+}
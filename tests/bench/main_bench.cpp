@@ -0,0 +1,215 @@
+/**
+ *  @file   main_bench.cpp
+ *  @brief  Benchmark runner.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ *  swpl_bench [--filter <text>] [--min-time <seconds>] [--repetitions <n>] [--output <file>]
+ *  JSON report goes to the output file (stdout by default), human readable summary to stderr.
+ */
+
+#include "Bench.hpp"
+#include "Global.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+std::vector<std::pair<const char*, BenchFunction>>& registry()
+{
+	static std::vector<std::pair<const char*, BenchFunction>> benchmarks;
+	return benchmarks;
+}
+
+std::string json_string(const std::string& value)
+{
+	std::string result = "\"";
+
+	for (auto c : value)
+	{
+		if (c == '"' || c == '\\')
+			result += '\\';
+		result += c;
+	}
+
+	return result + '"';
+}
+
+/**
+* JSON has no representation of infinity and NaN (eg. run too short to be measured).
+*/
+std::string json_number(double value)
+{
+	if (!std::isfinite(value))
+		return "null";
+
+	std::ostringstream out;
+	out.precision(6);
+	out << value;
+	return out.str();
+}
+
+std::string json_report(const std::vector<BenchResult>& results)
+{
+	std::ostringstream out;
+	char date[32];
+	auto now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+	out << "{\n"
+		<< "  \"version\": \"" << SWPL_VERSION_MAJOR << '.' << SWPL_VERSION_MINOR << '.' << SWPL_VERSION_REV << "\",\n"
+		<< "  \"date\": \"" << date << "\",\n"
+		<< "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(SWPL_ENABLE_METRICS)
+		<< "  \"metrics\": true,\n"
+#else
+		<< "  \"metrics\": false,\n"
+#endif
+		<< "  \"benchmarks\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const auto& result = results[i];
+		auto operations = static_cast<double>(result.iterations * result.items_per_iteration);
+
+		out << (i == 0 ? "\n" : ",\n") << "    {\n"
+			<< "      \"name\": " << json_string(result.name) << ",\n"
+			<< "      \"params\": {";
+		for (size_t p = 0; p < result.params.size(); ++p)
+			out << (p == 0 ? "" : ", ") << json_string(result.params[p].first) << ": " << json_string(result.params[p].second);
+		out << "},\n"
+			<< "      \"iterations\": " << result.iterations << ",\n"
+			<< "      \"seconds\": " << json_number(result.seconds) << ",\n"
+			<< "      \"ns_per_op\": " << json_number(result.seconds * 1e9 / operations) << ",\n"
+			<< "      \"ops_per_second\": " << json_number(operations / result.seconds);
+		if (result.bytes_per_iteration != 0)
+			out << ",\n      \"bytes_per_second\": " << json_number(static_cast<double>(result.iterations * result.bytes_per_iteration) / result.seconds);
+		for (const auto& [key, value] : result.extra)
+			out << ",\n      " << json_string(key) << ": " << json_number(value);
+		out << "\n    }";
+	}
+
+	out << "\n  ]\n}\n";
+	return out.str();
+}
+
+void print_usage()
+{
+	std::cerr << "swpl_bench [--filter <text>] [--min-time <seconds>] [--repetitions <n>] [--output <file>]" << std::endl;
+}
+
+}
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction function)
+{
+	registry().emplace_back(name, function);
+}
+
+size_t BenchContext::measure(const std::string& name, const Params& params, const std::function<void(uint64_t)>& body,
+	uint64_t items, uint64_t bytes)
+{
+	using clock = std::chrono::steady_clock;
+
+	if (!selected(name))
+		return SKIPPED;
+
+	auto run = [&body](uint64_t iterations) {
+		auto start = clock::now();
+		body(iterations);
+		return std::chrono::duration<double>(clock::now() - start).count();
+	};
+
+	// Grow iteration count until the run is long enough to be measured reliably, then scale it up to min_time.
+	uint64_t iterations = 1;
+	double elapsed = run(iterations);
+	while (elapsed < options_.min_time / 10 && iterations < (1ull << 40))
+	{
+		iterations *= 10;
+		elapsed = run(iterations);
+	}
+	if (elapsed < options_.min_time)
+		iterations = static_cast<uint64_t>(static_cast<double>(iterations) * options_.min_time / std::max(elapsed, 1e-9)) + 1;
+
+	double best = 0.0;
+	for (unsigned int i = 0; i < std::max(options_.repetitions, 1u); ++i)
+	{
+		elapsed = run(iterations);
+		if (i == 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	BenchResult result;
+	result.name = name;
+	result.params = params;
+	result.iterations = iterations;
+	result.seconds = best;
+	result.items_per_iteration = items;
+	result.bytes_per_iteration = bytes;
+
+	std::cerr << name;
+	for (const auto& [key, value] : params)
+		std::cerr << ' ' << key << '=' << value;
+	std::cerr << ": " << best * 1e9 / static_cast<double>(iterations * items) << " ns/op" << std::endl;
+
+	results_.push_back(std::move(result));
+	return results_.size() - 1;
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	const char* output = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool has_value = i + 1 < argc;
+
+		if (std::strcmp(argv[i], "--filter") == 0 && has_value)
+			options.filter = argv[++i];
+		else if (std::strcmp(argv[i], "--min-time") == 0 && has_value)
+			options.min_time = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--repetitions") == 0 && has_value)
+			options.repetitions = static_cast<unsigned int>(std::atoi(argv[++i]));
+		else if (std::strcmp(argv[i], "--output") == 0 && has_value)
+			output = argv[++i];
+		else
+		{
+			print_usage();
+			return std::strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	BenchContext context(options);
+	for (const auto& [name, function] : registry())
+		function(context);
+
+	auto report = json_report(context.results());
+	if (output == nullptr)
+	{
+		std::cout << report;
+	}
+	else
+	{
+		std::ofstream file(output);
+		file << report;
+		if (!file)
+		{
+			std::cerr << "Cannot write " << output << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
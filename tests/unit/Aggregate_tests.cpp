@@ -0,0 +1,177 @@
+/**
+ *  @file   Aggregate_tests.cpp
+ *  @brief  Unit tests for the aggregation transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Aggregate.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* aggregate_conf = R"conf(
+[aggregate_tumbling]
+type = aggregate
+window = 100
+value = column
+column = 2
+
+[aggregate_sliding]
+type = aggregate
+window = 300
+slide = 100
+value = binary
+offset = 1
+size = 2
+emit_empty = false
+
+[aggregate_bad_slide]
+type = aggregate
+window = 300
+slide = 200
+
+[aggregate_bad_value]
+type = aggregate
+value = text
+
+[aggregate_bad_size]
+type = aggregate
+value = binary
+size = 3
+)conf";
+
+typedef std::vector<std::pair<std::string, unsigned int>> Reports;
+
+/**
+* Close slides up to the time, strip the time from the reports.
+*/
+static Reports close(AggregateTransformation& aggregate, std::chrono::steady_clock::time_point now)
+{
+	Reports reports;
+
+	aggregate.close(now, [&reports](std::vector<uint8_t>&& report, unsigned int src) {
+		std::string line(report.begin(), report.end());
+		EXPECT_EQ(0, line.find("time="));
+		reports.emplace_back(line.substr(line.find(' ') + 1), src);
+	});
+
+	return reports;
+}
+
+TEST(Aggregate, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(aggregate_conf);
+	cm.parseFromMemory(config);
+
+	AggregateTransformation aggregate;
+	EXPECT_EQ(true, aggregate.configure(cm, "aggregate_tumbling"));
+	EXPECT_EQ(true, aggregate.configure(cm, "aggregate_sliding"));
+	EXPECT_EQ(false, aggregate.configure(cm, "aggregate_bad_slide"));
+	EXPECT_EQ(false, aggregate.configure(cm, "aggregate_bad_value"));
+	EXPECT_EQ(false, aggregate.configure(cm, "aggregate_bad_size"));
+}
+
+TEST(Aggregate, tumbling)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(aggregate_conf);
+	cm.parseFromMemory(config);
+
+	AggregateTransformation aggregate;
+	ASSERT_EQ(true, aggregate.configure(cm, "aggregate_tumbling"));
+	const auto end = aggregate.getSlideEnd();
+	const auto slide = std::chrono::milliseconds(100);
+
+	aggregate.add(bytes("a,12.5,x\n"), 1);
+	aggregate.add(bytes("b,-3\n"), 1);
+	aggregate.add(bytes("c\n"), 1);
+	aggregate.add(bytes("d,7,e\n"), 2);
+
+	EXPECT_EQ(Reports{}, close(aggregate, end - std::chrono::milliseconds(1)));
+	EXPECT_EQ((Reports{ { "count=3 bytes=16 min=-3 max=12.5\n", 1 }, { "count=1 bytes=6 min=7 max=7\n", 2 } }), close(aggregate, end));
+	EXPECT_EQ(1, aggregate.getInvalid());
+
+	// Empty windows are reported too, a long gap does not give a report for every missed window.
+	aggregate.add(bytes("x,1\n"), 2);
+	EXPECT_EQ((Reports{ { "count=0 bytes=0\n", 1 }, { "count=1 bytes=4 min=1 max=1\n", 2 } }), close(aggregate, end + slide));
+	EXPECT_EQ(4, close(aggregate, end + 1000 * slide).size());
+	EXPECT_EQ(end + 1001 * slide, aggregate.getSlideEnd());
+}
+
+TEST(Aggregate, sliding)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(aggregate_conf);
+	cm.parseFromMemory(config);
+
+	AggregateTransformation aggregate;
+	ASSERT_EQ(true, aggregate.configure(cm, "aggregate_sliding"));
+	const auto end = aggregate.getSlideEnd();
+	const auto slide = std::chrono::milliseconds(100);
+
+	// Big endian 16-bit value at offset 1.
+	aggregate.add({ 0, 0x01, 0x00 }, 1);
+	EXPECT_EQ((Reports{ { "count=1 bytes=3 min=256 max=256\n", 1 } }), close(aggregate, end));
+	aggregate.add({ 0, 0x00, 0x05, 0xff }, 1);
+	EXPECT_EQ((Reports{ { "count=2 bytes=7 min=5 max=256\n", 1 } }), close(aggregate, end + slide));
+	aggregate.add({ 0 }, 1);
+	EXPECT_EQ((Reports{ { "count=3 bytes=8 min=5 max=256\n", 1 } }), close(aggregate, end + 2 * slide));
+
+	// First slide leaves the window, then the others, empty windows are not reported.
+	EXPECT_EQ((Reports{ { "count=2 bytes=5 min=5 max=5\n", 1 } }), close(aggregate, end + 3 * slide));
+	EXPECT_EQ((Reports{ { "count=1 bytes=1\n", 1 } }), close(aggregate, end + 4 * slide));
+	EXPECT_EQ(Reports{}, close(aggregate, end + 5 * slide));
+	EXPECT_EQ(1, aggregate.getInvalid());
+}
+
+TEST(Aggregate, reports_on_time)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(aggregate_conf);
+	cm.parseFromMemory(config);
+
+	AggregateTransformation aggregate;
+	ASSERT_EQ(true, aggregate.configure(cm, "aggregate_tumbling"));
+
+	CollectStage source, sink;
+	for (auto* peer : { &source, &sink })
+	{
+		aggregate.register_coop(peer->getID(), peer);
+		peer->register_coop(aggregate.getID(), &aggregate);
+	}
+
+	aggregate.set_work_flag(true);
+	std::thread worker(&AggregateTransformation::run, &aggregate);
+	aggregate.add_to_queue(bytes("a,1\n"), source.getID());
+	aggregate.add_to_queue(bytes("b,2\n"), source.getID());
+
+	// Report comes when the window ends, even though no more data comes to wake the stage up.
+	std::vector<std::string> reports;
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (reports.size() < 2 && std::chrono::steady_clock::now() < deadline)
+	{
+		auto more = sink.collected();
+		reports.insert(reports.end(), more.begin(), more.end());
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	aggregate.set_work_flag(false);
+	worker.join();
+
+	ASSERT_LE(2, reports.size());
+	EXPECT_NE(std::string::npos, reports[0].find(" count=2 bytes=8 min=1 max=2\n"));
+	EXPECT_NE(std::string::npos, reports[1].find(" count=0 bytes=0\n"));
+	EXPECT_EQ(std::vector<std::string>{}, source.collected());
+
+	for (auto* peer : { &source, &sink })
+		aggregate.unregister_coop(peer->getID());
+}
@@ -0,0 +1,176 @@
+/**
+ *  @file   Api_tests.cpp
+ *  @brief  Unit tests for the plugin api transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Api.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const std::string api_conf = std::string(R"conf(
+[api_pass]
+type = api
+library = )conf") + SWPL_TEST_PLUGIN + R"conf(
+mode = pass
+
+[api_upper]
+type = api
+library = )conf" + SWPL_TEST_PLUGIN + R"conf(
+mode = upper
+batch = 2
+
+[api_split]
+type = api
+library = )conf" + SWPL_TEST_PLUGIN + R"conf(
+mode = split
+
+[api_drop]
+type = api
+library = )conf" + SWPL_TEST_PLUGIN + R"conf(
+mode = drop
+
+[api_pipeline_keys]
+type = api
+library = )conf" + SWPL_TEST_PLUGIN + R"conf(
+mode = pass
+spill_threshold = 4096
+spill_directory = "/tmp"
+spill_segment = 65536
+pass1 = api_pass
+default = api_upper
+
+[api_bad_option]
+type = api
+library = )conf" + SWPL_TEST_PLUGIN + R"conf(
+mode = shuffle
+
+[api_not_plugin]
+type = api
+library = libc.so.6
+
+[api_missing]
+type = api
+library = /nonexistent/plugin.so
+)conf";
+
+typedef std::vector<std::vector<uint8_t>> Messages;
+
+static Messages messages(const std::vector<std::string>& texts)
+{
+	Messages result;
+	for (const auto& text : texts)
+		result.emplace_back(text.begin(), text.end());
+	return result;
+}
+
+TEST(Api, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(api_conf);
+	cm.parseFromMemory(config);
+
+	ApiTransformation api;
+	EXPECT_EQ(true, api.configure(cm, "api_pass"));
+	EXPECT_EQ(true, api.configure(cm, "api_upper"));
+	EXPECT_EQ(true, api.configure(cm, "api_pipeline_keys"));
+	EXPECT_EQ(false, api.configure(cm, "api_bad_option"));
+	EXPECT_EQ(false, api.configure(cm, "api_not_plugin"));
+	EXPECT_EQ(false, api.configure(cm, "api_missing"));
+
+	Messages batch = messages({ "data" }), output;
+	EXPECT_EQ(-1, api.process(batch, output));
+}
+
+TEST(Api, zero_copy)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(api_conf);
+	cm.parseFromMemory(config);
+
+	ApiTransformation api;
+	ASSERT_EQ(true, api.configure(cm, "api_pass"));
+
+	// Messages passed on unchanged keep their buffers.
+	Messages batch = messages({ "first", "second" }), output;
+	const auto* first = batch[0].data();
+	const auto* second = batch[1].data();
+
+	EXPECT_EQ(0, api.process(batch, output));
+	ASSERT_EQ(messages({ "first", "second" }), output);
+	EXPECT_EQ(first, output[0].data());
+	EXPECT_EQ(second, output[1].data());
+
+	// Host buffers filled by the plugin are passed on too.
+	ASSERT_EQ(true, api.configure(cm, "api_upper"));
+	batch = messages({ "lower", "MiXeD" });
+	output.clear();
+	EXPECT_EQ(0, api.process(batch, output));
+	EXPECT_EQ(messages({ "LOWER", "MIXED" }), output);
+
+	// Parts of the message are copied.
+	ASSERT_EQ(true, api.configure(cm, "api_split"));
+	batch = messages({ "abcd" });
+	output.clear();
+	EXPECT_EQ(0, api.process(batch, output));
+	EXPECT_EQ(messages({ "ab", "cd" }), output);
+	EXPECT_EQ(messages({ "abcd" }), batch);
+}
+
+TEST(Api, run)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(api_conf);
+	cm.parseFromMemory(config);
+
+	/**
+	* Stage remembering everything it gets.
+	*/
+	class Peer : public Stage
+	{
+	public:
+		void run() override { }
+
+		std::vector<std::string> collected() {
+			std::vector<std::string> result;
+			std::vector<uint8_t> data;
+			RoutingTable<Route>::ReadGuard routes{ routes_ };
+			for (const auto& route : routes.table())
+			{
+				while (take(route, data))
+					result.emplace_back(data.begin(), data.end());
+			}
+			return result;
+		}
+	};
+
+	ApiTransformation api;
+	Peer source, sink;
+	ASSERT_EQ(true, api.configure(cm, "api_upper"));
+	for (auto* peer : { &source, &sink })
+	{
+		api.register_coop(peer->getID(), peer);
+		peer->register_coop(api.getID(), &api);
+	}
+
+	for (std::string text : { "one", "two", "three", "four", "five" })
+		api.add_to_queue(std::vector<uint8_t>(text.begin(), text.end()), source.getID());
+
+	api.set_work_flag(true);
+	std::thread worker(&ApiTransformation::run, &api);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	api.set_work_flag(false);
+	worker.join();
+
+	EXPECT_EQ((std::vector<std::string>{ "ONE", "TWO", "THREE", "FOUR", "FIVE" }), sink.collected());
+	EXPECT_EQ(std::vector<std::string>{}, source.collected());
+}
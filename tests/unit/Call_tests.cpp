@@ -0,0 +1,160 @@
+/**
+ *  @file   Call_tests.cpp
+ *  @brief  Unit tests for the external application call transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Call.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* call_conf = R"conf(
+[call_cat]
+type = call
+command = "cat"
+workers = 3
+
+[call_sleep]
+type = call
+command = "sleep"
+arg1 = "10"
+timeout = 50
+
+[call_exit]
+type = call
+command = "sh"
+arg1 = "-c"
+arg2 = "exit 1"
+
+[call_missing]
+type = call
+command = "/nonexistent/application"
+
+[call_no_command]
+type = call
+workers = 2
+
+[call_no_workers]
+type = call
+command = "cat"
+workers = 0
+)conf";
+
+/**
+* Run the call stage between two peers until all answers come or call stage restarts workers
+* given number of times (or time is out).
+*/
+static std::vector<std::string> call_all(CallTransformation& call, const std::vector<std::string>& messages, uint64_t restarts = 0)
+{
+	CollectStage source, sink;
+	std::vector<std::string> answers;
+
+	for (auto* peer : { &source, &sink })
+	{
+		call.register_coop(peer->getID(), peer);
+		peer->register_coop(call.getID(), &call);
+	}
+
+	call.set_work_flag(true);
+	std::thread worker(&CallTransformation::run, &call);
+
+	for (const auto& text : messages)
+		call.add_to_queue(std::vector<uint8_t>(text.begin(), text.end()), source.getID());
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		auto more = sink.collected();
+		answers.insert(answers.end(), more.begin(), more.end());
+		if (restarts > 0 ? call.getRestarts() >= restarts : answers.size() >= messages.size())
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	call.set_work_flag(false);
+	worker.join();
+
+	EXPECT_EQ(std::vector<std::string>{}, source.collected());
+	for (auto* peer : { &source, &sink })
+		call.unregister_coop(peer->getID());
+	return answers;
+}
+
+TEST(Call, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(call_conf);
+	cm.parseFromMemory(config);
+
+	CallTransformation call;
+	EXPECT_EQ(true, call.configure(cm, "call_cat"));
+	EXPECT_EQ(true, call.configure(cm, "call_sleep"));
+	EXPECT_EQ(false, call.configure(cm, "call_no_command"));
+	EXPECT_EQ(false, call.configure(cm, "call_no_workers"));
+}
+
+TEST(Call, pool)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(call_conf);
+	cm.parseFromMemory(config);
+
+	CallTransformation call;
+	ASSERT_EQ(true, call.configure(cm, "call_cat"));
+
+	// cat answers with the framed request itself.
+	std::vector<std::string> messages;
+	for (int i = 0; i < 100; ++i)
+		messages.push_back("message " + std::to_string(i));
+	messages.push_back(std::string(300000, 'x'));
+
+	auto answers = call_all(call, messages);
+	std::sort(answers.begin(), answers.end());
+	std::sort(messages.begin(), messages.end());
+	EXPECT_EQ(messages, answers);
+	EXPECT_EQ(0, call.getRestarts());
+}
+
+TEST(Call, timeout)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(call_conf);
+	cm.parseFromMemory(config);
+
+	CallTransformation call;
+	ASSERT_EQ(true, call.configure(cm, "call_sleep"));
+
+	auto answers = call_all(call, { "one", "two" }, 2);
+	EXPECT_EQ(std::vector<std::string>{}, answers);
+	EXPECT_EQ(2, call.getTimeouts());
+	EXPECT_EQ(2, call.getRestarts());
+}
+
+TEST(Call, crash)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(call_conf);
+	cm.parseFromMemory(config);
+
+	CallTransformation call;
+	ASSERT_EQ(true, call.configure(cm, "call_exit"));
+
+	auto answers = call_all(call, { "one" }, 1);
+	EXPECT_EQ(std::vector<std::string>{}, answers);
+	EXPECT_EQ(1, call.getRestarts());
+	EXPECT_EQ(0, call.getTimeouts());
+
+	ASSERT_EQ(true, call.configure(cm, "call_missing"));
+	EXPECT_EQ(std::vector<std::string>{}, call_all(call, {}));
+}
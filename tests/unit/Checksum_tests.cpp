@@ -0,0 +1,161 @@
+/**
+ *  @file   Checksum_tests.cpp
+ *  @brief  Unit tests for the checksums and the checksum transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Checksum.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr const char* checksum_conf = R"conf(
+[checksum_append]
+type = checksum
+
+[checksum_strip]
+type = checksum
+mode = strip
+
+[checksum_verify64]
+type = checksum
+algorithm = crc64
+mode = verify
+big_endian = false
+drop_invalid = false
+
+[checksum_append64]
+type = checksum
+algorithm = crc64
+big_endian = false
+
+[checksum_bad_algorithm]
+type = checksum
+algorithm = md5
+
+[checksum_bad_mode]
+type = checksum
+mode = check
+)conf";
+
+TEST(Crc, check_values)
+{
+	const std::string check{ "123456789" };
+
+	EXPECT_EQ(0xE3069283u, Crc(Crc::Algorithm::CRC32C).compute(check.data(), check.size()));
+	EXPECT_EQ(0xCBF43926u, Crc(Crc::Algorithm::CRC32).compute(check.data(), check.size()));
+	EXPECT_EQ(0x995DC9BBDF1939FAull, Crc(Crc::Algorithm::CRC64).compute(check.data(), check.size()));
+	EXPECT_EQ(0u, Crc(Crc::Algorithm::CRC32).compute(check.data(), 0));
+
+	EXPECT_EQ(4, Crc(Crc::Algorithm::CRC32C).size());
+	EXPECT_EQ(8, Crc(Crc::Algorithm::CRC64).size());
+
+	Crc::Algorithm algorithm;
+	EXPECT_EQ(true, Crc::parse("crc32", algorithm));
+	EXPECT_EQ(Crc::Algorithm::CRC32, algorithm);
+	EXPECT_EQ(false, Crc::parse("adler32", algorithm));
+}
+
+TEST(Crc, accelerated_matches_portable)
+{
+	std::mt19937 random{ 7 };
+	std::vector<uint8_t> data(5000);
+	for (auto& byte : data)
+		byte = static_cast<uint8_t>(random());
+
+	for (auto algorithm : { Crc::Algorithm::CRC32C, Crc::Algorithm::CRC32, Crc::Algorithm::CRC64 })
+	{
+		Crc crc{ algorithm };
+
+		// Every length around the folding block sizes, at every alignment.
+		for (size_t size = 0; size < 600; ++size)
+		{
+			size_t offset = size % 16;
+			EXPECT_EQ(crc.update_portable(0, data.data() + offset, size), crc.update(0, data.data() + offset, size)) << size;
+		}
+		EXPECT_EQ(crc.update_portable(0, data.data(), data.size()), crc.compute(data.data(), data.size()));
+
+		// Checksum computed in chunks is the same as of the whole data.
+		uint64_t chunked = 0;
+		for (size_t pos = 0; pos < data.size(); pos += 777)
+			chunked = crc.update(chunked, data.data() + pos, std::min<size_t>(777, data.size() - pos));
+		EXPECT_EQ(crc.compute(data.data(), data.size()), chunked);
+	}
+}
+
+TEST(Checksum, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(checksum_conf);
+	cm.parseFromMemory(config);
+
+	ChecksumTransformation checksum;
+	EXPECT_EQ(true, checksum.configure(cm, "checksum_append"));
+	EXPECT_EQ(true, checksum.configure(cm, "checksum_strip"));
+	EXPECT_EQ(true, checksum.configure(cm, "checksum_verify64"));
+	EXPECT_EQ(false, checksum.configure(cm, "checksum_bad_algorithm"));
+	EXPECT_EQ(false, checksum.configure(cm, "checksum_bad_mode"));
+}
+
+TEST(Checksum, append_and_strip)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(checksum_conf);
+	cm.parseFromMemory(config);
+
+	ChecksumTransformation append, strip;
+	ASSERT_EQ(true, append.configure(cm, "checksum_append"));
+	ASSERT_EQ(true, strip.configure(cm, "checksum_strip"));
+
+	auto data = bytes("123456789");
+	EXPECT_EQ(true, append.process(data));
+	EXPECT_EQ((std::vector<uint8_t>{ '1', '2', '3', '4', '5', '6', '7', '8', '9', 0xE3, 0x06, 0x92, 0x83 }), data);
+
+	EXPECT_EQ(true, strip.process(data));
+	EXPECT_EQ(bytes("123456789"), data);
+	EXPECT_EQ(1, strip.getVerified());
+	EXPECT_EQ(0, strip.getMismatches());
+
+	// Corrupted and too short messages are dropped.
+	EXPECT_EQ(true, append.process(data));
+	data[3] ^= 0x10;
+	EXPECT_EQ(false, strip.process(data));
+	auto shorter = bytes("abc");
+	EXPECT_EQ(false, strip.process(shorter));
+	EXPECT_EQ(3, strip.getVerified());
+	EXPECT_EQ(2, strip.getMismatches());
+}
+
+TEST(Checksum, verify_passes_invalid)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(checksum_conf);
+	cm.parseFromMemory(config);
+
+	ChecksumTransformation append, verify;
+	ASSERT_EQ(true, append.configure(cm, "checksum_append64"));
+	ASSERT_EQ(true, verify.configure(cm, "checksum_verify64"));
+
+	auto data = bytes("123456789");
+	EXPECT_EQ(true, append.process(data));
+	ASSERT_EQ(17, data.size());
+	EXPECT_EQ(0xFA, data[9]);									// Little endian trailer.
+	EXPECT_EQ(0x99, data[16]);
+
+	auto sent = data;
+	EXPECT_EQ(true, verify.process(data));
+	EXPECT_EQ(sent, data);
+	EXPECT_EQ(0, verify.getMismatches());
+
+	data[0] = 'X';
+	EXPECT_EQ(true, verify.process(data));
+	EXPECT_EQ(1, verify.getMismatches());
+}
@@ -0,0 +1,227 @@
+/**
+ *  @file   Compress_tests.cpp
+ *  @brief  Unit tests for the LZ codec and the compress/decompress transforms.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Compress.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr const char* compress_conf = R"conf(
+[compress_blocks]
+type = compress
+block_size = 1000
+
+[compress_messages]
+type = compress
+block_size = 0
+
+[decompress_small]
+type = decompress
+max_frame = 100000
+
+[decompress_bad]
+type = decompress
+max_frame = 0
+)conf";
+
+typedef std::vector<std::vector<uint8_t>> Blocks;
+
+/**
+* Data with some repetitions, like logs.
+*/
+static std::vector<uint8_t> log_lines(size_t size, unsigned int seed)
+{
+	static const char* words[] = { "INFO ", "WARNING ", "connection ", "from ", "10.0.0.", "closed ", "user=", "\n" };
+	std::mt19937 random{ seed };
+	std::vector<uint8_t> data;
+
+	while (data.size() < size)
+	{
+		std::string word = words[random() % 8];
+		if (random() % 4 == 0)
+			word += std::to_string(random() % 1000);
+		data.insert(data.end(), word.begin(), word.end());
+	}
+	data.resize(size);
+
+	return data;
+}
+
+static std::vector<uint8_t> join(const Blocks& blocks)
+{
+	std::vector<uint8_t> result;
+	for (const auto& block : blocks)
+		result.insert(result.end(), block.begin(), block.end());
+	return result;
+}
+
+TEST(LzCodec, round_trip)
+{
+	std::mt19937 random{ 5 };
+	LzCodec codec;
+
+	for (size_t size : { 0, 1, 12, 13, 100, 4096, 70000, 300000 })
+	{
+		std::vector<std::vector<uint8_t>> inputs{ log_lines(size, 1), std::vector<uint8_t>(size, 'a'), std::vector<uint8_t>(size) };
+		for (auto& byte : inputs.back())
+			byte = static_cast<uint8_t>(random());
+
+		for (const auto& input : inputs)
+		{
+			std::vector<uint8_t> compressed(LzCodec::bound(size)), output(size);
+			auto length = codec.compress(input.data(), size, compressed.data());
+			ASSERT_LE(length, LzCodec::bound(size));
+			ASSERT_EQ(true, LzCodec::decompress(compressed.data(), length, output.data(), size)) << size;
+			EXPECT_EQ(input, output);
+
+			// Original size is checked too.
+			if (size > 0) {
+				EXPECT_EQ(false, LzCodec::decompress(compressed.data(), length, output.data(), size - 1));
+			}
+		}
+	}
+
+	auto text = log_lines(65536, 2);
+	std::vector<uint8_t> compressed(LzCodec::bound(text.size()));
+	EXPECT_LT(codec.compress(text.data(), text.size(), compressed.data()), text.size() / 2);
+}
+
+TEST(LzCodec, broken_input)
+{
+	std::mt19937 random{ 9 };
+	LzCodec codec;
+	auto text = log_lines(5000, 3);
+	std::vector<uint8_t> compressed(LzCodec::bound(text.size())), output(text.size());
+	auto length = codec.compress(text.data(), text.size(), compressed.data());
+
+	// Never reads or writes out of the buffers (checked with sanitizers), mostly detects damage.
+	for (int i = 0; i < 2000; ++i)
+	{
+		auto broken = compressed;
+		broken[random() % length] ^= static_cast<uint8_t>(1 << (random() % 8));
+		LzCodec::decompress(broken.data(), random() % 2 ? length : random() % length, output.data(), output.size());
+	}
+
+	EXPECT_EQ(false, LzCodec::decompress(compressed.data(), 0, output.data(), output.size()));
+	EXPECT_EQ(false, LzCodec::decompress(compressed.data(), length / 2, output.data(), output.size()));
+}
+
+TEST(Compress, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(compress_conf);
+	cm.parseFromMemory(config);
+
+	CompressTransformation compress;
+	DecompressTransformation decompress;
+	EXPECT_EQ(true, compress.configure(cm, "compress_blocks"));
+	EXPECT_EQ(true, compress.configure(cm, "compress_messages"));
+	EXPECT_EQ(true, decompress.configure(cm, "decompress_small"));
+	EXPECT_EQ(false, decompress.configure(cm, "decompress_bad"));
+}
+
+TEST(Compress, blocks_round_trip)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(compress_conf);
+	cm.parseFromMemory(config);
+
+	CompressTransformation compress;
+	DecompressTransformation decompress;
+	ASSERT_EQ(true, compress.configure(cm, "compress_blocks"));
+	ASSERT_EQ(true, decompress.configure(cm, "decompress_small"));
+
+	// Messages are joined into blocks, incomplete block is compressed on flush.
+	auto text = log_lines(3500, 4);
+	Blocks frames;
+	for (size_t pos = 0; pos < text.size(); pos += 250)
+		compress.compress(std::vector<uint8_t>(text.begin() + pos, text.begin() + pos + 250), 1, frames);
+	EXPECT_EQ(3, frames.size());
+
+	std::vector<uint8_t> last;
+	ASSERT_EQ(true, compress.flush(last, 1));
+	EXPECT_EQ(false, compress.flush(last, 1));
+	frames.push_back(last);
+	EXPECT_EQ(3500, compress.getBytesIn());
+	EXPECT_LT(compress.getBytesOut(), 3500);
+
+	// Stream read in pieces of any size.
+	auto stream = join(frames);
+	for (size_t piece : { 1, 7, 100, 5000 })
+	{
+		Blocks blocks;
+		for (size_t pos = 0; pos < stream.size(); pos += piece)
+			decompress.decompress(std::vector<uint8_t>(stream.begin() + pos, stream.begin() + std::min(pos + piece, stream.size())), 2, blocks);
+		EXPECT_EQ(text, join(blocks)) << piece;
+	}
+	EXPECT_EQ(0, decompress.getBroken());
+	EXPECT_EQ(0, decompress.getDropped());
+}
+
+TEST(Compress, messages_and_stored)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(compress_conf);
+	cm.parseFromMemory(config);
+
+	CompressTransformation compress;
+	DecompressTransformation decompress;
+	ASSERT_EQ(true, compress.configure(cm, "compress_messages"));
+	ASSERT_EQ(true, decompress.configure(cm, "decompress_small"));
+
+	// Every message is a frame, data that does not compress is stored.
+	Blocks frames, blocks;
+	compress.compress({ 'a', 'b', 'c' }, 1, frames);
+	compress.compress(std::vector<uint8_t>(500, 'z'), 1, frames);
+	ASSERT_EQ(2, frames.size());
+	EXPECT_EQ(16 + 3, frames[0].size());
+	EXPECT_EQ(0, frames[0][3]);
+	EXPECT_EQ(1, frames[1][3]);
+	EXPECT_LT(frames[1].size(), 50);
+
+	decompress.decompress(join(frames), 1, blocks);
+	ASSERT_EQ(2, blocks.size());
+	EXPECT_EQ((std::vector<uint8_t>{ 'a', 'b', 'c' }), blocks[0]);
+	EXPECT_EQ(std::vector<uint8_t>(500, 'z'), blocks[1]);
+}
+
+TEST(Compress, broken_frames)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(compress_conf);
+	cm.parseFromMemory(config);
+
+	CompressTransformation compress;
+	DecompressTransformation decompress;
+	ASSERT_EQ(true, compress.configure(cm, "compress_messages"));
+	ASSERT_EQ(true, decompress.configure(cm, "decompress_small"));
+
+	Blocks frames, blocks;
+	compress.compress(log_lines(2000, 5), 1, frames);
+	compress.compress(log_lines(2000, 6), 1, frames);
+	ASSERT_EQ(2, frames.size());
+
+	// Damaged data is caught by the checksum, next frame is still decoded.
+	frames[0][frames[0].size() / 2] ^= 0x40;
+	decompress.decompress(join(frames), 1, blocks);
+	ASSERT_EQ(1, blocks.size());
+	EXPECT_EQ(log_lines(2000, 6), blocks[0]);
+	EXPECT_EQ(1, decompress.getBroken());
+
+	// Damaged header makes the rest of the piece unreadable.
+	blocks.clear();
+	frames[1][0] = 'X';
+	decompress.decompress(std::vector<uint8_t>(frames[1]), 2, blocks);
+	EXPECT_EQ(0, blocks.size());
+	EXPECT_EQ(frames[1].size(), decompress.getDropped());
+}
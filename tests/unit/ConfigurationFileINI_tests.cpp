@@ -13,6 +13,8 @@
 #include "gtest/gtest.h"
 #include "config/ConfigurationFileINI.hpp"
 
+#include <cstdio>
+#include <fstream>
 #include <string>
 #include <sstream>
 
@@ -48,4 +50,68 @@ key1000 = 2.1
 	EXPECT_EQ("abcd", cs["test2"]["key4"]);
 	EXPECT_EQ("abde asdf zxcv", cs["test2"]["key5"]);
 
-}
\ No newline at end of file
+}
+
+TEST(ConfigurationFileINI, Errors)
+{
+	constexpr const char* conf = "[first]\r\n"
+		"  key = value with  spaces  \r\n"
+		"# comment = not a key\n"
+		"broken line\n"
+		"[second\n"
+		"two words = 1\n"
+		"empty =\n"
+		"[]\n"
+		"=5\n"
+		"key=last";
+
+	ConfigurationFileINI cf;
+	ConfigurationFile::ConfigurationStructure cs;
+
+	cf.parseText(conf, cs);
+
+	// Lines with errors are skipped, the rest is read.
+	ASSERT_EQ(1, cs.size());
+	EXPECT_EQ(1, cs["first"].size());
+	EXPECT_EQ("last", cs["first"]["key"]);
+
+	const auto& errors = cf.getErrors();
+	ASSERT_EQ(6, errors.size());
+	unsigned int lines[] = { 4, 5, 6, 7, 8, 9 };
+	for (size_t i = 0; i < errors.size(); ++i)
+		EXPECT_EQ(lines[i], errors[i].line) << errors[i].message;
+}
+
+TEST(ConfigurationFileINI, ParseFile)
+{
+	const char* path = "ini_test_file.ini";
+	{
+		std::ofstream file(path);
+		file << "[file]\nkey1 = 1\n\n[other]\n; comment\nkey2 = \"quoted value\"\n";
+	}
+
+	ConfigurationFileINI cf;
+	ConfigurationFile::ConfigurationStructure cs;
+
+	cf.parse(std::string(path), cs);
+	EXPECT_EQ(0, cf.getErrors().size());
+	EXPECT_EQ("1", cs["file"]["key1"]);
+	EXPECT_EQ("\"quoted value\"", cs["other"]["key2"]);
+	std::remove(path);
+
+	// Missing file is reported and leaves settings untouched.
+	cf.parse(std::string(path), cs);
+	ASSERT_EQ(1, cf.getErrors().size());
+	EXPECT_EQ(0, cf.getErrors()[0].line);
+	EXPECT_EQ(2, cs.size());
+
+	// Empty file.
+	{
+		std::ofstream file(path);
+	}
+	ConfigurationFile::ConfigurationStructure empty;
+	cf.parse(std::string(path), empty);
+	EXPECT_EQ(0, cf.getErrors().size());
+	EXPECT_EQ(0, empty.size());
+	std::remove(path);
+}
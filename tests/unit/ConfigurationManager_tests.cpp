@@ -13,7 +13,10 @@
 #include "gtest/gtest.h"
 #include "config/ConfigurationManager.hpp"
 
+#include <cstdio>
+#include <fstream>
 #include <string>
+#include <unordered_map>
 
 constexpr const char* conf = R"conf(
 [test1]
@@ -187,7 +190,12 @@ TEST(ConfigurationManagerHelpers, convertToDoubleTestCorrect)
 
 TEST(ConfigurationManagerHelpers, convertToDoubleTestIncorrect)
 {
-	std::string t1(""), t2("test"), t3("   328uu7730   ");
+	std::string t1(""), t2("test"), t3("   328uu7730   "), t4("inf"), t5("nan"), t6("0x10"), t7("1e");
+
+	EXPECT_THROW(convertToDouble(t4), std::runtime_error);
+	EXPECT_THROW(convertToDouble(t5), std::runtime_error);
+	EXPECT_THROW(convertToDouble(t6), std::runtime_error);
+	EXPECT_THROW(convertToDouble(t7), std::runtime_error);
 
 	EXPECT_THROW({
 		auto w1 = convertToDouble(t1);
@@ -230,7 +238,11 @@ TEST(ConfigurationManagerHelpers, convertToLongLongTestCorrect)
 
 TEST(ConfigurationManagerHelpers, convertToLongLongTestIncorrect)
 {
-	std::string t1(""), t2("test"), t3("   328uu7730   ");
+	std::string t1(""), t2("test"), t3("   328uu7730   "), t4("+-5"), t5("1.5"), t6("99999999999999999999");
+
+	EXPECT_THROW(convertToLongLong(t4), std::runtime_error);
+	EXPECT_THROW(convertToLongLong(t5), std::runtime_error);
+	EXPECT_THROW(convertToLongLong(t6), std::runtime_error);
 
 	EXPECT_THROW({
 		auto w1 = convertToLongLong(t1);
@@ -243,4 +255,165 @@ TEST(ConfigurationManagerHelpers, convertToLongLongTestIncorrect)
 	EXPECT_THROW({
 		auto w3 = convertToLongLong(t3);
 		}, std::runtime_error);
-}
\ No newline at end of file
+}
+
+constexpr const char* typed_conf = R"conf(
+[typed]
+count = 42
+ratio = 0.5
+flag = TRUE
+text = 12 monkeys
+negative = -7
+huge = 3000000000
+)conf";
+
+enum class TypedLabel
+{
+	COUNT,
+	RATIO,
+	FLAG,
+	TEXT,
+	MISSING
+};
+
+// Values are converted once at load, get() only picks the converted value.
+TEST(ConfigurationManager, TypedValues)
+{
+	std::string config(typed_conf);
+	auto& configurationManager = ConfigurationManager::instance();
+
+	configurationManager.parseFromMemory(config);
+
+	int iTestVal = 0;
+	size_t sizeVal = 0;
+	double dTestVal = 0.0;
+	bool bTestVal = false;
+
+	EXPECT_EQ(true, configurationManager.get<int>("typed", "count", iTestVal));
+	EXPECT_EQ(42, iTestVal);
+	EXPECT_EQ(true, configurationManager.get<double>("typed", "count", dTestVal));
+	EXPECT_EQ(42.0, dTestVal);
+	EXPECT_EQ(true, configurationManager.get<size_t>("typed", "count", sizeVal));
+	EXPECT_EQ(42, sizeVal);
+	EXPECT_EQ(true, configurationManager.get<int>("typed", "negative", iTestVal));
+	EXPECT_EQ(-7, iTestVal);
+
+	// Value that is not a number does not change the output.
+	EXPECT_EQ(false, configurationManager.get<int>("typed", "ratio", iTestVal));
+	EXPECT_EQ(false, configurationManager.get<int>("typed", "text", iTestVal));
+	EXPECT_EQ(-7, iTestVal);
+	EXPECT_EQ(true, configurationManager.get<double>("typed", "ratio", dTestVal));
+	EXPECT_EQ(0.5, dTestVal);
+
+	EXPECT_EQ(true, configurationManager.get<bool>("typed", "flag", bTestVal));
+	EXPECT_EQ(true, bTestVal);
+
+	// Integers that do not fit the type are rejected instead of truncated or wrapped.
+	sizeVal = 5;
+	EXPECT_EQ(false, configurationManager.get<size_t>("typed", "negative", sizeVal));
+	EXPECT_EQ(5, sizeVal);
+	EXPECT_EQ(false, configurationManager.get<int>("typed", "huge", iTestVal));
+	EXPECT_EQ(-7, iTestVal);
+	EXPECT_EQ(true, configurationManager.get<size_t>("typed", "huge", sizeVal));
+	EXPECT_EQ(3000000000u, sizeVal);
+
+	// Reading does not create sections or keys.
+	EXPECT_EQ(false, configurationManager.get<int>("typed_missing", "count", iTestVal));
+	EXPECT_EQ(false, configurationManager.settingExists("typed_missing", "count"));
+}
+
+TEST(ConfigurationManager, Validate)
+{
+	std::string config(typed_conf);
+	auto& configurationManager = ConfigurationManager::instance();
+
+	configurationManager.parseFromMemory(config);
+
+	const std::unordered_map<TypedLabel, Setting> valid(
+	{
+		{TypedLabel::COUNT, {"count", SettingType::INTEGER}},
+		{TypedLabel::RATIO, {"ratio", SettingType::DOUBLE}},
+		{TypedLabel::FLAG, {"flag", SettingType::BOOL}},
+		{TypedLabel::TEXT, {"text", SettingType::STRING}},
+		{TypedLabel::MISSING, {"missing", SettingType::INTEGER}}
+	});
+	EXPECT_EQ(true, configurationManager.validate("typed", valid));
+	EXPECT_EQ(true, configurationManager.validate("typed_missing", valid));
+
+	EXPECT_EQ(false, configurationManager.validate("typed", Setting{ "ratio", SettingType::INTEGER }));
+	EXPECT_EQ(false, configurationManager.validate("typed", Setting{ "text", SettingType::DOUBLE }));
+	EXPECT_EQ(false, configurationManager.validate("typed", Setting{ "count", SettingType::BOOL }));
+	EXPECT_EQ(true, configurationManager.validate("typed", Setting{ "count", SettingType::DOUBLE }));
+	EXPECT_EQ(true, configurationManager.validate("typed", Setting{ "count", SettingType::UNSIGNED }));
+	EXPECT_EQ(false, configurationManager.validate("typed", Setting{ "negative", SettingType::UNSIGNED }));
+}
+
+// Configuration parsed later is merged - keys present before are replaced, other are kept.
+TEST(ConfigurationManager, Merge)
+{
+	std::string first("[merged]\nzeta = 1\nalpha = first\n[merged]\nalpha = again\n");
+	std::string second("[merged]\nbeta = 2\nalpha = second\nbeta = 3\n");
+	auto& configurationManager = ConfigurationManager::instance();
+
+	configurationManager.parseFromMemory(first);
+	std::string sTestVal;
+	EXPECT_EQ(true, configurationManager.get<std::string>("merged", "alpha", sTestVal));
+	EXPECT_EQ("again", sTestVal);
+
+	// Replaced many times - texts of the old values are dropped from the snapshot.
+	for (int i = 0; i < 20000; ++i)
+		configurationManager.parseFromMemory(second);
+
+	ConfigurationManager::SectionStructure values;
+	ASSERT_EQ(true, configurationManager.getSection("merged", values));
+	EXPECT_EQ(3, values.size());
+	EXPECT_EQ("1", values["zeta"]);
+	EXPECT_EQ("second", values["alpha"]);
+	EXPECT_EQ("3", values["beta"]);
+
+	int iTestVal = 0;
+	EXPECT_EQ(true, configurationManager.get<int>("merged", "beta", iTestVal));
+	EXPECT_EQ(3, iTestVal);
+}
+
+// Reloaded file with errors would miss the broken lines, so running configuration is kept.
+TEST(ConfigurationManager, Reload)
+{
+	static char program[] = "swpl", option[] = "-c", path[] = "reload_test.ini";
+	char* argv[] = { program, option, path };
+	auto& configurationManager = ConfigurationManager::instance();
+	std::string value;
+
+	{
+		std::ofstream file(path);
+		file << "[reloaded]\nkey = first\n";
+	}
+	configurationManager.parseConfiguration(3, argv);
+	EXPECT_EQ(true, configurationManager.get<std::string>("reloaded", "key", value));
+	EXPECT_EQ("first", value);
+
+	{
+		std::ofstream file(path);
+		file << "[reloaded]\nkey = second\nbroken line\n";
+	}
+	EXPECT_EQ(false, configurationManager.reload());
+	EXPECT_EQ(true, configurationManager.get<std::string>("reloaded", "key", value));
+	EXPECT_EQ("first", value);
+
+	{
+		std::ofstream file(path);
+		file << "[reloaded]\nkey = third\n";
+	}
+	EXPECT_EQ(true, configurationManager.reload());
+	EXPECT_EQ(true, configurationManager.get<std::string>("reloaded", "key", value));
+	EXPECT_EQ("third", value);
+
+	// Reload that could not be applied is taken back once.
+	EXPECT_EQ(true, configurationManager.revert());
+	EXPECT_EQ(true, configurationManager.get<std::string>("reloaded", "key", value));
+	EXPECT_EQ("first", value);
+	EXPECT_EQ(false, configurationManager.revert());
+
+	remove(path);
+	EXPECT_EQ(false, configurationManager.reload());
+}
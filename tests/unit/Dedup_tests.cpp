@@ -0,0 +1,160 @@
+/**
+ *  @file   Dedup_tests.cpp
+ *  @brief  Unit tests for the hash and the deduplication transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Dedup.hpp"
+#include "transform/Hash.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+
+constexpr const char* dedup_conf = R"conf(
+[dedup_default]
+type = dedup
+
+[dedup_window]
+type = dedup
+window = 10
+memory = 4096
+
+[dedup_part]
+type = dedup
+offset = 4
+length = 4
+per_source = true
+
+[dedup_tiny]
+type = dedup
+memory = 64
+
+[dedup_no_window]
+type = dedup
+window = 0
+
+[dedup_no_memory]
+type = dedup
+memory = 32
+)conf";
+
+static constexpr uint64_t MS = 1000000;
+
+TEST(Dedup, hash)
+{
+	std::vector<uint8_t> data(256);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<uint8_t>(i * 7);
+
+	// Every length (and every branch for the short ones) gives a different hash.
+	std::set<uint64_t> hashes;
+	for (size_t size = 0; size <= data.size(); ++size)
+		hashes.insert(Hash::compute(data.data(), size));
+	EXPECT_EQ(data.size() + 1, hashes.size());
+
+	// Single bit changes the hash, the seed too, the same input gives the same hash.
+	auto base = Hash::compute(data.data(), 100);
+	data[57] ^= 0x10;
+	EXPECT_NE(base, Hash::compute(data.data(), 100));
+	data[57] ^= 0x10;
+	EXPECT_EQ(base, Hash::compute(data.data(), 100));
+	EXPECT_NE(base, Hash::compute(data.data(), 100, 1));
+
+	// Hash depends on the content, not on the alignment.
+	std::vector<uint8_t> shifted(data.begin(), data.begin() + 101);
+	shifted.insert(shifted.begin(), 0);
+	EXPECT_EQ(Hash::compute(data.data(), 101), Hash::compute(shifted.data() + 1, 101));
+}
+
+TEST(Dedup, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(dedup_conf);
+	cm.parseFromMemory(config);
+
+	DedupTransformation dedup;
+	EXPECT_EQ(true, dedup.configure(cm, "dedup_default"));
+	EXPECT_EQ(1u << 20, dedup.getCapacity());
+	EXPECT_EQ(true, dedup.configure(cm, "dedup_window"));
+	EXPECT_EQ(256, dedup.getCapacity());
+	EXPECT_EQ(true, dedup.configure(cm, "dedup_tiny"));
+	EXPECT_EQ(4, dedup.getCapacity());
+	EXPECT_EQ(false, dedup.configure(cm, "dedup_no_window"));
+	EXPECT_EQ(false, dedup.configure(cm, "dedup_no_memory"));
+}
+
+TEST(Dedup, window)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(dedup_conf);
+	cm.parseFromMemory(config);
+
+	DedupTransformation dedup;
+	ASSERT_EQ(true, dedup.configure(cm, "dedup_window"));
+
+	const uint64_t now = 1000 * MS;
+	EXPECT_EQ(false, dedup.duplicate(bytes("frame 1"), 1, now));
+	EXPECT_EQ(false, dedup.duplicate(bytes("frame 2"), 1, now));
+	EXPECT_EQ(true, dedup.duplicate(bytes("frame 1"), 2, now + MS));
+	EXPECT_EQ(true, dedup.duplicate(bytes("frame 2"), 1, now + 9 * MS));
+	EXPECT_EQ(false, dedup.duplicate(bytes("frame 3"), 1, now + 9 * MS));
+
+	// Window counts from the first time message was seen.
+	EXPECT_EQ(false, dedup.duplicate(bytes("frame 1"), 1, now + 10 * MS));
+	EXPECT_EQ(true, dedup.duplicate(bytes("frame 1"), 1, now + 11 * MS));
+	EXPECT_EQ(true, dedup.duplicate(bytes("frame 3"), 1, now + 18 * MS));
+	EXPECT_EQ(false, dedup.duplicate(bytes(""), 1, now + 18 * MS));
+	EXPECT_EQ(true, dedup.duplicate(bytes(""), 1, now + 18 * MS));
+
+	EXPECT_EQ(5, dedup.getDuplicates());
+	EXPECT_EQ(0, dedup.getEvictions());
+}
+
+TEST(Dedup, part_per_source)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(dedup_conf);
+	cm.parseFromMemory(config);
+
+	DedupTransformation dedup;
+	ASSERT_EQ(true, dedup.configure(cm, "dedup_part"));
+
+	// Only bytes 4-7 are compared, messages of other cooperatives are not duplicates.
+	EXPECT_EQ(false, dedup.duplicate(bytes("0001abcd0001"), 1, 0));
+	EXPECT_EQ(true, dedup.duplicate(bytes("0002abcd0002"), 1, 0));
+	EXPECT_EQ(false, dedup.duplicate(bytes("0002abce0002"), 1, 0));
+	EXPECT_EQ(false, dedup.duplicate(bytes("0001abcd0001"), 2, 0));
+	EXPECT_EQ(true, dedup.duplicate(bytes("0001abcd"), 2, 0));
+
+	// Shorter messages are compared by what they have.
+	EXPECT_EQ(false, dedup.duplicate(bytes("0001ab"), 1, 0));
+	EXPECT_EQ(true, dedup.duplicate(bytes("0002ab"), 1, 0));
+	EXPECT_EQ(false, dedup.duplicate(bytes("01"), 1, 0));
+	EXPECT_EQ(true, dedup.duplicate(bytes("02"), 1, 0));
+}
+
+TEST(Dedup, eviction)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(dedup_conf);
+	cm.parseFromMemory(config);
+
+	DedupTransformation dedup;
+	ASSERT_EQ(true, dedup.configure(cm, "dedup_tiny"));
+
+	// Single bucket of 4 slots, the fifth message evicts the one that expires first.
+	for (int i = 0; i < 5; ++i)
+		EXPECT_EQ(false, dedup.duplicate(bytes("message " + std::to_string(i)), 1, i * MS));
+	EXPECT_EQ(1, dedup.getEvictions());
+	EXPECT_EQ(false, dedup.duplicate(bytes("message 0"), 1, 5 * MS));
+	EXPECT_EQ(true, dedup.duplicate(bytes("message 4"), 1, 5 * MS));
+	EXPECT_EQ(2, dedup.getEvictions());
+}
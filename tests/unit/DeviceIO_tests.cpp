@@ -0,0 +1,70 @@
+/**
+ *  @file   DeviceIO_tests.cpp
+ *  @brief  Unit tests for DeviceIO.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "io/DeviceIO.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+static constexpr const char* DEVICE_FIFO = "device_test_fifo";
+
+constexpr const char* device_conf = R"conf(
+[device_fifo]
+type = device
+file = device_test_fifo
+)conf";
+
+// Reader waiting on an idle device is woken up by cancel() and by close().
+TEST(DeviceIO, cancel)
+{
+	std::remove(DEVICE_FIFO);
+	ASSERT_EQ(0, ::mkfifo(DEVICE_FIFO, 0600));
+
+	auto& cm = ConfigurationManager::instance();
+	std::string config(device_conf);
+	cm.parseFromMemory(config);
+
+	DeviceIO device;
+	std::vector<char> buffer(64);
+	ASSERT_EQ(true, device.configure(cm, "device_fifo"));
+	ASSERT_EQ(0, device.open());
+
+	// Data is still read as before.
+	std::vector<char> message{ 'a', 'b', 'c' };
+	ASSERT_EQ(3, device.write(message, message.size()));
+	EXPECT_EQ(3, device.read(buffer, buffer.size()));
+
+	auto start = std::chrono::steady_clock::now();
+	std::thread reader([&device, &buffer]() {
+		EXPECT_EQ(0, device.read(buffer, buffer.size()));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	device.cancel();
+	reader.join();
+	EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+	// Opened again it waits for data once more, close() does not hang on it.
+	ASSERT_EQ(0, device.open());
+	reader = std::thread([&device, &buffer]() {
+		EXPECT_GE(0, device.read(buffer, buffer.size()));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	EXPECT_EQ(0, device.close());
+	reader.join();
+
+	std::remove(DEVICE_FIFO);
+}
@@ -0,0 +1,139 @@
+/**
+ *  @file   Fields_tests.cpp
+ *  @brief  Unit tests for the fields transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Fields.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <vector>
+
+constexpr const char* fields_conf = R"conf(
+[fields_csv]
+type = fields
+columns = "3,1"
+
+[fields_tsv]
+type = fields
+columns = "2-4, 2"
+delimiter = "\t"
+quote = ""
+output_delimiter = ";"
+
+[fields_drop]
+type = fields
+columns = "40,2"
+drop_short = true
+
+[fields_no_columns]
+type = fields
+
+[fields_bad_columns]
+type = fields
+columns = "1,0"
+
+[fields_bad_range]
+type = fields
+columns = "4-2"
+
+[fields_bad_delimiter]
+type = fields
+columns = "1"
+delimiter = ",;"
+
+[fields_quote_delimiter]
+type = fields
+columns = "1"
+delimiter = "'"
+quote = "'"
+)conf";
+
+static std::string project(FieldsTransformation& fields, const std::string& record, bool expected_pass = true)
+{
+	std::vector<uint8_t> data(record.begin(), record.end());
+	EXPECT_EQ(expected_pass, fields.project(data));
+	return std::string(data.begin(), data.end());
+}
+
+TEST(Fields, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(fields_conf);
+	cm.parseFromMemory(config);
+
+	FieldsTransformation fields;
+	EXPECT_EQ(true, fields.configure(cm, "fields_csv"));
+	EXPECT_EQ(true, fields.configure(cm, "fields_tsv"));
+	EXPECT_EQ(true, fields.configure(cm, "fields_drop"));
+	EXPECT_EQ(false, fields.configure(cm, "fields_no_columns"));
+	EXPECT_EQ(false, fields.configure(cm, "fields_bad_columns"));
+	EXPECT_EQ(false, fields.configure(cm, "fields_bad_range"));
+	EXPECT_EQ(false, fields.configure(cm, "fields_bad_delimiter"));
+	EXPECT_EQ(false, fields.configure(cm, "fields_quote_delimiter"));
+}
+
+TEST(Fields, csv)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(fields_conf);
+	cm.parseFromMemory(config);
+
+	FieldsTransformation fields;
+	ASSERT_EQ(true, fields.configure(cm, "fields_csv"));
+
+	EXPECT_EQ("c,a\n", project(fields, "a,b,c,d\n"));
+	EXPECT_EQ("c,a\r\n", project(fields, "a,b,c\r\n"));
+	EXPECT_EQ("c,a", project(fields, "a,b,c"));
+	EXPECT_EQ(",", project(fields, ",,,"));
+	EXPECT_EQ("\"x,y\",\"a,\"\"b\"\"\"\n", project(fields, "\"a,\"\"b\"\"\",2,\"x,y\",4\n"));
+
+	// Missing columns are empty.
+	EXPECT_EQ(",a\n", project(fields, "a\n"));
+	EXPECT_EQ(",\n", project(fields, "\n"));
+	EXPECT_EQ(",", project(fields, ""));
+	EXPECT_EQ(3, fields.getShort());
+
+	// Records longer than a vector, with delimiters and quotes on both sides of the block boundaries.
+	std::string head = "0123456789abcdef0123456789,";
+	EXPECT_EQ("0123456789abcdef,\"" + head + "\"\n", project(fields, "\"" + head + "\"," + head + "0123456789abcdef,third,\"rest,,,,,,,,,,,,,,,,,,\"\n"));
+	EXPECT_EQ(3, fields.getShort());
+}
+
+TEST(Fields, tsv_reorder)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(fields_conf);
+	cm.parseFromMemory(config);
+
+	FieldsTransformation fields;
+	ASSERT_EQ(true, fields.configure(cm, "fields_tsv"));
+
+	// No quoting, columns repeat and output delimiter differs.
+	EXPECT_EQ("\"b;c;d\";\"b\n", project(fields, "a\t\"b\tc\td\"\te\n"));
+	EXPECT_EQ("b;;;b", project(fields, "a\tb"));
+}
+
+TEST(Fields, drop_short)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(fields_conf);
+	cm.parseFromMemory(config);
+
+	FieldsTransformation fields;
+	ASSERT_EQ(true, fields.configure(cm, "fields_drop"));
+
+	std::string record;
+	for (int i = 1; i <= 40; ++i)
+		record += "field" + std::to_string(i) + (i == 40 ? "\n" : ",");
+
+	EXPECT_EQ("field40,field2\n", project(fields, record));
+	project(fields, "a,b,c\n", false);
+	EXPECT_EQ(1, fields.getShort());
+}
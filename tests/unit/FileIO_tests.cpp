@@ -13,8 +13,13 @@
 #include "io/FileIO.hpp"
 #include "config/ConfigurationManager.hpp"
 
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <sstream>
+#include <thread>
 
 #define TEST_FILE "test_file"
 #define TEST_STR "This is the test file"
@@ -42,6 +47,14 @@ file = test_file
 direction = bidirectional
 )conf";
 
+constexpr const char* conf_follow = R"conf(
+[io_follow]
+type = file
+file = follow_file
+direction = input
+follow = true
+)conf";
+
 void prepare_file();
 void remove_file();
 
@@ -145,6 +158,117 @@ TEST(FileIO, read_write)
 }
 
 
+static std::string read_string(FileIO& fio)
+{
+	std::vector<char> buffer(64);
+	auto got = fio.read(buffer, buffer.size());
+	return got > 0 ? std::string(buffer.data(), static_cast<size_t>(got)) : std::string();
+}
+
+static void append(const char* path, const char* text)
+{
+	std::ofstream file(path, std::ios::app);
+	file << text;
+}
+
+TEST(FileIO, follow)
+{
+	auto& configurationManager = ConfigurationManager::instance();
+	std::string config(conf_follow);
+	configurationManager.parseFromMemory(config);
+
+	std::remove("follow_file");
+	std::remove("follow_file.1");
+	append("follow_file", "first");
+
+	FileIO fio;
+	ASSERT_EQ(true, fio.configure(configurationManager, "io_follow"));
+	ASSERT_EQ(0, fio.open());
+	EXPECT_EQ("first", read_string(fio));
+
+	// Read at the end waits for appended data and costs no CPU meanwhile.
+	std::thread writer([]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		append("follow_file", "second");
+	});
+	auto cpu = std::clock();
+	EXPECT_EQ("second", read_string(fio));
+	EXPECT_GT(CLOCKS_PER_SEC / 50, std::clock() - cpu);
+	writer.join();
+
+	// Rotation by rename - rest of the old file is read and then the new one.
+	std::thread rotator([]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		append("follow_file", "third");
+		std::rename("follow_file", "follow_file.1");
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		append("follow_file", "fourth");
+	});
+	EXPECT_EQ("third", read_string(fio));
+	EXPECT_EQ("fourth", read_string(fio));
+	rotator.join();
+
+	// Truncated file is read from the beginning.
+	std::thread truncator([]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		std::ofstream file("follow_file", std::ios::trunc);
+		file << "fifth";
+	});
+	EXPECT_EQ("fifth", read_string(fio));
+	truncator.join();
+
+	// Cancelled read ends as the end of the stream.
+	std::thread canceller([&fio]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		fio.cancel();
+	});
+	std::vector<char> buffer(64);
+	EXPECT_EQ(0, fio.read(buffer, buffer.size()));
+	canceller.join();
+
+	EXPECT_EQ(0, fio.close());
+	std::remove("follow_file");
+	std::remove("follow_file.1");
+}
+
+TEST(FileIO, follow_output)
+{
+	auto& configurationManager = ConfigurationManager::instance();
+	std::string config("[io_follow_out]\ntype = file\nfile = follow_file\ndirection = output\nfollow = true\n");
+	configurationManager.parseFromMemory(config);
+
+	FileIO fio;
+	EXPECT_EQ(false, fio.configure(configurationManager, "io_follow_out"));
+}
+
+TEST(FileIO, rotate)
+{
+	auto& configurationManager = ConfigurationManager::instance();
+	std::string config("[io_rotate]\ntype = file\nfile = rotate_file\ndirection = output\nrotate_size = 100\n"
+		"[io_rotate_in]\ntype = file\nfile = rotate_file\ndirection = input\nrotate_size = 100\n");
+	configurationManager.parseFromMemory(config);
+
+	FileIO input;
+	EXPECT_EQ(false, input.configure(configurationManager, "io_rotate_in"));
+
+	FileIO fio;
+	ASSERT_EQ(true, fio.configure(configurationManager, "io_rotate"));
+	EXPECT_EQ(-ENOTSUP, fio.resume(0));
+	ASSERT_EQ(0, fio.open());
+
+	std::vector<char> buffer(60, 'x');
+	for (int i = 0; i < 4; ++i)
+		EXPECT_EQ(60, fio.write(buffer, buffer.size()));
+	EXPECT_EQ(0, fio.sync());
+	EXPECT_EQ(0, fio.close());
+
+	EXPECT_EQ(120, std::filesystem::file_size("rotate_file.000000"));
+	EXPECT_EQ(120, std::filesystem::file_size("rotate_file.000001"));
+	EXPECT_EQ(false, std::filesystem::exists("rotate_file.000002"));
+	for (auto name : { "rotate_file.000000", "rotate_file.000001" })
+		std::remove(name);
+}
+
 #include <fstream>
 #include <iostream>
 #include <cstdio>
@@ -0,0 +1,262 @@
+/**
+ *  @file   Framer_tests.cpp
+ *  @brief  Unit tests for the framer transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Framer.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* framer_conf = R"conf(
+[framer_lines]
+type = framer
+
+[framer_crlf]
+type = framer
+delimiter = "\r\n"
+keep_delimiter = false
+max_record = 16
+
+[framer_length]
+type = framer
+mode = length
+length_bytes = 2
+max_record = 100
+
+[framer_length_le]
+type = framer
+mode = length
+length_bytes = 1
+big_endian = false
+keep_header = true
+
+[framer_fixed]
+type = framer
+mode = fixed
+record_size = 3
+
+[framer_bad_mode]
+type = framer
+mode = lines
+
+[framer_bad_fixed]
+type = framer
+mode = fixed
+
+[framer_bad_length]
+type = framer
+mode = length
+length_bytes = 3
+
+[framer_negative_record]
+type = framer
+max_record = -1
+)conf";
+
+typedef std::vector<std::string> Records;
+
+/**
+* Pass pieces through the framer and collect records as strings.
+*/
+static Records frame(FramerTransformation& framer, const std::vector<std::string>& pieces, unsigned int src = 1)
+{
+	Records result;
+	std::vector<std::vector<uint8_t>> records;
+
+	for (const auto& piece : pieces)
+	{
+		records.clear();
+		framer.frame(std::vector<uint8_t>(piece.begin(), piece.end()), src, records);
+		for (const auto& record : records)
+			result.emplace_back(record.begin(), record.end());
+	}
+
+	return result;
+}
+
+TEST(Framer, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	EXPECT_EQ(true, framer.configure(cm, "framer_lines"));
+	EXPECT_EQ(true, framer.configure(cm, "framer_crlf"));
+	EXPECT_EQ(true, framer.configure(cm, "framer_length"));
+	EXPECT_EQ(true, framer.configure(cm, "framer_fixed"));
+	EXPECT_EQ(false, framer.configure(cm, "framer_bad_mode"));
+	EXPECT_EQ(false, framer.configure(cm, "framer_bad_fixed"));
+	EXPECT_EQ(false, framer.configure(cm, "framer_bad_length"));
+	EXPECT_EQ(false, framer.configure(cm, "framer_negative_record"));
+}
+
+TEST(Framer, lines)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	ASSERT_EQ(true, framer.configure(cm, "framer_lines"));
+
+	EXPECT_EQ((Records{ "one\n", "two\n" }), frame(framer, { "one\ntw", "o\nthr" }));
+	EXPECT_EQ((Records{ "three\n", "\n" }), frame(framer, { "ee", "\n\n" }));
+
+	std::vector<uint8_t> rest;
+	EXPECT_EQ((Records{}), frame(framer, { "last" }));
+	EXPECT_EQ(true, framer.flush(rest, 1));
+	EXPECT_EQ("last", std::string(rest.begin(), rest.end()));
+	EXPECT_EQ(false, framer.flush(rest, 1));
+}
+
+TEST(Framer, records_keep_buffers)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	ASSERT_EQ(true, framer.configure(cm, "framer_lines"));
+
+	std::vector<uint8_t> data{ 'l', 'i', 'n', 'e', '\n' };
+	std::vector<std::vector<uint8_t>> records;
+	const auto* buffer = data.data();
+
+	framer.frame(std::move(data), 1, records);
+	ASSERT_EQ(1, records.size());
+	EXPECT_EQ(buffer, records[0].data());
+
+	// Last of many records and the held back one keep the buffers of their pieces.
+	data = { 'a', '\n', 'b', '\n' };
+	buffer = data.data();
+	records.clear();
+	framer.frame(std::move(data), 1, records);
+	ASSERT_EQ(2, records.size());
+	EXPECT_EQ(buffer, records[1].data());
+	EXPECT_EQ("b\n", std::string(records[1].begin(), records[1].end()));
+
+	data = { 'c', '\n', 'd' };
+	buffer = data.data();
+	records.clear();
+	framer.frame(std::move(data), 1, records);
+	ASSERT_TRUE(framer.flush(data, 1));
+	EXPECT_EQ(buffer, data.data());
+	EXPECT_EQ("d", std::string(data.begin(), data.end()));
+}
+
+TEST(Framer, split_delimiter)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	ASSERT_EQ(true, framer.configure(cm, "framer_crlf"));
+
+	EXPECT_EQ((Records{ "a\rb", "c" }), frame(framer, { "a\rb\r", "\nc\r\n" }));
+	EXPECT_EQ((Records{ "x" }), frame(framer, { "x\r", "\n" }));
+
+	// Record without the delimiter is passed on when held back data reaches max_record.
+	EXPECT_EQ((Records{ "0123456789abcdef", "end" }), frame(framer, { "0123456789", "abcdef", "end\r\n" }));
+
+	// Streams from different cooperatives do not mix.
+	EXPECT_EQ((Records{}), frame(framer, { "one" }, 1));
+	EXPECT_EQ((Records{ "two" }), frame(framer, { "two\r\n" }, 2));
+	EXPECT_EQ((Records{ "one" }), frame(framer, { "\r\n" }, 1));
+}
+
+TEST(Framer, length_prefix)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	ASSERT_EQ(true, framer.configure(cm, "framer_length"));
+
+	std::string stream = std::string("\x00\x03" "abc" "\x00\x05" "hello" "\x00\x01" "z", 15);
+	EXPECT_EQ((Records{ "abc", "hello", "z" }), frame(framer, { stream }));
+	EXPECT_EQ((Records{ "abc", "hello", "z" }), frame(framer, { stream.substr(0, 1), stream.substr(1, 3), stream.substr(4, 8), stream.substr(12) }));
+
+	// Length over max_record breaks the stream - the piece is dropped.
+	EXPECT_EQ((Records{}), frame(framer, { std::string("\x01\x00" "data", 6) }));
+	EXPECT_EQ(6, framer.getDropped());
+	EXPECT_EQ((Records{ "ok" }), frame(framer, { std::string("\x00\x02" "ok", 4) }));
+
+	ASSERT_EQ(true, framer.configure(cm, "framer_length_le"));
+	EXPECT_EQ((Records{ "\x02xy" }), frame(framer, { "\x02x", "y" }));
+}
+
+TEST(Framer, fixed)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	ASSERT_EQ(true, framer.configure(cm, "framer_fixed"));
+
+	EXPECT_EQ((Records{ "abc", "def", "ghi" }), frame(framer, { "ab", "cdefg", "h", "ij" }));
+
+	std::vector<uint8_t> rest;
+	EXPECT_EQ(false, framer.flush(rest, 1));
+}
+
+TEST(Framer, unregistered_source_tail)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(framer_conf);
+	cm.parseFromMemory(config);
+
+	FramerTransformation framer;
+	ASSERT_EQ(true, framer.configure(cm, "framer_lines"));
+
+	CollectStage source, sink;
+	for (auto* peer : { &source, &sink })
+	{
+		framer.register_coop(peer->getID(), peer);
+		peer->register_coop(framer.getID(), &framer);
+	}
+
+	framer.set_work_flag(true);
+	std::thread worker(&FramerTransformation::run, &framer);
+	framer.add_to_queue(bytes("one\ntw"), source.getID());
+
+	std::vector<std::string> records;
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (records.empty() && std::chrono::steady_clock::now() < deadline)
+	{
+		records = sink.collected();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	// Record of the unregistered cooperative is delivered although no other one takes its slot.
+	framer.unregister_coop(source.getID());
+	while (records.size() < 2 && std::chrono::steady_clock::now() < deadline)
+	{
+		auto more = sink.collected();
+		records.insert(records.end(), more.begin(), more.end());
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	framer.set_work_flag(false);
+	worker.join();
+
+	EXPECT_EQ((Records{ "one\n", "tw" }), records);
+	framer.update_held();
+	EXPECT_EQ(0, framer.held());
+
+	framer.unregister_coop(sink.getID());
+}
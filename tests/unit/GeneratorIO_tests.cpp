@@ -0,0 +1,132 @@
+/**
+ *  @file   GeneratorIO_tests.cpp
+ *  @brief  Unit tests for GeneratorIO.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "io/GeneratorIO.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* generator_conf = R"conf(
+[gen_fixed]
+type = generator
+size = 100
+count = 3
+
+[gen_uniform]
+type = generator
+size = 10
+size_max = 200
+rate = 1000
+burst = 5
+
+[gen_invalid]
+type = generator
+size = 100
+size_max = 50
+
+[gen_output]
+type = generator
+direction = output
+
+[gen_slow]
+type = generator
+rate = 1
+)conf";
+
+TEST(GeneratorIO, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(generator_conf);
+	cm.parseFromMemory(config);
+
+	GeneratorIO fixed, uniform, invalid, output;
+
+	EXPECT_EQ(true, fixed.configure(cm, "gen_fixed"));
+	EXPECT_EQ(true, uniform.configure(cm, "gen_uniform"));
+	EXPECT_EQ(false, invalid.configure(cm, "gen_invalid"));
+	EXPECT_EQ(false, output.configure(cm, "gen_output"));
+}
+
+TEST(GeneratorIO, messages)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(generator_conf);
+	cm.parseFromMemory(config);
+
+	GeneratorIO generator;
+	std::vector<char> buffer(4096);
+	GeneratorHeader header;
+
+	ASSERT_EQ(true, generator.configure(cm, "gen_fixed"));
+	ASSERT_EQ(0, generator.open());
+
+	for (uint64_t i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(100, generator.read(buffer, buffer.size()));
+		ASSERT_EQ(true, header.decode(buffer.data(), 100));
+		EXPECT_EQ(i, header.sequence);
+		EXPECT_EQ(generator.getConfiguration().getID(), header.source);
+	}
+
+	EXPECT_EQ(0, generator.read(buffer, buffer.size()));
+	EXPECT_EQ(3, generator.getGenerated());
+	EXPECT_GT(0, generator.write(buffer, 10));
+}
+
+TEST(GeneratorIO, rate_and_sizes)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(generator_conf);
+	cm.parseFromMemory(config);
+
+	GeneratorIO generator;
+	std::vector<char> buffer(4096);
+
+	ASSERT_EQ(true, generator.configure(cm, "gen_uniform"));
+	ASSERT_EQ(0, generator.open());
+
+	// 50 messages at 1000 msg/s in bursts of 5 - 10 bursts, 9 gaps of 5 ms.
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < 50; ++i)
+	{
+		auto size = generator.read(buffer, buffer.size());
+		EXPECT_GE(size, static_cast<ssize_t>(GeneratorHeader::SIZE));
+		EXPECT_LE(size, 200);
+	}
+	EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(45));
+}
+
+TEST(GeneratorIO, cancel)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(generator_conf);
+	cm.parseFromMemory(config);
+
+	GeneratorIO generator;
+	std::vector<char> buffer(4096);
+
+	ASSERT_EQ(true, generator.configure(cm, "gen_slow"));
+	ASSERT_EQ(0, generator.open());
+	ASSERT_EQ(64, generator.read(buffer, buffer.size()));
+
+	// Next message is due in a second - waiting read ends as soon as it is cancelled.
+	auto start = std::chrono::steady_clock::now();
+	std::thread canceller([&generator]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		generator.cancel();
+	});
+	EXPECT_EQ(0, generator.read(buffer, buffer.size()));
+	EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+	canceller.join();
+}
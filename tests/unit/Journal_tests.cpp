@@ -0,0 +1,169 @@
+/**
+ *  @file   Journal_tests.cpp
+ *  @brief  Unit tests for the journal of pipeline positions.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/Journal.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define JOURNAL_FILE "journal_test"
+
+TEST(Journal, recovers_positions)
+{
+	std::remove(JOURNAL_FILE);
+	uint64_t value = 0;
+
+	{
+		Journal journal{ JOURNAL_FILE };
+		ASSERT_EQ(true, journal.open());
+		EXPECT_EQ(false, journal.get("in.read", value));
+
+		journal.set("in.read", 100);
+		journal.set("out.written", 50);
+		auto ticket = journal.set("in.read", 200);
+		EXPECT_EQ(true, journal.sync(ticket));
+		EXPECT_EQ(1, journal.getCommits());
+
+		// Not synced change is lost with the crash.
+		journal.set("out.written", 1000);
+	}
+
+	Journal journal{ JOURNAL_FILE };
+	ASSERT_EQ(true, journal.open());
+	ASSERT_EQ(true, journal.get("in.read", value));
+	EXPECT_EQ(200, value);
+	ASSERT_EQ(true, journal.get("out.written", value));
+	EXPECT_EQ(50, value);
+
+	std::remove(JOURNAL_FILE);
+}
+
+TEST(Journal, torn_record)
+{
+	std::remove(JOURNAL_FILE);
+	uint64_t value = 0;
+
+	{
+		Journal journal{ JOURNAL_FILE };
+		ASSERT_EQ(true, journal.open());
+		journal.set("position", 1);
+		journal.set("position", 2);
+		ASSERT_EQ(true, journal.sync());
+	}
+
+	// Record cut in the middle by the crash.
+	auto size = std::filesystem::file_size(JOURNAL_FILE);
+	std::filesystem::resize_file(JOURNAL_FILE, size - 3);
+
+	{
+		Journal journal{ JOURNAL_FILE };
+		ASSERT_EQ(true, journal.open());
+		ASSERT_EQ(true, journal.get("position", value));
+		EXPECT_EQ(1, value);
+		EXPECT_EQ(size / 2, std::filesystem::file_size(JOURNAL_FILE));
+
+		// Records written after recovery are not hidden behind the broken one.
+		journal.set("position", 3);
+		ASSERT_EQ(true, journal.sync());
+	}
+
+	{
+		std::ofstream garbage(JOURNAL_FILE, std::ios::binary | std::ios::app);
+		garbage << "garbage after the last record";
+	}
+
+	Journal journal{ JOURNAL_FILE };
+	ASSERT_EQ(true, journal.open());
+	ASSERT_EQ(true, journal.get("position", value));
+	EXPECT_EQ(3, value);
+
+	std::remove(JOURNAL_FILE);
+}
+
+TEST(Journal, compaction)
+{
+	std::remove(JOURNAL_FILE);
+	uint64_t value = 0;
+
+	{
+		Journal journal{ JOURNAL_FILE };
+		ASSERT_EQ(true, journal.open());
+		for (uint64_t i = 0; i < 100000; ++i)
+		{
+			journal.set("input", i);
+			journal.set("output", 2 * i);
+			if (i % 1000 == 999)
+			{
+				ASSERT_EQ(true, journal.sync());
+			}
+		}
+		EXPECT_GT(1 << 20, journal.getFileSize());
+		EXPECT_EQ(journal.getFileSize(), std::filesystem::file_size(JOURNAL_FILE));
+	}
+
+	Journal journal{ JOURNAL_FILE };
+	ASSERT_EQ(true, journal.open());
+	ASSERT_EQ(true, journal.get("input", value));
+	EXPECT_EQ(99999, value);
+	ASSERT_EQ(true, journal.get("output", value));
+	EXPECT_EQ(199998, value);
+
+	std::remove(JOURNAL_FILE);
+}
+
+TEST(Journal, group_commit)
+{
+	std::remove(JOURNAL_FILE);
+	constexpr unsigned int THREADS = 4;
+	constexpr uint64_t CHANGES = 200;
+
+	Journal journal{ JOURNAL_FILE };
+	ASSERT_EQ(true, journal.open());
+
+	std::vector<std::thread> threads;
+	std::vector<bool> synced(THREADS, true);
+	for (unsigned int t = 0; t < THREADS; ++t)
+	{
+		threads.emplace_back([&journal, &synced, t]() {
+			for (uint64_t i = 1; i <= CHANGES; ++i)
+			{
+				if (!journal.sync(journal.set("thread" + std::to_string(t), i)))
+					synced[t] = false;
+			}
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	EXPECT_GE(THREADS * CHANGES, journal.getCommits());
+	for (unsigned int t = 0; t < THREADS; ++t)
+	{
+		uint64_t value = 0;
+		EXPECT_EQ(true, synced[t]);
+		EXPECT_EQ(true, journal.get("thread" + std::to_string(t), value));
+		EXPECT_EQ(CHANGES, value);
+	}
+
+	Journal recovered{ JOURNAL_FILE };
+	ASSERT_EQ(true, recovered.open());
+	for (unsigned int t = 0; t < THREADS; ++t)
+	{
+		uint64_t value = 0;
+		EXPECT_EQ(true, recovered.get("thread" + std::to_string(t), value));
+		EXPECT_EQ(CHANGES, value);
+	}
+
+	std::remove(JOURNAL_FILE);
+}
@@ -0,0 +1,128 @@
+/**
+ *  @file   Logger_tests.cpp
+ *  @brief  Unit tests for the asynchronous logger.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "Global.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+/**
+* Redirects the log into a temporary file for its lifetime.
+*/
+class CapturedLog
+{
+public:
+	CapturedLog() : output_(std::tmpfile()) {
+		EXPECT_NE(nullptr, output_);
+		Logger::set_output(output_);
+		Logger::set_level(LogLevel::VERBOSE);
+	}
+
+	~CapturedLog() {
+		Logger::set_output(stderr);
+		Logger::set_level(LogLevel::INFO);
+		if (output_ != nullptr)
+			std::fclose(output_);
+	}
+
+	std::string written() {
+		Logger::flush();
+		std::string content;
+		char buffer[512];
+		if (output_ == nullptr)
+			return content;
+		std::rewind(output_);
+		while (auto read = std::fread(buffer, 1, sizeof(buffer), output_))
+			content.append(buffer, read);
+		return content;
+	}
+
+private:
+	std::FILE* output_{ nullptr };
+};
+
+TEST(Logger, formats_arguments)
+{
+	CapturedLog captured;
+	std::string path = "/tmp/file";
+	const void* pointer = nullptr;
+
+	Logger::log(LogLevel::ERROR, "open {} failed: {} ({}, {}, {}) {}", path, -9, 42u, true, 1.5, pointer);
+	Logger::log(LogLevel::WARNING, "missing {} {}", "one");
+
+	auto content = captured.written();
+	EXPECT_NE(std::string::npos, content.find("[ERROR] open /tmp/file failed: -9 (42, true, 1.5) "));
+	EXPECT_NE(std::string::npos, content.find("[WARNING] missing one {}\n"));
+}
+
+TEST(Logger, runtime_level)
+{
+	CapturedLog captured;
+	Logger::set_level(LogLevel::WARNING);
+	Logger::log(LogLevel::INFO, "hidden");
+	Logger::log(LogLevel::WARNING, "shown");
+
+	auto content = captured.written();
+	EXPECT_EQ(std::string::npos, content.find("hidden"));
+	EXPECT_NE(std::string::npos, content.find("shown"));
+}
+
+TEST(Logger, threads)
+{
+	CapturedLog captured;
+	std::thread first([]() { for (int i = 0; i < 100; ++i) Logger::log(LogLevel::INFO, "first {}", i); });
+	std::thread second([]() { for (int i = 0; i < 100; ++i) Logger::log(LogLevel::INFO, "second {}", i); });
+	first.join();
+	second.join();
+
+	auto content = captured.written();
+	EXPECT_NE(std::string::npos, content.find("first 99\n"));
+	EXPECT_NE(std::string::npos, content.find("second 99\n"));
+}
+
+TEST(Logger, long_strings_truncated)
+{
+	CapturedLog captured;
+	std::string long_string(1000, 'x');
+
+	Logger::log(LogLevel::INFO, "{}|{}", long_string, "tail");
+
+	auto content = captured.written();
+	EXPECT_NE(std::string::npos, content.find(std::string(sizeof(LogRecord::text), 'x') + "|\n"));
+}
+
+/**
+* Logs from its destructor, which runs after the ring of the thread is released.
+*/
+struct LogOnExit
+{
+	void touch() { }
+
+	~LogOnExit() {
+		Logger::log(LogLevel::INFO, "logged at thread exit");
+	}
+};
+
+TEST(Logger, thread_exit)
+{
+	CapturedLog captured;
+	std::thread thread([]() {
+		thread_local LogOnExit guard;
+		guard.touch();
+		Logger::log(LogLevel::INFO, "logged by the thread");
+	});
+	thread.join();
+
+	auto content = captured.written();
+	EXPECT_NE(std::string::npos, content.find("logged by the thread\n"));
+	EXPECT_NE(std::string::npos, content.find("logged at thread exit\n"));
+}
@@ -0,0 +1,334 @@
+/**
+ *  @file   Match_tests.cpp
+ *  @brief  Unit tests for the multi-pattern matcher and match transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/AhoCorasick.hpp"
+#include "transform/Match.hpp"
+#include "core/Pipeline.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<size_t, size_t>> Matches;
+
+static Matches find_all(const AhoCorasick& automaton, const std::string& text)
+{
+	Matches found;
+	AhoCorasick::State state = AhoCorasick::START;
+
+	automaton.scan(reinterpret_cast<const uint8_t*>(text.data()), text.size(), state, [&](size_t pattern, size_t end) {
+		found.emplace_back(pattern, end);
+		return true;
+	});
+
+	return found;
+}
+
+constexpr const char* match_conf = R"conf(
+[match_one]
+type = match
+pattern1 = "Name"
+
+[match_branch]
+type = match
+pattern1 = "Name"
+pass1 = names
+pattern2 = "Password"
+pass2 = passwords
+pattern3 = "Login"
+pass3 = names
+default = rest
+
+[match_escape]
+type = match
+pattern1 = "a\x00b\n"
+
+[match_bad_escape]
+type = match
+pattern1 = "a\q"
+
+[match_empty]
+type = match
+
+[match_regex]
+type = match
+regex1 = "^ERROR .*disk"
+pass1 = errors
+pattern2 = "a.b"
+pass2 = literal
+regex3 = "id=\d+$"
+pass3 = ids
+
+[match_big_cache]
+type = match
+regex1 = "a+b"
+dfa_states = 8388609
+
+[match_bad_regex]
+type = match
+regex1 = "(unclosed"
+
+[match_stream]
+type = match
+pattern1 = "boundary"
+stream = true
+)conf";
+
+constexpr const char* branch_pipeline_conf = R"conf(
+[bin]
+type = file
+file = match_in
+direction = input
+
+[bmatch]
+type = match
+pattern1 = "Password"
+pass1 = bpass
+
+[bpass]
+type = file
+file = match_pass
+direction = output
+
+[bnames]
+type = file
+file = match_names
+direction = output
+
+[branches]
+stage1 = bin
+stage2 = bmatch
+stage3 = bnames
+)conf";
+
+TEST(AhoCorasick, overlapping)
+{
+	AhoCorasick automaton;
+
+	EXPECT_EQ(-1, automaton.add(""));
+	EXPECT_EQ(0, automaton.add("he"));
+	EXPECT_EQ(1, automaton.add("she"));
+	EXPECT_EQ(2, automaton.add("his"));
+	EXPECT_EQ(3, automaton.add("hers"));
+	automaton.compile();
+
+	Matches expected{ { 1, 4 }, { 0, 4 }, { 3, 6 } };
+	EXPECT_EQ(expected, find_all(automaton, "ushers"));
+	EXPECT_EQ(Matches{}, find_all(automaton, "nothing to see"));
+}
+
+TEST(AhoCorasick, prefilters)
+{
+	std::string text(1000, '.');
+	text.replace(500, 3, "abc");
+	text.replace(997, 3, "xyz");
+
+	// Single, few and many first bytes take different prefilter paths.
+	for (const auto& patterns : { std::vector<std::string>{ "abc", "xyz" }, std::vector<std::string>{ "abc", "bcd", "xyz" },
+		std::vector<std::string>{ "abc", "qqq", "rrr", "sss", "ttt", "\xc1" "bc", "xyz" } })
+	{
+		AhoCorasick automaton;
+		for (const auto& pattern : patterns)
+			automaton.add(pattern);
+		automaton.compile();
+
+		auto found = find_all(automaton, text);
+		ASSERT_EQ(2, found.size());
+		EXPECT_EQ(503, found[0].second);
+		EXPECT_EQ(1000, found[1].second);
+	}
+
+	AhoCorasick single;
+	single.add("z");
+	single.compile();
+	EXPECT_EQ(1, find_all(single, text).size());
+}
+
+TEST(AhoCorasick, state_between_chunks)
+{
+	AhoCorasick automaton;
+	automaton.add("boundary");
+	automaton.compile();
+
+	std::string first = "data across the bou", second = "ndary of chunks";
+	AhoCorasick::State state = AhoCorasick::START;
+	size_t found = 0, end = 0;
+	auto count = [&](size_t, size_t at) { found++; end = at; return true; };
+
+	automaton.scan(reinterpret_cast<const uint8_t*>(first.data()), first.size(), state, count);
+	EXPECT_EQ(0, found);
+	automaton.scan(reinterpret_cast<const uint8_t*>(second.data()), second.size(), state, count);
+	EXPECT_EQ(1, found);
+	EXPECT_EQ(5, end);
+}
+
+TEST(Match, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(match_conf);
+	cm.parseFromMemory(config);
+
+	MatchTransformation match;
+	EXPECT_EQ(true, match.configure(cm, "match_one"));
+	EXPECT_EQ(true, match.configure(cm, "match_branch"));
+	EXPECT_EQ((std::vector<std::string>{ "", "names", "passwords", "rest" }), match.getOutputs());
+	EXPECT_EQ(true, match.configure(cm, "match_escape"));
+	EXPECT_EQ(false, match.configure(cm, "match_bad_escape"));
+	EXPECT_EQ(false, match.configure(cm, "match_empty"));
+}
+
+TEST(Match, select)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(match_conf);
+	cm.parseFromMemory(config);
+
+	MatchTransformation match;
+	std::vector<uint8_t> selected;
+	auto message = [](const std::string& text) { return std::vector<uint8_t>(text.begin(), text.end()); };
+
+	ASSERT_EQ(true, match.configure(cm, "match_branch"));
+	EXPECT_EQ(1, match.select(message("Name: John"), selected));
+	EXPECT_EQ((std::vector<uint8_t>{ 0, 1, 0, 0 }), selected);
+	EXPECT_EQ(1, match.select(message("Login and Name"), selected));
+	EXPECT_EQ(2, match.select(message("Name: John, Password: secret"), selected));
+	EXPECT_EQ((std::vector<uint8_t>{ 0, 1, 1, 0 }), selected);
+	EXPECT_EQ(1, match.select(message("nothing"), selected));
+	EXPECT_EQ((std::vector<uint8_t>{ 0, 0, 0, 1 }), selected);
+
+	ASSERT_EQ(true, match.configure(cm, "match_escape"));
+	EXPECT_EQ(1, match.select({ 'x', 'a', 0, 'b', '\n' }, selected));
+	EXPECT_EQ(0, match.select({ 'a', 'b', '\n' }, selected));
+}
+
+TEST(Match, select_regex)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(match_conf);
+	cm.parseFromMemory(config);
+
+	MatchTransformation match;
+	std::vector<uint8_t> selected;
+	auto message = [](const std::string& text) { return std::vector<uint8_t>(text.begin(), text.end()); };
+
+	EXPECT_EQ(false, match.configure(cm, "match_bad_regex"));
+	EXPECT_EQ(false, match.configure(cm, "match_big_cache"));
+	ASSERT_EQ(true, match.configure(cm, "match_regex"));
+	EXPECT_EQ((std::vector<std::string>{ "", "errors", "literal", "ids" }), match.getOutputs());
+
+	EXPECT_EQ(1, match.select(message("ERROR no space on disk"), selected));
+	EXPECT_EQ((std::vector<uint8_t>{ 0, 1, 0, 0 }), selected);
+	EXPECT_EQ(0, match.select(message("WARN ERROR disk"), selected));
+
+	// Literal patterns are not regular expressions even if regexes are used.
+	EXPECT_EQ(0, match.select(message("axb"), selected));
+	EXPECT_EQ(1, match.select(message("a.b"), selected));
+	EXPECT_EQ((std::vector<uint8_t>{ 0, 0, 1, 0 }), selected);
+
+	// $ matches at the end of the message.
+	EXPECT_EQ(1, match.select(message("request id=42"), selected));
+	EXPECT_EQ((std::vector<uint8_t>{ 0, 0, 0, 1 }), selected);
+	EXPECT_EQ(0, match.select(message("request id=42 done"), selected));
+}
+
+TEST(Match, select_stream)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(match_conf);
+	cm.parseFromMemory(config);
+
+	MatchTransformation match;
+	std::vector<uint8_t> selected;
+	auto message = [](const std::string& text) { return std::vector<uint8_t>(text.begin(), text.end()); };
+
+	ASSERT_EQ(true, match.configure(cm, "match_stream"));
+	EXPECT_EQ(0, match.select(message("data across the bou"), selected, 1));
+	EXPECT_EQ(0, match.select(message("unrelated"), selected, 2));
+	EXPECT_EQ(1, match.select(message("ndary of chunks"), selected, 1));
+
+	// Without stream mode every message is matched on its own.
+	ASSERT_EQ(true, match.configure(cm, "match_one"));
+	EXPECT_EQ(0, match.select(message("Na"), selected, 1));
+	EXPECT_EQ(0, match.select(message("me"), selected, 1));
+}
+
+TEST(Match, routing)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(match_conf);
+	cm.parseFromMemory(config);
+
+	MatchTransformation match;
+	CollectStage source, names, passwords, rest, other;
+	names.setName("names");
+	passwords.setName("passwords");
+	rest.setName("rest");
+
+	ASSERT_EQ(true, match.configure(cm, "match_branch"));
+	for (Stage* coop : std::initializer_list<Stage*>{ &source, &names, &passwords, &rest, &other })
+	{
+		match.register_coop(coop->getID(), coop);
+		coop->register_coop(match.getID(), &match);
+	}
+
+	for (std::string text : { "Name", "Password", "Name Password", "Login", "none" })
+		match.add_to_queue(std::vector<uint8_t>(text.begin(), text.end()), source.getID());
+
+	match.set_work_flag(true);
+	std::thread worker(&MatchTransformation::run, &match);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	match.set_work_flag(false);
+	worker.join();
+
+	EXPECT_EQ((std::vector<std::string>{ "Name", "Name Password", "Login" }), names.collected());
+	EXPECT_EQ((std::vector<std::string>{ "Password", "Name Password" }), passwords.collected());
+	EXPECT_EQ((std::vector<std::string>{ "none" }), rest.collected());
+	EXPECT_EQ(std::vector<std::string>{}, other.collected());
+	EXPECT_EQ(std::vector<std::string>{}, source.collected());
+}
+
+TEST(Match, pipeline_branch)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(branch_pipeline_conf);
+	cm.parseFromMemory(config);
+
+	{
+		std::ofstream in("match_in");
+		in << "Password: secret";
+	}
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "branches"));
+	ASSERT_NE(nullptr, pipeline.getStage("bpass"));
+	EXPECT_EQ(true, pipeline.start());
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	EXPECT_EQ(true, pipeline.stop());
+
+	std::ifstream pass("match_pass"), names("match_names");
+	std::stringstream pass_content, names_content;
+	pass_content << pass.rdbuf();
+	names_content << names.rdbuf();
+	EXPECT_EQ("Password: secret", pass_content.str());
+	EXPECT_EQ("", names_content.str());
+
+	remove("match_in");
+	remove("match_pass");
+	remove("match_names");
+}
@@ -0,0 +1,140 @@
+/**
+ *  @file   MetricsExporter_tests.cpp
+ *  @brief  Unit tests for MetricsExporter.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/MetricsExporter.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(SWPL_SYSTEM_HAVE_SYS_UN_H)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define EXPORTER_SOCKET "exporter_test.sock"
+#define EXPORTER_FILE "exporter_test.prom"
+
+constexpr const char* exporter_conf = R"conf(
+[ein]
+type = file
+name = exporter_in
+file = exporter_in
+direction = input
+
+[emirror]
+type = mirror
+
+[epipeline]
+stage1 = ein
+stage2 = emirror
+
+[emetrics]
+socket = exporter_test.sock
+file = exporter_test.prom
+interval = 50
+
+[emetrics_empty]
+interval = 50
+)conf";
+
+TEST(MetricsExporter, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(exporter_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	MetricsExporter exporter(pipeline);
+
+	EXPECT_EQ(false, exporter.configure(cm, "emetrics_empty"));
+	EXPECT_EQ(true, exporter.configure(cm, "emetrics"));
+}
+
+TEST(MetricsExporter, render)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(exporter_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "epipeline"));
+
+	Stage* in = pipeline.getStage("ein");
+	Stage* mirror = pipeline.getStage("emirror");
+	ASSERT_NE(nullptr, mirror);
+	mirror->add_to_queue({ 1, 2, 3 }, in->getID());
+
+	MetricsExporter exporter(pipeline);
+	auto text = exporter.render();
+	auto labels = "pipeline=\"epipeline\",stage=\"emirror\",id=\"" + std::to_string(mirror->getID()) + "\"";
+
+	EXPECT_NE(std::string::npos, text.find("# TYPE swpl_stage_messages_in_total counter"));
+	EXPECT_NE(std::string::npos, text.find("swpl_stage_queue_depth{" + labels + "} 1"));
+	EXPECT_NE(std::string::npos, text.find("swpl_stage_queue_latency_seconds_bucket{" + labels + ",le=\"+Inf\"}"));
+	EXPECT_NE(std::string::npos, text.find("swpl_io_read_calls_total{pipeline=\"epipeline\",stage=\"ein\",id=\""
+		+ std::to_string(in->getID()) + "\",io=\"exporter_in\"} 0"));
+#if defined(SWPL_ENABLE_METRICS)
+	EXPECT_NE(std::string::npos, text.find("swpl_stage_bytes_in_total{" + labels + "} 3"));
+#endif
+}
+
+#if defined(SWPL_SYSTEM_HAVE_SYS_UN_H)
+TEST(MetricsExporter, socket_and_file)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(exporter_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "epipeline"));
+
+	MetricsExporter exporter(pipeline);
+	ASSERT_EQ(true, exporter.configure(cm, "emetrics"));
+	ASSERT_EQ(true, exporter.start());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	ASSERT_GE(fd, 0);
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::string(EXPORTER_SOCKET).copy(address.sun_path, sizeof(address.sun_path) - 1);
+	ASSERT_EQ(0, connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+
+	std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+	ASSERT_EQ(static_cast<ssize_t>(request.size()), write(fd, request.data(), request.size()));
+
+	std::string response;
+	char buffer[4096];
+	ssize_t ret;
+	while ((ret = read(fd, buffer, sizeof(buffer))) > 0)
+		response.append(buffer, static_cast<size_t>(ret));
+	close(fd);
+
+	EXPECT_EQ(0u, response.find("HTTP/1.0 200 OK"));
+	EXPECT_NE(std::string::npos, response.find("swpl_stage_messages_out_total{pipeline=\"epipeline\""));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	exporter.stop();
+
+	std::ifstream file(EXPORTER_FILE);
+	std::stringstream content;
+	content << file.rdbuf();
+	EXPECT_NE(std::string::npos, content.str().find("# TYPE swpl_io_write_duration_seconds histogram"));
+
+	EXPECT_NE(0, access(EXPORTER_SOCKET, F_OK));
+	remove(EXPORTER_FILE);
+}
+#endif
@@ -0,0 +1,128 @@
+/**
+ *  @file   Metrics_tests.cpp
+ *  @brief  Unit tests for instrumentation primitives.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/Metrics.hpp"
+#include "core/Stage.hpp"
+
+#include <thread>
+#include <vector>
+
+#if defined(SWPL_ENABLE_METRICS)
+
+TEST(Metrics, counter_aggregates_threads)
+{
+	Counter counter;
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&counter]() {
+			for (int i = 0; i < 1000; ++i)
+				counter.add(2);
+			});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	EXPECT_EQ(8000, counter.value());
+}
+
+TEST(Metrics, histogram_buckets)
+{
+	for (uint64_t value : { 0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 100ull, 1000ull, 123456789ull, ~0ull }) {
+		auto bucket = LatencyHistogram::bucket_index(value);
+		ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+		EXPECT_LE(LatencyHistogram::bucket_lower(bucket), value);
+		EXPECT_GE(LatencyHistogram::bucket_upper(bucket), value);
+	}
+
+	// Buckets are contiguous.
+	for (unsigned int i = 1; i < LatencyHistogram::BUCKETS; ++i)
+		EXPECT_EQ(LatencyHistogram::bucket_upper(i - 1) + 1, LatencyHistogram::bucket_lower(i));
+}
+
+TEST(Metrics, histogram_quantiles)
+{
+	LatencyHistogram histogram;
+
+	EXPECT_EQ(0, histogram.quantile(0.5));
+
+	for (uint64_t i = 1; i <= 1000; ++i)
+		histogram.record(i);
+
+	EXPECT_EQ(1000, histogram.count());
+	EXPECT_EQ(500500, histogram.sum());
+	EXPECT_EQ(1000, histogram.max());
+
+	auto median = histogram.quantile(0.5);
+	EXPECT_GE(median, 500);
+	EXPECT_LE(median, 500 + 500 / 8);
+	EXPECT_GE(histogram.quantile(1.0), 1000);
+}
+
+class MetricsTestStage : public Stage
+{
+public:
+	void run() override { }
+
+	bool take_from(unsigned int id, std::vector<uint8_t>& data) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		auto route = routes.find(id);
+		return route != nullptr && take(*route, data);
+	}
+
+	void forward(std::vector<uint8_t> data) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		send_to_all(std::move(data), routes);
+	}
+};
+
+TEST(Metrics, stage_counters)
+{
+	MetricsTestStage stage, coop;
+	std::vector<uint8_t> data;
+
+	stage.register_coop(coop.getID(), &coop);
+	coop.register_coop(stage.getID(), &stage);
+
+	stage.add_to_queue({ 1, 2, 3 }, coop.getID());
+	stage.add_to_queue({ 4, 5 }, coop.getID());
+
+	EXPECT_EQ(2, stage.getMetrics().in.messages());
+	EXPECT_EQ(5, stage.getMetrics().in.bytes());
+	EXPECT_EQ(2, stage.pending());
+	EXPECT_EQ(2, stage.pending_high_water());
+
+	ASSERT_EQ(true, stage.take_from(coop.getID(), data));
+	stage.forward(std::move(data));
+
+	EXPECT_EQ(1, stage.getMetrics().out.messages());
+	EXPECT_EQ(3, stage.getMetrics().out.bytes());
+	EXPECT_EQ(1, coop.getMetrics().in.messages());
+	EXPECT_EQ(1, stage.pending());
+	EXPECT_EQ(2, stage.pending_high_water());
+}
+
+TEST(Metrics, stage_latency_sampling)
+{
+	MetricsTestStage stage, coop;
+	std::vector<uint8_t> data;
+
+	stage.register_coop(coop.getID(), &coop);
+
+	for (unsigned int i = 0; i < LATENCY_SAMPLE_RATE; ++i)
+		stage.add_to_queue({ 1 }, coop.getID());
+	while (stage.take_from(coop.getID(), data)) { }
+
+	EXPECT_EQ(1, stage.getMetrics().queue_latency.count());
+	EXPECT_EQ(LATENCY_SAMPLE_RATE, stage.pending_high_water());
+}
+
+#endif /* defined(SWPL_ENABLE_METRICS) */
@@ -0,0 +1,155 @@
+/**
+ *  @file   Patch_tests.cpp
+ *  @brief  Unit tests for the patch transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Patch.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <string>
+#include <vector>
+
+constexpr const char* patch_conf = R"conf(
+[patch_secret]
+type = patch
+find1 = "password=secret"
+replace1 = "password=******"
+find2 = "\x02\x10"
+replace2 = "\x02"
+find3 = "drop"
+replace3 = ""
+
+[patch_overlap]
+type = patch
+find1 = "abc"
+replace1 = "X"
+find2 = "bc"
+replace2 = "Y"
+find3 = "bcd"
+replace3 = "Z"
+
+[patch_messages]
+type = patch
+find1 = "secret"
+replace1 = "***"
+stream = false
+
+[patch_no_replace]
+type = patch
+find1 = "secret"
+
+[patch_empty]
+type = patch
+)conf";
+
+static std::string text(const std::vector<uint8_t>& data)
+{
+	return std::string(data.begin(), data.end());
+}
+
+TEST(Patch, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(patch_conf);
+	cm.parseFromMemory(config);
+
+	PatchTransformation patch;
+	EXPECT_EQ(true, patch.configure(cm, "patch_secret"));
+	EXPECT_EQ(true, patch.configure(cm, "patch_overlap"));
+	EXPECT_EQ(false, patch.configure(cm, "patch_no_replace"));
+	EXPECT_EQ(false, patch.configure(cm, "patch_empty"));
+}
+
+TEST(Patch, replace)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(patch_conf);
+	cm.parseFromMemory(config);
+
+	PatchTransformation patch;
+	ASSERT_EQ(true, patch.configure(cm, "patch_secret"));
+
+	auto data = bytes("login password=secret; drop it");
+	EXPECT_EQ(2, patch.patch(data));
+	EXPECT_EQ("login password=******;  it", text(data));
+
+	data = { 0x01, 0x02, 0x10, 0x03, 0x02, 0x10 };
+	EXPECT_EQ(2, patch.patch(data));
+	EXPECT_EQ((std::vector<uint8_t>{ 0x01, 0x02, 0x03, 0x02 }), data);
+}
+
+TEST(Patch, overlapping)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(patch_conf);
+	cm.parseFromMemory(config);
+
+	PatchTransformation patch;
+	ASSERT_EQ(true, patch.configure(cm, "patch_overlap"));
+
+	// Longest sequence ending first wins, overlapping ones are left alone.
+	auto data = bytes("abcd bcd xbc.");
+	EXPECT_EQ(3, patch.patch(data));
+	EXPECT_EQ("Xd Yd xY.", text(data));
+}
+
+TEST(Patch, pass_through)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(patch_conf);
+	cm.parseFromMemory(config);
+
+	PatchTransformation patch;
+	ASSERT_EQ(true, patch.configure(cm, "patch_secret"));
+
+	auto data = bytes("nothing to replace here");
+	const auto* buffer = data.data();
+	EXPECT_EQ(0, patch.patch(data));
+	EXPECT_EQ("nothing to replace here", text(data));
+	EXPECT_EQ(buffer, data.data());
+}
+
+TEST(Patch, between_messages)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(patch_conf);
+	cm.parseFromMemory(config);
+
+	PatchTransformation patch;
+	ASSERT_EQ(true, patch.configure(cm, "patch_secret"));
+
+	// Possible beginning of the sequence waits for the next message from the same cooperative.
+	auto first = bytes("user password=se"), other = bytes("password=");
+	EXPECT_EQ(0, patch.patch(first, 1));
+	EXPECT_EQ("user ", text(first));
+	EXPECT_EQ(0, patch.patch(other, 2));
+	EXPECT_EQ("", text(other));
+
+	auto second = bytes("cret; pass");
+	EXPECT_EQ(1, patch.patch(second, 1));
+	EXPECT_EQ("password=******; ", text(second));
+
+	auto third = bytes("word=public");
+	EXPECT_EQ(0, patch.patch(third, 1));
+	EXPECT_EQ("password=public", text(third));
+
+	std::vector<uint8_t> rest;
+	EXPECT_EQ(false, patch.flush(rest, 1));
+	EXPECT_EQ(true, patch.flush(rest, 2));
+	EXPECT_EQ("password=", text(rest));
+
+	ASSERT_EQ(true, patch.configure(cm, "patch_messages"));
+	first = bytes("top sec");
+	second = bytes("ret");
+	EXPECT_EQ(0, patch.patch(first, 1));
+	EXPECT_EQ("top sec", text(first));
+	EXPECT_EQ(0, patch.patch(second, 1));
+	EXPECT_EQ(false, patch.flush(rest, 1));
+}
@@ -0,0 +1,339 @@
+/**
+ *  @file   Pipeline_tests.cpp
+ *  @brief  Unit tests for Pipeline.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/Pipeline.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#define PIPELINE_IN_FILE "pipeline_in"
+#define PIPELINE_OUT_FILE "pipeline_out"
+#define PIPELINE_TEST_STR "Data going through the pipeline"
+
+constexpr const char* copy_conf = R"conf(
+[pin]
+type = file
+file = pipeline_in
+direction = input
+
+[pmirror]
+type = mirror
+
+[pout]
+type = file
+file = pipeline_out
+direction = output
+
+[pipeline]
+stage1 = pin
+stage2 = pmirror
+stage3 = pout
+)conf";
+
+constexpr const char* graph_conf = R"conf(
+[m1]
+type = mirror
+
+[m2]
+type = mirror
+tag = first
+
+[m3]
+type = mirror
+
+[graph]
+stage1 = m1
+stage2 = m2
+stage3 = m3
+)conf";
+
+constexpr const char* changed_graph_conf = R"conf(
+[m2]
+type = mirror
+tag = second
+)conf";
+
+constexpr const char* broken_graph_conf = R"conf(
+[m3]
+type = nonexistent
+)conf";
+
+constexpr const char* journal_conf = R"conf(
+[jin]
+type = file
+file = journal_in
+direction = input
+
+[jmirror]
+type = mirror
+
+[jout]
+type = file
+file = journal_out
+direction = output
+
+[jpipeline]
+stage1 = jin
+stage2 = jmirror
+stage3 = jout
+journal = journal_pipeline
+journal_interval = 10
+)conf";
+
+constexpr const char* held_conf = R"conf(
+[hin]
+type = file
+file = journal_in
+direction = input
+
+[hframer]
+type = framer
+
+[hout]
+type = file
+file = journal_out
+direction = output
+
+[hpipeline]
+stage1 = hin
+stage2 = hframer
+stage3 = hout
+journal = journal_pipeline
+journal_interval = 0
+)conf";
+
+/**
+* Run journaled pipeline until the whole input is written to the output.
+*/
+static void run_journaled(size_t input_size, bool checkpointed)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(journal_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "jpipeline"));
+	ASSERT_NE(nullptr, pipeline.getJournal());
+	auto output = dynamic_cast<IOStage*>(pipeline.getStage("jout"));
+	ASSERT_NE(nullptr, output);
+	EXPECT_EQ(true, pipeline.start());
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (output->getWritten() < input_size && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_EQ(input_size, output->getWritten());
+
+	// Periodic checkpoint catches up with the delivered data while pipeline is running.
+	uint64_t read = 0;
+	while (checkpointed && std::chrono::steady_clock::now() < deadline)
+	{
+		if (pipeline.getJournal()->get("jin.read", read) && read == input_size)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (checkpointed)
+	{
+		EXPECT_EQ(input_size, read);
+	}
+
+	EXPECT_EQ(true, pipeline.stop());
+
+	uint64_t written = 0;
+	EXPECT_EQ(true, pipeline.getJournal()->get("jout.written", written));
+	EXPECT_EQ(input_size, written);
+}
+
+static std::string read_file(const char* path)
+{
+	std::ifstream file(path);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+TEST(Pipeline, invalid_config)
+{
+	auto& cm = ConfigurationManager::instance();
+	Pipeline pipeline;
+
+	EXPECT_EQ(false, pipeline.configure(cm, "no_such_pipeline"));
+	EXPECT_EQ(false, pipeline.start());
+
+	// Negative size would wrap around to a huge one.
+	std::string config("[neg_mirror]\ntype = mirror\nspill_threshold = -1\n[neg_pipeline]\nstage1 = neg_mirror\n");
+	cm.parseFromMemory(config);
+	EXPECT_EQ(false, pipeline.configure(cm, "neg_pipeline"));
+}
+
+TEST(Pipeline, copy_file)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(copy_conf);
+	cm.parseFromMemory(config);
+
+	{
+		std::ofstream in(PIPELINE_IN_FILE);
+		in << PIPELINE_TEST_STR;
+	}
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "pipeline"));
+	ASSERT_NE(nullptr, pipeline.getStage("pmirror"));
+	EXPECT_EQ(true, pipeline.start());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	EXPECT_EQ(true, pipeline.stop());
+
+	std::ifstream out(PIPELINE_OUT_FILE);
+	std::stringstream content;
+	content << out.rdbuf();
+	EXPECT_EQ(PIPELINE_TEST_STR, content.str());
+
+	remove(PIPELINE_IN_FILE);
+	remove(PIPELINE_OUT_FILE);
+}
+
+TEST(Pipeline, reconfigure_keeps_queued_data)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(graph_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "graph"));
+
+	Stage* m1 = pipeline.getStage("m1");
+	Stage* m2 = pipeline.getStage("m2");
+	Stage* m3 = pipeline.getStage("m3");
+	ASSERT_NE(nullptr, m2);
+
+	EXPECT_EQ(true, m2->add_to_queue({ 1, 2, 3 }, m1->getID()));
+	EXPECT_EQ(true, m2->add_to_queue({ 4, 5, 6 }, m3->getID()));
+
+	// Broken configuration must not touch the graph.
+	std::string broken(broken_graph_conf);
+	cm.parseFromMemory(broken);
+	EXPECT_EQ(false, pipeline.reconfigure(cm));
+	EXPECT_EQ(m2, pipeline.getStage("m2"));
+	EXPECT_EQ(m3, pipeline.getStage("m3"));
+
+	std::string fixed(graph_conf);
+	cm.parseFromMemory(fixed);
+	std::string changed(changed_graph_conf);
+	cm.parseFromMemory(changed);
+	EXPECT_EQ(true, pipeline.reconfigure(cm));
+
+	// Only the changed stage is replaced and data queued in the old instance is migrated.
+	EXPECT_EQ(m1, pipeline.getStage("m1"));
+	EXPECT_EQ(m3, pipeline.getStage("m3"));
+	Stage* new_m2 = pipeline.getStage("m2");
+	ASSERT_NE(nullptr, new_m2);
+	EXPECT_NE(m2->getID(), new_m2->getID());
+	EXPECT_EQ(1, new_m2->pending(m1->getID()));
+	EXPECT_EQ(1, new_m2->pending(m3->getID()));
+
+	// Neighbours are connected to the new instance.
+	EXPECT_EQ(true, m1->add_to_queue({ 7 }, new_m2->getID()));
+	EXPECT_EQ(true, m3->add_to_queue({ 8 }, new_m2->getID()));
+}
+
+TEST(Pipeline, journal_resumes_inputs)
+{
+	remove("journal_pipeline");
+	{
+		std::ofstream in("journal_in");
+		in << PIPELINE_TEST_STR;
+	}
+	run_journaled(std::string(PIPELINE_TEST_STR).size(), true);
+	EXPECT_EQ(PIPELINE_TEST_STR, read_file("journal_out"));
+
+	// Restarted pipeline reads only what was appended and keeps the output written before.
+	{
+		std::ofstream in("journal_in", std::ios::app);
+		in << " after restart";
+	}
+	run_journaled(std::string(PIPELINE_TEST_STR " after restart").size(), false);
+	EXPECT_EQ(PIPELINE_TEST_STR " after restart", read_file("journal_out"));
+
+	remove("journal_in");
+	remove("journal_out");
+	remove("journal_pipeline");
+}
+
+TEST(Pipeline, journal_after_crash)
+{
+	remove("journal_pipeline");
+	{
+		// Last checkpoint before the crash had 5 bytes delivered, output got more that was not checkpointed.
+		Journal journal{ "journal_pipeline" };
+		ASSERT_EQ(true, journal.open());
+		journal.set("jin.read", 5);
+		journal.set("jout.written", 5);
+		ASSERT_EQ(true, journal.sync());
+
+		std::ofstream in("journal_in");
+		in << "0123456789";
+		std::ofstream out("journal_out");
+		out << "01234567";
+	}
+
+	run_journaled(10, false);
+	EXPECT_EQ("0123456789", read_file("journal_out"));
+
+	remove("journal_in");
+	remove("journal_out");
+	remove("journal_pipeline");
+}
+
+TEST(Pipeline, journal_held_data)
+{
+	remove("journal_pipeline");
+	{
+		std::ofstream in("journal_in");
+		in << "complete\nincomplete";
+	}
+
+	auto& cm = ConfigurationManager::instance();
+	std::string config(held_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "hpipeline"));
+	auto output = dynamic_cast<IOStage*>(pipeline.getStage("hout"));
+	ASSERT_NE(nullptr, output);
+	EXPECT_EQ(true, pipeline.start());
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (output->getWritten() < 9 && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_EQ(9, output->getWritten());
+
+	// Framer holds the incomplete record, input position is committed before it.
+	uint64_t read = 0;
+	EXPECT_EQ(true, pipeline.checkpoint());
+	EXPECT_EQ(true, pipeline.getJournal()->get("hin.read", read));
+	EXPECT_EQ(9, read);
+
+	// Stopping framer passes the record on, so everything is checkpointed.
+	EXPECT_EQ(true, pipeline.stop());
+	EXPECT_EQ(true, pipeline.getJournal()->get("hin.read", read));
+	EXPECT_EQ(19, read);
+	EXPECT_EQ("complete\nincomplete", read_file("journal_out"));
+
+	remove("journal_in");
+	remove("journal_out");
+	remove("journal_pipeline");
+}
@@ -0,0 +1,199 @@
+/**
+ *  @file   RateLimit_tests.cpp
+ *  @brief  Unit tests for the rate limiting transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/RateLimit.hpp"
+#include "io/GeneratorIO.hpp"
+#include "config/ConfigurationManager.hpp"
+#include "TestStages.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* ratelimit_conf = R"conf(
+[rate_messages]
+type = ratelimit
+messages_per_second = 1000
+burst_messages = 2
+
+[rate_bytes]
+type = ratelimit
+bytes_per_second = 1000000
+burst_bytes = 1000
+per_source = true
+
+[rate_replay]
+type = ratelimit
+mode = replay
+speed = 2.0
+
+[rate_live]
+type = ratelimit
+messages_per_second = 2000
+burst_messages = 1
+
+[rate_no_limit]
+type = ratelimit
+
+[rate_bad_unit]
+type = ratelimit
+mode = replay
+timestamp_unit = "h"
+
+[rate_bad_speed]
+type = ratelimit
+mode = replay
+speed = 0
+)conf";
+
+static constexpr uint64_t MS = 1000000;
+
+static std::vector<uint8_t> stamped(uint64_t timestamp)
+{
+	GeneratorHeader header;
+	header.timestamp = timestamp;
+	std::vector<uint8_t> data(GeneratorHeader::SIZE);
+	header.encode(reinterpret_cast<char*>(data.data()));
+	return data;
+}
+
+TEST(RateLimit, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(ratelimit_conf);
+	cm.parseFromMemory(config);
+
+	RateLimitTransformation limit;
+	EXPECT_EQ(true, limit.configure(cm, "rate_messages"));
+	EXPECT_EQ(true, limit.configure(cm, "rate_bytes"));
+	EXPECT_EQ(true, limit.configure(cm, "rate_replay"));
+	EXPECT_EQ(false, limit.configure(cm, "rate_no_limit"));
+	EXPECT_EQ(false, limit.configure(cm, "rate_bad_unit"));
+	EXPECT_EQ(false, limit.configure(cm, "rate_bad_speed"));
+}
+
+TEST(RateLimit, message_bucket)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(ratelimit_conf);
+	cm.parseFromMemory(config);
+
+	RateLimitTransformation limit;
+	ASSERT_EQ(true, limit.configure(cm, "rate_messages"));
+	const uint64_t now = RateLimitTransformation::clock();
+
+	// Burst passes at once, then one message every millisecond.
+	EXPECT_EQ(now, limit.schedule({ 'a' }, 1, now));
+	EXPECT_EQ(now, limit.schedule({ 'b' }, 1, now));
+	EXPECT_EQ(now + MS, limit.schedule({ 'c' }, 1, now));
+	EXPECT_EQ(now + 2 * MS, limit.schedule({ 'd' }, 2, now));
+	EXPECT_EQ(4, limit.getBuffered());
+
+	std::string released;
+	auto collect = [&released](std::vector<uint8_t>&& data, unsigned int) { released.append(data.begin(), data.end()); };
+	EXPECT_EQ(2, limit.release(now + MS / 2, collect));
+	EXPECT_EQ(2, limit.release(now + 2 * MS, collect));
+	EXPECT_EQ("abcd", released);
+	EXPECT_EQ(0, limit.getBuffered());
+
+	// Bucket refills while idle, but not above the burst.
+	EXPECT_EQ(now + 100 * MS, limit.schedule({ 'e' }, 1, now + 100 * MS));
+	EXPECT_EQ(now + 100 * MS, limit.schedule({ 'f' }, 1, now + 100 * MS));
+	EXPECT_EQ(now + 101 * MS, limit.schedule({ 'g' }, 1, now + 100 * MS));
+}
+
+TEST(RateLimit, byte_bucket_per_source)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(ratelimit_conf);
+	cm.parseFromMemory(config);
+
+	RateLimitTransformation limit;
+	ASSERT_EQ(true, limit.configure(cm, "rate_bytes"));
+	const uint64_t now = RateLimitTransformation::clock();
+
+	EXPECT_EQ(now, limit.schedule(std::vector<uint8_t>(1000), 1, now));
+	EXPECT_EQ(now + MS / 2, limit.schedule(std::vector<uint8_t>(500), 1, now));
+	// Message over the burst waits for the full bucket and leaves a debt.
+	EXPECT_EQ(now + 3 * MS / 2, limit.schedule(std::vector<uint8_t>(3000), 1, now));
+	EXPECT_EQ(now + 7 * MS / 2 + 1000, limit.schedule(std::vector<uint8_t>(1), 1, now));
+
+	// Other source has its own bucket.
+	EXPECT_EQ(now, limit.schedule(std::vector<uint8_t>(1000), 2, now));
+}
+
+TEST(RateLimit, replay_timestamps)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(ratelimit_conf);
+	cm.parseFromMemory(config);
+
+	RateLimitTransformation limit;
+	ASSERT_EQ(true, limit.configure(cm, "rate_replay"));
+	const uint64_t now = RateLimitTransformation::clock();
+	const uint64_t origin = 5000 * MS;
+
+	// Gaps are reproduced at double speed, order is kept for timestamps going back and no timestamps.
+	EXPECT_EQ(now, limit.schedule(stamped(origin), 1, now));
+	EXPECT_EQ(now + MS, limit.schedule(stamped(origin + 2 * MS), 1, now));
+	EXPECT_EQ(now + MS, limit.schedule(stamped(origin + MS), 1, now));
+	EXPECT_EQ(now + MS, limit.schedule({ 's', 'h', 'o', 'r', 't' }, 1, now));
+	EXPECT_EQ(now + 5 * MS, limit.schedule(stamped(origin + 10 * MS), 1, now + MS));
+}
+
+TEST(RateLimit, paces_pipeline)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(ratelimit_conf);
+	cm.parseFromMemory(config);
+
+	RateLimitTransformation limit;
+	ASSERT_EQ(true, limit.configure(cm, "rate_live"));
+
+	CollectStage source, sink;
+	for (auto* peer : { &source, &sink })
+	{
+		limit.register_coop(peer->getID(), peer);
+		peer->register_coop(limit.getID(), &limit);
+	}
+
+	std::vector<std::string> sent, received;
+	for (int i = 0; i < 21; ++i)
+		sent.push_back("message " + std::to_string(i));
+
+	limit.set_work_flag(true);
+	std::thread worker(&RateLimitTransformation::run, &limit);
+	auto start = std::chrono::steady_clock::now();
+
+	for (const auto& text : sent)
+		limit.add_to_queue(std::vector<uint8_t>(text.begin(), text.end()), source.getID());
+
+	auto deadline = start + std::chrono::seconds(5);
+	while (received.size() < sent.size() && std::chrono::steady_clock::now() < deadline)
+	{
+		auto more = sink.collected();
+		received.insert(received.end(), more.begin(), more.end());
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	limit.set_work_flag(false);
+	worker.join();
+
+	// 20 intervals of 0.5 ms.
+	EXPECT_EQ(sent, received);
+	EXPECT_GE(elapsed, std::chrono::microseconds(9900));
+	EXPECT_EQ(std::vector<std::string>{}, source.collected());
+
+	for (auto* peer : { &source, &sink })
+		limit.unregister_coop(peer->getID());
+}
@@ -0,0 +1,175 @@
+/**
+ *  @file   Regex_tests.cpp
+ *  @brief  Unit tests for the lazy DFA regular expression set.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Regex.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+
+typedef std::set<size_t> Found;
+
+static Found find_all(RegexSet& regexes, const std::string& text)
+{
+	Found found;
+	RegexSet::Stream stream;
+	auto collect = [&](size_t expression) { found.insert(expression); return true; };
+
+	if (regexes.scan(reinterpret_cast<const uint8_t*>(text.data()), text.size(), stream, collect))
+		regexes.finish(stream, collect);
+
+	return found;
+}
+
+static Found match_all(RegexSet& regexes, const std::string& text)
+{
+	Found found;
+	regexes.match(reinterpret_cast<const uint8_t*>(text.data()), text.size(), [&](size_t expression) {
+		found.insert(expression);
+		return true;
+	});
+	return found;
+}
+
+static bool matches(const std::string& pattern, const std::string& text)
+{
+	RegexSet regexes;
+	EXPECT_EQ(0, regexes.add(pattern)) << pattern;
+	regexes.compile();
+	return !find_all(regexes, text).empty();
+}
+
+TEST(Regex, syntax)
+{
+	EXPECT_TRUE(matches("abc", "xxabcxx"));
+	EXPECT_FALSE(matches("abc", "ab c"));
+	EXPECT_TRUE(matches("a.c", "a-c"));
+	EXPECT_FALSE(matches("a.c", "a\nc"));
+	EXPECT_TRUE(matches("gr(a|e)y", "grey"));
+	EXPECT_TRUE(matches("(?:ab)+c", "xababc"));
+	EXPECT_TRUE(matches("colou?r", "color"));
+	EXPECT_TRUE(matches("a\\.b", "a.b"));
+	EXPECT_FALSE(matches("a\\.b", "axb"));
+	EXPECT_TRUE(matches("\\x41\\t", "A\t"));
+	EXPECT_TRUE(matches("(?i)error", "ERROR: disk"));
+	EXPECT_TRUE(matches("(?i)[a-c]x", "Bx"));
+	EXPECT_TRUE(matches("", "anything"));
+}
+
+TEST(Regex, classes)
+{
+	EXPECT_TRUE(matches("[0-9a-f]+", "zz7f"));
+	EXPECT_FALSE(matches("^[^0-9]+$", "abc1"));
+	EXPECT_TRUE(matches("[]a]", "]"));
+	EXPECT_TRUE(matches("[a-]", "-"));
+	EXPECT_TRUE(matches("\\d\\d:\\d\\d", "at 12:30"));
+	EXPECT_FALSE(matches("\\D", "123"));
+	EXPECT_TRUE(matches("\\w+\\s\\w+", "hello world"));
+	EXPECT_FALSE(matches("^\\S+$", "a b"));
+	EXPECT_TRUE(matches("[\\d.]+", "1.5"));
+}
+
+TEST(Regex, repeat)
+{
+	EXPECT_TRUE(matches("^a{3}$", "aaa"));
+	EXPECT_FALSE(matches("^a{3}$", "aaaa"));
+	EXPECT_TRUE(matches("^a{2,}$", "aaaaa"));
+	EXPECT_FALSE(matches("^a{2,}$", "a"));
+	EXPECT_TRUE(matches("^a{1,3}b$", "aab"));
+	EXPECT_FALSE(matches("^a{1,3}b$", "aaaab"));
+	EXPECT_TRUE(matches("^(ab){2}$", "abab"));
+	EXPECT_TRUE(matches("a{x}", "a{x}"));
+	EXPECT_TRUE(matches("^x*?y+?$", "xxyy"));
+}
+
+TEST(Regex, anchors)
+{
+	EXPECT_TRUE(matches("^start", "start of data"));
+	EXPECT_FALSE(matches("^start", "no start"));
+	EXPECT_TRUE(matches("^second", "first\nsecond"));
+	EXPECT_TRUE(matches("end$", "the end"));
+	EXPECT_TRUE(matches("end$", "the end\nnext"));
+	EXPECT_FALSE(matches("end$", "the end."));
+	EXPECT_TRUE(matches("^$", "a\n\nb"));
+	EXPECT_FALSE(matches("^$", "ab"));
+}
+
+TEST(Regex, multiple_expressions)
+{
+	RegexSet regexes;
+	EXPECT_EQ(0, regexes.add("ERROR"));
+	EXPECT_EQ(1, regexes.add("user=\\w+"));
+	EXPECT_EQ(2, regexes.add("^\\d+$"));
+	regexes.compile();
+	EXPECT_EQ(3, regexes.size());
+
+	EXPECT_EQ((Found{ 0, 1 }), find_all(regexes, "ERROR login user=bob"));
+	EXPECT_EQ((Found{ 2 }), find_all(regexes, "12345"));
+	EXPECT_EQ((Found{ 0, 2 }), find_all(regexes, "42\nERROR"));
+	EXPECT_EQ(Found{}, find_all(regexes, "user= nobody"));
+
+	for (const char* text : { "ERROR login user=bob", "12345", "42\nERROR", "user= nobody" })
+		EXPECT_EQ(find_all(regexes, text), match_all(regexes, text)) << text;
+}
+
+TEST(Regex, invalid)
+{
+	RegexSet regexes;
+
+	for (const char* pattern : { "(", "a)", "[abc", "a\\", "*a", "a|*", "\\q", "[z-a]", "a{1001}", "a{2,1}", "\\xZZ" })
+		EXPECT_EQ(-1, regexes.add(pattern)) << pattern;
+	EXPECT_EQ(0, regexes.size());
+}
+
+TEST(Regex, stream_between_chunks)
+{
+	RegexSet regexes;
+	regexes.add("id=\\d+;");
+	regexes.add("^line");
+	regexes.compile();
+
+	std::vector<std::string> chunks{ "first id=12", "34; then\nli", "ne" };
+	std::vector<Found> found(chunks.size());
+	RegexSet::Stream stream;
+
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		regexes.scan(reinterpret_cast<const uint8_t*>(chunks[i].data()), chunks[i].size(), stream, [&](size_t expression) {
+			found[i].insert(expression);
+			return true;
+		});
+	}
+
+	EXPECT_EQ(Found{}, found[0]);
+	EXPECT_EQ(Found{ 0 }, found[1]);
+	EXPECT_EQ(Found{ 1 }, found[2]);
+}
+
+TEST(Regex, cache_flush)
+{
+	RegexSet regexes;
+	regexes.add("a[ab]{6}c");
+	regexes.add("x\\d+y");
+	regexes.set_cache_limit(4);
+	regexes.compile();
+
+	// State explosion of a[ab]{6} does not fit into 4 states, results must not change.
+	std::string text = "bababbbabac x123y abababab";
+	EXPECT_EQ((Found{ 0, 1 }), find_all(regexes, text));
+	EXPECT_LT(0, regexes.flushes());
+	EXPECT_GE(4, regexes.cached());
+	EXPECT_EQ((Found{ 0, 1 }), find_all(regexes, text));
+	EXPECT_EQ((Found{ 0, 1 }), match_all(regexes, text));
+
+	regexes.set_cache_limit(RegexSet::MAX_CACHE_LIMIT + 1);
+	regexes.compile();
+	EXPECT_EQ((Found{ 0, 1 }), find_all(regexes, text));
+}
@@ -0,0 +1,157 @@
+/**
+ *  @file   RotatingFile_tests.cpp
+ *  @brief  Unit tests for the rotated output file.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "io/RotatingFile.hpp"
+#include "transform/Compress.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const std::filesystem::path ROTATING_DIR{ "rotating_test" };
+
+static RotatingFile::Settings rotating_settings(uint64_t size)
+{
+	std::filesystem::remove_all(ROTATING_DIR);
+	std::filesystem::create_directory(ROTATING_DIR);
+
+	RotatingFile::Settings settings;
+	settings.path = (ROTATING_DIR / "out").string();
+	settings.size = size;
+	return settings;
+}
+
+static std::string rotating_content(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static size_t rotating_files()
+{
+	return static_cast<size_t>(std::distance(std::filesystem::directory_iterator(ROTATING_DIR), std::filesystem::directory_iterator()));
+}
+
+TEST(RotatingFile, size)
+{
+	auto settings = rotating_settings(250);
+	std::string written;
+
+	{
+		RotatingFile file(settings);
+		ASSERT_EQ(true, file.open());
+		EXPECT_EQ(settings.path + ".000000", file.getCurrentPath());
+
+		// Write is never split - segment ends with the write crossing the size.
+		for (char c = 'a'; c < 'a' + 10; ++c)
+		{
+			std::string block(100, c);
+			ASSERT_EQ(true, file.write(block.data(), block.size()));
+			written += block;
+		}
+		EXPECT_EQ(3, file.getRotations());
+		file.close();
+	}
+
+	// Segment prepared for the next rotation is removed.
+	EXPECT_EQ(4, rotating_files());
+	std::string joined;
+	for (uint64_t index = 0; index < 4; ++index)
+	{
+		char name[16];
+		std::snprintf(name, sizeof(name), "out.%06llu", static_cast<unsigned long long>(index));
+		auto content = rotating_content((ROTATING_DIR / name).string());
+		EXPECT_EQ(index < 3 ? 300 : 100, content.size()) << index;
+		EXPECT_EQ(content.size(), std::filesystem::file_size(ROTATING_DIR / name));
+		joined += content;
+	}
+	EXPECT_EQ(written, joined);
+
+	// Numbering continues after the segments already present.
+	RotatingFile again(settings);
+	ASSERT_EQ(true, again.open());
+	EXPECT_EQ(settings.path + ".000004", again.getCurrentPath());
+	again.close();
+
+	std::filesystem::remove_all(ROTATING_DIR);
+}
+
+TEST(RotatingFile, interval)
+{
+	auto settings = rotating_settings(0);
+	settings.interval = std::chrono::milliseconds(50);
+
+	RotatingFile file(settings);
+	ASSERT_EQ(true, file.open());
+	ASSERT_EQ(true, file.write("first", 5));
+	EXPECT_EQ(0, file.getRotations());
+
+	// Time limit is checked when data is written.
+	std::this_thread::sleep_for(std::chrono::milliseconds(80));
+	ASSERT_EQ(true, file.write("second", 6));
+	EXPECT_EQ(1, file.getRotations());
+	ASSERT_EQ(true, file.write("third", 5));
+
+	// Synced file has all data durable and closed segments finalized.
+	ASSERT_EQ(true, file.sync());
+	EXPECT_EQ("firstsecond", rotating_content(settings.path + ".000000"));
+	EXPECT_EQ("third", rotating_content(settings.path + ".000001"));
+	file.close();
+
+	std::filesystem::remove_all(ROTATING_DIR);
+}
+
+TEST(RotatingFile, compress)
+{
+	auto settings = rotating_settings(4000);
+	settings.compress = true;
+	std::string written;
+
+	{
+		RotatingFile file(settings);
+		ASSERT_EQ(true, file.open());
+		for (unsigned int i = 0; i < 1000; ++i)
+		{
+			auto line = "line " + std::to_string(i) + " of the compressed output\n";
+			ASSERT_EQ(true, file.write(line.data(), line.size()));
+			written += line;
+		}
+		file.close();
+	}
+
+	// Only compressed segments are left, readable by the decompress stage.
+	std::string joined;
+	DecompressTransformation decompress;
+	for (uint64_t index = 0; ; ++index)
+	{
+		char name[24];
+		std::snprintf(name, sizeof(name), "out.%06llu", static_cast<unsigned long long>(index));
+		auto path = ROTATING_DIR / name;
+		if (!std::filesystem::exists(path.string() + ".swz"))
+			break;
+		EXPECT_EQ(false, std::filesystem::exists(path));
+
+		auto content = rotating_content(path.string() + ".swz");
+		EXPECT_LT(content.size(), 4000);
+
+		std::vector<std::vector<uint8_t>> blocks;
+		decompress.decompress(std::vector<uint8_t>(content.begin(), content.end()), 1, blocks);
+		for (const auto& block : blocks)
+			joined.append(block.begin(), block.end());
+	}
+	EXPECT_EQ(written, joined);
+	EXPECT_EQ(0, decompress.getBroken());
+
+	std::filesystem::remove_all(ROTATING_DIR);
+}
@@ -0,0 +1,184 @@
+/**
+ *  @file   Sample_tests.cpp
+ *  @brief  Unit tests for the sampling transform.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "transform/Sample.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <string>
+#include <vector>
+
+constexpr const char* sample_conf = R"conf(
+[sample_nth]
+type = sample
+every = 3
+
+[sample_probability]
+type = sample
+mode = probability
+probability = 0.1
+seed = 7
+
+[sample_all]
+type = sample
+mode = probability
+probability = 1
+
+[sample_reservoir]
+type = sample
+mode = reservoir
+size = 4
+seed = 7
+
+[sample_bad_mode]
+type = sample
+mode = random
+
+[sample_bad_every]
+type = sample
+every = 0
+
+[sample_bad_probability]
+type = sample
+mode = probability
+probability = 1.5
+
+[sample_bad_size]
+type = sample
+mode = reservoir
+size = 0
+)conf";
+
+static std::vector<uint8_t> message(unsigned int number)
+{
+	auto text = std::to_string(number);
+	return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+TEST(Sample, configure)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(sample_conf);
+	cm.parseFromMemory(config);
+
+	SampleTransformation sample;
+	EXPECT_EQ(true, sample.configure(cm, "sample_nth"));
+	EXPECT_EQ(true, sample.configure(cm, "sample_probability"));
+	EXPECT_EQ(true, sample.configure(cm, "sample_reservoir"));
+	EXPECT_EQ(false, sample.configure(cm, "sample_bad_mode"));
+	EXPECT_EQ(false, sample.configure(cm, "sample_bad_every"));
+	EXPECT_EQ(false, sample.configure(cm, "sample_bad_probability"));
+	EXPECT_EQ(false, sample.configure(cm, "sample_bad_size"));
+}
+
+TEST(Sample, nth)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(sample_conf);
+	cm.parseFromMemory(config);
+
+	SampleTransformation sample;
+	ASSERT_EQ(true, sample.configure(cm, "sample_nth"));
+
+	std::vector<unsigned int> passed;
+	for (unsigned int i = 0; i < 10; ++i)
+	{
+		auto data = message(i);
+		if (sample.sample(data, 1))
+			passed.push_back(i);
+	}
+
+	EXPECT_EQ((std::vector<unsigned int>{ 0, 3, 6, 9 }), passed);
+	EXPECT_EQ(6, sample.getSkipped());
+}
+
+TEST(Sample, probability)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(sample_conf);
+	cm.parseFromMemory(config);
+
+	SampleTransformation sample;
+	ASSERT_EQ(true, sample.configure(cm, "sample_probability"));
+
+	size_t passed = 0;
+	for (unsigned int i = 0; i < 100000; ++i)
+	{
+		auto data = message(i);
+		passed += sample.sample(data, 1) ? 1 : 0;
+	}
+
+	// 10000 expected, standard deviation is under 100.
+	EXPECT_GT(passed, 9500);
+	EXPECT_LT(passed, 10500);
+	EXPECT_EQ(100000 - passed, sample.getSkipped());
+
+	ASSERT_EQ(true, sample.configure(cm, "sample_all"));
+	for (unsigned int i = 0; i < 100; ++i)
+	{
+		auto data = message(i);
+		EXPECT_EQ(true, sample.sample(data, 1));
+	}
+}
+
+TEST(Sample, reservoir)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(sample_conf);
+	cm.parseFromMemory(config);
+
+	SampleTransformation sample;
+	ASSERT_EQ(true, sample.configure(cm, "sample_reservoir"));
+
+	// Every message gets into the sample with the same probability.
+	std::vector<unsigned int> hits(20);
+	for (int window = 0; window < 5000; ++window)
+	{
+		for (unsigned int i = 0; i < hits.size(); ++i)
+		{
+			auto data = message(i);
+			EXPECT_EQ(false, sample.sample(data, 1));
+		}
+
+		std::vector<unsigned int> sampled;
+		sample.drain([&sampled](std::vector<uint8_t>&& data, unsigned int src) {
+			EXPECT_EQ(1, src);
+			sampled.push_back(static_cast<unsigned int>(std::stoul(std::string(data.begin(), data.end()))));
+		});
+
+		ASSERT_EQ(4, sampled.size());
+		for (size_t i = 0; i < sampled.size(); ++i)
+		{
+			++hits[sampled[i]];
+			// Sample keeps the order of the messages.
+			if (i != 0)
+			{
+				EXPECT_LT(sampled[i - 1], sampled[i]);
+			}
+		}
+	}
+
+	// 1000 expected for every message, standard deviation is under 30.
+	for (auto count : hits)
+	{
+		EXPECT_GT(count, 850);
+		EXPECT_LT(count, 1150);
+	}
+	EXPECT_EQ(5000 * 16, sample.getSkipped());
+
+	// Window with fewer messages than the reservoir passes them all, empty one passes nothing.
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		auto data = message(i);
+		sample.sample(data, 2);
+	}
+	EXPECT_EQ(2, sample.drain([](std::vector<uint8_t>&&, unsigned int src) { EXPECT_EQ(2, src); }));
+	EXPECT_EQ(0, sample.drain([](std::vector<uint8_t>&&, unsigned int) { }));
+}
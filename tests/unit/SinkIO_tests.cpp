@@ -0,0 +1,106 @@
+/**
+ *  @file   SinkIO_tests.cpp
+ *  @brief  Unit tests for SinkIO.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "io/SinkIO.hpp"
+#include "io/GeneratorIO.hpp"
+#include "core/Pipeline.hpp"
+#include "config/ConfigurationManager.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* sink_conf = R"conf(
+[sink]
+type = sink
+direction = output
+
+[load_gen]
+type = generator
+direction = input
+count = 100
+size = 64
+size_max = 256
+
+[load_mirror]
+type = mirror
+
+[load_sink]
+type = sink
+direction = output
+
+[load]
+stage1 = load_gen
+stage2 = load_mirror
+stage3 = load_sink
+)conf";
+
+static std::vector<char> message(uint32_t source, uint64_t sequence, uint64_t timestamp)
+{
+	std::vector<char> data(GeneratorHeader::SIZE + 8);
+	GeneratorHeader{ source, sequence, timestamp }.encode(data.data());
+	return data;
+}
+
+TEST(SinkIO, accounting)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(sink_conf);
+	cm.parseFromMemory(config);
+
+	SinkIO sink;
+	std::vector<char> buffer;
+	ASSERT_EQ(true, sink.configure(cm, "sink"));
+	ASSERT_EQ(0, sink.open());
+
+	auto now = GeneratorHeader::now();
+	EXPECT_EQ(32, sink.write(message(1, 0, now)));
+	EXPECT_EQ(32, sink.write(message(1, 3, now)));			// 1 and 2 missing
+	EXPECT_EQ(32, sink.write(message(1, 1, now)));			// late
+	EXPECT_EQ(32, sink.write(message(2, 0, now)));			// other source
+	EXPECT_EQ(5, sink.write(std::vector<char>(5, 'x')));	// untagged
+
+	auto report = sink.getReport();
+	EXPECT_EQ(5, report.messages);
+	EXPECT_EQ(4 * 32 + 5, report.bytes);
+	EXPECT_EQ(4, report.tagged);
+	EXPECT_EQ(1, report.lost);
+	EXPECT_EQ(1, report.reordered);
+	EXPECT_GE(report.latency_quantile(1.0), report.latency_quantile(0.5));
+	EXPECT_EQ(0, sink.read(buffer, 10));
+}
+
+TEST(SinkIO, pipeline_end_to_end)
+{
+	auto& cm = ConfigurationManager::instance();
+	std::string config(sink_conf);
+	cm.parseFromMemory(config);
+
+	Pipeline pipeline;
+	ASSERT_EQ(true, pipeline.configure(cm, "load"));
+	ASSERT_EQ(true, pipeline.start());
+
+	auto sinkStage = dynamic_cast<IOStage*>(pipeline.getStage("load_sink"));
+	ASSERT_NE(nullptr, sinkStage);
+	auto& sink = dynamic_cast<const SinkIO&>(sinkStage->getIO());
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (sink.getReport().messages < 100 && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	pipeline.stop();
+
+	auto report = sink.getReport();
+	EXPECT_EQ(100, report.messages);
+	EXPECT_EQ(100, report.tagged);
+	EXPECT_EQ(0, report.lost);
+	EXPECT_GT(report.latency_quantile(0.5), 0);
+}
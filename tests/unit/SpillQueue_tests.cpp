@@ -0,0 +1,172 @@
+/**
+ *  @file   SpillQueue_tests.cpp
+ *  @brief  Unit tests for spilling of the stage queues.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/SpillQueue.hpp"
+#include "core/Stage.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static std::vector<uint8_t> message(unsigned int number, size_t size = 0)
+{
+	auto text = std::to_string(number);
+	text.resize(std::max(size, text.size()), '.');
+	return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+static std::string spill_directory()
+{
+	auto directory = std::filesystem::temp_directory_path() / "swpl_spill_tests";
+	std::filesystem::create_directories(directory);
+	return directory.string();
+}
+
+static size_t spill_files(const std::string& directory)
+{
+	size_t files = 0;
+	for ([[maybe_unused]] const auto& entry : std::filesystem::directory_iterator(directory))
+		++files;
+	return files;
+}
+
+/**
+* Stage exposing its queues.
+*/
+class SpillStage : public Stage
+{
+public:
+	void run() override { }
+
+	bool next(unsigned int id, std::vector<uint8_t>& data) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		auto route = routes.find(id);
+		return route != nullptr && take(*route, data);
+	}
+};
+
+TEST(SpillQueue, file_segments)
+{
+	auto directory = spill_directory();
+	std::vector<uint8_t> data;
+
+	{
+		SpillFile file{ (std::filesystem::path(directory) / "segments").string(), 100 };
+		EXPECT_EQ(false, file.next(data));
+
+		// Records go over several segments, read ones are removed.
+		for (unsigned int i = 0; i < 50; ++i)
+			ASSERT_EQ(true, file.append(message(i, 10)));
+		EXPECT_EQ(50, file.size());
+		EXPECT_LE(6, spill_files(directory));
+
+		for (unsigned int i = 0; i < 30; ++i)
+		{
+			ASSERT_EQ(true, file.next(data));
+			EXPECT_EQ(message(i, 10), data);
+		}
+		EXPECT_GE(4, spill_files(directory));
+
+		// Reader catches up with the writer in the segment being written.
+		auto expected = [](unsigned int number) { return message(number, number < 50 ? 10 : (number % 3 == 0 ? 0 : 300)); };
+		unsigned int read = 30;
+		for (unsigned int i = 50; i < 60; ++i)
+		{
+			ASSERT_EQ(true, file.append(expected(i)));
+			for (unsigned int j = 0; j < 3; ++j, ++read)
+			{
+				ASSERT_EQ(true, file.next(data));
+				EXPECT_EQ(expected(read), data);
+			}
+		}
+		EXPECT_EQ(0, file.size());
+		EXPECT_EQ(false, file.next(data));
+
+		file.append(message(1));
+	}
+
+	// Destroyed file leaves nothing behind.
+	EXPECT_EQ(0, spill_files(directory));
+}
+
+TEST(SpillQueue, keeps_order)
+{
+	auto directory = spill_directory();
+	SpillQueue queue{ SpillSettings{ 100, directory, 256 }, "order" };
+	std::vector<std::vector<uint8_t>> memory;
+	std::vector<uint8_t> data;
+
+	// Three messages fit in memory, the rest is spilled - also after memory is freed.
+	for (unsigned int i = 0; i < 10; ++i)
+	{
+		data = message(i, 30);
+		if (!queue.push(data))
+			memory.push_back(data);
+		if (i == 5)
+		{
+			for (const auto& taken : memory)
+				queue.taken(taken.size());
+		}
+	}
+	ASSERT_EQ(3, memory.size());
+	EXPECT_EQ(7, queue.size());
+	EXPECT_EQ(7, queue.getSpilled());
+
+	for (unsigned int i = 3; i < 10; ++i)
+	{
+		ASSERT_EQ(true, queue.pop(data));
+		EXPECT_EQ(message(i, 30), data);
+	}
+	EXPECT_EQ(false, queue.pop(data));
+	EXPECT_EQ(0, queue.size());
+	EXPECT_EQ(0, spill_files(directory));
+
+	// Drained queue takes messages into memory again, too large ones are always spilled.
+	data = message(10, 30);
+	EXPECT_EQ(false, queue.push(data));
+	data = message(11, 200);
+	EXPECT_EQ(true, queue.push(data));
+	ASSERT_EQ(true, queue.pop(data));
+	EXPECT_EQ(message(11, 200), data);
+}
+
+TEST(SpillQueue, stage_queue)
+{
+	auto directory = spill_directory();
+	SpillStage stage, sender;
+	stage.setSpill(SpillSettings{ 1000, directory, 4096 });
+	stage.register_coop(sender.getID(), &sender);
+
+	for (unsigned int i = 0; i < 1000; ++i)
+		ASSERT_EQ(true, stage.add_to_queue(message(i, 100), sender.getID()));
+	EXPECT_EQ(1000, stage.pending(sender.getID()));
+	EXPECT_LT(0, spill_files(directory));
+
+	std::vector<uint8_t> data;
+	for (unsigned int i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(true, stage.next(sender.getID(), data));
+		EXPECT_EQ(message(i, 100), data);
+		// New data keeps coming while spilled data is read.
+		if (i % 2 == 0)
+			stage.add_to_queue(message(1000 + i / 2, 100), sender.getID());
+	}
+	for (unsigned int i = 0; i < 500; ++i)
+	{
+		ASSERT_EQ(true, stage.next(sender.getID(), data));
+		EXPECT_EQ(message(1000 + i, 100), data);
+	}
+
+	EXPECT_EQ(false, stage.next(sender.getID(), data));
+	EXPECT_EQ(0, stage.pending());
+	EXPECT_EQ(0, spill_files(directory));
+	stage.unregister_coop(sender.getID());
+}
@@ -0,0 +1,180 @@
+/**
+ *  @file   Stage_tests.cpp
+ *  @brief  Unit tests for Stage routing.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/Stage.hpp"
+
+#include <atomic>
+#include <thread>
+
+class TestStage : public Stage
+{
+public:
+	void run() override { }
+
+	size_t queued(unsigned int id) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		auto route = routes.find(id);
+		return (route != nullptr && route->incoming) ? route->incoming->queue.size() : 0;
+	}
+
+	Stage* outgoing(unsigned int id) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		auto route = routes.find(id);
+		return route != nullptr ? route->outgoing : nullptr;
+	}
+
+	size_t slots() {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		return routes.table().size();
+	}
+
+	bool take_from(unsigned int id, std::vector<uint8_t>& data) {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		auto route = routes.find(id);
+		return route != nullptr && take(*route, data);
+	}
+
+	void check() {
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		check_sources(routes);
+	}
+
+	std::vector<unsigned int> changed;
+
+protected:
+	void source_changed(unsigned int slot) override {
+		changed.push_back(slot);
+	}
+};
+
+TEST(Stage, ids)
+{
+	TestStage s1, s2;
+
+	EXPECT_NE(s1.getID(), 0);
+	EXPECT_NE(s1.getID(), s2.getID());
+}
+
+TEST(Stage, add_unregistered)
+{
+	TestStage stage;
+
+	EXPECT_EQ(false, stage.add_to_queue({ 1, 2, 3 }));
+	EXPECT_EQ(false, stage.add_to_queue({ 1, 2, 3 }, 5));
+}
+
+TEST(Stage, register_add_unregister)
+{
+	TestStage stage, coop;
+
+	stage.register_coop(coop.getID(), &coop);
+
+	EXPECT_EQ(&coop, stage.outgoing(coop.getID()));
+	EXPECT_EQ(true, stage.add_to_queue({ 1, 2, 3 }, coop.getID()));
+	EXPECT_EQ(true, stage.add_to_queue({ 4 }, coop.getID()));
+	EXPECT_EQ(2, stage.queued(coop.getID()));
+
+	// Registering again must not drop queued data.
+	stage.register_coop(coop.getID(), &coop);
+	EXPECT_EQ(2, stage.queued(coop.getID()));
+
+	stage.unregister_coop(coop.getID());
+
+	EXPECT_EQ(nullptr, stage.outgoing(coop.getID()));
+	EXPECT_EQ(false, stage.add_to_queue({ 1 }, coop.getID()));
+	EXPECT_EQ(0, stage.queued(coop.getID()));
+}
+
+TEST(Stage, slots_reused)
+{
+	TestStage stage, coop;
+	std::vector<uint8_t> data;
+
+	stage.register_coop(coop.getID(), &coop);
+	const auto size = stage.slots();
+
+	// Every reconfiguration creates stages with new IDs - table must not grow with them.
+	for (int i = 0; i < 100; ++i)
+	{
+		TestStage other;
+		stage.register_coop(other.getID(), &other);
+		EXPECT_EQ(size + 1, stage.slots());
+		stage.unregister_coop(other.getID());
+		EXPECT_EQ(size, stage.slots());
+	}
+
+	TestStage first, second;
+	stage.register_coop(first.getID(), &first);
+	EXPECT_EQ(true, stage.add_to_queue({ 1 }, first.getID()));
+	EXPECT_EQ(true, stage.take_from(first.getID(), data));
+	EXPECT_EQ(true, stage.changed.empty());
+
+	// Slot of the unregistered cooperative goes to the next one and the stage is told about it.
+	stage.unregister_coop(first.getID());
+	stage.register_coop(second.getID(), &second);
+	EXPECT_EQ(size + 1, stage.slots());
+	EXPECT_EQ(true, stage.add_to_queue({ 2 }, second.getID()));
+	EXPECT_EQ(true, stage.take_from(second.getID(), data));
+	ASSERT_EQ(1, stage.changed.size());
+	EXPECT_EQ(std::vector<uint8_t>{ 2 }, data);
+}
+
+TEST(Stage, sources_gone)
+{
+	TestStage stage, first, second;
+	std::vector<uint8_t> data;
+
+	stage.register_coop(first.getID(), &first);
+	stage.register_coop(second.getID(), &second);
+	EXPECT_EQ(true, stage.add_to_queue({ 1 }, second.getID()));
+	EXPECT_EQ(true, stage.take_from(second.getID(), data));
+	stage.check();
+	EXPECT_EQ(true, stage.changed.empty());
+
+	// Stage is told about the unregistered cooperative even though nobody takes its slot.
+	stage.unregister_coop(second.getID());
+	stage.check();
+	ASSERT_EQ(1, stage.changed.size());
+	stage.check();
+	EXPECT_EQ(1, stage.changed.size());
+
+	// Cooperative the stage never took data of is not reported.
+	stage.unregister_coop(first.getID());
+	stage.check();
+	EXPECT_EQ(1, stage.changed.size());
+}
+
+TEST(Stage, reconfigure_during_traffic)
+{
+	TestStage stage, coop;
+	const unsigned int other_id = coop.getID() + 100;
+	std::atomic<bool> run{ true };
+	std::atomic<unsigned int> added{ 0 };
+
+	stage.register_coop(coop.getID(), &coop);
+
+	std::thread producer([&]() {
+		while (run.load()) {
+			if (stage.add_to_queue({ 1 }, coop.getID()))
+				added++;
+		}
+		});
+
+	for (int i = 0; i < 200; ++i) {
+		stage.register_coop(other_id, &coop);
+		stage.unregister_coop(other_id);
+	}
+
+	run.store(false);
+	producer.join();
+
+	EXPECT_EQ(added.load(), stage.queued(coop.getID()));
+}
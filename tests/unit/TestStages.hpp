@@ -0,0 +1,46 @@
+/**
+ *  @file   TestStages.hpp
+ *  @brief  Helpers shared by the stage unit tests.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#ifndef TESTS_UNIT_TESTSTAGES_HPP_
+#define TESTS_UNIT_TESTSTAGES_HPP_
+
+#include "core/Stage.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* Stage feeding the tested stage and remembering everything it gets back.
+*/
+class CollectStage : public Stage
+{
+public:
+	void run() override { }
+
+	std::vector<std::string> collected() {
+		std::vector<std::string> result;
+		std::vector<uint8_t> data;
+		RoutingTable<Route>::ReadGuard routes{ routes_ };
+		for (const auto& route : routes.table())
+		{
+			while (take(route, data))
+				result.emplace_back(data.begin(), data.end());
+		}
+		return result;
+	}
+};
+
+inline std::vector<uint8_t> bytes(const std::string& text)
+{
+	return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+#endif /* TESTS_UNIT_TESTSTAGES_HPP_ */
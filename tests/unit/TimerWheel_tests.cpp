@@ -0,0 +1,96 @@
+/**
+ *  @file   TimerWheel_tests.cpp
+ *  @brief  Unit tests for the timer wheel.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "core/TimerWheel.hpp"
+
+#include <map>
+#include <random>
+#include <vector>
+
+TEST(TimerWheel, expire_in_order)
+{
+	TimerWheel<int> wheel{ 10, 1000 };
+	std::vector<int> expired;
+	auto collect = [&expired](int&& item) { expired.push_back(item); };
+
+	EXPECT_EQ(true, wheel.empty());
+	EXPECT_EQ(TimerWheel<int>::NEVER, wheel.next_time());
+
+	wheel.schedule(1500, 2);
+	wheel.schedule(1200, 1);
+	wheel.schedule(1500, 3);									// Same tick - scheduling order.
+	wheel.schedule(500, 0);										// Past - expires right away.
+	EXPECT_EQ(4, wheel.size());
+	EXPECT_EQ(1000, wheel.next_time());
+
+	EXPECT_EQ(1, wheel.expire(1000, collect));
+	EXPECT_EQ(1200, wheel.next_time());
+	EXPECT_EQ(0, wheel.expire(1199, collect));
+	EXPECT_EQ(3, wheel.expire(1500, collect));
+	EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3 }), expired);
+	EXPECT_EQ(true, wheel.empty());
+}
+
+TEST(TimerWheel, far_and_cascaded)
+{
+	TimerWheel<int> wheel{ 1, 0 };
+	std::vector<int> expired;
+	auto collect = [&expired](int&& item) { expired.push_back(item); };
+
+	// Ticks on every level and beyond the last one.
+	wheel.schedule(100000000, 4);
+	wheel.schedule(70000, 3);
+	wheel.schedule(4100, 2);
+	wheel.schedule(65, 1);
+
+	EXPECT_EQ(0, wheel.expire(64, collect));
+	EXPECT_EQ(1, wheel.expire(4099, collect));
+	EXPECT_EQ(1, wheel.expire(4100, collect));
+	EXPECT_EQ(1, wheel.expire(99999999, collect));
+	EXPECT_EQ(100000000, wheel.next_time());
+	EXPECT_EQ(1, wheel.expire(100000000, collect));
+	EXPECT_EQ((std::vector<int>{ 1, 2, 3, 4 }), expired);
+}
+
+TEST(TimerWheel, random_against_reference)
+{
+	std::mt19937_64 random{ 11 };
+	TimerWheel<uint64_t> wheel{ 1, 0 };
+	std::multimap<uint64_t, uint64_t> reference;					// Tick -> id, keeps insertion order of equal keys.
+	uint64_t now = 0, id = 0;
+
+	for (int round = 0; round < 20000; ++round)
+	{
+		for (int i = static_cast<int>(random() % 4); i > 0; --i)
+		{
+			uint64_t range = uint64_t{ 1 } << (random() % 30);
+			uint64_t time = now + random() % range;
+			wheel.schedule(time, uint64_t{ id });
+			reference.emplace(time, id++);
+		}
+
+		now += random() % (uint64_t{ 1 } << (random() % 20));
+
+		std::vector<uint64_t> expired, expected;
+		wheel.expire(now, [&expired](uint64_t&& item) { expired.push_back(item); });
+		while (!reference.empty() && reference.begin()->first <= now)
+		{
+			expected.push_back(reference.begin()->second);
+			reference.erase(reference.begin());
+		}
+
+		ASSERT_EQ(expected, expired) << round;
+		ASSERT_EQ(reference.size(), wheel.size());
+		if (!reference.empty()) {
+			ASSERT_LE(wheel.next_time(), reference.begin()->first);
+		}
+	}
+}
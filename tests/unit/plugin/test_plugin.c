@@ -0,0 +1,121 @@
+/**
+ *  @file   test_plugin.c
+ *  @brief  Plugin used by the api transform unit tests.
+ *
+ *  @author Piotr Olszewski     asmie@asmie.pl
+ *
+ *  @date   2026.10.19
+ *
+ *  Option "mode" selects what the plugin does with every message:
+ *  - pass - emits the message itself,
+ *  - upper - emits upper case copy built in the host buffer,
+ *  - split - emits the first and the second half of the message,
+ *  - drop - emits nothing.
+ */
+
+#include "swpl_plugin.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum mode
+{
+	MODE_PASS,
+	MODE_UPPER,
+	MODE_SPLIT,
+	MODE_DROP
+};
+
+struct context
+{
+	enum mode mode;
+	int configured;
+};
+
+static void* plugin_init(const swpl_host* host)
+{
+	struct context* context = calloc(1, sizeof(struct context));
+
+	host->log(host->handle, SWPL_PLUGIN_LOG_VERBOSE, "test plugin created");
+	return context;
+}
+
+static int plugin_configure(void* instance, const char* key, const char* value)
+{
+	struct context* context = instance;
+
+	if (strcmp(key, "mode") != 0)
+		return -1;
+
+	if (strcmp(value, "pass") == 0)
+		context->mode = MODE_PASS;
+	else if (strcmp(value, "upper") == 0)
+		context->mode = MODE_UPPER;
+	else if (strcmp(value, "split") == 0)
+		context->mode = MODE_SPLIT;
+	else if (strcmp(value, "drop") == 0)
+		context->mode = MODE_DROP;
+	else
+		return -1;
+
+	context->configured = 1;
+	return 0;
+}
+
+static int plugin_process(void* instance, const swpl_view* messages, size_t count, const swpl_host* host)
+{
+	struct context* context = instance;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const swpl_view* message = &messages[i];
+
+		switch (context->mode)
+		{
+		case MODE_PASS:
+			host->emit(host->handle, message->data, message->size);
+			break;
+		case MODE_UPPER:
+		{
+			uint8_t* buffer = host->alloc(host->handle, message->size);
+			if (buffer == NULL)
+				return -1;
+			for (size_t pos = 0; pos < message->size; ++pos)
+				buffer[pos] = (message->data[pos] >= 'a' && message->data[pos] <= 'z') ? message->data[pos] - 'a' + 'A' : message->data[pos];
+			host->emit(host->handle, buffer, message->size);
+			break;
+		}
+		case MODE_SPLIT:
+			host->emit(host->handle, message->data, message->size / 2);
+			host->emit(host->handle, message->data + message->size / 2, message->size - message->size / 2);
+			break;
+		case MODE_DROP:
+			break;
+		}
+	}
+
+	return context->configured ? 0 : 1;
+}
+
+static void plugin_destroy(void* instance)
+{
+	free(instance);
+}
+
+static const swpl_plugin plugin = {
+	SWPL_PLUGIN_ABI_VERSION,
+	plugin_init,
+	plugin_configure,
+	plugin_process,
+	plugin_destroy
+};
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+const swpl_plugin* swpl_plugin_entry(void)
+{
+	return &plugin;
+}